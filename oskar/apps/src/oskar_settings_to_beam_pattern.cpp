@@ -48,6 +48,9 @@ oskar_BeamPattern* oskar_settings_to_beam_pattern(oskar::SettingsTree* s,
     oskar_beam_pattern_set_log(h, log);
     oskar_beam_pattern_set_max_chunk_size(h,
             s->to_int("max_sources_per_chunk", status));
+    if (!s->starts_with("max_station_work_mb", "auto", status))
+        oskar_beam_pattern_set_max_station_work_mb(h,
+                s->to_int("max_station_work_mb", status));
     if (!s->to_int("use_gpus", status))
         oskar_beam_pattern_set_gpus(h, 0, 0, status);
     else
@@ -98,14 +98,23 @@ oskar_Imager* oskar_settings_to_imager(oskar::SettingsTree* s,
     oskar_imager_set_weighting(h,
             s->to_string("weighting", status), status);
     if (s->starts_with("algorithm", "FFT", status) ||
-            s->starts_with("algorithm", "fft", status))
+            s->starts_with("algorithm", "fft", status) ||
+            s->starts_with("algorithm", "W-s", status))
     {
         oskar_imager_set_grid_kernel(h,
                 s->to_string("fft/kernel_type", status),
                 s->to_int("fft/support", status),
                 s->to_int("fft/oversample", status), status);
     }
-    if (!s->starts_with("wproj/num_w_planes", "auto", status))
+    if (s->starts_with("algorithm", "W-s", status))
+    {
+        if (!s->starts_with("wstack/num_w_layers", "auto", status))
+            oskar_imager_set_num_w_planes(h,
+                    s->to_int("wstack/num_w_layers", status));
+        oskar_imager_set_max_w_layers_in_memory(h,
+                s->to_int("wstack/max_w_layers_in_memory", status));
+    }
+    else if (!s->starts_with("wproj/num_w_planes", "auto", status))
         oskar_imager_set_num_w_planes(h,
                 s->to_int("wproj/num_w_planes", status));
     oskar_imager_set_fft_on_gpu(h, s->to_int("fft/use_gpu", status));
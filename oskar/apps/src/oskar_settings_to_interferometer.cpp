@@ -47,6 +47,9 @@ oskar_Interferometer* oskar_settings_to_interferometer(oskar::SettingsTree* s,
     oskar_interferometer_set_log(h, log);
     oskar_interferometer_set_max_sources_per_chunk(h,
             s->to_int("max_sources_per_chunk", status));
+    if (!s->starts_with("max_station_work_mb", "auto", status))
+        oskar_interferometer_set_max_station_work_mb(h,
+                s->to_int("max_station_work_mb", status));
     oskar_interferometer_set_settings_path(h, s->file_name());
     if (!s->to_int("use_gpus", status))
         oskar_interferometer_set_gpus(h, 0, 0, status);
@@ -62,6 +65,8 @@ oskar_Interferometer* oskar_settings_to_interferometer(oskar::SettingsTree* s,
                 oskar_interferometer_set_gpus(h, size, ids, status);
         }
     }
+    oskar_interferometer_set_num_threads_per_device(h,
+            s->to_int("num_cpu_threads_per_device", status));
     if (s->starts_with("num_devices", "auto", status))
         oskar_interferometer_set_num_devices(h, -1);
     else
@@ -102,6 +107,10 @@ oskar_Interferometer* oskar_settings_to_interferometer(oskar::SettingsTree* s,
             s->to_string("correlation_type", status), status);
     oskar_interferometer_set_max_times_per_block(h,
             s->to_int("max_time_samples_per_block", status));
+    oskar_interferometer_set_station_beam_cache_tolerance(h,
+            s->to_double("station_beam_cache_tolerance_deg", status));
+    oskar_interferometer_set_max_station_beam_cache_mb(h,
+            s->to_int("station_beam_cache_max_mb", status));
     oskar_interferometer_set_output_vis_file(h,
             s->to_string("oskar_vis_filename", status));
     oskar_interferometer_set_output_measurement_set(h,
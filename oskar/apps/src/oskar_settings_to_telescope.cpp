@@ -150,6 +150,29 @@ oskar_Telescope* oskar_settings_to_telescope(SettingsTree* s,
     for (int i = 0; i < num_stations; ++i)
         set_station_data(oskar_telescope_station(t, i), s, status);
 
+    /* Generate element pattern lookup tables if required. */
+    s->clear_group();
+    s->begin_group("telescope/aperture_array/element_pattern/lookup_table");
+    if (s->to_int("enable", status))
+    {
+        double max_err = 0.0, res_deg = s->to_double("resolution_deg", status);
+        if (res_deg <= 0.0)
+        {
+            *status = OSKAR_ERR_SETTINGS_TELESCOPE;
+            oskar_log_error(log, "Element pattern lookup table resolution "
+                    "must be positive.");
+            return t;
+        }
+        int num_theta = 1 + (int) ceil(180.0 / res_deg);
+        int num_phi = (int) ceil(360.0 / res_deg);
+        int interp = s->first_letter("interpolation", status) == 'L' ?
+                OSKAR_ELEMENT_TABLE_BILINEAR : OSKAR_ELEMENT_TABLE_BICUBIC;
+        oskar_telescope_tabulate_element_patterns(t, num_theta, num_phi,
+                interp, &max_err, status);
+        oskar_log_message(log, 'M', 0, "Element pattern lookup tables have "
+                "max. fractional error %.3e.", max_err);
+    }
+
     /* Apply element level overrides. */
     s->clear_group();
     s->begin_group("telescope/aperture_array/array_pattern/element");
@@ -248,6 +271,10 @@ void set_station_data(oskar_Station* station, SettingsTree* s, int* status)
             s->to_int("enable", status));
     oskar_station_set_normalise_array_pattern(station,
             s->to_int("normalise", status));
+    oskar_station_set_enable_array_fft(station,
+            s->to_int("fft/enable", status));
+    oskar_station_set_array_fft_tolerance(station,
+            s->to_double("fft/tolerance", status));
     oskar_station_set_seed_time_variable_errors(station,
             (unsigned int) s->to_int(
                     "element/seed_time_variable_errors", status));
@@ -258,6 +285,7 @@ void set_station_data(oskar_Station* station, SettingsTree* s, int* status)
     double dipole_length = s->to_double("dipole_length", status);
     char units = s->first_letter("dipole_length_units", status);
     char functional_type = s->first_letter("functional_type", status);
+    int interpolate_freq = s->to_int("interpolate_frequency", status);
     char taper_type = s->first_letter("taper/type", status);
     double cosine_power = s->to_double("taper/cosine_power", status);
     double fwhm_rad = s->to_double("taper/gaussian_fwhm_deg", status) * D2R;
@@ -269,6 +297,7 @@ void set_station_data(oskar_Station* station, SettingsTree* s, int* status)
         oskar_element_set_taper_type(element, &taper_type, status);
         oskar_element_set_cosine_power(element, cosine_power);
         oskar_element_set_gaussian_fwhm_rad(element, fwhm_rad);
+        oskar_element_set_interpolate_freq(element, interpolate_freq);
     }
 
     /* Recursively set data for child stations. */
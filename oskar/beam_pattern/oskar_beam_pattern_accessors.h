@@ -102,6 +102,10 @@ void oskar_beam_pattern_set_log(oskar_BeamPattern* h, oskar_Log* log);
 OSKAR_EXPORT
 void oskar_beam_pattern_set_max_chunk_size(oskar_BeamPattern* h, int value);
 
+OSKAR_EXPORT
+void oskar_beam_pattern_set_max_station_work_mb(oskar_BeamPattern* h,
+        int value);
+
 OSKAR_EXPORT
 void oskar_beam_pattern_set_num_devices(oskar_BeamPattern* h, int value);
 
@@ -87,7 +87,7 @@ struct oskar_BeamPattern
 {
     /* Settings. */
     int prec, num_devices, num_gpus, *gpu_ids;
-    int coord_type, max_chunk_size;
+    int coord_type, max_chunk_size, max_station_work_mb;
     int num_time_steps, num_channels, num_chunks;
     int pol_mode, width, height, num_pixels, nside;
     int num_active_stations, *station_ids;
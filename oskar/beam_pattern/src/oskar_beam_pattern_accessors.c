@@ -188,6 +188,13 @@ void oskar_beam_pattern_set_max_chunk_size(oskar_BeamPattern* h, int value)
 }
 
 
+void oskar_beam_pattern_set_max_station_work_mb(oskar_BeamPattern* h,
+        int value)
+{
+    h->max_station_work_mb = value;
+}
+
+
 void oskar_beam_pattern_set_num_devices(oskar_BeamPattern* h, int value)
 {
     int status = 0;
@@ -605,6 +605,8 @@ static void set_up_device_data(oskar_BeamPattern* h, int* status)
             d->tel  = oskar_telescope_create_copy(h->tel, dev_loc, status);
             d->work = oskar_station_work_create(h->prec, dev_loc, status);
         }
+        oskar_station_work_set_max_memory(d->work,
+                (size_t) h->max_station_work_mb * 1024 * 1024);
 
         /* Host memory. */
         if (!d->jones_data_cpu[0] && raw_data)
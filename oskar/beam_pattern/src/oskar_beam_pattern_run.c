@@ -300,6 +300,10 @@ static void sim_chunks(oskar_BeamPattern* h, int i_chunk_start, int i_time,
                 i_chunk * h->max_chunk_size, chunk_size, status);
     }
 
+    /* Generate element errors for this time, for reuse by all channels. */
+    oskar_station_work_evaluate_element_errors(d->work, d->tel, i_time, 1,
+            status);
+
     /* Generate beam for this pixel chunk, for all active stations. */
     input_alias  = oskar_mem_create_alias(0, 0, 0, status);
     output_alias = oskar_mem_create_alias(0, 0, 0, status);
@@ -928,6 +932,13 @@ static void record_timing(oskar_BeamPattern* h)
         oskar_log_value(h->log, 'M', 0, "Compute", "%.3f s [Device %i]",
                 oskar_timer_elapsed(h->d[i].tmr_compute), i);
     }
+    for (i = 0; i < h->num_devices; ++i)
+    {
+        if (h->d[i].work)
+            oskar_log_value(h->log, 'M', 0, "Station work memory",
+                    "%.1f MB peak [Device %i]", oskar_station_work_memory_peak(
+                    h->d[i].work) / (1024. * 1024.), i);
+    }
     oskar_log_value(h->log, 'M', 0, "Write", "%.3f s",
             oskar_timer_elapsed(h->tmr_write));
 }
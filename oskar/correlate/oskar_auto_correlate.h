@@ -50,6 +50,9 @@ extern "C" {
  * The source brightness matrices are constructed from the Stokes parameters
  * in the supplied sky model.
  *
+ * If the Jones matrices are shared between all stations, the visibility is
+ * evaluated only once and added to every station.
+ *
  * @param[out] vis          Output visibilities.
  * @param[in]  n_sources    Number of sources to use.
  * @param[in]  J            Set of Jones matrices.
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OSKAR_CORRELATE_FUSED_H_
+#define OSKAR_CORRELATE_FUSED_H_
+
+/**
+ * @file oskar_correlate_fused.h
+ */
+
+#include <oskar_global.h>
+#include <telescope/oskar_telescope.h>
+#include <interferometer/oskar_jones.h>
+#include <sky/oskar_sky.h>
+#include <mem/oskar_mem.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Forms visibilities from station beams, evaluating the
+ * interferometer phase on the fly.
+ *
+ * @details
+ * This is equivalent to evaluating Jones K, joining it with the station
+ * beams (and parallactic angle rotation, if supplied) to form Jones J, and
+ * then calling oskar_auto_correlate() and oskar_cross_correlate() with J,
+ * except that J and K are never stored in full.
+ *
+ * Sources with Stokes I outside the range (\p source_min_jy,
+ * \p source_max_jy] are excluded, as in oskar_evaluate_jones_K().
+ *
+ * The station beams may be shared between all stations.
+ * Either of \p vis_cross or \p vis_auto may be NULL if not required.
+ *
+ * This function is only available for data in CPU memory.
+ *
+ * @param[in,out] vis_cross  Cross-correlations to add to, or NULL.
+ * @param[in,out] vis_auto   Auto-correlations to add to, or NULL.
+ * @param[in]  n_sources     Number of sources to use.
+ * @param[in]  E             Station beam Jones matrices.
+ * @param[in]  R             Parallactic angle Jones matrices, or NULL.
+ * @param[in]  sky           Sky model.
+ * @param[in]  tel           Telescope model.
+ * @param[in]  u             Station u coordinates, in metres.
+ * @param[in]  v             Station v coordinates, in metres.
+ * @param[in]  w             Station w coordinates, in metres.
+ * @param[in]  gast          Greenwich apparent sidereal time, in radians.
+ * @param[in]  frequency_hz  Current observation frequency, in Hz.
+ * @param[in]  source_min_jy Minimum source flux density, in Jy.
+ * @param[in]  source_max_jy Maximum source flux density, in Jy.
+ * @param[in,out] status     Status return code.
+ */
+OSKAR_EXPORT
+void oskar_correlate_fused(oskar_Mem* vis_cross, oskar_Mem* vis_auto,
+        int n_sources, const oskar_Jones* E, const oskar_Jones* R,
+        const oskar_Sky* sky, const oskar_Telescope* tel, const oskar_Mem* u,
+        const oskar_Mem* v, const oskar_Mem* w, double gast,
+        double frequency_hz, double source_min_jy, double source_max_jy,
+        int* status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OSKAR_CORRELATE_FUSED_H_ */
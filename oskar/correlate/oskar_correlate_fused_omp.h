@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OSKAR_CORRELATE_FUSED_OMP_H_
+#define OSKAR_CORRELATE_FUSED_OMP_H_
+
+/**
+ * @file oskar_correlate_fused_omp.h
+ */
+
+#include <oskar_global.h>
+#include <utility/oskar_vector_types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief
+ * CPU correlate function that forms the interferometer phase on the fly
+ * (single precision).
+ *
+ * @details
+ * Forms cross- and/or auto-correlations from the station beam (Jones E)
+ * and, optionally, the parallactic angle rotation (Jones R), without
+ * requiring the combined Jones matrices to be stored.
+ *
+ * The interferometer phase (Jones K) and the source flux filter are applied
+ * to each station's Jones matrices as the source tiles used by the
+ * cross-correlator are filled, so that the combined Jones matrices of each
+ * station are only ever held for one tile of sources at a time.
+ *
+ * Either of \p vis_cross or \p vis_auto may be NULL if that output is not
+ * required.
+ *
+ * @param[in] num_sources    Number of sources.
+ * @param[in] num_stations   Number of stations.
+ * @param[in] jones_E        Station beam Jones matrices.
+ * @param[in] shared_E       If set, \p jones_E holds one station for all.
+ * @param[in] jones_R        Parallactic angle Jones matrices, or NULL.
+ * @param[in] source_filter  Source flux values to filter on, or NULL.
+ * @param[in] filter_min     Flux must be greater than this to be used.
+ * @param[in] filter_max     Flux must be less or equal to this to be used.
+ * @param[in] source_I       Source Stokes I values, in Jy.
+ * @param[in] source_Q       Source Stokes Q values, in Jy.
+ * @param[in] source_U       Source Stokes U values, in Jy.
+ * @param[in] source_V       Source Stokes V values, in Jy.
+ * @param[in] source_l       Source l-direction cosines from phase centre.
+ * @param[in] source_m       Source m-direction cosines from phase centre.
+ * @param[in] source_n       Source n-direction cosines from phase centre.
+ * @param[in] source_a       Source Gaussian parameter a, or NULL.
+ * @param[in] source_b       Source Gaussian parameter b, or NULL.
+ * @param[in] source_c       Source Gaussian parameter c, or NULL.
+ * @param[in] station_u      Station u-coordinates, in metres.
+ * @param[in] station_v      Station v-coordinates, in metres.
+ * @param[in] station_w      Station w-coordinates, in metres.
+ * @param[in] station_x      Station x-coordinates, in metres, or NULL.
+ * @param[in] station_y      Station y-coordinates, in metres, or NULL.
+ * @param[in] uv_min_lambda  Minimum allowed UV length, in wavelengths.
+ * @param[in] uv_max_lambda  Maximum allowed UV length, in wavelengths.
+ * @param[in] inv_wavelength Inverse of the wavelength, in metres.
+ * @param[in] frac_bandwidth Bandwidth divided by frequency.
+ * @param[in] time_int_sec   Time averaging interval, in seconds.
+ * @param[in] gha0_rad       Greenwich Hour Angle of phase centre, in radians.
+ * @param[in] dec0_rad       Declination of phase centre, in radians.
+ * @param[in,out] vis_cross  Modified cross-correlations, or NULL.
+ * @param[in,out] vis_auto   Modified auto-correlations, or NULL.
+ * @param[in,out] status     Status return code.
+ */
+OSKAR_EXPORT
+void oskar_correlate_fused_omp_f(int num_sources, int num_stations,
+        const float4c* jones_E, int shared_E, const float4c* jones_R,
+        const float* source_filter, float filter_min, float filter_max,
+        const float* source_I, const float* source_Q,
+        const float* source_U, const float* source_V, const float* source_l,
+        const float* source_m, const float* source_n, const float* source_a,
+        const float* source_b, const float* source_c, const float* station_u,
+        const float* station_v, const float* station_w,
+        const float* station_x, const float* station_y, float uv_min_lambda,
+        float uv_max_lambda, float inv_wavelength, float frac_bandwidth,
+        float time_int_sec, float gha0_rad, float dec0_rad,
+        float4c* vis_cross, float4c* vis_auto, int* status);
+
+/**
+ * @brief
+ * CPU correlate function that forms the interferometer phase on the fly
+ * (double precision).
+ *
+ * @details
+ * See oskar_correlate_fused_omp_f().
+ */
+OSKAR_EXPORT
+void oskar_correlate_fused_omp_d(int num_sources, int num_stations,
+        const double4c* jones_E, int shared_E, const double4c* jones_R,
+        const double* source_filter, double filter_min, double filter_max,
+        const double* source_I, const double* source_Q,
+        const double* source_U, const double* source_V,
+        const double* source_l, const double* source_m,
+        const double* source_n, const double* source_a,
+        const double* source_b, const double* source_c,
+        const double* station_u, const double* station_v,
+        const double* station_w, const double* station_x,
+        const double* station_y, double uv_min_lambda, double uv_max_lambda,
+        double inv_wavelength, double frac_bandwidth, double time_int_sec,
+        double gha0_rad, double dec0_rad, double4c* vis_cross,
+        double4c* vis_auto, int* status);
+
+/**
+ * @brief
+ * CPU correlate function that forms the interferometer phase on the fly
+ * (scalar version, single precision).
+ *
+ * @details
+ * As oskar_correlate_fused_omp_f(), but for scalar Jones terms and
+ * Stokes I only. There is no parallactic angle rotation in this case.
+ */
+OSKAR_EXPORT
+void oskar_correlate_fused_scalar_omp_f(int num_sources, int num_stations,
+        const float2* jones_E, int shared_E, const float* source_filter,
+        float filter_min, float filter_max, const float* source_I,
+        const float* source_l, const float* source_m, const float* source_n,
+        const float* source_a, const float* source_b, const float* source_c,
+        const float* station_u, const float* station_v,
+        const float* station_w, const float* station_x,
+        const float* station_y, float uv_min_lambda, float uv_max_lambda,
+        float inv_wavelength, float frac_bandwidth, float time_int_sec,
+        float gha0_rad, float dec0_rad, float2* vis_cross, float2* vis_auto,
+        int* status);
+
+/**
+ * @brief
+ * CPU correlate function that forms the interferometer phase on the fly
+ * (scalar version, double precision).
+ *
+ * @details
+ * See oskar_correlate_fused_scalar_omp_f().
+ */
+OSKAR_EXPORT
+void oskar_correlate_fused_scalar_omp_d(int num_sources, int num_stations,
+        const double2* jones_E, int shared_E, const double* source_filter,
+        double filter_min, double filter_max, const double* source_I,
+        const double* source_l, const double* source_m,
+        const double* source_n, const double* source_a,
+        const double* source_b, const double* source_c,
+        const double* station_u, const double* station_v,
+        const double* station_w, const double* station_x,
+        const double* station_y, double uv_min_lambda, double uv_max_lambda,
+        double inv_wavelength, double frac_bandwidth, double time_int_sec,
+        double gha0_rad, double dec0_rad, double2* vis_cross,
+        double2* vis_auto, int* status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OSKAR_CORRELATE_FUSED_OMP_H_ */
@@ -53,6 +53,7 @@ extern "C" {
  *
  * The Jones matrices should have dimensions corresponding to the number of
  * sources in the brightness matrix and the number of stations.
+ * Jones matrices shared between all stations are not accepted.
  *
  * @param[out] vis          Output visibility amplitudes.
  * @param[in]  n_sources    Number of sources to use.
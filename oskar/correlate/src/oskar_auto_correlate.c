@@ -43,13 +43,17 @@ extern "C" {
 void oskar_auto_correlate(oskar_Mem* vis, int n_sources, const oskar_Jones* J,
         const oskar_Sky* sky, int* status)
 {
-    int jones_type, base_type, location, matrix_type, n_stations;
+    int i, jones_type, base_type, location, matrix_type, n_stations;
+    int n_stations_eval;
+    oskar_Mem *vis0 = 0, *vis_st = 0, *vis0_prev = 0;
 
     /* Check if safe to proceed. */
     if (*status) return;
 
-    /* Get the data dimensions. */
+    /* Get the data dimensions.
+     * If the Jones matrices are shared, evaluate only the first station. */
     n_stations = oskar_jones_num_stations(J);
+    n_stations_eval = oskar_jones_shared_stations(J) ? 1 : n_stations;
 
     /* Check data locations. */
     location = oskar_sky_mem_location(sky);
@@ -91,6 +95,17 @@ void oskar_auto_correlate(oskar_Mem* vis, int n_sources, const oskar_Jones* J,
         return;
     }
 
+    /* If the Jones matrices are shared, the visibility for the first station
+     * is accumulated from zero, and added to all stations afterwards. */
+    if (n_stations_eval < n_stations)
+    {
+        vis0 = oskar_mem_create_alias(vis, 0, 1, status);
+        vis_st = oskar_mem_create_alias(0, 0, 0, status);
+        vis0_prev = oskar_mem_create(oskar_mem_type(vis), location, 1, status);
+        oskar_mem_copy_contents(vis0_prev, vis0, 0, 0, 1, status);
+        oskar_mem_clear_contents(vis0, status);
+    }
+
     /* Select kernel. */
     if (base_type == OSKAR_DOUBLE)
     {
@@ -110,7 +125,7 @@ void oskar_auto_correlate(oskar_Mem* vis, int n_sources, const oskar_Jones* J,
             if (location == OSKAR_GPU)
             {
 #ifdef OSKAR_HAVE_CUDA
-                oskar_auto_correlate_cuda_d(n_sources, n_stations,
+                oskar_auto_correlate_cuda_d(n_sources, n_stations_eval,
                         J_, I_, Q_, U_, V_, vis_);
                 oskar_device_check_error(status);
 #else
@@ -119,7 +134,7 @@ void oskar_auto_correlate(oskar_Mem* vis, int n_sources, const oskar_Jones* J,
             }
             else /* CPU */
             {
-                oskar_auto_correlate_omp_d(n_sources, n_stations,
+                oskar_auto_correlate_omp_d(n_sources, n_stations_eval,
                         J_, I_, Q_, U_, V_, vis_);
             }
         }
@@ -133,7 +148,7 @@ void oskar_auto_correlate(oskar_Mem* vis, int n_sources, const oskar_Jones* J,
             if (location == OSKAR_GPU)
             {
 #ifdef OSKAR_HAVE_CUDA
-                oskar_auto_correlate_scalar_cuda_d(n_sources, n_stations,
+                oskar_auto_correlate_scalar_cuda_d(n_sources, n_stations_eval,
                         J_, I_, vis_);
                 oskar_device_check_error(status);
 #else
@@ -142,7 +157,7 @@ void oskar_auto_correlate(oskar_Mem* vis, int n_sources, const oskar_Jones* J,
             }
             else /* CPU */
             {
-                oskar_auto_correlate_scalar_omp_d(n_sources, n_stations,
+                oskar_auto_correlate_scalar_omp_d(n_sources, n_stations_eval,
                         J_, I_, vis_);
             }
         }
@@ -165,7 +180,7 @@ void oskar_auto_correlate(oskar_Mem* vis, int n_sources, const oskar_Jones* J,
             if (location == OSKAR_GPU)
             {
 #ifdef OSKAR_HAVE_CUDA
-                oskar_auto_correlate_cuda_f(n_sources, n_stations,
+                oskar_auto_correlate_cuda_f(n_sources, n_stations_eval,
                         J_, I_, Q_, U_, V_, vis_);
                 oskar_device_check_error(status);
 #else
@@ -174,7 +189,7 @@ void oskar_auto_correlate(oskar_Mem* vis, int n_sources, const oskar_Jones* J,
             }
             else /* CPU */
             {
-                oskar_auto_correlate_omp_f(n_sources, n_stations,
+                oskar_auto_correlate_omp_f(n_sources, n_stations_eval,
                         J_, I_, Q_, U_, V_, vis_);
             }
         }
@@ -188,7 +203,7 @@ void oskar_auto_correlate(oskar_Mem* vis, int n_sources, const oskar_Jones* J,
             if (location == OSKAR_GPU)
             {
 #ifdef OSKAR_HAVE_CUDA
-                oskar_auto_correlate_scalar_cuda_f(n_sources, n_stations,
+                oskar_auto_correlate_scalar_cuda_f(n_sources, n_stations_eval,
                         J_, I_, vis_);
                 oskar_device_check_error(status);
 #else
@@ -197,11 +212,25 @@ void oskar_auto_correlate(oskar_Mem* vis, int n_sources, const oskar_Jones* J,
             }
             else /* CPU */
             {
-                oskar_auto_correlate_scalar_omp_f(n_sources, n_stations,
+                oskar_auto_correlate_scalar_omp_f(n_sources, n_stations_eval,
                         J_, I_, vis_);
             }
         }
     }
+
+    /* Add the result for the first station to the others. */
+    if (vis0)
+    {
+        for (i = 1; i < n_stations; ++i)
+        {
+            oskar_mem_set_alias(vis_st, vis, i, 1, status);
+            oskar_mem_add(vis_st, vis_st, vis0, 1, status);
+        }
+        oskar_mem_add(vis0, vis0, vis0_prev, 1, status);
+        oskar_mem_free(vis0, status);
+        oskar_mem_free(vis_st, status);
+        oskar_mem_free(vis0_prev, status);
+    }
 }
 
 #ifdef __cplusplus
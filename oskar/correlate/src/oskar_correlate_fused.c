@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "correlate/oskar_correlate_fused.h"
+#include "correlate/oskar_correlate_fused_omp.h"
+
+#include <float.h>
+#include <math.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void oskar_correlate_fused(oskar_Mem* vis_cross, oskar_Mem* vis_auto,
+        int n_sources, const oskar_Jones* E, const oskar_Jones* R,
+        const oskar_Sky* sky, const oskar_Telescope* tel, const oskar_Mem* u,
+        const oskar_Mem* v, const oskar_Mem* w, double gast,
+        double frequency_hz, double source_min_jy, double source_max_jy,
+        int* status)
+{
+    int jones_type, base_type, location, matrix_type, n_stations;
+    int use_extended, use_filter, shared_E;
+    double inv_wavelength, frac_bandwidth, time_avg, gha0, dec0;
+    double uv_filter_max, uv_filter_min;
+
+    /* Check if safe to proceed. */
+    if (*status) return;
+    if (!vis_cross && !vis_auto) return;
+
+    /* Get the data dimensions. */
+    n_stations = oskar_telescope_num_stations(tel);
+    use_extended = oskar_sky_use_extended(sky);
+    use_filter = (source_min_jy > -DBL_MAX || source_max_jy < DBL_MAX);
+    shared_E = oskar_jones_shared_stations(E);
+
+    /* Get bandwidth-smearing terms. */
+    frequency_hz = fabs(frequency_hz);
+    inv_wavelength = frequency_hz / 299792458.0;
+    frac_bandwidth = oskar_telescope_channel_bandwidth_hz(tel) / frequency_hz;
+
+    /* Get time-average smearing term and Greenwich hour angle. */
+    time_avg = oskar_telescope_time_average_sec(tel);
+    gha0 = gast - oskar_telescope_phase_centre_ra_rad(tel);
+    dec0 = oskar_telescope_phase_centre_dec_rad(tel);
+
+    /* Get UV filter parameters in wavelengths. */
+    uv_filter_min = oskar_telescope_uv_filter_min(tel);
+    uv_filter_max = oskar_telescope_uv_filter_max(tel);
+    if (oskar_telescope_uv_filter_units(tel) == OSKAR_METRES)
+    {
+        uv_filter_min *= inv_wavelength;
+        uv_filter_max *= inv_wavelength;
+    }
+    if (uv_filter_max < 0.0 || uv_filter_max > FLT_MAX)
+        uv_filter_max = FLT_MAX;
+
+    /* Check data locations. Only CPU memory is supported. */
+    location = oskar_sky_mem_location(sky);
+    if (oskar_telescope_mem_location(tel) != location ||
+            oskar_jones_mem_location(E) != location ||
+            (R && oskar_jones_mem_location(R) != location) ||
+            (vis_cross && oskar_mem_location(vis_cross) != location) ||
+            (vis_auto && oskar_mem_location(vis_auto) != location) ||
+            oskar_mem_location(u) != location ||
+            oskar_mem_location(v) != location ||
+            oskar_mem_location(w) != location)
+    {
+        *status = OSKAR_ERR_LOCATION_MISMATCH;
+        return;
+    }
+    if (location != OSKAR_CPU)
+    {
+        *status = OSKAR_ERR_BAD_LOCATION;
+        return;
+    }
+
+    /* Check for consistent data types. */
+    jones_type = oskar_jones_type(E);
+    base_type = oskar_sky_precision(sky);
+    matrix_type = oskar_type_is_matrix(jones_type);
+    if (oskar_type_precision(jones_type) != base_type ||
+            (R && oskar_jones_type(R) != jones_type) ||
+            (vis_cross && oskar_mem_type(vis_cross) != jones_type) ||
+            (vis_auto && oskar_mem_type(vis_auto) != jones_type) ||
+            oskar_mem_type(u) != base_type || oskar_mem_type(v) != base_type ||
+            oskar_mem_type(w) != base_type)
+    {
+        *status = OSKAR_ERR_TYPE_MISMATCH;
+        return;
+    }
+
+    /* If neither single or double precision, return error. */
+    if (base_type != OSKAR_SINGLE && base_type != OSKAR_DOUBLE)
+    {
+        *status = OSKAR_ERR_BAD_DATA_TYPE;
+        return;
+    }
+
+    /* Check the input dimensions. */
+    if (oskar_jones_num_sources(E) < n_sources ||
+            (!shared_E && oskar_jones_num_stations(E) != n_stations) ||
+            (R && (oskar_jones_num_sources(R) < n_sources ||
+                    oskar_jones_num_stations(R) != n_stations ||
+                    oskar_jones_shared_stations(R))) ||
+            (R && !matrix_type) ||
+            (int)oskar_mem_length(u) != n_stations ||
+            (int)oskar_mem_length(v) != n_stations ||
+            (int)oskar_mem_length(w) != n_stations)
+    {
+        *status = OSKAR_ERR_DIMENSION_MISMATCH;
+        return;
+    }
+
+    /* Check there is enough space for the results. */
+    if ((vis_cross && (int)oskar_mem_length(vis_cross) <
+            oskar_telescope_num_baselines(tel)) ||
+            (vis_auto && (int)oskar_mem_length(vis_auto) < n_stations))
+    {
+        *status = OSKAR_ERR_DIMENSION_MISMATCH;
+        return;
+    }
+
+    /* Select kernel. */
+    if (base_type == OSKAR_DOUBLE)
+    {
+        const double *I_, *Q_, *U_, *V_, *l_, *m_, *n_, *a_, *b_, *c_;
+        const double *u_, *v_, *w_, *x_, *y_, *f_;
+        I_ = oskar_mem_double_const(oskar_sky_I_const(sky), status);
+        Q_ = oskar_mem_double_const(oskar_sky_Q_const(sky), status);
+        U_ = oskar_mem_double_const(oskar_sky_U_const(sky), status);
+        V_ = oskar_mem_double_const(oskar_sky_V_const(sky), status);
+        l_ = oskar_mem_double_const(oskar_sky_l_const(sky), status);
+        m_ = oskar_mem_double_const(oskar_sky_m_const(sky), status);
+        n_ = oskar_mem_double_const(oskar_sky_n_const(sky), status);
+        a_ = oskar_mem_double_const(oskar_sky_gaussian_a_const(sky), status);
+        b_ = oskar_mem_double_const(oskar_sky_gaussian_b_const(sky), status);
+        c_ = oskar_mem_double_const(oskar_sky_gaussian_c_const(sky), status);
+        u_ = oskar_mem_double_const(u, status);
+        v_ = oskar_mem_double_const(v, status);
+        w_ = oskar_mem_double_const(w, status);
+        x_ = oskar_mem_double_const(
+                oskar_telescope_station_true_x_offset_ecef_metres_const(tel),
+                status);
+        y_ = oskar_mem_double_const(
+                oskar_telescope_station_true_y_offset_ecef_metres_const(tel),
+                status);
+        f_ = use_filter ? I_ : 0;
+
+        if (matrix_type)
+        {
+            oskar_correlate_fused_omp_d(n_sources, n_stations,
+                    oskar_jones_double4c_const(E, status), shared_E,
+                    R ? oskar_jones_double4c_const(R, status) : 0,
+                    f_, source_min_jy, source_max_jy,
+                    I_, Q_, U_, V_, l_, m_, n_,
+                    use_extended ? a_ : 0, use_extended ? b_ : 0,
+                    use_extended ? c_ : 0, u_, v_, w_, x_, y_,
+                    uv_filter_min, uv_filter_max, inv_wavelength,
+                    frac_bandwidth, time_avg, gha0, dec0,
+                    vis_cross ? oskar_mem_double4c(vis_cross, status) : 0,
+                    vis_auto ? oskar_mem_double4c(vis_auto, status) : 0,
+                    status);
+        }
+        else /* Scalar version. */
+        {
+            oskar_correlate_fused_scalar_omp_d(n_sources, n_stations,
+                    oskar_jones_double2_const(E, status), shared_E,
+                    f_, source_min_jy, source_max_jy, I_, l_, m_, n_,
+                    use_extended ? a_ : 0, use_extended ? b_ : 0,
+                    use_extended ? c_ : 0, u_, v_, w_, x_, y_,
+                    uv_filter_min, uv_filter_max, inv_wavelength,
+                    frac_bandwidth, time_avg, gha0, dec0,
+                    vis_cross ? oskar_mem_double2(vis_cross, status) : 0,
+                    vis_auto ? oskar_mem_double2(vis_auto, status) : 0,
+                    status);
+        }
+    }
+    else /* Single precision. */
+    {
+        const float *I_, *Q_, *U_, *V_, *l_, *m_, *n_, *a_, *b_, *c_;
+        const float *u_, *v_, *w_, *x_, *y_, *f_;
+        float filter_min, filter_max;
+        I_ = oskar_mem_float_const(oskar_sky_I_const(sky), status);
+        Q_ = oskar_mem_float_const(oskar_sky_Q_const(sky), status);
+        U_ = oskar_mem_float_const(oskar_sky_U_const(sky), status);
+        V_ = oskar_mem_float_const(oskar_sky_V_const(sky), status);
+        l_ = oskar_mem_float_const(oskar_sky_l_const(sky), status);
+        m_ = oskar_mem_float_const(oskar_sky_m_const(sky), status);
+        n_ = oskar_mem_float_const(oskar_sky_n_const(sky), status);
+        a_ = oskar_mem_float_const(oskar_sky_gaussian_a_const(sky), status);
+        b_ = oskar_mem_float_const(oskar_sky_gaussian_b_const(sky), status);
+        c_ = oskar_mem_float_const(oskar_sky_gaussian_c_const(sky), status);
+        u_ = oskar_mem_float_const(u, status);
+        v_ = oskar_mem_float_const(v, status);
+        w_ = oskar_mem_float_const(w, status);
+        x_ = oskar_mem_float_const(
+                oskar_telescope_station_true_x_offset_ecef_metres_const(tel),
+                status);
+        y_ = oskar_mem_float_const(
+                oskar_telescope_station_true_y_offset_ecef_metres_const(tel),
+                status);
+        f_ = use_filter ? I_ : 0;
+
+        /* Clamp the filter range to values representable in single
+         * precision. */
+        filter_min = (float) (source_min_jy < -FLT_MAX ? -FLT_MAX :
+                (source_min_jy > FLT_MAX ? FLT_MAX : source_min_jy));
+        filter_max = (float) (source_max_jy > FLT_MAX ? FLT_MAX :
+                (source_max_jy < -FLT_MAX ? -FLT_MAX : source_max_jy));
+
+        if (matrix_type)
+        {
+            oskar_correlate_fused_omp_f(n_sources, n_stations,
+                    oskar_jones_float4c_const(E, status), shared_E,
+                    R ? oskar_jones_float4c_const(R, status) : 0,
+                    f_, filter_min, filter_max,
+                    I_, Q_, U_, V_, l_, m_, n_,
+                    use_extended ? a_ : 0, use_extended ? b_ : 0,
+                    use_extended ? c_ : 0, u_, v_, w_, x_, y_,
+                    uv_filter_min, uv_filter_max, inv_wavelength,
+                    frac_bandwidth, time_avg, gha0, dec0,
+                    vis_cross ? oskar_mem_float4c(vis_cross, status) : 0,
+                    vis_auto ? oskar_mem_float4c(vis_auto, status) : 0,
+                    status);
+        }
+        else /* Scalar version. */
+        {
+            oskar_correlate_fused_scalar_omp_f(n_sources, n_stations,
+                    oskar_jones_float2_const(E, status), shared_E,
+                    f_, filter_min, filter_max, I_, l_, m_, n_,
+                    use_extended ? a_ : 0, use_extended ? b_ : 0,
+                    use_extended ? c_ : 0, u_, v_, w_, x_, y_,
+                    uv_filter_min, uv_filter_max, inv_wavelength,
+                    frac_bandwidth, time_avg, gha0, dec0,
+                    vis_cross ? oskar_mem_float2(vis_cross, status) : 0,
+                    vis_auto ? oskar_mem_float2(vis_auto, status) : 0,
+                    status);
+        }
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -28,21 +28,14 @@
 
 #include "correlate/oskar_cross_correlate.h"
 #include "correlate/oskar_cross_correlate_gaussian_cuda.h"
-#include "correlate/oskar_cross_correlate_gaussian_omp.h"
 #include "correlate/oskar_cross_correlate_gaussian_time_smearing_cuda.h"
-#include "correlate/oskar_cross_correlate_gaussian_time_smearing_omp.h"
 #include "correlate/oskar_cross_correlate_point_cuda.h"
-#include "correlate/oskar_cross_correlate_point_omp.h"
 #include "correlate/oskar_cross_correlate_point_time_smearing_cuda.h"
-#include "correlate/oskar_cross_correlate_point_time_smearing_omp.h"
 #include "correlate/oskar_cross_correlate_gaussian_scalar_cuda.h"
-#include "correlate/oskar_cross_correlate_gaussian_scalar_omp.h"
 #include "correlate/oskar_cross_correlate_gaussian_time_smearing_scalar_cuda.h"
-#include "correlate/oskar_cross_correlate_gaussian_time_smearing_scalar_omp.h"
 #include "correlate/oskar_cross_correlate_point_scalar_cuda.h"
-#include "correlate/oskar_cross_correlate_point_scalar_omp.h"
 #include "correlate/oskar_cross_correlate_point_time_smearing_scalar_cuda.h"
-#include "correlate/oskar_cross_correlate_point_time_smearing_scalar_omp.h"
+#include "correlate/oskar_cross_correlate_omp.h"
 #include "utility/oskar_device_utils.h"
 
 #include <float.h>
@@ -129,8 +122,10 @@ void oskar_cross_correlate(oskar_Mem* vis, int n_sources, const oskar_Jones* J,
         return;
     }
 
-    /* Check the input dimensions. */
+    /* Check the input dimensions.
+     * Jones matrices must be present for every station. */
     if (oskar_jones_num_sources(J) < n_sources ||
+            oskar_jones_shared_stations(J) ||
             (int)oskar_mem_length(u) != n_stations ||
             (int)oskar_mem_length(v) != n_stations ||
             (int)oskar_mem_length(w) != n_stations)
@@ -225,43 +220,13 @@ void oskar_cross_correlate(oskar_Mem* vis, int n_sources, const oskar_Jones* J,
             }
             else /* CPU */
             {
-                if (time_avg > 0.0)
-                {
-                    if (use_extended)
-                    {
-                        oskar_cross_correlate_gaussian_time_smearing_omp_d
-                        (n_sources, n_stations, J_, I_, Q_, U_, V_, l_, m_, n_,
-                                a_, b_, c_, u_, v_, w_, x_, y_, uv_filter_min,
-                                uv_filter_max, inv_wavelength, frac_bandwidth,
-                                time_avg, gha0, dec0, vis_);
-                    }
-                    else
-                    {
-                        oskar_cross_correlate_point_time_smearing_omp_d
-                        (n_sources, n_stations, J_, I_, Q_, U_, V_, l_, m_, n_,
-                                u_, v_, w_, x_, y_, uv_filter_min,
-                                uv_filter_max, inv_wavelength, frac_bandwidth,
-                                time_avg, gha0, dec0, vis_);
-                    }
-                }
-                else /* Non-time-smearing. */
-                {
-                    if (use_extended)
-                    {
-                        oskar_cross_correlate_gaussian_omp_d
-                        (n_sources, n_stations, J_, I_, Q_, U_, V_, l_, m_, n_,
-                                a_, b_, c_, u_, v_, w_, uv_filter_min,
-                                uv_filter_max, inv_wavelength, frac_bandwidth,
-                                vis_);
-                    }
-                    else
-                    {
-                        oskar_cross_correlate_point_omp_d
-                        (n_sources, n_stations, J_, I_, Q_, U_, V_, l_, m_, n_,
-                                u_, v_, w_, uv_filter_min, uv_filter_max,
-                                inv_wavelength, frac_bandwidth, vis_);
-                    }
-                }
+                oskar_cross_correlate_omp_d(n_sources, n_stations,
+                        J_, I_, Q_, U_, V_, l_, m_, n_,
+                        use_extended ? a_ : 0, use_extended ? b_ : 0,
+                        use_extended ? c_ : 0, u_, v_, w_, x_, y_,
+                        uv_filter_min, uv_filter_max, inv_wavelength,
+                        frac_bandwidth, time_avg, gha0, dec0, vis_,
+                        status);
             }
         }
         else /* Scalar version. */
@@ -318,43 +283,13 @@ void oskar_cross_correlate(oskar_Mem* vis, int n_sources, const oskar_Jones* J,
             }
             else /* CPU */
             {
-                if (time_avg > 0.0)
-                {
-                    if (use_extended)
-                    {
-                        oskar_cross_correlate_gaussian_time_smearing_scalar_omp_d
-                        (n_sources, n_stations, J_, I_, l_, m_, n_,
-                                a_, b_, c_, u_, v_, w_, x_, y_, uv_filter_min,
-                                uv_filter_max, inv_wavelength, frac_bandwidth,
-                                time_avg, gha0, dec0, vis_);
-                    }
-                    else
-                    {
-                        oskar_cross_correlate_point_time_smearing_scalar_omp_d
-                        (n_sources, n_stations, J_, I_, l_, m_, n_,
-                                u_, v_, w_, x_, y_, uv_filter_min,
-                                uv_filter_max, inv_wavelength, frac_bandwidth,
-                                time_avg, gha0, dec0, vis_);
-                    }
-                }
-                else /* Non-time-smearing. */
-                {
-                    if (use_extended)
-                    {
-                        oskar_cross_correlate_gaussian_scalar_omp_d
-                        (n_sources, n_stations, J_, I_, l_, m_, n_,
-                                a_, b_, c_, u_, v_, w_, uv_filter_min,
-                                uv_filter_max, inv_wavelength, frac_bandwidth,
-                                vis_);
-                    }
-                    else
-                    {
-                        oskar_cross_correlate_point_scalar_omp_d
-                        (n_sources, n_stations, J_, I_, l_, m_, n_,
-                                u_, v_, w_, uv_filter_min, uv_filter_max,
-                                inv_wavelength, frac_bandwidth, vis_);
-                    }
-                }
+                oskar_cross_correlate_scalar_omp_d(n_sources, n_stations,
+                        J_, I_, l_, m_, n_,
+                        use_extended ? a_ : 0, use_extended ? b_ : 0,
+                        use_extended ? c_ : 0, u_, v_, w_, x_, y_,
+                        uv_filter_min, uv_filter_max, inv_wavelength,
+                        frac_bandwidth, time_avg, gha0, dec0, vis_,
+                        status);
             }
         }
     }
@@ -436,43 +371,13 @@ void oskar_cross_correlate(oskar_Mem* vis, int n_sources, const oskar_Jones* J,
             }
             else /* CPU */
             {
-                if (time_avg > 0.0)
-                {
-                    if (use_extended)
-                    {
-                        oskar_cross_correlate_gaussian_time_smearing_omp_f
-                        (n_sources, n_stations, J_, I_, Q_, U_, V_, l_, m_, n_,
-                                a_, b_, c_, u_, v_, w_, x_, y_, uv_filter_min,
-                                uv_filter_max, inv_wavelength, frac_bandwidth,
-                                time_avg, gha0, dec0, vis_);
-                    }
-                    else
-                    {
-                        oskar_cross_correlate_point_time_smearing_omp_f
-                        (n_sources, n_stations, J_, I_, Q_, U_, V_, l_, m_, n_,
-                                u_, v_, w_, x_, y_, uv_filter_min,
-                                uv_filter_max, inv_wavelength, frac_bandwidth,
-                                time_avg, gha0, dec0, vis_);
-                    }
-                }
-                else /* Non-time-smearing. */
-                {
-                    if (use_extended)
-                    {
-                        oskar_cross_correlate_gaussian_omp_f
-                        (n_sources, n_stations, J_, I_, Q_, U_, V_, l_, m_, n_,
-                                a_, b_, c_, u_, v_, w_, uv_filter_min,
-                                uv_filter_max, inv_wavelength, frac_bandwidth,
-                                vis_);
-                    }
-                    else
-                    {
-                        oskar_cross_correlate_point_omp_f
-                        (n_sources, n_stations, J_, I_, Q_, U_, V_, l_, m_, n_,
-                                u_, v_, w_, uv_filter_min, uv_filter_max,
-                                inv_wavelength, frac_bandwidth, vis_);
-                    }
-                }
+                oskar_cross_correlate_omp_f(n_sources, n_stations,
+                        J_, I_, Q_, U_, V_, l_, m_, n_,
+                        use_extended ? a_ : 0, use_extended ? b_ : 0,
+                        use_extended ? c_ : 0, u_, v_, w_, x_, y_,
+                        uv_filter_min, uv_filter_max, inv_wavelength,
+                        frac_bandwidth, time_avg, gha0, dec0, vis_,
+                        status);
             }
         }
         else /* Scalar version. */
@@ -529,43 +434,13 @@ void oskar_cross_correlate(oskar_Mem* vis, int n_sources, const oskar_Jones* J,
             }
             else /* CPU */
             {
-                if (time_avg > 0.0)
-                {
-                    if (use_extended)
-                    {
-                        oskar_cross_correlate_gaussian_time_smearing_scalar_omp_f
-                        (n_sources, n_stations, J_, I_, l_, m_, n_,
-                                a_, b_, c_, u_, v_, w_, x_, y_, uv_filter_min,
-                                uv_filter_max, inv_wavelength,
-                                frac_bandwidth, time_avg, gha0, dec0, vis_);
-                    }
-                    else
-                    {
-                        oskar_cross_correlate_point_time_smearing_scalar_omp_f
-                        (n_sources, n_stations, J_, I_, l_, m_, n_,
-                                u_, v_, w_, x_, y_, uv_filter_min,
-                                uv_filter_max, inv_wavelength, frac_bandwidth,
-                                time_avg, gha0, dec0, vis_);
-                    }
-                }
-                else /* Non-time-smearing. */
-                {
-                    if (use_extended)
-                    {
-                        oskar_cross_correlate_gaussian_scalar_omp_f
-                        (n_sources, n_stations, J_, I_, l_, m_, n_,
-                                a_, b_, c_, u_, v_, w_, uv_filter_min,
-                                uv_filter_max, inv_wavelength, frac_bandwidth,
-                                vis_);
-                    }
-                    else
-                    {
-                        oskar_cross_correlate_point_scalar_omp_f
-                        (n_sources, n_stations, J_, I_, l_, m_, n_,
-                                u_, v_, w_, uv_filter_min, uv_filter_max,
-                                inv_wavelength, frac_bandwidth, vis_);
-                    }
-                }
+                oskar_cross_correlate_scalar_omp_f(n_sources, n_stations,
+                        J_, I_, l_, m_, n_,
+                        use_extended ? a_ : 0, use_extended ? b_ : 0,
+                        use_extended ? c_ : 0, u_, v_, w_, x_, y_,
+                        uv_filter_min, uv_filter_max, inv_wavelength,
+                        frac_bandwidth, time_avg, gha0, dec0, vis_,
+                        status);
             }
         }
     }
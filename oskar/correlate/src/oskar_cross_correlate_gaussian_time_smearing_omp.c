@@ -26,10 +26,8 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
-#include <math.h>
-#include "correlate/private_correlate_functions_inline.h"
+#include "correlate/oskar_cross_correlate_omp.h"
 #include "correlate/oskar_cross_correlate_gaussian_time_smearing_omp.h"
-#include "math/oskar_add_inline.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -47,76 +45,12 @@ void oskar_cross_correlate_gaussian_time_smearing_omp_f(int num_sources,
         float inv_wavelength, float frac_bandwidth, float time_int_sec,
         float gha0_rad, float dec0_rad, float4c* vis)
 {
-    int SQ;
-
-    /* Loop over stations. */
-#pragma omp parallel for private(SQ) schedule(dynamic, 1)
-    for (SQ = 0; SQ < num_stations; ++SQ)
-    {
-        int SP, i;
-        const float4c *station_p, *station_q;
-
-        /* Pointer to source vector for station q. */
-        station_q = &jones[SQ * num_sources];
-
-        /* Loop over baselines for this station. */
-        for (SP = SQ + 1; SP < num_stations; ++SP)
-        {
-            float uv_len, uu, vv, ww, uu2, vv2, uuvv, du, dv, dw;
-            float4c sum, guard;
-            oskar_clear_complex_matrix_f(&sum);
-            oskar_clear_complex_matrix_f(&guard);
-
-            /* Pointer to source vector for station p. */
-            station_p = &jones[SP * num_sources];
-
-            /* Get common baseline values. */
-            oskar_evaluate_baseline_terms_inline_f(station_u[SP],
-                    station_u[SQ], station_v[SP], station_v[SQ],
-                    station_w[SP], station_w[SQ], inv_wavelength,
-                    frac_bandwidth, &uv_len, &uu, &vv, &ww, &uu2, &vv2, &uuvv);
-
-            /* Apply the baseline length filter. */
-            if (uv_len < uv_min_lambda || uv_len > uv_max_lambda)
-                continue;
-
-            /* Compute the deltas for time-average smearing. */
-            oskar_evaluate_baseline_deltas_inline_f(station_x[SP],
-                    station_x[SQ], station_y[SP], station_y[SQ],
-                    inv_wavelength, time_int_sec, gha0_rad, dec0_rad,
-                    &du, &dv, &dw);
-
-            /* Loop over sources. */
-            for (i = 0; i < num_sources; ++i)
-            {
-                float l, m, n, r1, r2;
-
-                /* Get source direction cosines. */
-                l = source_l[i];
-                m = source_m[i];
-                n = source_n[i];
-
-                /* Compute bandwidth- and time-smearing terms. */
-                r1 = oskar_sinc_f(uu * l + vv * m + ww * (n - 1.0f));
-                r2 = oskar_evaluate_time_smearing_f(du, dv, dw, l, m, n);
-                r1 *= r2;
-
-                /* Evaluate Gaussian source width term. */
-                r2 = expf(-(source_a[i] * uu2 + source_b[i] * uuvv +
-                        source_c[i] * vv2));
-                r1 *= r2;
-
-                /* Accumulate baseline visibility response for source. */
-                oskar_accumulate_baseline_visibility_for_source_inline_f(&sum,
-                        i, source_I, source_Q, source_U, source_V,
-                        station_p, station_q, r1, &guard);
-            }
-
-            /* Add result to the baseline visibility. */
-            i = oskar_evaluate_baseline_index_inline(num_stations, SP, SQ);
-            oskar_add_complex_matrix_in_place_f(&vis[i], &sum);
-        }
-    }
+    int status = 0;
+    oskar_cross_correlate_omp_f(num_sources, num_stations, jones, source_I,
+            source_Q, source_U, source_V, source_l, source_m, source_n,
+            source_a, source_b, source_c, station_u, station_v, station_w,
+            station_x, station_y, uv_min_lambda, uv_max_lambda, inv_wavelength,
+            frac_bandwidth, time_int_sec, gha0_rad, dec0_rad, vis, &status);
 }
 
 /* Double precision. */
@@ -131,75 +65,12 @@ void oskar_cross_correlate_gaussian_time_smearing_omp_d(int num_sources,
         double inv_wavelength, double frac_bandwidth, double time_int_sec,
         double gha0_rad, double dec0_rad, double4c* vis)
 {
-    int SQ;
-
-    /* Loop over stations. */
-#pragma omp parallel for private(SQ) schedule(dynamic, 1)
-    for (SQ = 0; SQ < num_stations; ++SQ)
-    {
-        int SP, i;
-        const double4c *station_p, *station_q;
-
-        /* Pointer to source vector for station q. */
-        station_q = &jones[SQ * num_sources];
-
-        /* Loop over baselines for this station. */
-        for (SP = SQ + 1; SP < num_stations; ++SP)
-        {
-            double uv_len, uu, vv, ww, uu2, vv2, uuvv, du, dv, dw;
-            double4c sum;
-            oskar_clear_complex_matrix_d(&sum);
-
-            /* Pointer to source vector for station p. */
-            station_p = &jones[SP * num_sources];
-
-            /* Get common baseline values. */
-            oskar_evaluate_baseline_terms_inline_d(station_u[SP],
-                    station_u[SQ], station_v[SP], station_v[SQ],
-                    station_w[SP], station_w[SQ], inv_wavelength,
-                    frac_bandwidth, &uv_len, &uu, &vv, &ww, &uu2, &vv2, &uuvv);
-
-            /* Apply the baseline length filter. */
-            if (uv_len < uv_min_lambda || uv_len > uv_max_lambda)
-                continue;
-
-            /* Compute the deltas for time-average smearing. */
-            oskar_evaluate_baseline_deltas_inline_d(station_x[SP],
-                    station_x[SQ], station_y[SP], station_y[SQ],
-                    inv_wavelength, time_int_sec, gha0_rad, dec0_rad,
-                    &du, &dv, &dw);
-
-            /* Loop over sources. */
-            for (i = 0; i < num_sources; ++i)
-            {
-                double l, m, n, r1, r2;
-
-                /* Get source direction cosines. */
-                l = source_l[i];
-                m = source_m[i];
-                n = source_n[i];
-
-                /* Compute bandwidth- and time-smearing terms. */
-                r1 = oskar_sinc_d(uu * l + vv * m + ww * (n - 1.0));
-                r2 = oskar_evaluate_time_smearing_d(du, dv, dw, l, m, n);
-                r1 *= r2;
-
-                /* Evaluate Gaussian source width term. */
-                r2 = exp(-(source_a[i] * uu2 + source_b[i] * uuvv +
-                        source_c[i] * vv2));
-                r1 *= r2;
-
-                /* Accumulate baseline visibility response for source. */
-                oskar_accumulate_baseline_visibility_for_source_inline_d(&sum,
-                        i, source_I, source_Q, source_U, source_V,
-                        station_p, station_q, r1);
-            }
-
-            /* Add result to the baseline visibility. */
-            i = oskar_evaluate_baseline_index_inline(num_stations, SP, SQ);
-            oskar_add_complex_matrix_in_place_d(&vis[i], &sum);
-        }
-    }
+    int status = 0;
+    oskar_cross_correlate_omp_d(num_sources, num_stations, jones, source_I,
+            source_Q, source_U, source_V, source_l, source_m, source_n,
+            source_a, source_b, source_c, station_u, station_v, station_w,
+            station_x, station_y, uv_min_lambda, uv_max_lambda, inv_wavelength,
+            frac_bandwidth, time_int_sec, gha0_rad, dec0_rad, vis, &status);
 }
 
 #ifdef __cplusplus
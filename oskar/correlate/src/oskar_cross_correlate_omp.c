@@ -0,0 +1,1301 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "correlate/private_correlate_functions_inline.h"
+#include "correlate/oskar_cross_correlate_omp.h"
+#include "correlate/oskar_correlate_fused_omp.h"
+#include "math/oskar_add_inline.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+/* Number of sources in each tile: the tile for one station must fit in L1. */
+#define TILE_SIZE 128
+
+/* Number of independent accumulators used for each visibility component. */
+#define NUM_LANES 8
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Evaluates smearing and extended source terms for a tile of sources. */
+static void evaluate_smearing_tile_f(const int num_sources,
+        const float* restrict l, const float* restrict m,
+        const float* restrict n, const float* restrict a,
+        const float* restrict b, const float* restrict c, const float uu,
+        const float vv, const float ww, const float uu2, const float vv2,
+        const float uuvv, const int time_smearing, const float du,
+        const float dv, const float dw, float* restrict r)
+{
+    int i;
+    for (i = 0; i < num_sources; ++i)
+        r[i] = oskar_sinc_f(uu * l[i] + vv * m[i] + ww * (n[i] - 1.0f));
+    if (time_smearing)
+        for (i = 0; i < num_sources; ++i)
+            r[i] *= oskar_evaluate_time_smearing_f(du, dv, dw,
+                    l[i], m[i], n[i]);
+    if (a)
+        for (i = 0; i < num_sources; ++i)
+            r[i] *= expf(-(a[i] * uu2 + b[i] * uuvv + c[i] * vv2));
+    for (i = num_sources; i < TILE_SIZE; ++i)
+        r[i] = 0.0f;
+}
+
+static void evaluate_smearing_tile_d(const int num_sources,
+        const double* restrict l, const double* restrict m,
+        const double* restrict n, const double* restrict a,
+        const double* restrict b, const double* restrict c, const double uu,
+        const double vv, const double ww, const double uu2, const double vv2,
+        const double uuvv, const int time_smearing, const double du,
+        const double dv, const double dw, double* restrict r)
+{
+    int i;
+    for (i = 0; i < num_sources; ++i)
+        r[i] = oskar_sinc_d(uu * l[i] + vv * m[i] + ww * (n[i] - 1.0));
+    if (time_smearing)
+        for (i = 0; i < num_sources; ++i)
+            r[i] *= oskar_evaluate_time_smearing_d(du, dv, dw,
+                    l[i], m[i], n[i]);
+    if (a)
+        for (i = 0; i < num_sources; ++i)
+            r[i] *= exp(-(a[i] * uu2 + b[i] * uuvv + c[i] * vv2));
+    for (i = num_sources; i < TILE_SIZE; ++i)
+        r[i] = 0.0;
+}
+
+/* Forms the combined Jones terms of one station for a tile of sources. */
+static void repack_station_f(const int num_tile, const int start,
+        const float4c* restrict E, const float4c* restrict R,
+        const int apply_K, const float us, const float vs, const float ws,
+        const float* restrict l, const float* restrict m,
+        const float* restrict n, const float* restrict filter,
+        const float filter_min, const float filter_max,
+        const float* restrict I, const float* restrict Q,
+        const float* restrict U, const float* restrict V,
+        float* restrict t, float4c* auto_sum, float4c* auto_guard)
+{
+    int i, k;
+    for (i = 0; i < num_tile; ++i)
+    {
+        float4c J;
+        const int j = start + i;
+        J = E[j];
+
+        /* Join with Jones R. */
+        if (R) oskar_multiply_complex_matrix_in_place_f(&J, &R[j]);
+
+        /* Join with Jones K, which is zero for sources filtered out. */
+        if (apply_K || filter)
+        {
+            float2 K;
+            K.x = 1.0f;
+            K.y = 0.0f;
+            if (filter && !(filter[j] > filter_min && filter[j] <= filter_max))
+                K.x = 0.0f;
+            else if (apply_K)
+            {
+                const float phase = us * l[j] + vs * m[j] + ws * (n[j] - 1.0f);
+                K.x = cos(phase);
+                K.y = sin(phase);
+            }
+            oskar_multiply_complex_matrix_complex_scalar_in_place_f(&J, &K);
+        }
+
+        /* Accumulate the auto-correlation, if required. */
+        if (auto_sum)
+            oskar_accumulate_station_visibility_for_source_inline_f(auto_sum,
+                    0, I + j, Q + j, U + j, V + j, &J, auto_guard);
+
+        t[i]                 = J.a.x;
+        t[TILE_SIZE + i]     = J.a.y;
+        t[2 * TILE_SIZE + i] = J.b.x;
+        t[3 * TILE_SIZE + i] = J.b.y;
+        t[4 * TILE_SIZE + i] = J.c.x;
+        t[5 * TILE_SIZE + i] = J.c.y;
+        t[6 * TILE_SIZE + i] = J.d.x;
+        t[7 * TILE_SIZE + i] = J.d.y;
+    }
+    for (i = num_tile; i < TILE_SIZE; ++i)
+        for (k = 0; k < 8; ++k) t[k * TILE_SIZE + i] = 0.0f;
+}
+
+static void repack_station_d(const int num_tile, const int start,
+        const double4c* restrict E, const double4c* restrict R,
+        const int apply_K, const double us, const double vs, const double ws,
+        const double* restrict l, const double* restrict m,
+        const double* restrict n, const double* restrict filter,
+        const double filter_min, const double filter_max,
+        const double* restrict I, const double* restrict Q,
+        const double* restrict U, const double* restrict V,
+        double* restrict t, double4c* auto_sum)
+{
+    int i, k;
+    for (i = 0; i < num_tile; ++i)
+    {
+        double4c J;
+        const int j = start + i;
+        J = E[j];
+
+        /* Join with Jones R. */
+        if (R) oskar_multiply_complex_matrix_in_place_d(&J, &R[j]);
+
+        /* Join with Jones K, which is zero for sources filtered out. */
+        if (apply_K || filter)
+        {
+            double2 K;
+            K.x = 1.0;
+            K.y = 0.0;
+            if (filter && !(filter[j] > filter_min && filter[j] <= filter_max))
+                K.x = 0.0;
+            else if (apply_K)
+            {
+                const double phase = us * l[j] + vs * m[j] + ws * (n[j] - 1.0);
+                K.x = cos(phase);
+                K.y = sin(phase);
+            }
+            oskar_multiply_complex_matrix_complex_scalar_in_place_d(&J, &K);
+        }
+
+        /* Accumulate the auto-correlation, if required. */
+        if (auto_sum)
+            oskar_accumulate_station_visibility_for_source_inline_d(auto_sum,
+                    0, I + j, Q + j, U + j, V + j, &J);
+
+        t[i]                 = J.a.x;
+        t[TILE_SIZE + i]     = J.a.y;
+        t[2 * TILE_SIZE + i] = J.b.x;
+        t[3 * TILE_SIZE + i] = J.b.y;
+        t[4 * TILE_SIZE + i] = J.c.x;
+        t[5 * TILE_SIZE + i] = J.c.y;
+        t[6 * TILE_SIZE + i] = J.d.x;
+        t[7 * TILE_SIZE + i] = J.d.y;
+    }
+    for (i = num_tile; i < TILE_SIZE; ++i)
+        for (k = 0; k < 8; ++k) t[k * TILE_SIZE + i] = 0.0;
+}
+
+static void repack_station_scalar_f(const int num_tile, const int start,
+        const float2* restrict E, const int apply_K, const float us,
+        const float vs, const float ws, const float* restrict l,
+        const float* restrict m, const float* restrict n,
+        const float* restrict filter, const float filter_min,
+        const float filter_max, const float* restrict I, float* restrict t,
+        float2* auto_sum, float2* auto_guard)
+{
+    int i;
+    for (i = 0; i < num_tile; ++i)
+    {
+        float2 J;
+        const int j = start + i;
+        J = E[j];
+
+        /* Join with Jones K, which is zero for sources filtered out. */
+        if (apply_K || filter)
+        {
+            float2 K;
+            K.x = 1.0f;
+            K.y = 0.0f;
+            if (filter && !(filter[j] > filter_min && filter[j] <= filter_max))
+                K.x = 0.0f;
+            else if (apply_K)
+            {
+                const float phase = us * l[j] + vs * m[j] + ws * (n[j] - 1.0f);
+                K.x = cos(phase);
+                K.y = sin(phase);
+            }
+            oskar_multiply_complex_in_place_f(&J, &K);
+        }
+
+        /* Accumulate the auto-correlation, if required. */
+        if (auto_sum)
+            oskar_accumulate_station_visibility_for_source_scalar_inline_f(
+                    auto_sum, 0, I + j, &J, auto_guard);
+
+        t[i]             = J.x;
+        t[TILE_SIZE + i] = J.y;
+    }
+    for (i = num_tile; i < TILE_SIZE; ++i)
+        t[i] = t[TILE_SIZE + i] = 0.0f;
+}
+
+static void repack_station_scalar_d(const int num_tile, const int start,
+        const double2* restrict E, const int apply_K, const double us,
+        const double vs, const double ws, const double* restrict l,
+        const double* restrict m, const double* restrict n,
+        const double* restrict filter, const double filter_min,
+        const double filter_max, const double* restrict I, double* restrict t,
+        double2* auto_sum)
+{
+    int i;
+    for (i = 0; i < num_tile; ++i)
+    {
+        double2 J;
+        const int j = start + i;
+        J = E[j];
+
+        /* Join with Jones K, which is zero for sources filtered out. */
+        if (apply_K || filter)
+        {
+            double2 K;
+            K.x = 1.0;
+            K.y = 0.0;
+            if (filter && !(filter[j] > filter_min && filter[j] <= filter_max))
+                K.x = 0.0;
+            else if (apply_K)
+            {
+                const double phase = us * l[j] + vs * m[j] + ws * (n[j] - 1.0);
+                K.x = cos(phase);
+                K.y = sin(phase);
+            }
+            oskar_multiply_complex_in_place_d(&J, &K);
+        }
+
+        /* Accumulate the auto-correlation, if required. */
+        if (auto_sum)
+            oskar_accumulate_station_visibility_for_source_scalar_inline_d(
+                    auto_sum, 0, I + j, &J);
+
+        t[i]             = J.x;
+        t[TILE_SIZE + i] = J.y;
+    }
+    for (i = num_tile; i < TILE_SIZE; ++i)
+        t[i] = t[TILE_SIZE + i] = 0.0;
+}
+
+/*
+ * Jones matrices in a tile are stored as
+ * jt[(station * 8 + component) * TILE_SIZE + source], with components in the
+ * order a.x, a.y, b.x, b.y, c.x, c.y, d.x, d.y, and zero padding.
+ * Brightness matrices are stored as
+ * bt[component * TILE_SIZE + source], with components I+Q, I-Q, U, V.
+ */
+
+/* Single precision. */
+static void correlate_f(int num_sources, int num_stations,
+        const float4c* jones, int jones_stride, const float4c* jones_R,
+        int apply_K, const float* source_filter, float filter_min,
+        float filter_max, const float* source_I, const float* source_Q,
+        const float* source_U, const float* source_V, const float* source_l,
+        const float* source_m, const float* source_n, const float* source_a,
+        const float* source_b, const float* source_c, const float* station_u,
+        const float* station_v, const float* station_w,
+        const float* station_x, const float* station_y, float uv_min_lambda,
+        float uv_max_lambda, float inv_wavelength, float frac_bandwidth,
+        float time_int_sec, float gha0_rad, float dec0_rad, float4c* vis,
+        float4c* vis_auto, int* status)
+{
+    float *jt, *bt;
+    float4c *guard = 0, *auto_sum = 0, *auto_guard = 0;
+    const int time_smearing = (time_int_sec > 0.0f && station_x && station_y);
+    const int num_baselines = num_stations * (num_stations - 1) / 2;
+    const int do_cross = vis && num_baselines > 0;
+    const float wavenumber = 2.0 * M_PI * inv_wavelength;
+    if (*status || num_sources <= 0 || num_stations <= 0) return;
+    if (!do_cross && !vis_auto) return;
+
+    /* Allocate tile buffers, accumulators and Kahan summation guards. */
+    jt = (float*) malloc(num_stations * 8 * TILE_SIZE * sizeof(float));
+    bt = (float*) malloc(4 * TILE_SIZE * sizeof(float));
+    if (do_cross)
+        guard = (float4c*) calloc(num_baselines, sizeof(float4c));
+    if (vis_auto)
+    {
+        auto_sum = (float4c*) calloc(num_stations, sizeof(float4c));
+        auto_guard = (float4c*) calloc(num_stations, sizeof(float4c));
+    }
+    if (!jt || !bt || (do_cross && !guard) ||
+            (vis_auto && (!auto_sum || !auto_guard)))
+    {
+        *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+        free(jt);
+        free(bt);
+        free(guard);
+        free(auto_sum);
+        free(auto_guard);
+        return;
+    }
+
+#pragma omp parallel
+    {
+        int start;
+        for (start = 0; start < num_sources; start += TILE_SIZE)
+        {
+            int i, s, SQ;
+            const int num_tile = (num_sources - start < TILE_SIZE) ?
+                    num_sources - start : TILE_SIZE;
+            const int num_padded =
+                    ((num_tile + NUM_LANES - 1) / NUM_LANES) * NUM_LANES;
+
+            /* Repack source brightness matrices for the tile. */
+#pragma omp single nowait
+            for (i = 0; i < TILE_SIZE; ++i)
+            {
+                const int j = start + i;
+                if (i < num_tile)
+                {
+                    bt[i] = source_I[j] + source_Q[j];
+                    bt[TILE_SIZE + i] = source_I[j] - source_Q[j];
+                    bt[2 * TILE_SIZE + i] = source_U[j];
+                    bt[3 * TILE_SIZE + i] = source_V[j];
+                }
+                else
+                {
+                    bt[i] = bt[TILE_SIZE + i] = 0.0f;
+                    bt[2 * TILE_SIZE + i] = bt[3 * TILE_SIZE + i] = 0.0f;
+                }
+            }
+
+            /* Form and repack Jones matrices for the tile. */
+#pragma omp for schedule(static)
+            for (s = 0; s < num_stations; ++s)
+            {
+                repack_station_f(num_tile, start,
+                        jones + s * jones_stride,
+                        jones_R ? jones_R + s * num_sources : 0,
+                        apply_K, wavenumber * station_u[s],
+                        wavenumber * station_v[s], wavenumber * station_w[s],
+                        source_l, source_m, source_n, source_filter,
+                        filter_min, filter_max, source_I, source_Q,
+                        source_U, source_V,
+                        &jt[s * 8 * TILE_SIZE],
+                        vis_auto ? &auto_sum[s] : 0,
+                        vis_auto ? &auto_guard[s] : 0);
+            }
+
+            /* Loop over stations. */
+#pragma omp for schedule(dynamic, 1)
+            for (SQ = 0; SQ < (do_cross ? num_stations : 0); ++SQ)
+            {
+                int SP;
+                float r[TILE_SIZE];
+                const float* restrict q = &jt[SQ * 8 * TILE_SIZE];
+
+                /* Loop over baselines for this station. */
+                for (SP = SQ + 1; SP < num_stations; ++SP)
+                {
+                    int b, k;
+                    float uv_len, uu, vv, ww, uu2, vv2, uuvv;
+                    float du = 0.0f, dv = 0.0f, dw = 0.0f;
+                    float sum[8][NUM_LANES], lane_guard[8][NUM_LANES];
+                    float4c tile_sum;
+                    const float* restrict p = &jt[SP * 8 * TILE_SIZE];
+
+                    /* Get common baseline values. */
+                    oskar_evaluate_baseline_terms_inline_f(station_u[SP],
+                            station_u[SQ], station_v[SP], station_v[SQ],
+                            station_w[SP], station_w[SQ], inv_wavelength,
+                            frac_bandwidth, &uv_len, &uu, &vv, &ww,
+                            &uu2, &vv2, &uuvv);
+
+                    /* Apply the baseline length filter. */
+                    if (uv_len < uv_min_lambda || uv_len > uv_max_lambda)
+                        continue;
+
+                    /* Compute the deltas for time-average smearing. */
+                    if (time_smearing)
+                        oskar_evaluate_baseline_deltas_inline_f(
+                                station_x[SP], station_x[SQ],
+                                station_y[SP], station_y[SQ],
+                                inv_wavelength, time_int_sec, gha0_rad,
+                                dec0_rad, &du, &dv, &dw);
+
+                    /* Evaluate smearing terms for all sources in the tile. */
+                    evaluate_smearing_tile_f(num_tile, source_l + start,
+                            source_m + start, source_n + start,
+                            source_a ? source_a + start : 0,
+                            source_b ? source_b + start : 0,
+                            source_c ? source_c + start : 0,
+                            uu, vv, ww, uu2, vv2, uuvv,
+                            time_smearing, du, dv, dw, r);
+
+                    /* Accumulate in independent lanes across sources. */
+                    for (k = 0; k < NUM_LANES; ++k)
+                        for (b = 0; b < 8; ++b)
+                            sum[b][k] = lane_guard[b][k] = 0.0f;
+                    for (i = 0; i < num_padded; i += NUM_LANES)
+                    {
+                        for (k = 0; k < NUM_LANES; ++k)
+                        {
+                            float t_a_x, t_a_y, t_b_x, t_b_y;
+                            float t_c_x, t_c_y, t_d_x, t_d_y;
+                            const int j = i + k;
+                            const float f = r[j];
+                            const float AA = bt[j];
+                            const float DD = bt[TILE_SIZE + j];
+                            const float UU = bt[2 * TILE_SIZE + j];
+                            const float VV = bt[3 * TILE_SIZE + j];
+                            const float pax = p[j];
+                            const float pay = p[TILE_SIZE + j];
+                            const float pbx = p[2 * TILE_SIZE + j];
+                            const float pby = p[3 * TILE_SIZE + j];
+                            const float pcx = p[4 * TILE_SIZE + j];
+                            const float pcy = p[5 * TILE_SIZE + j];
+                            const float pdx = p[6 * TILE_SIZE + j];
+                            const float pdy = p[7 * TILE_SIZE + j];
+                            const float qax = q[j];
+                            const float qay = q[TILE_SIZE + j];
+                            const float qbx = q[2 * TILE_SIZE + j];
+                            const float qby = q[3 * TILE_SIZE + j];
+                            const float qcx = q[4 * TILE_SIZE + j];
+                            const float qcy = q[5 * TILE_SIZE + j];
+                            const float qdx = q[6 * TILE_SIZE + j];
+                            const float qdy = q[7 * TILE_SIZE + j];
+
+                            /* T = J_p * B. */
+                            t_a_x = pax * AA + pbx * UU + pby * VV;
+                            t_a_y = pay * AA + pby * UU - pbx * VV;
+                            t_b_x = pbx * DD + pax * UU - pay * VV;
+                            t_b_y = pby * DD + pay * UU + pax * VV;
+                            t_c_x = pcx * AA + pdx * UU + pdy * VV;
+                            t_c_y = pcy * AA + pdy * UU - pdx * VV;
+                            t_d_x = pdx * DD + pcx * UU - pcy * VV;
+                            t_d_y = pdy * DD + pcy * UU + pcx * VV;
+
+                            /* V = T * J_q^H, scaled by smearing term. */
+                            oskar_kahan_sum_f(&sum[0][k], f * (
+                                    t_a_x * qax + t_a_y * qay +
+                                    t_b_x * qbx + t_b_y * qby),
+                                    &lane_guard[0][k]);
+                            oskar_kahan_sum_f(&sum[1][k], f * (
+                                    t_a_y * qax - t_a_x * qay +
+                                    t_b_y * qbx - t_b_x * qby),
+                                    &lane_guard[1][k]);
+                            oskar_kahan_sum_f(&sum[2][k], f * (
+                                    t_b_x * qdx + t_b_y * qdy +
+                                    t_a_x * qcx + t_a_y * qcy),
+                                    &lane_guard[2][k]);
+                            oskar_kahan_sum_f(&sum[3][k], f * (
+                                    t_b_y * qdx - t_b_x * qdy +
+                                    t_a_y * qcx - t_a_x * qcy),
+                                    &lane_guard[3][k]);
+                            oskar_kahan_sum_f(&sum[4][k], f * (
+                                    t_c_x * qax + t_c_y * qay +
+                                    t_d_x * qbx + t_d_y * qby),
+                                    &lane_guard[4][k]);
+                            oskar_kahan_sum_f(&sum[5][k], f * (
+                                    t_c_y * qax - t_c_x * qay +
+                                    t_d_y * qbx - t_d_x * qby),
+                                    &lane_guard[5][k]);
+                            oskar_kahan_sum_f(&sum[6][k], f * (
+                                    t_d_x * qdx + t_d_y * qdy +
+                                    t_c_x * qcx + t_c_y * qcy),
+                                    &lane_guard[6][k]);
+                            oskar_kahan_sum_f(&sum[7][k], f * (
+                                    t_d_y * qdx - t_d_x * qdy +
+                                    t_c_y * qcx - t_c_x * qcy),
+                                    &lane_guard[7][k]);
+                        }
+                    }
+
+                    /* Reduce lanes, including their compensation terms. */
+                    for (b = 0; b < 8; ++b)
+                    {
+                        float t = 0.0f, g = 0.0f;
+                        for (k = 0; k < NUM_LANES; ++k)
+                            oskar_kahan_sum_f(&t,
+                                    sum[b][k] - lane_guard[b][k], &g);
+                        sum[b][0] = t;
+                    }
+                    tile_sum.a.x = sum[0][0]; tile_sum.a.y = sum[1][0];
+                    tile_sum.b.x = sum[2][0]; tile_sum.b.y = sum[3][0];
+                    tile_sum.c.x = sum[4][0]; tile_sum.c.y = sum[5][0];
+                    tile_sum.d.x = sum[6][0]; tile_sum.d.y = sum[7][0];
+
+                    /* Add result to the baseline visibility. */
+                    b = oskar_evaluate_baseline_index_inline(num_stations,
+                            SP, SQ);
+                    oskar_kahan_sum_complex_matrix_f(&vis[b], tile_sum,
+                            &guard[b]);
+                }
+            }
+        }
+    }
+
+    /* Add auto-correlations, blanking non-Hermitian values. */
+    if (vis_auto)
+    {
+        int s;
+        for (s = 0; s < num_stations; ++s)
+        {
+            vis_auto[s].a.x += auto_sum[s].a.x;
+            vis_auto[s].b.x += auto_sum[s].b.x;
+            vis_auto[s].b.y += auto_sum[s].b.y;
+            vis_auto[s].c.x += auto_sum[s].c.x;
+            vis_auto[s].c.y += auto_sum[s].c.y;
+            vis_auto[s].d.x += auto_sum[s].d.x;
+        }
+    }
+
+    free(jt);
+    free(bt);
+    free(guard);
+    free(auto_sum);
+    free(auto_guard);
+}
+
+/* Double precision. */
+static void correlate_d(int num_sources, int num_stations,
+        const double4c* jones, int jones_stride, const double4c* jones_R,
+        int apply_K, const double* source_filter, double filter_min,
+        double filter_max, const double* source_I, const double* source_Q,
+        const double* source_U, const double* source_V, const double* source_l,
+        const double* source_m, const double* source_n, const double* source_a,
+        const double* source_b, const double* source_c,
+        const double* station_u, const double* station_v,
+        const double* station_w, const double* station_x,
+        const double* station_y, double uv_min_lambda, double uv_max_lambda,
+        double inv_wavelength, double frac_bandwidth, double time_int_sec,
+        double gha0_rad, double dec0_rad, double4c* vis, double4c* vis_auto,
+        int* status)
+{
+    double *jt, *bt;
+    double4c* auto_sum = 0;
+    const int time_smearing = (time_int_sec > 0.0 && station_x && station_y);
+    const int num_baselines = num_stations * (num_stations - 1) / 2;
+    const int do_cross = vis && num_baselines > 0;
+    const double wavenumber = 2.0 * M_PI * inv_wavelength;
+    if (*status || num_sources <= 0 || num_stations <= 0) return;
+    if (!do_cross && !vis_auto) return;
+
+    /* Allocate tile buffers and accumulators. */
+    jt = (double*) malloc(num_stations * 8 * TILE_SIZE * sizeof(double));
+    bt = (double*) malloc(4 * TILE_SIZE * sizeof(double));
+    if (vis_auto)
+        auto_sum = (double4c*) calloc(num_stations, sizeof(double4c));
+    if (!jt || !bt || (vis_auto && !auto_sum))
+    {
+        *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+        free(jt);
+        free(bt);
+        free(auto_sum);
+        return;
+    }
+
+#pragma omp parallel
+    {
+        int start;
+        for (start = 0; start < num_sources; start += TILE_SIZE)
+        {
+            int i, s, SQ;
+            const int num_tile = (num_sources - start < TILE_SIZE) ?
+                    num_sources - start : TILE_SIZE;
+            const int num_padded =
+                    ((num_tile + NUM_LANES - 1) / NUM_LANES) * NUM_LANES;
+
+            /* Repack source brightness matrices for the tile. */
+#pragma omp single nowait
+            for (i = 0; i < TILE_SIZE; ++i)
+            {
+                const int j = start + i;
+                if (i < num_tile)
+                {
+                    bt[i] = source_I[j] + source_Q[j];
+                    bt[TILE_SIZE + i] = source_I[j] - source_Q[j];
+                    bt[2 * TILE_SIZE + i] = source_U[j];
+                    bt[3 * TILE_SIZE + i] = source_V[j];
+                }
+                else
+                {
+                    bt[i] = bt[TILE_SIZE + i] = 0.0;
+                    bt[2 * TILE_SIZE + i] = bt[3 * TILE_SIZE + i] = 0.0;
+                }
+            }
+
+            /* Form and repack Jones matrices for the tile. */
+#pragma omp for schedule(static)
+            for (s = 0; s < num_stations; ++s)
+            {
+                repack_station_d(num_tile, start,
+                        jones + s * jones_stride,
+                        jones_R ? jones_R + s * num_sources : 0,
+                        apply_K, wavenumber * station_u[s],
+                        wavenumber * station_v[s], wavenumber * station_w[s],
+                        source_l, source_m, source_n, source_filter,
+                        filter_min, filter_max, source_I, source_Q,
+                        source_U, source_V,
+                        &jt[s * 8 * TILE_SIZE],
+                        vis_auto ? &auto_sum[s] : 0);
+            }
+
+            /* Loop over stations. */
+#pragma omp for schedule(dynamic, 1)
+            for (SQ = 0; SQ < (do_cross ? num_stations : 0); ++SQ)
+            {
+                int SP;
+                double r[TILE_SIZE];
+                const double* restrict q = &jt[SQ * 8 * TILE_SIZE];
+
+                /* Loop over baselines for this station. */
+                for (SP = SQ + 1; SP < num_stations; ++SP)
+                {
+                    int b, k;
+                    double uv_len, uu, vv, ww, uu2, vv2, uuvv;
+                    double du = 0.0, dv = 0.0, dw = 0.0;
+                    double sum[8][NUM_LANES];
+                    double4c tile_sum;
+                    const double* restrict p = &jt[SP * 8 * TILE_SIZE];
+
+                    /* Get common baseline values. */
+                    oskar_evaluate_baseline_terms_inline_d(station_u[SP],
+                            station_u[SQ], station_v[SP], station_v[SQ],
+                            station_w[SP], station_w[SQ], inv_wavelength,
+                            frac_bandwidth, &uv_len, &uu, &vv, &ww,
+                            &uu2, &vv2, &uuvv);
+
+                    /* Apply the baseline length filter. */
+                    if (uv_len < uv_min_lambda || uv_len > uv_max_lambda)
+                        continue;
+
+                    /* Compute the deltas for time-average smearing. */
+                    if (time_smearing)
+                        oskar_evaluate_baseline_deltas_inline_d(
+                                station_x[SP], station_x[SQ],
+                                station_y[SP], station_y[SQ],
+                                inv_wavelength, time_int_sec, gha0_rad,
+                                dec0_rad, &du, &dv, &dw);
+
+                    /* Evaluate smearing terms for all sources in the tile. */
+                    evaluate_smearing_tile_d(num_tile, source_l + start,
+                            source_m + start, source_n + start,
+                            source_a ? source_a + start : 0,
+                            source_b ? source_b + start : 0,
+                            source_c ? source_c + start : 0,
+                            uu, vv, ww, uu2, vv2, uuvv,
+                            time_smearing, du, dv, dw, r);
+
+                    /* Accumulate in independent lanes across sources. */
+                    for (k = 0; k < NUM_LANES; ++k)
+                        for (b = 0; b < 8; ++b)
+                            sum[b][k] = 0.0;
+                    for (i = 0; i < num_padded; i += NUM_LANES)
+                    {
+                        for (k = 0; k < NUM_LANES; ++k)
+                        {
+                            double t_a_x, t_a_y, t_b_x, t_b_y;
+                            double t_c_x, t_c_y, t_d_x, t_d_y;
+                            const int j = i + k;
+                            const double f = r[j];
+                            const double AA = bt[j];
+                            const double DD = bt[TILE_SIZE + j];
+                            const double UU = bt[2 * TILE_SIZE + j];
+                            const double VV = bt[3 * TILE_SIZE + j];
+                            const double pax = p[j];
+                            const double pay = p[TILE_SIZE + j];
+                            const double pbx = p[2 * TILE_SIZE + j];
+                            const double pby = p[3 * TILE_SIZE + j];
+                            const double pcx = p[4 * TILE_SIZE + j];
+                            const double pcy = p[5 * TILE_SIZE + j];
+                            const double pdx = p[6 * TILE_SIZE + j];
+                            const double pdy = p[7 * TILE_SIZE + j];
+                            const double qax = q[j];
+                            const double qay = q[TILE_SIZE + j];
+                            const double qbx = q[2 * TILE_SIZE + j];
+                            const double qby = q[3 * TILE_SIZE + j];
+                            const double qcx = q[4 * TILE_SIZE + j];
+                            const double qcy = q[5 * TILE_SIZE + j];
+                            const double qdx = q[6 * TILE_SIZE + j];
+                            const double qdy = q[7 * TILE_SIZE + j];
+
+                            /* T = J_p * B. */
+                            t_a_x = pax * AA + pbx * UU + pby * VV;
+                            t_a_y = pay * AA + pby * UU - pbx * VV;
+                            t_b_x = pbx * DD + pax * UU - pay * VV;
+                            t_b_y = pby * DD + pay * UU + pax * VV;
+                            t_c_x = pcx * AA + pdx * UU + pdy * VV;
+                            t_c_y = pcy * AA + pdy * UU - pdx * VV;
+                            t_d_x = pdx * DD + pcx * UU - pcy * VV;
+                            t_d_y = pdy * DD + pcy * UU + pcx * VV;
+
+                            /* V = T * J_q^H, scaled by smearing term. */
+                            sum[0][k] += f * (t_a_x * qax + t_a_y * qay +
+                                    t_b_x * qbx + t_b_y * qby);
+                            sum[1][k] += f * (t_a_y * qax - t_a_x * qay +
+                                    t_b_y * qbx - t_b_x * qby);
+                            sum[2][k] += f * (t_b_x * qdx + t_b_y * qdy +
+                                    t_a_x * qcx + t_a_y * qcy);
+                            sum[3][k] += f * (t_b_y * qdx - t_b_x * qdy +
+                                    t_a_y * qcx - t_a_x * qcy);
+                            sum[4][k] += f * (t_c_x * qax + t_c_y * qay +
+                                    t_d_x * qbx + t_d_y * qby);
+                            sum[5][k] += f * (t_c_y * qax - t_c_x * qay +
+                                    t_d_y * qbx - t_d_x * qby);
+                            sum[6][k] += f * (t_d_x * qdx + t_d_y * qdy +
+                                    t_c_x * qcx + t_c_y * qcy);
+                            sum[7][k] += f * (t_d_y * qdx - t_d_x * qdy +
+                                    t_c_y * qcx - t_c_x * qcy);
+                        }
+                    }
+
+                    /* Reduce lanes. */
+                    for (b = 0; b < 8; ++b)
+                        for (k = 1; k < NUM_LANES; ++k)
+                            sum[b][0] += sum[b][k];
+                    tile_sum.a.x = sum[0][0]; tile_sum.a.y = sum[1][0];
+                    tile_sum.b.x = sum[2][0]; tile_sum.b.y = sum[3][0];
+                    tile_sum.c.x = sum[4][0]; tile_sum.c.y = sum[5][0];
+                    tile_sum.d.x = sum[6][0]; tile_sum.d.y = sum[7][0];
+
+                    /* Add result to the baseline visibility. */
+                    b = oskar_evaluate_baseline_index_inline(num_stations,
+                            SP, SQ);
+                    oskar_add_complex_matrix_in_place_d(&vis[b], &tile_sum);
+                }
+            }
+        }
+    }
+
+    /* Add auto-correlations, blanking non-Hermitian values. */
+    if (vis_auto)
+    {
+        int s;
+        for (s = 0; s < num_stations; ++s)
+        {
+            vis_auto[s].a.x += auto_sum[s].a.x;
+            vis_auto[s].b.x += auto_sum[s].b.x;
+            vis_auto[s].b.y += auto_sum[s].b.y;
+            vis_auto[s].c.x += auto_sum[s].c.x;
+            vis_auto[s].c.y += auto_sum[s].c.y;
+            vis_auto[s].d.x += auto_sum[s].d.x;
+        }
+    }
+
+    free(jt);
+    free(bt);
+    free(auto_sum);
+}
+
+/* Single precision. */
+static void correlate_scalar_f(int num_sources, int num_stations,
+        const float2* jones, int jones_stride, int apply_K,
+        const float* source_filter, float filter_min,
+        float filter_max, const float* source_I, const float* source_l,
+        const float* source_m, const float* source_n, const float* source_a,
+        const float* source_b, const float* source_c, const float* station_u,
+        const float* station_v, const float* station_w,
+        const float* station_x, const float* station_y, float uv_min_lambda,
+        float uv_max_lambda, float inv_wavelength, float frac_bandwidth,
+        float time_int_sec, float gha0_rad, float dec0_rad, float2* vis,
+        float2* vis_auto, int* status)
+{
+    float *jt, *bt;
+    float2 *guard = 0, *auto_sum = 0, *auto_guard = 0;
+    const int time_smearing = (time_int_sec > 0.0f && station_x && station_y);
+    const int num_baselines = num_stations * (num_stations - 1) / 2;
+    const int do_cross = vis && num_baselines > 0;
+    const float wavenumber = 2.0 * M_PI * inv_wavelength;
+    if (*status || num_sources <= 0 || num_stations <= 0) return;
+    if (!do_cross && !vis_auto) return;
+
+    /* Allocate tile buffers, accumulators and Kahan summation guards. */
+    jt = (float*) malloc(num_stations * 2 * TILE_SIZE * sizeof(float));
+    bt = (float*) malloc(TILE_SIZE * sizeof(float));
+    if (do_cross)
+        guard = (float2*) calloc(num_baselines, sizeof(float2));
+    if (vis_auto)
+    {
+        auto_sum = (float2*) calloc(num_stations, sizeof(float2));
+        auto_guard = (float2*) calloc(num_stations, sizeof(float2));
+    }
+    if (!jt || !bt || (do_cross && !guard) ||
+            (vis_auto && (!auto_sum || !auto_guard)))
+    {
+        *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+        free(jt);
+        free(bt);
+        free(guard);
+        free(auto_sum);
+        free(auto_guard);
+        return;
+    }
+
+#pragma omp parallel
+    {
+        int start;
+        for (start = 0; start < num_sources; start += TILE_SIZE)
+        {
+            int i, s, SQ;
+            const int num_tile = (num_sources - start < TILE_SIZE) ?
+                    num_sources - start : TILE_SIZE;
+            const int num_padded =
+                    ((num_tile + NUM_LANES - 1) / NUM_LANES) * NUM_LANES;
+
+            /* Repack source Stokes I values for the tile. */
+#pragma omp single nowait
+            for (i = 0; i < TILE_SIZE; ++i)
+                bt[i] = (i < num_tile) ? source_I[start + i] : 0.0f;
+
+            /* Repack Jones scalars for the tile. */
+#pragma omp for schedule(static)
+            for (s = 0; s < num_stations; ++s)
+            {
+                repack_station_scalar_f(num_tile, start,
+                        jones + s * jones_stride,
+                        apply_K, wavenumber * station_u[s],
+                        wavenumber * station_v[s], wavenumber * station_w[s],
+                        source_l, source_m, source_n, source_filter,
+                        filter_min, filter_max, source_I,
+                        &jt[s * 2 * TILE_SIZE],
+                        vis_auto ? &auto_sum[s] : 0,
+                        vis_auto ? &auto_guard[s] : 0);
+            }
+
+            /* Loop over stations. */
+#pragma omp for schedule(dynamic, 1)
+            for (SQ = 0; SQ < (do_cross ? num_stations : 0); ++SQ)
+            {
+                int SP;
+                float r[TILE_SIZE];
+                const float* restrict q = &jt[SQ * 2 * TILE_SIZE];
+
+                /* Loop over baselines for this station. */
+                for (SP = SQ + 1; SP < num_stations; ++SP)
+                {
+                    int b, k;
+                    float uv_len, uu, vv, ww, uu2, vv2, uuvv;
+                    float du = 0.0f, dv = 0.0f, dw = 0.0f;
+                    float sum[2][NUM_LANES], lane_guard[2][NUM_LANES];
+                    float2 tile_sum;
+                    const float* restrict p = &jt[SP * 2 * TILE_SIZE];
+
+                    /* Get common baseline values. */
+                    oskar_evaluate_baseline_terms_inline_f(station_u[SP],
+                            station_u[SQ], station_v[SP], station_v[SQ],
+                            station_w[SP], station_w[SQ], inv_wavelength,
+                            frac_bandwidth, &uv_len, &uu, &vv, &ww,
+                            &uu2, &vv2, &uuvv);
+
+                    /* Apply the baseline length filter. */
+                    if (uv_len < uv_min_lambda || uv_len > uv_max_lambda)
+                        continue;
+
+                    /* Compute the deltas for time-average smearing. */
+                    if (time_smearing)
+                        oskar_evaluate_baseline_deltas_inline_f(
+                                station_x[SP], station_x[SQ],
+                                station_y[SP], station_y[SQ],
+                                inv_wavelength, time_int_sec, gha0_rad,
+                                dec0_rad, &du, &dv, &dw);
+
+                    /* Evaluate smearing terms for all sources in the tile. */
+                    evaluate_smearing_tile_f(num_tile, source_l + start,
+                            source_m + start, source_n + start,
+                            source_a ? source_a + start : 0,
+                            source_b ? source_b + start : 0,
+                            source_c ? source_c + start : 0,
+                            uu, vv, ww, uu2, vv2, uuvv,
+                            time_smearing, du, dv, dw, r);
+
+                    /* Accumulate in independent lanes across sources. */
+                    for (k = 0; k < NUM_LANES; ++k)
+                        sum[0][k] = sum[1][k] =
+                                lane_guard[0][k] = lane_guard[1][k] = 0.0f;
+                    for (i = 0; i < num_padded; i += NUM_LANES)
+                    {
+                        for (k = 0; k < NUM_LANES; ++k)
+                        {
+                            const int j = i + k;
+                            const float f = r[j] * bt[j];
+                            const float px = p[j], py = p[TILE_SIZE + j];
+                            const float qx = q[j], qy = q[TILE_SIZE + j];
+                            oskar_kahan_sum_f(&sum[0][k],
+                                    f * (px * qx + py * qy),
+                                    &lane_guard[0][k]);
+                            oskar_kahan_sum_f(&sum[1][k],
+                                    f * (py * qx - px * qy),
+                                    &lane_guard[1][k]);
+                        }
+                    }
+
+                    /* Reduce lanes, including their compensation terms. */
+                    for (b = 0; b < 2; ++b)
+                    {
+                        float t = 0.0f, g = 0.0f;
+                        for (k = 0; k < NUM_LANES; ++k)
+                            oskar_kahan_sum_f(&t,
+                                    sum[b][k] - lane_guard[b][k], &g);
+                        sum[b][0] = t;
+                    }
+                    tile_sum.x = sum[0][0];
+                    tile_sum.y = sum[1][0];
+
+                    /* Add result to the baseline visibility. */
+                    b = oskar_evaluate_baseline_index_inline(num_stations,
+                            SP, SQ);
+                    oskar_kahan_sum_complex_f(&vis[b], tile_sum, &guard[b]);
+                }
+            }
+        }
+    }
+
+    /* Add auto-correlations (only the real part is needed). */
+    if (vis_auto)
+    {
+        int s;
+        for (s = 0; s < num_stations; ++s)
+            vis_auto[s].x += auto_sum[s].x;
+    }
+
+    free(jt);
+    free(bt);
+    free(guard);
+    free(auto_sum);
+    free(auto_guard);
+}
+
+/* Double precision. */
+static void correlate_scalar_d(int num_sources, int num_stations,
+        const double2* jones, int jones_stride, int apply_K,
+        const double* source_filter, double filter_min,
+        double filter_max, const double* source_I, const double* source_l,
+        const double* source_m, const double* source_n,
+        const double* source_a, const double* source_b,
+        const double* source_c, const double* station_u,
+        const double* station_v, const double* station_w,
+        const double* station_x, const double* station_y,
+        double uv_min_lambda, double uv_max_lambda, double inv_wavelength,
+        double frac_bandwidth, double time_int_sec, double gha0_rad,
+        double dec0_rad, double2* vis, double2* vis_auto, int* status)
+{
+    double *jt, *bt;
+    double2* auto_sum = 0;
+    const int time_smearing = (time_int_sec > 0.0 && station_x && station_y);
+    const int num_baselines = num_stations * (num_stations - 1) / 2;
+    const int do_cross = vis && num_baselines > 0;
+    const double wavenumber = 2.0 * M_PI * inv_wavelength;
+    if (*status || num_sources <= 0 || num_stations <= 0) return;
+    if (!do_cross && !vis_auto) return;
+
+    /* Allocate tile buffers and accumulators. */
+    jt = (double*) malloc(num_stations * 2 * TILE_SIZE * sizeof(double));
+    bt = (double*) malloc(TILE_SIZE * sizeof(double));
+    if (vis_auto)
+        auto_sum = (double2*) calloc(num_stations, sizeof(double2));
+    if (!jt || !bt || (vis_auto && !auto_sum))
+    {
+        *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+        free(jt);
+        free(bt);
+        free(auto_sum);
+        return;
+    }
+
+#pragma omp parallel
+    {
+        int start;
+        for (start = 0; start < num_sources; start += TILE_SIZE)
+        {
+            int i, s, SQ;
+            const int num_tile = (num_sources - start < TILE_SIZE) ?
+                    num_sources - start : TILE_SIZE;
+            const int num_padded =
+                    ((num_tile + NUM_LANES - 1) / NUM_LANES) * NUM_LANES;
+
+            /* Repack source Stokes I values for the tile. */
+#pragma omp single nowait
+            for (i = 0; i < TILE_SIZE; ++i)
+                bt[i] = (i < num_tile) ? source_I[start + i] : 0.0;
+
+            /* Repack Jones scalars for the tile. */
+#pragma omp for schedule(static)
+            for (s = 0; s < num_stations; ++s)
+            {
+                repack_station_scalar_d(num_tile, start,
+                        jones + s * jones_stride,
+                        apply_K, wavenumber * station_u[s],
+                        wavenumber * station_v[s], wavenumber * station_w[s],
+                        source_l, source_m, source_n, source_filter,
+                        filter_min, filter_max, source_I,
+                        &jt[s * 2 * TILE_SIZE],
+                        vis_auto ? &auto_sum[s] : 0);
+            }
+
+            /* Loop over stations. */
+#pragma omp for schedule(dynamic, 1)
+            for (SQ = 0; SQ < (do_cross ? num_stations : 0); ++SQ)
+            {
+                int SP;
+                double r[TILE_SIZE];
+                const double* restrict q = &jt[SQ * 2 * TILE_SIZE];
+
+                /* Loop over baselines for this station. */
+                for (SP = SQ + 1; SP < num_stations; ++SP)
+                {
+                    int b, k;
+                    double uv_len, uu, vv, ww, uu2, vv2, uuvv;
+                    double du = 0.0, dv = 0.0, dw = 0.0;
+                    double sum[2][NUM_LANES];
+                    const double* restrict p = &jt[SP * 2 * TILE_SIZE];
+
+                    /* Get common baseline values. */
+                    oskar_evaluate_baseline_terms_inline_d(station_u[SP],
+                            station_u[SQ], station_v[SP], station_v[SQ],
+                            station_w[SP], station_w[SQ], inv_wavelength,
+                            frac_bandwidth, &uv_len, &uu, &vv, &ww,
+                            &uu2, &vv2, &uuvv);
+
+                    /* Apply the baseline length filter. */
+                    if (uv_len < uv_min_lambda || uv_len > uv_max_lambda)
+                        continue;
+
+                    /* Compute the deltas for time-average smearing. */
+                    if (time_smearing)
+                        oskar_evaluate_baseline_deltas_inline_d(
+                                station_x[SP], station_x[SQ],
+                                station_y[SP], station_y[SQ],
+                                inv_wavelength, time_int_sec, gha0_rad,
+                                dec0_rad, &du, &dv, &dw);
+
+                    /* Evaluate smearing terms for all sources in the tile. */
+                    evaluate_smearing_tile_d(num_tile, source_l + start,
+                            source_m + start, source_n + start,
+                            source_a ? source_a + start : 0,
+                            source_b ? source_b + start : 0,
+                            source_c ? source_c + start : 0,
+                            uu, vv, ww, uu2, vv2, uuvv,
+                            time_smearing, du, dv, dw, r);
+
+                    /* Accumulate in independent lanes across sources. */
+                    for (k = 0; k < NUM_LANES; ++k)
+                        sum[0][k] = sum[1][k] = 0.0;
+                    for (i = 0; i < num_padded; i += NUM_LANES)
+                    {
+                        for (k = 0; k < NUM_LANES; ++k)
+                        {
+                            const int j = i + k;
+                            const double f = r[j] * bt[j];
+                            const double px = p[j], py = p[TILE_SIZE + j];
+                            const double qx = q[j], qy = q[TILE_SIZE + j];
+                            sum[0][k] += f * (px * qx + py * qy);
+                            sum[1][k] += f * (py * qx - px * qy);
+                        }
+                    }
+
+                    /* Reduce lanes and add to the baseline visibility. */
+                    for (k = 1; k < NUM_LANES; ++k)
+                    {
+                        sum[0][0] += sum[0][k];
+                        sum[1][0] += sum[1][k];
+                    }
+                    b = oskar_evaluate_baseline_index_inline(num_stations,
+                            SP, SQ);
+                    vis[b].x += sum[0][0];
+                    vis[b].y += sum[1][0];
+                }
+            }
+        }
+    }
+
+    /* Add auto-correlations (only the real part is needed). */
+    if (vis_auto)
+    {
+        int s;
+        for (s = 0; s < num_stations; ++s)
+            vis_auto[s].x += auto_sum[s].x;
+    }
+
+    free(jt);
+    free(bt);
+    free(auto_sum);
+}
+
+/* Single precision. */
+void oskar_cross_correlate_omp_f(int num_sources, int num_stations,
+        const float4c* jones, const float* source_I, const float* source_Q,
+        const float* source_U, const float* source_V, const float* source_l,
+        const float* source_m, const float* source_n, const float* source_a,
+        const float* source_b, const float* source_c, const float* station_u,
+        const float* station_v, const float* station_w,
+        const float* station_x, const float* station_y, float uv_min_lambda,
+        float uv_max_lambda, float inv_wavelength, float frac_bandwidth,
+        float time_int_sec, float gha0_rad, float dec0_rad, float4c* vis,
+        int* status)
+{
+    correlate_f(num_sources, num_stations, jones, num_sources, 0, 0, 0,
+            0.0f, 0.0f, source_I, source_Q, source_U, source_V,
+            source_l, source_m, source_n, source_a, source_b, source_c,
+            station_u, station_v, station_w, station_x, station_y,
+            uv_min_lambda, uv_max_lambda, inv_wavelength, frac_bandwidth,
+            time_int_sec, gha0_rad, dec0_rad, vis, 0, status);
+}
+
+/* Double precision. */
+void oskar_cross_correlate_omp_d(int num_sources, int num_stations,
+        const double4c* jones, const double* source_I, const double* source_Q,
+        const double* source_U, const double* source_V, const double* source_l,
+        const double* source_m, const double* source_n, const double* source_a,
+        const double* source_b, const double* source_c,
+        const double* station_u, const double* station_v,
+        const double* station_w, const double* station_x,
+        const double* station_y, double uv_min_lambda, double uv_max_lambda,
+        double inv_wavelength, double frac_bandwidth, double time_int_sec,
+        double gha0_rad, double dec0_rad, double4c* vis, int* status)
+{
+    correlate_d(num_sources, num_stations, jones, num_sources, 0, 0, 0,
+            0.0, 0.0, source_I, source_Q, source_U, source_V,
+            source_l, source_m, source_n, source_a, source_b, source_c,
+            station_u, station_v, station_w, station_x, station_y,
+            uv_min_lambda, uv_max_lambda, inv_wavelength, frac_bandwidth,
+            time_int_sec, gha0_rad, dec0_rad, vis, 0, status);
+}
+
+/* Single precision. */
+void oskar_cross_correlate_scalar_omp_f(int num_sources, int num_stations,
+        const float2* jones, const float* source_I, const float* source_l,
+        const float* source_m, const float* source_n, const float* source_a,
+        const float* source_b, const float* source_c, const float* station_u,
+        const float* station_v, const float* station_w,
+        const float* station_x, const float* station_y, float uv_min_lambda,
+        float uv_max_lambda, float inv_wavelength, float frac_bandwidth,
+        float time_int_sec, float gha0_rad, float dec0_rad, float2* vis,
+        int* status)
+{
+    correlate_scalar_f(num_sources, num_stations, jones, num_sources, 0, 0,
+            0.0f, 0.0f, source_I, source_l, source_m, source_n,
+            source_a, source_b, source_c,
+            station_u, station_v, station_w, station_x, station_y,
+            uv_min_lambda, uv_max_lambda, inv_wavelength, frac_bandwidth,
+            time_int_sec, gha0_rad, dec0_rad, vis, 0, status);
+}
+
+/* Double precision. */
+void oskar_cross_correlate_scalar_omp_d(int num_sources, int num_stations,
+        const double2* jones, const double* source_I, const double* source_l,
+        const double* source_m, const double* source_n,
+        const double* source_a, const double* source_b,
+        const double* source_c, const double* station_u,
+        const double* station_v, const double* station_w,
+        const double* station_x, const double* station_y,
+        double uv_min_lambda, double uv_max_lambda, double inv_wavelength,
+        double frac_bandwidth, double time_int_sec, double gha0_rad,
+        double dec0_rad, double2* vis, int* status)
+{
+    correlate_scalar_d(num_sources, num_stations, jones, num_sources, 0, 0,
+            0.0, 0.0, source_I, source_l, source_m, source_n,
+            source_a, source_b, source_c,
+            station_u, station_v, station_w, station_x, station_y,
+            uv_min_lambda, uv_max_lambda, inv_wavelength, frac_bandwidth,
+            time_int_sec, gha0_rad, dec0_rad, vis, 0, status);
+}
+
+/* Single precision. */
+void oskar_correlate_fused_omp_f(int num_sources, int num_stations,
+        const float4c* jones_E, int shared_E, const float4c* jones_R,
+        const float* source_filter, float filter_min, float filter_max,
+        const float* source_I, const float* source_Q,
+        const float* source_U, const float* source_V, const float* source_l,
+        const float* source_m, const float* source_n, const float* source_a,
+        const float* source_b, const float* source_c, const float* station_u,
+        const float* station_v, const float* station_w,
+        const float* station_x, const float* station_y, float uv_min_lambda,
+        float uv_max_lambda, float inv_wavelength, float frac_bandwidth,
+        float time_int_sec, float gha0_rad, float dec0_rad,
+        float4c* vis_cross, float4c* vis_auto, int* status)
+{
+    correlate_f(num_sources, num_stations, jones_E,
+            shared_E ? 0 : num_sources, jones_R, 1, source_filter,
+            filter_min, filter_max, source_I, source_Q, source_U, source_V,
+            source_l, source_m, source_n, source_a, source_b, source_c,
+            station_u, station_v, station_w, station_x, station_y,
+            uv_min_lambda, uv_max_lambda, inv_wavelength, frac_bandwidth,
+            time_int_sec, gha0_rad, dec0_rad, vis_cross, vis_auto, status);
+}
+
+/* Double precision. */
+void oskar_correlate_fused_omp_d(int num_sources, int num_stations,
+        const double4c* jones_E, int shared_E, const double4c* jones_R,
+        const double* source_filter, double filter_min, double filter_max,
+        const double* source_I, const double* source_Q,
+        const double* source_U, const double* source_V,
+        const double* source_l, const double* source_m,
+        const double* source_n, const double* source_a,
+        const double* source_b, const double* source_c,
+        const double* station_u, const double* station_v,
+        const double* station_w, const double* station_x,
+        const double* station_y, double uv_min_lambda, double uv_max_lambda,
+        double inv_wavelength, double frac_bandwidth, double time_int_sec,
+        double gha0_rad, double dec0_rad, double4c* vis_cross,
+        double4c* vis_auto, int* status)
+{
+    correlate_d(num_sources, num_stations, jones_E,
+            shared_E ? 0 : num_sources, jones_R, 1, source_filter,
+            filter_min, filter_max, source_I, source_Q, source_U, source_V,
+            source_l, source_m, source_n, source_a, source_b, source_c,
+            station_u, station_v, station_w, station_x, station_y,
+            uv_min_lambda, uv_max_lambda, inv_wavelength, frac_bandwidth,
+            time_int_sec, gha0_rad, dec0_rad, vis_cross, vis_auto, status);
+}
+
+/* Single precision. */
+void oskar_correlate_fused_scalar_omp_f(int num_sources, int num_stations,
+        const float2* jones_E, int shared_E, const float* source_filter,
+        float filter_min, float filter_max, const float* source_I,
+        const float* source_l, const float* source_m, const float* source_n,
+        const float* source_a, const float* source_b, const float* source_c,
+        const float* station_u, const float* station_v,
+        const float* station_w, const float* station_x,
+        const float* station_y, float uv_min_lambda, float uv_max_lambda,
+        float inv_wavelength, float frac_bandwidth, float time_int_sec,
+        float gha0_rad, float dec0_rad, float2* vis_cross, float2* vis_auto,
+        int* status)
+{
+    correlate_scalar_f(num_sources, num_stations, jones_E,
+            shared_E ? 0 : num_sources, 1, source_filter, filter_min,
+            filter_max, source_I, source_l, source_m, source_n,
+            source_a, source_b, source_c,
+            station_u, station_v, station_w, station_x, station_y,
+            uv_min_lambda, uv_max_lambda, inv_wavelength, frac_bandwidth,
+            time_int_sec, gha0_rad, dec0_rad, vis_cross, vis_auto, status);
+}
+
+/* Double precision. */
+void oskar_correlate_fused_scalar_omp_d(int num_sources, int num_stations,
+        const double2* jones_E, int shared_E, const double* source_filter,
+        double filter_min, double filter_max, const double* source_I,
+        const double* source_l, const double* source_m,
+        const double* source_n, const double* source_a,
+        const double* source_b, const double* source_c,
+        const double* station_u, const double* station_v,
+        const double* station_w, const double* station_x,
+        const double* station_y, double uv_min_lambda, double uv_max_lambda,
+        double inv_wavelength, double frac_bandwidth, double time_int_sec,
+        double gha0_rad, double dec0_rad, double2* vis_cross,
+        double2* vis_auto, int* status)
+{
+    correlate_scalar_d(num_sources, num_stations, jones_E,
+            shared_E ? 0 : num_sources, 1, source_filter, filter_min,
+            filter_max, source_I, source_l, source_m, source_n,
+            source_a, source_b, source_c,
+            station_u, station_v, station_w, station_x, station_y,
+            uv_min_lambda, uv_max_lambda, inv_wavelength, frac_bandwidth,
+            time_int_sec, gha0_rad, dec0_rad, vis_cross, vis_auto, status);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -26,8 +26,7 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
-#include <math.h>
-#include "correlate/private_correlate_functions_inline.h"
+#include "correlate/oskar_cross_correlate_omp.h"
 #include "correlate/oskar_cross_correlate_point_scalar_omp.h"
 
 #ifdef __cplusplus
@@ -42,65 +41,11 @@ void oskar_cross_correlate_point_scalar_omp_f(int num_sources, int num_stations,
         float uv_max_lambda, float inv_wavelength, float frac_bandwidth,
         float2* vis)
 {
-    int SQ;
-
-    /* Loop over stations. */
-#pragma omp parallel for private(SQ) schedule(dynamic, 1)
-    for (SQ = 0; SQ < num_stations; ++SQ)
-    {
-        int SP, i;
-        const float2 *station_p, *station_q;
-
-        /* Pointer to source vector for station q. */
-        station_q = &jones[SQ * num_sources];
-
-        /* Loop over baselines for this station. */
-        for (SP = SQ + 1; SP < num_stations; ++SP)
-        {
-            float uv_len, uu, vv, ww, uu2, vv2, uuvv;
-            float2 sum, guard;
-            sum.x = 0.0f;
-            sum.y = 0.0f;
-            guard.x = 0.0f;
-            guard.y = 0.0f;
-
-            /* Pointer to source vector for station p. */
-            station_p = &jones[SP * num_sources];
-
-            /* Get common baseline values. */
-            oskar_evaluate_baseline_terms_inline_f(station_u[SP],
-                    station_u[SQ], station_v[SP], station_v[SQ],
-                    station_w[SP], station_w[SQ], inv_wavelength,
-                    frac_bandwidth, &uv_len, &uu, &vv, &ww, &uu2, &vv2, &uuvv);
-
-            /* Apply the baseline length filter. */
-            if (uv_len < uv_min_lambda || uv_len > uv_max_lambda)
-                continue;
-
-            /* Loop over sources. */
-            for (i = 0; i < num_sources; ++i)
-            {
-                float l, m, n, rb;
-
-                /* Get source direction cosines. */
-                l = source_l[i];
-                m = source_m[i];
-                n = source_n[i];
-
-                /* Compute bandwidth-smearing term. */
-                rb = oskar_sinc_f(uu * l + vv * m + ww * (n - 1.0f));
-
-                /* Accumulate baseline visibility response for source. */
-                oskar_accumulate_baseline_visibility_for_source_scalar_inline_f(
-                        &sum, i, source_I, station_p, station_q, rb, &guard);
-            }
-
-            /* Add result to the baseline visibility. */
-            i = oskar_evaluate_baseline_index_inline(num_stations, SP, SQ);
-            vis[i].x += sum.x;
-            vis[i].y += sum.y;
-        }
-    }
+    int status = 0;
+    oskar_cross_correlate_scalar_omp_f(num_sources, num_stations, jones,
+            source_I, source_l, source_m, source_n, 0, 0, 0, station_u,
+            station_v, station_w, 0, 0, uv_min_lambda, uv_max_lambda,
+            inv_wavelength, frac_bandwidth, 0.0f, 0.0f, 0.0f, vis, &status);
 }
 
 /* Double precision. */
@@ -111,63 +56,11 @@ void oskar_cross_correlate_point_scalar_omp_d(int num_sources, int num_stations,
         double uv_max_lambda, double inv_wavelength, double frac_bandwidth,
         double2* vis)
 {
-    int SQ;
-
-    /* Loop over stations. */
-#pragma omp parallel for private(SQ) schedule(dynamic, 1)
-    for (SQ = 0; SQ < num_stations; ++SQ)
-    {
-        int SP, i;
-        const double2 *station_p, *station_q;
-
-        /* Pointer to source vector for station q. */
-        station_q = &jones[SQ * num_sources];
-
-        /* Loop over baselines for this station. */
-        for (SP = SQ + 1; SP < num_stations; ++SP)
-        {
-            double uv_len, uu, vv, ww, uu2, vv2, uuvv;
-            double2 sum;
-            sum.x = 0.0;
-            sum.y = 0.0;
-
-            /* Pointer to source vector for station p. */
-            station_p = &jones[SP * num_sources];
-
-            /* Get common baseline values. */
-            oskar_evaluate_baseline_terms_inline_d(station_u[SP],
-                    station_u[SQ], station_v[SP], station_v[SQ],
-                    station_w[SP], station_w[SQ], inv_wavelength,
-                    frac_bandwidth, &uv_len, &uu, &vv, &ww, &uu2, &vv2, &uuvv);
-
-            /* Apply the baseline length filter. */
-            if (uv_len < uv_min_lambda || uv_len > uv_max_lambda)
-                continue;
-
-            /* Loop over sources. */
-            for (i = 0; i < num_sources; ++i)
-            {
-                double l, m, n, rb;
-
-                /* Get source direction cosines. */
-                l = source_l[i];
-                m = source_m[i];
-                n = source_n[i];
-
-                /* Compute bandwidth-smearing term. */
-                rb = oskar_sinc_d(uu * l + vv * m + ww * (n - 1.0));
-
-                /* Accumulate baseline visibility response for source. */
-                oskar_accumulate_baseline_visibility_for_source_scalar_inline_d(
-                        &sum, i, source_I, station_p, station_q, rb);
-            }
-
-            /* Add result to the baseline visibility. */
-            i = oskar_evaluate_baseline_index_inline(num_stations, SP, SQ);
-            vis[i].x += sum.x;
-            vis[i].y += sum.y;
-        }
-    }
+    int status = 0;
+    oskar_cross_correlate_scalar_omp_d(num_sources, num_stations, jones,
+            source_I, source_l, source_m, source_n, 0, 0, 0, station_u,
+            station_v, station_w, 0, 0, uv_min_lambda, uv_max_lambda,
+            inv_wavelength, frac_bandwidth, 0.0, 0.0, 0.0, vis, &status);
 }
 
 #ifdef __cplusplus
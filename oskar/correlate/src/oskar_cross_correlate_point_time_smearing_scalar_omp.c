@@ -26,8 +26,7 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
-#include <math.h>
-#include "correlate/private_correlate_functions_inline.h"
+#include "correlate/oskar_cross_correlate_omp.h"
 #include "correlate/oskar_cross_correlate_point_time_smearing_scalar_omp.h"
 
 #ifdef __cplusplus
@@ -44,73 +43,12 @@ void oskar_cross_correlate_point_time_smearing_scalar_omp_f(int num_sources,
         float uv_max_lambda, float inv_wavelength, float frac_bandwidth,
         float time_int_sec, float gha0_rad, float dec0_rad, float2* vis)
 {
-    int SQ;
-
-    /* Loop over stations. */
-#pragma omp parallel for private(SQ) schedule(dynamic, 1)
-    for (SQ = 0; SQ < num_stations; ++SQ)
-    {
-        int SP, i;
-        const float2 *station_p, *station_q;
-
-        /* Pointer to source vector for station q. */
-        station_q = &jones[SQ * num_sources];
-
-        /* Loop over baselines for this station. */
-        for (SP = SQ + 1; SP < num_stations; ++SP)
-        {
-            float uv_len, uu, vv, ww, uu2, vv2, uuvv, du, dv, dw;
-            float2 sum, guard;
-            sum.x = 0.0f;
-            sum.y = 0.0f;
-            guard.x = 0.0f;
-            guard.y = 0.0f;
-
-            /* Pointer to source vector for station p. */
-            station_p = &jones[SP * num_sources];
-
-            /* Get common baseline values. */
-            oskar_evaluate_baseline_terms_inline_f(station_u[SP],
-                    station_u[SQ], station_v[SP], station_v[SQ],
-                    station_w[SP], station_w[SQ], inv_wavelength,
-                    frac_bandwidth, &uv_len, &uu, &vv, &ww, &uu2, &vv2, &uuvv);
-
-            /* Apply the baseline length filter. */
-            if (uv_len < uv_min_lambda || uv_len > uv_max_lambda)
-                continue;
-
-            /* Compute the deltas for time-average smearing. */
-            oskar_evaluate_baseline_deltas_inline_f(station_x[SP],
-                    station_x[SQ], station_y[SP], station_y[SQ],
-                    inv_wavelength, time_int_sec, gha0_rad, dec0_rad,
-                    &du, &dv, &dw);
-
-            /* Loop over sources. */
-            for (i = 0; i < num_sources; ++i)
-            {
-                float l, m, n, r1, r2;
-
-                /* Get source direction cosines. */
-                l = source_l[i];
-                m = source_m[i];
-                n = source_n[i];
-
-                /* Compute bandwidth- and time-smearing terms. */
-                r1 = oskar_sinc_f(uu * l + vv * m + ww * (n - 1.0f));
-                r2 = oskar_evaluate_time_smearing_f(du, dv, dw, l, m, n);
-                r1 *= r2;
-
-                /* Accumulate baseline visibility response for source. */
-                oskar_accumulate_baseline_visibility_for_source_scalar_inline_f(
-                        &sum, i, source_I, station_p, station_q, r1, &guard);
-            }
-
-            /* Add result to the baseline visibility. */
-            i = oskar_evaluate_baseline_index_inline(num_stations, SP, SQ);
-            vis[i].x += sum.x;
-            vis[i].y += sum.y;
-        }
-    }
+    int status = 0;
+    oskar_cross_correlate_scalar_omp_f(num_sources, num_stations, jones,
+            source_I, source_l, source_m, source_n, 0, 0, 0, station_u,
+            station_v, station_w, station_x, station_y, uv_min_lambda,
+            uv_max_lambda, inv_wavelength, frac_bandwidth, time_int_sec,
+            gha0_rad, dec0_rad, vis, &status);
 }
 
 /* Double precision. */
@@ -123,71 +61,12 @@ void oskar_cross_correlate_point_time_smearing_scalar_omp_d(int num_sources,
         double uv_max_lambda, double inv_wavelength, double frac_bandwidth,
         double time_int_sec, double gha0_rad, double dec0_rad, double2* vis)
 {
-    int SQ;
-
-    /* Loop over stations. */
-#pragma omp parallel for private(SQ) schedule(dynamic, 1)
-    for (SQ = 0; SQ < num_stations; ++SQ)
-    {
-        int SP, i;
-        const double2 *station_p, *station_q;
-
-        /* Pointer to source vector for station q. */
-        station_q = &jones[SQ * num_sources];
-
-        /* Loop over baselines for this station. */
-        for (SP = SQ + 1; SP < num_stations; ++SP)
-        {
-            double uv_len, uu, vv, ww, uu2, vv2, uuvv, du, dv, dw;
-            double2 sum;
-            sum.x = 0.0;
-            sum.y = 0.0;
-
-            /* Pointer to source vector for station p. */
-            station_p = &jones[SP * num_sources];
-
-            /* Get common baseline values. */
-            oskar_evaluate_baseline_terms_inline_d(station_u[SP],
-                    station_u[SQ], station_v[SP], station_v[SQ],
-                    station_w[SP], station_w[SQ], inv_wavelength,
-                    frac_bandwidth, &uv_len, &uu, &vv, &ww, &uu2, &vv2, &uuvv);
-
-            /* Apply the baseline length filter. */
-            if (uv_len < uv_min_lambda || uv_len > uv_max_lambda)
-                continue;
-
-            /* Compute the deltas for time-average smearing. */
-            oskar_evaluate_baseline_deltas_inline_d(station_x[SP],
-                    station_x[SQ], station_y[SP], station_y[SQ],
-                    inv_wavelength, time_int_sec, gha0_rad, dec0_rad,
-                    &du, &dv, &dw);
-
-            /* Loop over sources. */
-            for (i = 0; i < num_sources; ++i)
-            {
-                double l, m, n, r1, r2;
-
-                /* Get source direction cosines. */
-                l = source_l[i];
-                m = source_m[i];
-                n = source_n[i];
-
-                /* Compute bandwidth- and time-smearing terms. */
-                r1 = oskar_sinc_d(uu * l + vv * m + ww * (n - 1.0));
-                r2 = oskar_evaluate_time_smearing_d(du, dv, dw, l, m, n);
-                r1 *= r2;
-
-                /* Accumulate baseline visibility response for source. */
-                oskar_accumulate_baseline_visibility_for_source_scalar_inline_d(
-                        &sum, i, source_I, station_p, station_q, r1);
-            }
-
-            /* Add result to the baseline visibility. */
-            i = oskar_evaluate_baseline_index_inline(num_stations, SP, SQ);
-            vis[i].x += sum.x;
-            vis[i].y += sum.y;
-        }
-    }
+    int status = 0;
+    oskar_cross_correlate_scalar_omp_d(num_sources, num_stations, jones,
+            source_I, source_l, source_m, source_n, 0, 0, 0, station_u,
+            station_v, station_w, station_x, station_y, uv_min_lambda,
+            uv_max_lambda, inv_wavelength, frac_bandwidth, time_int_sec,
+            gha0_rad, dec0_rad, vis, &status);
 }
 
 #ifdef __cplusplus
@@ -173,6 +173,47 @@ protected:
     }
 };
 
+TEST_F(auto_correlate, shared_stations)
+{
+    int status = 0;
+    oskar_Jones* jones_shared;
+    oskar_Mem *vis1, *vis2, *row;
+
+    // Create shared Jones matrices from the first station of the test data.
+    createTestData(OSKAR_DOUBLE, OSKAR_CPU, 1);
+    jones_shared = oskar_jones_create(OSKAR_DOUBLE_COMPLEX_MATRIX, OSKAR_CPU,
+            1, num_sources, &status);
+    oskar_jones_set_shared_stations(jones_shared, 1, &status);
+    oskar_jones_set_size(jones_shared, num_stations, num_sources, &status);
+    oskar_mem_copy_contents(oskar_jones_mem(jones_shared),
+            oskar_jones_mem(jones), 0, 0, num_sources, &status);
+    row = oskar_mem_create_alias(0, 0, 0, &status);
+    for (int i = 1; i < num_stations; ++i)
+    {
+        oskar_jones_get_station_pointer(row, jones, i, &status);
+        oskar_mem_copy_contents(row, oskar_jones_mem(jones_shared),
+                0, 0, num_sources, &status);
+    }
+
+    // Results must accumulate onto existing values.
+    vis1 = oskar_mem_create(OSKAR_DOUBLE_COMPLEX_MATRIX, OSKAR_CPU,
+            num_stations, &status);
+    oskar_mem_random_range(vis1, 1.0, 2.0, &status);
+    vis2 = oskar_mem_create_copy(vis1, OSKAR_CPU, &status);
+    oskar_auto_correlate(vis1, num_sources, jones_shared, sky, &status);
+    oskar_auto_correlate(vis2, num_sources, jones, sky, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    check_values(vis1, vis2);
+
+    // Free memory.
+    oskar_mem_free(row, &status);
+    oskar_mem_free(vis1, &status);
+    oskar_mem_free(vis2, &status);
+    oskar_jones_free(jones_shared, &status);
+    destroyTestData();
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+}
+
 // CPU only.
 TEST_F(auto_correlate, matrix_singleCPU_doubleCPU)
 {
@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "correlate/oskar_auto_correlate.h"
+#include "correlate/oskar_correlate_fused.h"
+#include "correlate/oskar_cross_correlate.h"
+#include "interferometer/oskar_evaluate_jones_K.h"
+#include "interferometer/oskar_jones.h"
+#include "utility/oskar_get_error_string.h"
+
+#include <cfloat>
+#include <cstdlib>
+
+static void check_values(const oskar_Mem* approx, const oskar_Mem* accurate)
+{
+    int status = 0;
+    double min_rel_error, max_rel_error, avg_rel_error, std_rel_error, tol;
+    oskar_mem_evaluate_relative_error(approx, accurate, &min_rel_error,
+            &max_rel_error, &avg_rel_error, &std_rel_error, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    tol = oskar_mem_is_double(approx) ? 1e-10 : 1e-4;
+    EXPECT_LT(max_rel_error, tol) << "MAX: " << max_rel_error;
+    tol = oskar_mem_is_double(approx) ? 1e-12 : 1e-4;
+    EXPECT_LT(avg_rel_error, tol) << "AVG: " << avg_rel_error;
+}
+
+static void run_test(int precision, int matrix, int shared_E, int use_R,
+        int extended, double time_average, double min_jy, double max_jy)
+{
+    int i, status = 0, type, num_baselines;
+    const int num_sources = 277, num_stations = 30;
+    const double frequency = 100e6, gast = 1.0;
+    oskar_Jones *E, *E_full, *R = 0, *J, *K;
+    oskar_Mem *u, *v, *w, *xc1, *xc2, *ac1, *ac2;
+    oskar_Sky* sky;
+    oskar_Telescope* tel;
+
+    // Create the test data.
+    type = precision | OSKAR_COMPLEX;
+    if (matrix) type |= OSKAR_MATRIX;
+    E = oskar_jones_create(type, OSKAR_CPU, shared_E ? 1 : num_stations,
+            num_sources, &status);
+    oskar_jones_set_shared_stations(E, shared_E, &status);
+    E_full = oskar_jones_create(type, OSKAR_CPU, num_stations, num_sources,
+            &status);
+    J = oskar_jones_create(type, OSKAR_CPU, num_stations, num_sources,
+            &status);
+    K = oskar_jones_create(precision | OSKAR_COMPLEX, OSKAR_CPU,
+            num_stations, num_sources, &status);
+    u = oskar_mem_create(precision, OSKAR_CPU, num_stations, &status);
+    v = oskar_mem_create(precision, OSKAR_CPU, num_stations, &status);
+    w = oskar_mem_create(precision, OSKAR_CPU, num_stations, &status);
+    sky = oskar_sky_create(precision, OSKAR_CPU, num_sources, &status);
+    tel = oskar_telescope_create(precision, OSKAR_CPU, num_stations, &status);
+    num_baselines = oskar_telescope_num_baselines(tel);
+    xc1 = oskar_mem_create(type, OSKAR_CPU, num_baselines, &status);
+    xc2 = oskar_mem_create(type, OSKAR_CPU, num_baselines, &status);
+    ac1 = oskar_mem_create(type, OSKAR_CPU, num_stations, &status);
+    ac2 = oskar_mem_create(type, OSKAR_CPU, num_stations, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    srand(2);
+    oskar_mem_random_range(oskar_jones_mem(E), 1.0, 5.0, &status);
+    oskar_mem_random_range(u, 1.0, 50.0, &status);
+    oskar_mem_random_range(v, 1.0, 50.0, &status);
+    oskar_mem_random_range(w, 1.0, 5.0, &status);
+    oskar_mem_random_range(
+            oskar_telescope_station_true_x_offset_ecef_metres(tel),
+            0.1, 1000.0, &status);
+    oskar_mem_random_range(
+            oskar_telescope_station_true_y_offset_ecef_metres(tel),
+            0.1, 1000.0, &status);
+    oskar_mem_random_range(oskar_sky_I(sky), 1.0, 2.0, &status);
+    oskar_mem_random_range(oskar_sky_Q(sky), 0.1, 1.0, &status);
+    oskar_mem_random_range(oskar_sky_U(sky), 0.1, 0.5, &status);
+    oskar_mem_random_range(oskar_sky_V(sky), 0.1, 0.2, &status);
+    oskar_mem_random_range(oskar_sky_l(sky), 0.1, 0.5, &status);
+    oskar_mem_random_range(oskar_sky_m(sky), 0.1, 0.5, &status);
+    oskar_mem_random_range(oskar_sky_n(sky), 0.7, 0.9, &status);
+    oskar_mem_random_range(oskar_sky_gaussian_a(sky), 0.1e-6, 0.2e-6,
+            &status);
+    oskar_mem_random_range(oskar_sky_gaussian_b(sky), 0.1e-6, 0.2e-6,
+            &status);
+    oskar_mem_random_range(oskar_sky_gaussian_c(sky), 0.1e-6, 0.2e-6,
+            &status);
+    oskar_sky_set_use_extended(sky, extended);
+    oskar_telescope_set_channel_bandwidth(tel, 1e6);
+    oskar_telescope_set_time_average(tel, time_average);
+    if (use_R)
+    {
+        R = oskar_jones_create(type, OSKAR_CPU, num_stations, num_sources,
+                &status);
+        oskar_mem_random_range(oskar_jones_mem(R), -1.0, 1.0, &status);
+    }
+    for (i = 0; i < num_stations; ++i)
+        oskar_mem_copy_contents(oskar_jones_mem(E_full), oskar_jones_mem(E),
+                i * num_sources, shared_E ? 0 : i * num_sources,
+                num_sources, &status);
+    oskar_mem_clear_contents(xc1, &status);
+    oskar_mem_clear_contents(xc2, &status);
+    oskar_mem_clear_contents(ac1, &status);
+    oskar_mem_clear_contents(ac2, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Form Jones J in full, and correlate.
+    oskar_evaluate_jones_K(K, num_sources, oskar_sky_l_const(sky),
+            oskar_sky_m_const(sky), oskar_sky_n_const(sky), u, v, w,
+            frequency, oskar_sky_I_const(sky), min_jy, max_jy, &status);
+    if (R)
+    {
+        oskar_jones_join(J, E_full, R, &status);
+        oskar_jones_join(J, K, J, &status);
+    }
+    else
+        oskar_jones_join(J, K, E_full, &status);
+    oskar_cross_correlate(xc1, num_sources, J, sky, tel, u, v, w,
+            gast, frequency, &status);
+    oskar_auto_correlate(ac1, num_sources, J, sky, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Correlate without forming Jones J.
+    oskar_correlate_fused(xc2, ac2, num_sources, E, R, sky, tel, u, v, w,
+            gast, frequency, min_jy, max_jy, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Compare results.
+    check_values(xc2, xc1);
+    check_values(ac2, ac1);
+
+    // Clean up.
+    oskar_jones_free(E, &status);
+    oskar_jones_free(E_full, &status);
+    oskar_jones_free(R, &status);
+    oskar_jones_free(J, &status);
+    oskar_jones_free(K, &status);
+    oskar_mem_free(u, &status);
+    oskar_mem_free(v, &status);
+    oskar_mem_free(w, &status);
+    oskar_mem_free(xc1, &status);
+    oskar_mem_free(xc2, &status);
+    oskar_mem_free(ac1, &status);
+    oskar_mem_free(ac2, &status);
+    oskar_sky_free(sky, &status);
+    oskar_telescope_free(tel, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+}
+
+TEST(correlate_fused, matrix_point_double)
+{
+    run_test(OSKAR_DOUBLE, 1, 0, 1, 0, 0.0, -DBL_MAX, DBL_MAX);
+}
+
+TEST(correlate_fused, matrix_point_single)
+{
+    run_test(OSKAR_SINGLE, 1, 0, 1, 0, 0.0, -DBL_MAX, DBL_MAX);
+}
+
+TEST(correlate_fused, matrix_gaussian_timeSmearing_filter_double)
+{
+    run_test(OSKAR_DOUBLE, 1, 0, 1, 1, 10.0, 1.2, 1.8);
+}
+
+TEST(correlate_fused, matrix_shared_filter_single)
+{
+    run_test(OSKAR_SINGLE, 1, 1, 0, 0, 10.0, 1.2, 1.8);
+}
+
+TEST(correlate_fused, scalar_shared_double)
+{
+    run_test(OSKAR_DOUBLE, 0, 1, 0, 0, 0.0, -DBL_MAX, DBL_MAX);
+}
+
+TEST(correlate_fused, scalar_gaussian_filter_single)
+{
+    run_test(OSKAR_SINGLE, 0, 0, 0, 1, 10.0, 1.2, 1.8);
+}
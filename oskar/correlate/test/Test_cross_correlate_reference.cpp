@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "correlate/oskar_cross_correlate.h"
+#include "interferometer/oskar_jones.h"
+#include "utility/oskar_get_error_string.h"
+
+#include <cmath>
+#include <complex>
+#include <cstdlib>
+
+typedef std::complex<double> cplx;
+
+static cplx get_jones(const oskar_Mem* jones, int matrix, size_t index,
+        int element, int* status)
+{
+    if (matrix)
+    {
+        double4c t = oskar_mem_get_element_matrix(jones, index, status);
+        switch (element)
+        {
+        case 0: return cplx(t.a.x, t.a.y);
+        case 1: return cplx(t.b.x, t.b.y);
+        case 2: return cplx(t.c.x, t.c.y);
+        default: return cplx(t.d.x, t.d.y);
+        }
+    }
+    double2 t = oskar_mem_get_element_complex(jones, index, status);
+    return (element == 0 || element == 3) ? cplx(t.x, t.y) : cplx(0.0, 0.0);
+}
+
+/*
+ * Evaluates V_pq = sum_s J_p B J_q^H * smear for every baseline directly,
+ * one source and one baseline at a time, without any of the correlator
+ * kernels. The scalar case uses B = I and the diagonal of the result.
+ */
+static void reference_correlate(oskar_Mem* vis, int num_sources,
+        const oskar_Jones* J, const oskar_Sky* sky, const oskar_Telescope* tel,
+        const oskar_Mem* u, const oskar_Mem* v, const oskar_Mem* w,
+        double frequency_hz, int* status)
+{
+    int p, q, s, i, j, k, b = 0;
+    const int num_stations = oskar_telescope_num_stations(tel);
+    const int matrix = oskar_mem_is_matrix(oskar_jones_mem_const(J));
+    const int extended = oskar_sky_use_extended(sky);
+    const oskar_Mem* jones = oskar_jones_mem_const(J);
+    const double inv_wavelength = frequency_hz / 299792458.0;
+    const double frac_bandwidth =
+            oskar_telescope_channel_bandwidth_hz(tel) / frequency_hz;
+    const double uv_min = oskar_telescope_uv_filter_min(tel);
+    const double uv_max = oskar_telescope_uv_filter_max(tel);
+    for (q = 0; q < num_stations; ++q)
+    {
+        for (p = q + 1; p < num_stations; ++p, ++b)
+        {
+            cplx sum[4];
+            double uu, vv, ww, uv_len;
+            uu = (oskar_mem_get_element(u, p, status) -
+                    oskar_mem_get_element(u, q, status)) * inv_wavelength;
+            vv = (oskar_mem_get_element(v, p, status) -
+                    oskar_mem_get_element(v, q, status)) * inv_wavelength;
+            ww = (oskar_mem_get_element(w, p, status) -
+                    oskar_mem_get_element(w, q, status)) * inv_wavelength;
+            uv_len = sqrt(uu * uu + vv * vv);
+            if (uv_len < uv_min || uv_len > uv_max) continue;
+            for (k = 0; k < 4; ++k) sum[k] = cplx(0.0, 0.0);
+            for (s = 0; s < num_sources; ++s)
+            {
+                cplx Jp[4], Jq[4], B[4], T[4];
+                double l, m, n, x, smear = 1.0;
+                double I = oskar_mem_get_element(oskar_sky_I_const(sky),
+                        s, status);
+                double Q = 0.0, U = 0.0, V = 0.0;
+                if (matrix)
+                {
+                    Q = oskar_mem_get_element(oskar_sky_Q_const(sky),
+                            s, status);
+                    U = oskar_mem_get_element(oskar_sky_U_const(sky),
+                            s, status);
+                    V = oskar_mem_get_element(oskar_sky_V_const(sky),
+                            s, status);
+                }
+                B[0] = cplx(I + Q, 0.0);
+                B[1] = cplx(U, V);
+                B[2] = cplx(U, -V);
+                B[3] = cplx(I - Q, 0.0);
+                for (k = 0; k < 4; ++k)
+                {
+                    Jp[k] = get_jones(jones, matrix,
+                            (size_t)p * num_sources + s, k, status);
+                    Jq[k] = get_jones(jones, matrix,
+                            (size_t)q * num_sources + s, k, status);
+                }
+
+                /* Bandwidth smearing. */
+                l = oskar_mem_get_element(oskar_sky_l_const(sky), s, status);
+                m = oskar_mem_get_element(oskar_sky_m_const(sky), s, status);
+                n = oskar_mem_get_element(oskar_sky_n_const(sky), s, status);
+                x = M_PI * frac_bandwidth * (uu * l + vv * m + ww * (n - 1.0));
+                if (x != 0.0) smear = sin(x) / x;
+
+                /* Gaussian source envelope. */
+                if (extended)
+                {
+                    double a, bb, c;
+                    a = oskar_mem_get_element(oskar_sky_gaussian_a_const(sky),
+                            s, status);
+                    bb = oskar_mem_get_element(oskar_sky_gaussian_b_const(sky),
+                            s, status);
+                    c = oskar_mem_get_element(oskar_sky_gaussian_c_const(sky),
+                            s, status);
+                    smear *= exp(-(a * uu * uu + bb * 2.0 * uu * vv +
+                            c * vv * vv));
+                }
+
+                /* T = Jp * B, then sum += T * Jq^H. */
+                for (i = 0; i < 2; ++i)
+                    for (j = 0; j < 2; ++j)
+                        T[2*i + j] = Jp[2*i] * B[j] + Jp[2*i + 1] * B[2 + j];
+                for (i = 0; i < 2; ++i)
+                    for (j = 0; j < 2; ++j)
+                        sum[2*i + j] += smear * (T[2*i] * conj(Jq[2*j]) +
+                                T[2*i + 1] * conj(Jq[2*j + 1]));
+            }
+            if (matrix)
+            {
+                double4c* t = oskar_mem_double4c(vis, status) + b;
+                t->a.x = sum[0].real(); t->a.y = sum[0].imag();
+                t->b.x = sum[1].real(); t->b.y = sum[1].imag();
+                t->c.x = sum[2].real(); t->c.y = sum[2].imag();
+                t->d.x = sum[3].real(); t->d.y = sum[3].imag();
+            }
+            else
+            {
+                double2* t = oskar_mem_double2(vis, status) + b;
+                t->x = sum[0].real(); t->y = sum[0].imag();
+            }
+        }
+    }
+}
+
+static void run_test(int precision, int matrix, int extended, double uv_min)
+{
+    int status = 0, type, num_baselines;
+    const int num_sources = 301, num_stations = 9;
+    const double frequency = 100e6;
+    oskar_Jones* J;
+    oskar_Mem *u, *v, *w, *vis, *vis_ref;
+    oskar_Sky* sky;
+    oskar_Telescope* tel;
+    double min_rel_error, max_rel_error, avg_rel_error, std_rel_error;
+
+    // Create the test data. Use enough sources to span several tiles.
+    type = precision | OSKAR_COMPLEX;
+    if (matrix) type |= OSKAR_MATRIX;
+    J = oskar_jones_create(type, OSKAR_CPU, num_stations, num_sources,
+            &status);
+    u = oskar_mem_create(precision, OSKAR_CPU, num_stations, &status);
+    v = oskar_mem_create(precision, OSKAR_CPU, num_stations, &status);
+    w = oskar_mem_create(precision, OSKAR_CPU, num_stations, &status);
+    sky = oskar_sky_create(precision, OSKAR_CPU, num_sources, &status);
+    tel = oskar_telescope_create(precision, OSKAR_CPU, num_stations, &status);
+    num_baselines = oskar_telescope_num_baselines(tel);
+    vis = oskar_mem_create(type, OSKAR_CPU, num_baselines, &status);
+    vis_ref = oskar_mem_create(OSKAR_DOUBLE | (type & ~OSKAR_SINGLE),
+            OSKAR_CPU, num_baselines, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    srand(3);
+    oskar_mem_random_range(oskar_jones_mem(J), -1.0, 1.0, &status);
+    oskar_mem_random_range(u, -50.0, 50.0, &status);
+    oskar_mem_random_range(v, -50.0, 50.0, &status);
+    oskar_mem_random_range(w, -5.0, 5.0, &status);
+    oskar_mem_random_range(oskar_sky_I(sky), 1.0, 2.0, &status);
+    oskar_mem_random_range(oskar_sky_Q(sky), 0.1, 1.0, &status);
+    oskar_mem_random_range(oskar_sky_U(sky), 0.1, 0.5, &status);
+    oskar_mem_random_range(oskar_sky_V(sky), 0.1, 0.2, &status);
+    oskar_mem_random_range(oskar_sky_l(sky), 0.1, 0.5, &status);
+    oskar_mem_random_range(oskar_sky_m(sky), 0.1, 0.5, &status);
+    oskar_mem_random_range(oskar_sky_n(sky), 0.7, 0.9, &status);
+    oskar_mem_random_range(oskar_sky_gaussian_a(sky), 1e-6, 2e-6, &status);
+    oskar_mem_random_range(oskar_sky_gaussian_b(sky), 1e-6, 2e-6, &status);
+    oskar_mem_random_range(oskar_sky_gaussian_c(sky), 1e-6, 2e-6, &status);
+    oskar_sky_set_use_extended(sky, extended);
+    oskar_telescope_set_channel_bandwidth(tel, 1e6);
+    oskar_telescope_set_uv_filter(tel, uv_min, 1e10, "Wavelengths", &status);
+    oskar_mem_clear_contents(vis, &status);
+    oskar_mem_clear_contents(vis_ref, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Correlate, and evaluate the reference.
+    oskar_cross_correlate(vis, num_sources, J, sky, tel, u, v, w,
+            1.0, frequency, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    reference_correlate(vis_ref, num_sources, J, sky, tel, u, v, w,
+            frequency, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Compare results.
+    oskar_mem_evaluate_relative_error(vis, vis_ref, &min_rel_error,
+            &max_rel_error, &avg_rel_error, &std_rel_error, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    EXPECT_LT(max_rel_error, precision == OSKAR_DOUBLE ? 1e-10 : 1e-3)
+            << "MAX: " << max_rel_error;
+    EXPECT_LT(avg_rel_error, precision == OSKAR_DOUBLE ? 1e-12 : 1e-4)
+            << "AVG: " << avg_rel_error;
+
+    // Clean up.
+    oskar_jones_free(J, &status);
+    oskar_mem_free(u, &status);
+    oskar_mem_free(v, &status);
+    oskar_mem_free(w, &status);
+    oskar_mem_free(vis, &status);
+    oskar_mem_free(vis_ref, &status);
+    oskar_sky_free(sky, &status);
+    oskar_telescope_free(tel, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+}
+
+TEST(cross_correlate_reference, matrix_point_double)
+{
+    run_test(OSKAR_DOUBLE, 1, 0, 0.0);
+}
+
+TEST(cross_correlate_reference, matrix_point_single)
+{
+    run_test(OSKAR_SINGLE, 1, 0, 0.0);
+}
+
+TEST(cross_correlate_reference, matrix_gaussian_filter_double)
+{
+    run_test(OSKAR_DOUBLE, 1, 1, 20.0);
+}
+
+TEST(cross_correlate_reference, scalar_point_double)
+{
+    run_test(OSKAR_DOUBLE, 0, 0, 0.0);
+}
+
+TEST(cross_correlate_reference, scalar_gaussian_filter_single)
+{
+    run_test(OSKAR_SINGLE, 0, 1, 20.0);
+}
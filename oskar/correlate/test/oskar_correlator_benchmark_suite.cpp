@@ -0,0 +1,422 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "apps/oskar_option_parser.h"
+#include "correlate/oskar_cross_correlate.h"
+#include "interferometer/oskar_jones.h"
+#include "mem/oskar_mem.h"
+#include "sky/oskar_sky.h"
+#include "telescope/oskar_telescope.h"
+#include "utility/oskar_get_error_string.h"
+#include "utility/oskar_timer.h"
+#include "oskar_version.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+/*
+ * Sweeps the CPU cross-correlator over station count, source count,
+ * precision, Jones type, source type and time smearing, and reports
+ * throughput against a measured floating-point peak and memory bandwidth.
+ */
+
+struct Config
+{
+    int num_stations, num_sources, precision, matrix, extended, time_smearing;
+};
+
+struct Result
+{
+    Config c;
+    double time_sec, vis_per_sec, source_baselines_per_sec;
+    double gflops, intensity, attainable_gflops;
+};
+
+static std::vector<std::string> split(const std::string& s)
+{
+    std::vector<std::string> out;
+    size_t start = 0, end;
+    while ((end = s.find(',', start)) != std::string::npos)
+    {
+        if (end > start) out.push_back(s.substr(start, end - start));
+        start = end + 1;
+    }
+    if (start < s.length()) out.push_back(s.substr(start));
+    return out;
+}
+
+static bool contains(const std::vector<std::string>& list, const char* value)
+{
+    for (size_t i = 0; i < list.size(); ++i)
+        if (list[i] == value) return true;
+    return false;
+}
+
+/*
+ * Nominal floating-point operation count per source per baseline.
+ * sin(), exp() and the division in sinc() are counted as one operation each.
+ */
+static double flops_per_source_baseline(const Config& c)
+{
+    double flops = c.matrix ?
+            104.0 : /* J_p * B (40), (J_p * B) * J_q^H (56), smearing (8). */
+            9.0;    /* J_p * I * conj(J_q), smearing. */
+    flops += 9.0; /* Bandwidth smearing: sinc argument and sinc(). */
+    if (c.time_smearing) flops += 10.0; /* Time smearing sinc and product. */
+    if (c.extended) flops += 10.0; /* Gaussian exponent, exp and product. */
+    return flops;
+}
+
+/* Minimum number of bytes to move to or from main memory per call. */
+static double bytes_per_call(const Config& c)
+{
+    const double real = c.precision == OSKAR_SINGLE ? 4.0 : 8.0;
+    const double jones = real * (c.matrix ? 8.0 : 2.0);
+    const double num_baselines = 0.5 * c.num_stations * (c.num_stations - 1);
+    const double source_params = (c.matrix ? 7.0 : 4.0) +
+            (c.extended ? 3.0 : 0.0);
+    return jones * c.num_stations * c.num_sources +
+            real * source_params * c.num_sources +
+            real * 5.0 * c.num_stations +
+            2.0 * jones * num_baselines;
+}
+
+/* Results of the machine measurements are stored here, so that the
+ * compiler cannot remove the loops that produce them. */
+static volatile double benchmark_sink = 0.0;
+
+/* Measures the peak multiply-add rate of all threads, in GFLOP/s. */
+template <typename T>
+static double measure_peak_gflops()
+{
+    const int num_acc = 64, num_iter = 1 << 20;
+    double best = 0.0, sink = 0.0;
+    for (int trial = 0; trial < 3; ++trial)
+    {
+        int num_threads = 1;
+        oskar_Timer* tmr = oskar_timer_create(OSKAR_TIMER_OMP);
+        oskar_timer_start(tmr);
+#pragma omp parallel reduction(+:sink)
+        {
+            T acc[num_acc];
+            const T mul = (T)0.999999, add = (T)1e-7;
+            for (int k = 0; k < num_acc; ++k) acc[k] = (T)k;
+            for (int i = 0; i < num_iter; ++i)
+                for (int k = 0; k < num_acc; ++k)
+                    acc[k] = acc[k] * mul + add;
+            for (int k = 0; k < num_acc; ++k) sink += acc[k];
+#ifdef _OPENMP
+#pragma omp master
+            num_threads = omp_get_num_threads();
+#endif
+        }
+        const double elapsed = oskar_timer_elapsed(tmr);
+        oskar_timer_free(tmr);
+        const double gflops = 2e-9 * num_acc * (double)num_iter *
+                num_threads / elapsed;
+        if (gflops > best) best = gflops;
+    }
+    benchmark_sink = sink;
+    return best;
+}
+
+/* Measures main memory bandwidth with a STREAM-like triad, in GB/s. */
+static double measure_bandwidth_gbs()
+{
+    const long n = 1L << 23;
+    double best = 0.0;
+    std::vector<double> a(n), b(n, 1.0), c(n, 2.0);
+    for (int trial = 0; trial < 5; ++trial)
+    {
+        oskar_Timer* tmr = oskar_timer_create(OSKAR_TIMER_OMP);
+        oskar_timer_start(tmr);
+#pragma omp parallel for
+        for (long i = 0; i < n; ++i)
+            a[i] = b[i] + 3.0 * c[i];
+        const double elapsed = oskar_timer_elapsed(tmr);
+        oskar_timer_free(tmr);
+        const double gbs = 1e-9 * 3.0 * sizeof(double) * n / elapsed;
+        if (gbs > best) best = gbs;
+    }
+    benchmark_sink = a[n / 2];
+    return best;
+}
+
+static int benchmark(const Config& c, int niter, double* time_sec)
+{
+    int status = 0, type = c.precision;
+    int jones_type = type | OSKAR_COMPLEX | (c.matrix ? OSKAR_MATRIX : 0);
+    const int loc = OSKAR_CPU;
+
+    // Set up a test sky model, telescope model and Jones matrices.
+    oskar_Telescope* tel = oskar_telescope_create(type, loc,
+            c.num_stations, &status);
+    oskar_Sky* sky = oskar_sky_create(type, loc, c.num_sources, &status);
+    oskar_Jones* J = oskar_jones_create(jones_type, loc, c.num_stations,
+            c.num_sources, &status);
+    oskar_telescope_set_channel_bandwidth(tel, 1e6);
+    oskar_telescope_set_time_average(tel, c.time_smearing ? 1.0 : 0.0);
+    oskar_sky_set_use_extended(sky, c.extended);
+    oskar_mem_random_range(oskar_jones_mem(J), -1.0, 1.0, &status);
+    oskar_mem_random_range(oskar_sky_I(sky), 1.0, 2.0, &status);
+    oskar_mem_random_range(oskar_sky_Q(sky), -0.1, 0.1, &status);
+    oskar_mem_random_range(oskar_sky_U(sky), -0.1, 0.1, &status);
+    oskar_mem_random_range(oskar_sky_V(sky), -0.1, 0.1, &status);
+    oskar_mem_random_range(oskar_sky_l(sky), -0.1, 0.1, &status);
+    oskar_mem_random_range(oskar_sky_m(sky), -0.1, 0.1, &status);
+    oskar_mem_random_range(oskar_sky_n(sky), 0.99, 1.0, &status);
+    oskar_mem_random_range(oskar_sky_gaussian_a(sky), 0.0, 1e-6, &status);
+    oskar_mem_random_range(oskar_sky_gaussian_b(sky), 0.0, 1e-6, &status);
+    oskar_mem_random_range(oskar_sky_gaussian_c(sky), 0.0, 1e-6, &status);
+
+    // Memory for visibility coordinates and output visibility slice.
+    oskar_Mem *vis, *u, *v, *w;
+    vis = oskar_mem_create(jones_type, loc,
+            oskar_telescope_num_baselines(tel), &status);
+    u = oskar_mem_create(type, loc, c.num_stations, &status);
+    v = oskar_mem_create(type, loc, c.num_stations, &status);
+    w = oskar_mem_create(type, loc, c.num_stations, &status);
+    oskar_mem_random_range(u, -1000.0, 1000.0, &status);
+    oskar_mem_random_range(v, -1000.0, 1000.0, &status);
+    oskar_mem_random_range(w, -10.0, 10.0, &status);
+
+    // Run once to warm up, then take the fastest iteration.
+    oskar_Timer* tmr = oskar_timer_create(OSKAR_TIMER_OMP);
+    *time_sec = 0.0;
+    for (int i = 0; i <= niter && !status; ++i)
+    {
+        oskar_timer_start(tmr);
+        oskar_cross_correlate(vis, c.num_sources, J, sky, tel, u, v, w,
+                0.0, 100e6, &status);
+        const double elapsed = oskar_timer_elapsed(tmr);
+        if (i > 0 && (*time_sec == 0.0 || elapsed < *time_sec))
+            *time_sec = elapsed;
+    }
+
+    // Free memory.
+    oskar_timer_free(tmr);
+    oskar_mem_free(u, &status);
+    oskar_mem_free(v, &status);
+    oskar_mem_free(w, &status);
+    oskar_mem_free(vis, &status);
+    oskar_jones_free(J, &status);
+    oskar_telescope_free(tel, &status);
+    oskar_sky_free(sky, &status);
+    return status;
+}
+
+static void write_json(FILE* f, int num_threads, double peak_sp,
+        double peak_dp, double bandwidth, const std::vector<Result>& results)
+{
+    fprintf(f, "{\n");
+    fprintf(f, "  \"benchmark\": \"oskar_correlator_benchmark_suite\",\n");
+    fprintf(f, "  \"oskar_version\": \"%s\",\n", OSKAR_VERSION_STR);
+    fprintf(f, "  \"num_threads\": %d,\n", num_threads);
+    fprintf(f, "  \"peak_gflops_single\": %.3f,\n", peak_sp);
+    fprintf(f, "  \"peak_gflops_double\": %.3f,\n", peak_dp);
+    fprintf(f, "  \"memory_bandwidth_gbs\": %.3f,\n", bandwidth);
+    fprintf(f, "  \"results\": [\n");
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const Result& r = results[i];
+        fprintf(f, "    {\"num_stations\": %d, \"num_sources\": %d, "
+                "\"precision\": \"%s\", \"jones_type\": \"%s\", "
+                "\"source_type\": \"%s\", \"time_smearing\": %s, "
+                "\"time_sec\": %.6e, \"vis_per_sec\": %.6e, "
+                "\"source_baselines_per_sec\": %.6e, \"gflops\": %.3f, "
+                "\"arithmetic_intensity\": %.3f, "
+                "\"attainable_gflops\": %.3f, \"fraction_of_roofline\": %.4f}"
+                "%s\n",
+                r.c.num_stations, r.c.num_sources,
+                r.c.precision == OSKAR_SINGLE ? "single" : "double",
+                r.c.matrix ? "matrix" : "scalar",
+                r.c.extended ? "gaussian" : "point",
+                r.c.time_smearing ? "true" : "false",
+                r.time_sec, r.vis_per_sec, r.source_baselines_per_sec,
+                r.gflops, r.intensity, r.attainable_gflops,
+                r.gflops / r.attainable_gflops,
+                i + 1 < results.size() ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+}
+
+int main(int argc, char** argv)
+{
+    oskar::OptionParser opt("oskar_correlator_benchmark_suite",
+            OSKAR_VERSION_STR);
+    opt.add_flag("-nst", "Comma-separated list of station counts.", 1,
+            "64,128,256");
+    opt.add_flag("-nsrc", "Comma-separated list of source counts.", 1,
+            "1000,10000");
+    opt.add_flag("-p", "Precisions to run (single,double).", 1,
+            "single,double");
+    opt.add_flag("-j", "Jones types to run (scalar,matrix).", 1,
+            "scalar,matrix");
+    opt.add_flag("-src", "Source types to run (point,gaussian).", 1,
+            "point,gaussian");
+    opt.add_flag("-t", "Time smearing modes to run (off,on).", 1, "off,on");
+    opt.add_flag("-n", "Number of timed iterations per configuration.", 1,
+            "3");
+    opt.add_flag("-o", "Write results as JSON to this file.", 1);
+    opt.add_flag("-q", "Do not print the results table.");
+    if (!opt.check_options(argc, argv))
+        return EXIT_FAILURE;
+
+    std::string s_nst, s_nsrc, s_p, s_j, s_src, s_t, json_file;
+    int niter = 3;
+    opt.get("-nst")->getString(s_nst);
+    opt.get("-nsrc")->getString(s_nsrc);
+    opt.get("-p")->getString(s_p);
+    opt.get("-j")->getString(s_j);
+    opt.get("-src")->getString(s_src);
+    opt.get("-t")->getString(s_t);
+    opt.get("-n")->getInt(niter);
+    if (opt.is_set("-o"))
+        opt.get("-o")->getString(json_file);
+    const bool quiet = opt.is_set("-q");
+    std::vector<std::string> nst = split(s_nst), nsrc = split(s_nsrc);
+    std::vector<std::string> p = split(s_p), j = split(s_j);
+    std::vector<std::string> src = split(s_src), t = split(s_t);
+
+    // Build the list of configurations.
+    std::vector<Config> configs;
+    for (size_t i_p = 0; i_p < 2; ++i_p)
+    {
+        if (!contains(p, i_p == 0 ? "single" : "double")) continue;
+        for (int i_j = 0; i_j < 2; ++i_j)
+        {
+            if (!contains(j, i_j ? "matrix" : "scalar")) continue;
+            for (int i_src = 0; i_src < 2; ++i_src)
+            {
+                if (!contains(src, i_src ? "gaussian" : "point")) continue;
+                for (int i_t = 0; i_t < 2; ++i_t)
+                {
+                    if (!contains(t, i_t ? "on" : "off")) continue;
+                    for (size_t i_st = 0; i_st < nst.size(); ++i_st)
+                    {
+                        for (size_t i_s = 0; i_s < nsrc.size(); ++i_s)
+                        {
+                            Config c;
+                            c.num_stations = atoi(nst[i_st].c_str());
+                            c.num_sources = atoi(nsrc[i_s].c_str());
+                            c.precision = i_p == 0 ?
+                                    OSKAR_SINGLE : OSKAR_DOUBLE;
+                            c.matrix = i_j;
+                            c.extended = i_src;
+                            c.time_smearing = i_t;
+                            if (c.num_stations < 2 || c.num_sources < 1)
+                            {
+                                opt.error("Invalid station or source count");
+                                return EXIT_FAILURE;
+                            }
+                            configs.push_back(c);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // Measure machine limits.
+    int num_threads = 1;
+#ifdef _OPENMP
+    num_threads = omp_get_max_threads();
+#endif
+    const double peak_sp = measure_peak_gflops<float>();
+    const double peak_dp = measure_peak_gflops<double>();
+    const double bandwidth = measure_bandwidth_gbs();
+    if (!quiet)
+    {
+        printf("Threads: %d, peak single: %.1f GFLOP/s, "
+                "peak double: %.1f GFLOP/s, bandwidth: %.1f GB/s\n\n",
+                num_threads, peak_sp, peak_dp, bandwidth);
+        printf("%6s %8s %4s %6s %8s %4s %11s %11s %11s %8s %7s %6s\n",
+                "nst", "nsrc", "prec", "jones", "source", "time",
+                "time/s", "vis/s", "src-bl/s", "GFLOP/s", "AI", "%roof");
+    }
+
+    // Run benchmarks.
+    std::vector<Result> results;
+    for (size_t i = 0; i < configs.size(); ++i)
+    {
+        Result r;
+        r.c = configs[i];
+        int status = benchmark(r.c, niter, &r.time_sec);
+        if (status)
+        {
+            fprintf(stderr, "ERROR: correlate failed with code %i: %s\n",
+                    status, oskar_get_error_string(status));
+            return EXIT_FAILURE;
+        }
+        const double num_baselines =
+                0.5 * r.c.num_stations * (r.c.num_stations - 1);
+        const double flops = flops_per_source_baseline(r.c) *
+                num_baselines * r.c.num_sources;
+        const double peak =
+                r.c.precision == OSKAR_SINGLE ? peak_sp : peak_dp;
+        r.vis_per_sec = num_baselines / r.time_sec;
+        r.source_baselines_per_sec = num_baselines * r.c.num_sources /
+                r.time_sec;
+        r.gflops = 1e-9 * flops / r.time_sec;
+        r.intensity = flops / bytes_per_call(r.c);
+        r.attainable_gflops = std::min(peak, r.intensity * bandwidth);
+        results.push_back(r);
+        if (!quiet)
+            printf("%6d %8d %4s %6s %8s %4s %11.4e %11.4e %11.4e %8.2f "
+                    "%7.1f %6.1f\n", r.c.num_stations, r.c.num_sources,
+                    r.c.precision == OSKAR_SINGLE ? "sp" : "dp",
+                    r.c.matrix ? "matrix" : "scalar",
+                    r.c.extended ? "gaussian" : "point",
+                    r.c.time_smearing ? "on" : "off", r.time_sec,
+                    r.vis_per_sec, r.source_baselines_per_sec, r.gflops,
+                    r.intensity, 100.0 * r.gflops / r.attainable_gflops);
+    }
+
+    // Write JSON output if required.
+    if (!json_file.empty())
+    {
+        FILE* f = json_file == "-" ? stdout : fopen(json_file.c_str(), "w");
+        if (!f)
+        {
+            fprintf(stderr, "ERROR: Unable to open %s\n", json_file.c_str());
+            return EXIT_FAILURE;
+        }
+        write_json(f, num_threads, peak_sp, peak_dp, bandwidth, results);
+        if (f != stdout) fclose(f);
+    }
+
+    return EXIT_SUCCESS;
+}
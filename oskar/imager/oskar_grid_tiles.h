@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OSKAR_GRID_TILES_H_
+#define OSKAR_GRID_TILES_H_
+
+/**
+ * @file oskar_grid_tiles.h
+ */
+
+#include <oskar_global.h>
+#include <mem/oskar_mem.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief
+ * Sorts visibilities into square tiles of the grid.
+ *
+ * @details
+ * Sorts visibilities into the tiles of the grid that their convolution
+ * kernels overlap, so that each tile can be updated independently of the
+ * others. Visibilities that overlap more than one tile are listed in
+ * each of them.
+ *
+ * The visibilities for each tile are listed in ascending order, so
+ * gridding them tile by tile adds contributions to each grid cell in the
+ * same order as gridding them one after another.
+ *
+ * Visibilities with a negative support size are ignored.
+ *
+ * @param[in] grid_size     Side length of grid.
+ * @param[in] tile_size     Side length of each tile.
+ * @param[in] num_threads   Number of threads to use.
+ * @param[in] num_points    Number of visibility points.
+ * @param[in] grid_u        Grid u-coordinate of each visibility.
+ * @param[in] grid_v        Grid v-coordinate of each visibility.
+ * @param[in] support       Kernel support size of each visibility.
+ * @param[out] tile_start   Integer array: start of each tile in
+ *                          \p tile_vis, length (number of tiles + 1).
+ * @param[out] tile_vis     Integer array: visibility indices for each tile.
+ * @param[in,out] status    Status return code.
+ */
+OSKAR_EXPORT
+void oskar_grid_tiles_bin(int grid_size, int tile_size, int num_threads,
+        size_t num_points, const int* restrict grid_u,
+        const int* restrict grid_v, const int* restrict support,
+        oskar_Mem* tile_start, oskar_Mem* tile_vis, int* status);
+
+/**
+ * @brief
+ * Returns the number of threads to use for tiled gridding.
+ *
+ * @details
+ * Returns the number of threads to use to grid the given number of
+ * visibilities, or 1 if they should be gridded one after another.
+ *
+ * @param[in] num_points    Number of visibility points.
+ */
+OSKAR_EXPORT
+int oskar_grid_tiles_num_threads(size_t num_points);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OSKAR_GRID_TILES_H_ */
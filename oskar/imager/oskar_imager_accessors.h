@@ -187,6 +187,20 @@ const char* oskar_imager_image_type(const oskar_Imager* h);
 OSKAR_EXPORT
 char* const* oskar_imager_input_files(const oskar_Imager* h);
 
+/**
+ * @brief
+ * Returns the maximum number of W-layers to hold in memory.
+ *
+ * @details
+ * Returns the maximum number of W-layers to hold in memory,
+ * used only for W-stacking.
+ * A value of 0 or less means 'automatic'.
+ *
+ * @param[in] h  Handle to imager.
+ */
+OSKAR_EXPORT
+int oskar_imager_max_w_layers_in_memory(const oskar_Imager* h);
+
 /**
  * @brief
  * Returns the Measurement Set column to use.
@@ -295,6 +309,7 @@ int oskar_imager_scale_norm_with_num_input_files(const oskar_Imager* h);
  * The \p type string can be:
  * - "FFT" to use standard gridding followed by a FFT.
  * - "W-projection" to use W-projection gridding followed by a FFT.
+ * - "W-stacking" to grid into W-layers, each followed by a FFT.
  * - "DFT 2D" to use a 2D Direct Fourier Transform, without gridding.
  * - "DFT 3D" to use a 3D Direct Fourier Transform, without gridding.
  *
@@ -342,7 +357,7 @@ void oskar_imager_set_channel_snapshots(oskar_Imager* h, int value);
  * Sets the imager to ignore visibility data and only update weights grids.
  *
  * @details
- * Use this method with uniform weighting or W-projection.
+ * Use this method with uniform weighting, W-projection or W-stacking.
  * The grids of weights can only be used once they are fully populated,
  * so this method puts the imager into a mode where it only updates its
  * internal weights grids when calling oskar_imager_update().
@@ -570,6 +585,24 @@ void oskar_imager_set_input_files(oskar_Imager* h, int num_files,
 OSKAR_EXPORT
 void oskar_imager_set_log(oskar_Imager* h, oskar_Log* log);
 
+/**
+ * @brief
+ * Sets the maximum number of W-layers to hold in memory.
+ *
+ * @details
+ * Sets the maximum number of W-layers to hold in memory,
+ * used only for W-stacking.
+ * If not all W-layers fit, oskar_imager_run() will read the input data
+ * more than once, gridding a different range of layers each time.
+ * A value of 0 or less means 'automatic', which limits the layers
+ * to half the physical memory.
+ *
+ * @param[in,out] h            Handle to imager.
+ * @param[in] value            Maximum number of W-layers to hold in memory.
+ */
+OSKAR_EXPORT
+void oskar_imager_set_max_w_layers_in_memory(oskar_Imager* h, int value);
+
 /**
  * @brief
  * Sets the data column to use from a Measurement Set.
@@ -758,7 +791,8 @@ void oskar_imager_set_vis_phase_centre(oskar_Imager* h,
  * Sets the number of W planes to use.
  *
  * @details
- * Sets the number of W planes, used only for W-projection.
+ * Sets the number of W planes, used for W-projection,
+ * or the number of W-layers, used for W-stacking.
  * A value of 0 or less means 'automatic'.
  *
  * @param[in,out] h            Handle to imager.
@@ -43,9 +43,16 @@ extern "C" {
 
 /**
  * @brief
- * Performs visibility amplitude phase rotation to a new phase centre.
+ * DEPRECATED. Performs visibility amplitude phase rotation to a new phase
+ * centre.
  *
  * @details
+ * @deprecated
+ * oskar_imager_update() now evaluates the phase rotation once per image
+ * channel and applies it to all polarisations, so it no longer calls this
+ * function. It is kept only for existing callers, such as the Python
+ * interface. Do not use this function in new code.
+ *
  * This function performs visibility amplitude phase rotation to a new phase
  * centre.
  *
@@ -26,13 +26,10 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
-#ifdef OSKAR_HAVE_CUDA
-#include <cufft.h>
-#endif
-
 #include <fitsio.h>
 #include <mem/oskar_mem.h>
 #include <log/oskar_log.h>
+#include <math/oskar_fft.h>
 #include <utility/oskar_thread.h>
 #include <utility/oskar_timer.h>
 
@@ -80,6 +77,8 @@ struct oskar_Imager
     /* Scratch data. */
     oskar_Mem *uu_im, *vv_im, *ww_im, *vis_im, *weight_im, *time_im;
     oskar_Mem *uu_tmp, *vv_tmp, *ww_tmp, *stokes, *weight_tmp;
+    oskar_Mem *sel_phasor; /* Shared by all pols. */
+    size_t *sel_index, *sel_pos, sel_capacity; /* Shared by all pols. */
     int coords_only; /* Set if doing a first pass for uniform weighting. */
     int num_planes; /* For each output channel and polarisation. */
     double *plane_norm, delta_l, delta_m, delta_n, M[9];
@@ -90,10 +89,8 @@ struct oskar_Imager
 
     /* FFT imager data. */
     int grid_size;
-    oskar_Mem *conv_func, *corr_func, *fftpack_wsave, *fftpack_work;
-#ifdef OSKAR_HAVE_CUDA
-    cufftHandle cufft_plan;
-#endif
+    oskar_Mem *conv_func, *corr_func;
+    oskar_FFT* fft;
 
     /* W-projection imager data. */
     size_t ww_points;
@@ -101,6 +98,13 @@ struct oskar_Imager
     double w_scale, ww_min, ww_max, ww_rms;
     oskar_Mem *w_kernels, *w_support;
 
+    /* W-stacking imager data. */
+    int max_w_layers_mem, num_w_layers_mem, w_layer_start;
+    double w_layer_min, w_layer_inc;
+    oskar_Mem *w_screen, *w_taper;
+    oskar_Mem *w_layer, *w_uu, *w_vv, *w_amp, *w_weight; /* Sorted by layer. */
+    size_t *w_layer_offset, *w_layer_fill;
+
     /* Memory allocated per GPU (array of DeviceData structures). */
     DeviceData* d;
 };
@@ -55,16 +55,16 @@ extern "C" {
  * @param[in,out] uu            Baseline uu coordinates, in wavelengths.
  * @param[in,out] vv            Baseline vv coordinates, in wavelengths.
  * @param[in,out] ww            Baseline ww coordinates, in wavelengths.
- * @param[in,out] amp           Baseline complex visibility amplitudes.
- * @param[in,out] weight        Baseline visibility weights.
+ * @param[in,out] index         Integer index of each visibility
+ *                              (compacted with the coordinates).
  * @param[in,out] time_centroid Time centroid values as MJD(UTC) _seconds_
  *                              (double precision).
  * @param[in,out] status        Status return code.
  */
 OSKAR_EXPORT
 void oskar_imager_filter_time(const oskar_Imager* h, size_t* num_vis,
-        oskar_Mem* uu, oskar_Mem* vv, oskar_Mem* ww, oskar_Mem* amp,
-        oskar_Mem* weight, oskar_Mem* time_centroid, int* status);
+        oskar_Mem* uu, oskar_Mem* vv, oskar_Mem* ww, size_t* index,
+        oskar_Mem* time_centroid, int* status);
 
 #ifdef __cplusplus
 }
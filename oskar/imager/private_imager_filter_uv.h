@@ -55,14 +55,14 @@ extern "C" {
  * @param[in,out] uu         Baseline uu coordinates, in wavelengths.
  * @param[in,out] vv         Baseline vv coordinates, in wavelengths.
  * @param[in,out] ww         Baseline ww coordinates, in wavelengths.
- * @param[in,out] amp        Baseline complex visibility amplitudes.
- * @param[in,out] weight     Baseline visibility weights.
+ * @param[in,out] index      Integer index of each visibility
+ *                           (compacted with the coordinates).
  * @param[in,out] status     Status return code.
  */
 OSKAR_EXPORT
 void oskar_imager_filter_uv(const oskar_Imager* h, size_t* num_vis,
-        oskar_Mem* uu, oskar_Mem* vv, oskar_Mem* ww, oskar_Mem* amp,
-        oskar_Mem* weight, int* status);
+        oskar_Mem* uu, oskar_Mem* vv, oskar_Mem* ww, size_t* index,
+        int* status);
 
 #ifdef __cplusplus
 }
@@ -26,8 +26,8 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
-#ifndef OSKAR_IMAGER_SELECT_DATA_H_
-#define OSKAR_IMAGER_SELECT_DATA_H_
+#ifndef OSKAR_IMAGER_SELECT_COORDS_H_
+#define OSKAR_IMAGER_SELECT_COORDS_H_
 
 #include <mem/oskar_mem.h>
 #include <stddef.h>
@@ -36,31 +36,33 @@
 extern "C" {
 #endif
 
-void oskar_imager_select_data(
+/*
+ * Selects the baseline coordinates (in wavelengths) and time centroids
+ * needed for one image channel. The index of each selected visibility in
+ * the channel-major input block (num_channels * row + channel) is written
+ * to index_out, so that the visibility data for each polarisation can be
+ * gathered later using oskar_imager_select_vis().
+ */
+void oskar_imager_select_coords(
         const oskar_Imager* h,
         size_t num_rows,
         int start_chan,
         int end_chan,
-        int num_pols,
         const oskar_Mem* uu_in,
         const oskar_Mem* vv_in,
         const oskar_Mem* ww_in,
-        const oskar_Mem* vis_in,
-        const oskar_Mem* weight_in,
         const oskar_Mem* time_in,
         double im_freq_hz,
-        int im_pol,
         size_t* num_out,
         oskar_Mem* uu_out,
         oskar_Mem* vv_out,
         oskar_Mem* ww_out,
-        oskar_Mem* vis_out,
-        oskar_Mem* weight_out,
         oskar_Mem* time_out,
+        size_t* index_out,
         int* status);
 
 #ifdef __cplusplus
 }
 #endif
 
-#endif /* OSKAR_IMAGER_SELECT_DATA_H_ */
+#endif /* OSKAR_IMAGER_SELECT_COORDS_H_ */
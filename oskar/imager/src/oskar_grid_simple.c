@@ -27,6 +27,7 @@
  */
 
 #include "imager/oskar_grid_simple.h"
+#include "imager/oskar_grid_tiles.h"
 #include <math.h>
 #include <stdlib.h>
 
@@ -37,6 +38,9 @@ extern "C" {
 #define D_SUPPORT 3
 #define D_OVERSAMPLE 100
 
+/* Side length of each tile of the grid updated by one thread. */
+#define TILE_SIZE 64
+
 static void oskar_grid_simple_default_d(
         const double* restrict conv_func,
         const size_t num_points,
@@ -175,6 +179,315 @@ static void oskar_grid_simple_default_f(
 }
 
 
+/* Grids visibilities in parallel, with each thread updating whole tiles of
+ * the grid. Contributions are added to each grid cell in the same order as
+ * by the serial version, so the result does not depend on the number of
+ * threads. */
+static int oskar_grid_simple_tiled_d(
+        const int support,
+        const int oversample,
+        const double* restrict conv_func,
+        const size_t num_points,
+        const double* restrict uu,
+        const double* restrict vv,
+        const double* restrict vis,
+        const double* restrict weight,
+        const double cell_size_rad,
+        const int grid_size,
+        const int num_threads,
+        size_t* restrict num_skipped,
+        double* restrict norm,
+        double* restrict grid)
+{
+    int i, t, status = 0, num_tiles_side, num_tiles;
+    int *grid_u, *grid_v, *off_u, *off_v, *supp;
+    const int *tile_start_, *tile_vis_;
+    double* sums;
+    oskar_Mem *tile_start, *tile_vis;
+    const int n = (int) num_points;
+    const int grid_centre = grid_size / 2;
+    const double grid_scale = grid_size * cell_size_rad;
+
+    /* Convert UV coordinates to grid coordinates and kernel offsets,
+     * and sum the kernel for each visibility. */
+    grid_u = (int*) malloc(num_points * sizeof(int));
+    grid_v = (int*) malloc(num_points * sizeof(int));
+    off_u  = (int*) malloc(num_points * sizeof(int));
+    off_v  = (int*) malloc(num_points * sizeof(int));
+    supp   = (int*) malloc(num_points * sizeof(int));
+    sums   = (double*) malloc(num_points * sizeof(double));
+    if (!grid_u || !grid_v || !off_u || !off_v || !supp || !sums)
+    {
+        free(grid_u);
+        free(grid_v);
+        free(off_u);
+        free(off_v);
+        free(supp);
+        free(sums);
+        return OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+    }
+#pragma omp parallel for private(i) num_threads(num_threads)
+    for (i = 0; i < n; ++i)
+    {
+        double sum = 0.0;
+        int j, k;
+        const double pos_u = -uu[i] * grid_scale;
+        const double pos_v = vv[i] * grid_scale;
+        grid_u[i] = (int)round(pos_u) + grid_centre;
+        grid_v[i] = (int)round(pos_v) + grid_centre;
+        off_u[i] = (int)round((round(pos_u) - pos_u) * oversample);
+        off_v[i] = (int)round((round(pos_v) - pos_v) * oversample);
+        supp[i] = support;
+        if (grid_u[i] + support >= grid_size || grid_u[i] - support < 0 ||
+                grid_v[i] + support >= grid_size || grid_v[i] - support < 0)
+        {
+            supp[i] = -1;
+            continue;
+        }
+        for (j = -support; j <= support; ++j)
+        {
+            const double c1 = conv_func[abs(off_v[i] + j * oversample)];
+            for (k = -support; k <= support; ++k)
+            {
+                const double c = conv_func[abs(off_u[i] + k * oversample)] * c1;
+                sum += c;
+            }
+        }
+        sums[i] = sum;
+    }
+
+    /* Sort visibilities into tiles. */
+    tile_start = oskar_mem_create(OSKAR_INT, OSKAR_CPU, 0, &status);
+    tile_vis = oskar_mem_create(OSKAR_INT, OSKAR_CPU, 0, &status);
+    oskar_grid_tiles_bin(grid_size, TILE_SIZE, num_threads, num_points,
+            grid_u, grid_v, supp, tile_start, tile_vis, &status);
+    if (!status)
+    {
+        /* Update the normalisation in the same order as the serial
+         * version. */
+        *num_skipped = 0;
+        for (i = 0; i < n; ++i)
+        {
+            if (supp[i] < 0)
+                *num_skipped += 1;
+            else
+                *norm += sums[i] * weight[i];
+        }
+
+        /* Convolve visibilities onto each tile of the grid. */
+        num_tiles_side = (grid_size + TILE_SIZE - 1) / TILE_SIZE;
+        num_tiles = num_tiles_side * num_tiles_side;
+        tile_start_ = oskar_mem_int_const(tile_start, &status);
+        tile_vis_ = oskar_mem_int_const(tile_vis, &status);
+#pragma omp parallel for private(t) schedule(dynamic, 1) \
+        num_threads(num_threads)
+        for (t = 0; t < num_tiles; ++t)
+        {
+            int m;
+            const int u0 = (t % num_tiles_side) * TILE_SIZE;
+            const int v0 = (t / num_tiles_side) * TILE_SIZE;
+            const int u1 = u0 + TILE_SIZE - 1;
+            const int v1 = v0 + TILE_SIZE - 1;
+            for (m = tile_start_[t]; m < tile_start_[t + 1]; ++m)
+            {
+                int j, k, j0, j1, k0, k1;
+                const int i_vis = tile_vis_[m];
+                const int gu = grid_u[i_vis], gv = grid_v[i_vis];
+                const int ou = off_u[i_vis], ov = off_v[i_vis];
+                const double weight_i = weight[i_vis];
+                const double v_re = weight_i * vis[2 * i_vis];
+                const double v_im = weight_i * vis[2 * i_vis + 1];
+
+                /* Clip the kernel to the tile. */
+                j0 = (v0 - gv > -support) ? v0 - gv : -support;
+                j1 = (v1 - gv < support) ? v1 - gv : support;
+                k0 = (u0 - gu > -support) ? u0 - gu : -support;
+                k1 = (u1 - gu < support) ? u1 - gu : support;
+                for (j = j0; j <= j1; ++j)
+                {
+                    size_t p1;
+                    const double c1 = conv_func[abs(ov + j * oversample)];
+                    p1 = gv + j;
+                    p1 *= grid_size; /* Tested to avoid int overflow. */
+                    p1 += gu;
+                    for (k = k0; k <= k1; ++k)
+                    {
+                        const size_t p = (p1 + k) << 1;
+                        const double c =
+                                conv_func[abs(ou + k * oversample)] * c1;
+                        grid[p]     += v_re * c;
+                        grid[p + 1] += v_im * c;
+                    }
+                }
+            }
+        }
+    }
+    oskar_mem_free(tile_start, &status);
+    oskar_mem_free(tile_vis, &status);
+    free(grid_u);
+    free(grid_v);
+    free(off_u);
+    free(off_v);
+    free(supp);
+    free(sums);
+    return status;
+}
+
+
+/* Grids visibilities in parallel, with each thread updating whole tiles of
+ * the grid. Contributions are added to each grid cell in the same order as
+ * by the serial version, so the result does not depend on the number of
+ * threads. */
+static int oskar_grid_simple_tiled_f(
+        const int support,
+        const int oversample,
+        const float* restrict conv_func,
+        const size_t num_points,
+        const float* restrict uu,
+        const float* restrict vv,
+        const float* restrict vis,
+        const float* restrict weight,
+        const float cell_size_rad,
+        const int grid_size,
+        const int num_threads,
+        size_t* restrict num_skipped,
+        double* restrict norm,
+        float* restrict grid)
+{
+    int i, t, status = 0, num_tiles_side, num_tiles;
+    int *grid_u, *grid_v, *off_u, *off_v, *supp;
+    const int *tile_start_, *tile_vis_;
+    double* sums;
+    oskar_Mem *tile_start, *tile_vis;
+    const int n = (int) num_points;
+    const int grid_centre = grid_size / 2;
+    const float grid_scale = grid_size * cell_size_rad;
+
+    /* Convert UV coordinates to grid coordinates and kernel offsets,
+     * and sum the kernel for each visibility. */
+    grid_u = (int*) malloc(num_points * sizeof(int));
+    grid_v = (int*) malloc(num_points * sizeof(int));
+    off_u  = (int*) malloc(num_points * sizeof(int));
+    off_v  = (int*) malloc(num_points * sizeof(int));
+    supp   = (int*) malloc(num_points * sizeof(int));
+    sums   = (double*) malloc(num_points * sizeof(double));
+    if (!grid_u || !grid_v || !off_u || !off_v || !supp || !sums)
+    {
+        free(grid_u);
+        free(grid_v);
+        free(off_u);
+        free(off_v);
+        free(supp);
+        free(sums);
+        return OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+    }
+#pragma omp parallel for private(i) num_threads(num_threads)
+    for (i = 0; i < n; ++i)
+    {
+        double sum = 0.0;
+        int j, k;
+        const float pos_u = -uu[i] * grid_scale;
+        const float pos_v = vv[i] * grid_scale;
+        grid_u[i] = (int)roundf(pos_u) + grid_centre;
+        grid_v[i] = (int)roundf(pos_v) + grid_centre;
+        off_u[i] = (int)roundf((roundf(pos_u) - pos_u) * oversample);
+        off_v[i] = (int)roundf((roundf(pos_v) - pos_v) * oversample);
+        supp[i] = support;
+        if (grid_u[i] + support >= grid_size || grid_u[i] - support < 0 ||
+                grid_v[i] + support >= grid_size || grid_v[i] - support < 0)
+        {
+            supp[i] = -1;
+            continue;
+        }
+        for (j = -support; j <= support; ++j)
+        {
+            const float c1 = conv_func[abs(off_v[i] + j * oversample)];
+            for (k = -support; k <= support; ++k)
+            {
+                const float c = conv_func[abs(off_u[i] + k * oversample)] * c1;
+                sum += c;
+            }
+        }
+        sums[i] = sum;
+    }
+
+    /* Sort visibilities into tiles. */
+    tile_start = oskar_mem_create(OSKAR_INT, OSKAR_CPU, 0, &status);
+    tile_vis = oskar_mem_create(OSKAR_INT, OSKAR_CPU, 0, &status);
+    oskar_grid_tiles_bin(grid_size, TILE_SIZE, num_threads, num_points,
+            grid_u, grid_v, supp, tile_start, tile_vis, &status);
+    if (!status)
+    {
+        /* Update the normalisation in the same order as the serial
+         * version. */
+        *num_skipped = 0;
+        for (i = 0; i < n; ++i)
+        {
+            if (supp[i] < 0)
+                *num_skipped += 1;
+            else
+                *norm += sums[i] * weight[i];
+        }
+
+        /* Convolve visibilities onto each tile of the grid. */
+        num_tiles_side = (grid_size + TILE_SIZE - 1) / TILE_SIZE;
+        num_tiles = num_tiles_side * num_tiles_side;
+        tile_start_ = oskar_mem_int_const(tile_start, &status);
+        tile_vis_ = oskar_mem_int_const(tile_vis, &status);
+#pragma omp parallel for private(t) schedule(dynamic, 1) \
+        num_threads(num_threads)
+        for (t = 0; t < num_tiles; ++t)
+        {
+            int m;
+            const int u0 = (t % num_tiles_side) * TILE_SIZE;
+            const int v0 = (t / num_tiles_side) * TILE_SIZE;
+            const int u1 = u0 + TILE_SIZE - 1;
+            const int v1 = v0 + TILE_SIZE - 1;
+            for (m = tile_start_[t]; m < tile_start_[t + 1]; ++m)
+            {
+                int j, k, j0, j1, k0, k1;
+                const int i_vis = tile_vis_[m];
+                const int gu = grid_u[i_vis], gv = grid_v[i_vis];
+                const int ou = off_u[i_vis], ov = off_v[i_vis];
+                const float weight_i = weight[i_vis];
+                const float v_re = weight_i * vis[2 * i_vis];
+                const float v_im = weight_i * vis[2 * i_vis + 1];
+
+                /* Clip the kernel to the tile. */
+                j0 = (v0 - gv > -support) ? v0 - gv : -support;
+                j1 = (v1 - gv < support) ? v1 - gv : support;
+                k0 = (u0 - gu > -support) ? u0 - gu : -support;
+                k1 = (u1 - gu < support) ? u1 - gu : support;
+                for (j = j0; j <= j1; ++j)
+                {
+                    size_t p1;
+                    const float c1 = conv_func[abs(ov + j * oversample)];
+                    p1 = gv + j;
+                    p1 *= grid_size; /* Tested to avoid int overflow. */
+                    p1 += gu;
+                    for (k = k0; k <= k1; ++k)
+                    {
+                        const size_t p = (p1 + k) << 1;
+                        const float c =
+                                conv_func[abs(ou + k * oversample)] * c1;
+                        grid[p]     += v_re * c;
+                        grid[p + 1] += v_im * c;
+                    }
+                }
+            }
+        }
+    }
+    oskar_mem_free(tile_start, &status);
+    oskar_mem_free(tile_vis, &status);
+    free(grid_u);
+    free(grid_v);
+    free(off_u);
+    free(off_v);
+    free(supp);
+    free(sums);
+    return status;
+}
+
 void oskar_grid_simple_d(
         const int support,
         const int oversample,
@@ -191,9 +504,17 @@ void oskar_grid_simple_d(
         double* restrict grid)
 {
     size_t i;
+    int num_threads;
     const int grid_centre = grid_size / 2;
     const double grid_scale = grid_size * cell_size_rad;
 
+    /* Grid in parallel if there are enough visibilities. */
+    num_threads = oskar_grid_tiles_num_threads(num_points);
+    if (num_threads > 1 && !oskar_grid_simple_tiled_d(support, oversample,
+            conv_func, num_points, uu, vv, vis, weight, cell_size_rad,
+            grid_size, num_threads, num_skipped, norm, grid))
+        return;
+
     /* Use slightly more efficient version for default parameters. */
     if (support == D_SUPPORT && oversample == D_OVERSAMPLE)
     {
@@ -270,9 +591,17 @@ void oskar_grid_simple_f(
         float* restrict grid)
 {
     size_t i;
+    int num_threads;
     const int grid_centre = grid_size / 2;
     const float grid_scale = grid_size * cell_size_rad;
 
+    /* Grid in parallel if there are enough visibilities. */
+    num_threads = oskar_grid_tiles_num_threads(num_points);
+    if (num_threads > 1 && !oskar_grid_simple_tiled_f(support, oversample,
+            conv_func, num_points, uu, vv, vis, weight, cell_size_rad,
+            grid_size, num_threads, num_skipped, norm, grid))
+        return;
+
     /* Use slightly more efficient version for default parameters. */
     if (support == D_SUPPORT && oversample == D_OVERSAMPLE)
     {
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "imager/oskar_grid_tiles.h"
+#include "math/oskar_prefix_sum.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Smallest number of visibilities worth gridding in parallel. */
+#define MIN_POINTS_PARALLEL 1024
+
+void oskar_grid_tiles_bin(int grid_size, int tile_size, int num_threads,
+        size_t num_points, const int* restrict grid_u,
+        const int* restrict grid_v, const int* restrict support,
+        oskar_Mem* tile_start, oskar_Mem* tile_vis, int* status)
+{
+    int i, r, num_tiles_side, num_tiles, num_bins, total, *offset_;
+    int *count_, *start_;
+    oskar_Mem *count, *offset;
+    if (*status) return;
+
+    /* The visibilities are split into one contiguous range per thread,
+     * and the visibilities in each range are counted for each tile.
+     * The exclusive prefix sum of the counts, ordered by tile and then by
+     * range, gives the position of each range in the output. */
+    num_tiles_side = (grid_size + tile_size - 1) / tile_size;
+    num_tiles = num_tiles_side * num_tiles_side;
+    num_bins = num_tiles * num_threads;
+    count = oskar_mem_create(OSKAR_INT, OSKAR_CPU, num_bins, status);
+    offset = oskar_mem_create(OSKAR_INT, OSKAR_CPU, num_bins, status);
+    oskar_mem_clear_contents(count, status);
+    if (*status)
+    {
+        oskar_mem_free(count, status);
+        oskar_mem_free(offset, status);
+        return;
+    }
+    count_ = oskar_mem_int(count, status);
+    offset_ = oskar_mem_int(offset, status);
+
+    /* The ranges are shared out by a loop rather than by thread ID, so
+     * all of them are counted even if fewer threads are available. */
+#pragma omp parallel for private(r) schedule(static, 1) num_threads(num_threads)
+    for (r = 0; r < num_threads; ++r)
+    {
+        int tu, tv;
+        size_t j;
+        const size_t start = (num_points * r) / num_threads;
+        const size_t end = (num_points * (r + 1)) / num_threads;
+        for (j = start; j < end; ++j)
+        {
+            const int s = support[j];
+            if (s < 0) continue;
+            for (tv = (grid_v[j] - s) / tile_size;
+                    tv <= (grid_v[j] + s) / tile_size; ++tv)
+                for (tu = (grid_u[j] - s) / tile_size;
+                        tu <= (grid_u[j] + s) / tile_size; ++tu)
+                    count_[(tv * num_tiles_side + tu) * num_threads + r]++;
+        }
+    }
+    oskar_prefix_sum(num_bins, count, offset, 0, 1, status);
+    total = offset_[num_bins - 1] + count_[num_bins - 1];
+
+    /* Store the start of each tile. */
+    oskar_mem_realloc(tile_start, num_tiles + 1, status);
+    if ((int)oskar_mem_length(tile_vis) < total)
+        oskar_mem_realloc(tile_vis, total, status);
+    if (!*status)
+    {
+        int* tile_vis_;
+        start_ = oskar_mem_int(tile_start, status);
+        tile_vis_ = oskar_mem_int(tile_vis, status);
+        for (i = 0; i < num_tiles; ++i)
+            start_[i] = offset_[i * num_threads];
+        start_[num_tiles] = total;
+
+        /* Write each range of visibilities again, in ascending order. */
+#pragma omp parallel for private(r) schedule(static, 1) num_threads(num_threads)
+        for (r = 0; r < num_threads; ++r)
+        {
+            int tu, tv;
+            size_t j;
+            const size_t start = (num_points * r) / num_threads;
+            const size_t end = (num_points * (r + 1)) / num_threads;
+            for (j = start; j < end; ++j)
+            {
+                const int s = support[j];
+                if (s < 0) continue;
+                for (tv = (grid_v[j] - s) / tile_size;
+                        tv <= (grid_v[j] + s) / tile_size; ++tv)
+                    for (tu = (grid_u[j] - s) / tile_size;
+                            tu <= (grid_u[j] + s) / tile_size; ++tu)
+                        tile_vis_[offset_[(tv * num_tiles_side + tu) *
+                                num_threads + r]++] = (int)j;
+            }
+        }
+    }
+    oskar_mem_free(count, status);
+    oskar_mem_free(offset, status);
+}
+
+int oskar_grid_tiles_num_threads(size_t num_points)
+{
+    int num_threads = 1;
+#ifdef _OPENMP
+    if (num_points >= MIN_POINTS_PARALLEL && !omp_in_parallel())
+        num_threads = omp_get_max_threads();
+#else
+    (void)num_points;
+#endif
+    return num_threads;
+}
+
+#ifdef __cplusplus
+}
+#endif
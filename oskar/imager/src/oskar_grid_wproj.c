@@ -27,6 +27,7 @@
  */
 
 #include "imager/oskar_grid_wproj.h"
+#include "imager/oskar_grid_tiles.h"
 #include <math.h>
 #include <stdlib.h>
 
@@ -34,6 +35,368 @@
 extern "C" {
 #endif
 
+/* Side length of each tile of the grid updated by one thread. */
+#define TILE_SIZE 64
+
+
+/* Grids visibilities in parallel, with each thread updating whole tiles of
+ * the grid. Contributions are added to each grid cell in the same order as
+ * by the serial version, so the result does not depend on the number of
+ * threads. */
+static int oskar_grid_wproj_tiled_d(
+        const size_t num_w_planes,
+        const int* restrict support,
+        const int oversample,
+        const int conv_size_half,
+        const double* restrict conv_func,
+        const size_t num_points,
+        const double* restrict uu,
+        const double* restrict vv,
+        const double* restrict ww,
+        const double* restrict vis,
+        const double* restrict weight,
+        const double cell_size_rad,
+        const double w_scale,
+        const int grid_size,
+        const int num_threads,
+        size_t* restrict num_skipped,
+        double* restrict norm,
+        double* restrict grid)
+{
+    int i, t, status = 0, num_tiles_side, num_tiles;
+    int *grid_u, *grid_v, *off_u, *off_v, *supp, *plane;
+    const int *tile_start_, *tile_vis_;
+    double* sums;
+    oskar_Mem *tile_start, *tile_vis;
+    const int n = (int) num_points;
+    const size_t kernel_dim = conv_size_half * conv_size_half;
+    const int grid_centre = grid_size / 2;
+    const double grid_scale = grid_size * cell_size_rad;
+
+    /* Convert UV coordinates to grid coordinates and kernel offsets,
+     * and sum the kernel for each visibility. */
+    grid_u = (int*) malloc(num_points * sizeof(int));
+    grid_v = (int*) malloc(num_points * sizeof(int));
+    off_u  = (int*) malloc(num_points * sizeof(int));
+    off_v  = (int*) malloc(num_points * sizeof(int));
+    supp   = (int*) malloc(num_points * sizeof(int));
+    plane  = (int*) malloc(num_points * sizeof(int));
+    sums   = (double*) malloc(num_points * sizeof(double));
+    if (!grid_u || !grid_v || !off_u || !off_v || !supp || !plane || !sums)
+    {
+        free(grid_u);
+        free(grid_v);
+        free(off_u);
+        free(off_v);
+        free(supp);
+        free(plane);
+        free(sums);
+        return OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+    }
+#pragma omp parallel for private(i) num_threads(num_threads)
+    for (i = 0; i < n; ++i)
+    {
+        double sum = 0.0;
+        int j, k, w_support;
+        size_t kernel_start;
+        const double pos_u = -uu[i] * grid_scale;
+        const double pos_v = vv[i] * grid_scale;
+        const size_t grid_w = (size_t)round(sqrt(fabs(ww[i] * w_scale)));
+        grid_u[i] = (int)round(pos_u) + grid_centre;
+        grid_v[i] = (int)round(pos_v) + grid_centre;
+        off_u[i] = (int)round((round(pos_u) - pos_u) * oversample);
+        off_v[i] = (int)round((round(pos_v) - pos_v) * oversample);
+        plane[i] = (int)(grid_w < num_w_planes ? grid_w : num_w_planes - 1);
+        w_support = support[plane[i]];
+        kernel_start = plane[i] * kernel_dim;
+        supp[i] = w_support;
+        if (grid_u[i] + w_support >= grid_size || grid_u[i] - w_support < 0 ||
+                grid_v[i] + w_support >= grid_size ||
+                grid_v[i] - w_support < 0)
+        {
+            supp[i] = -1;
+            continue;
+        }
+        for (j = -w_support; j <= w_support; ++j)
+        {
+            size_t t1;
+            t1 = abs(off_v[i] + j * oversample);
+            t1 *= conv_size_half;
+            t1 += kernel_start;
+            for (k = -w_support; k <= w_support; ++k)
+            {
+                const size_t p = (t1 + abs(off_u[i] + k * oversample)) << 1;
+                const double c_re = conv_func[p];
+                sum += c_re; /* Real part only. */
+            }
+        }
+        sums[i] = sum;
+    }
+
+    /* Sort visibilities into tiles. */
+    tile_start = oskar_mem_create(OSKAR_INT, OSKAR_CPU, 0, &status);
+    tile_vis = oskar_mem_create(OSKAR_INT, OSKAR_CPU, 0, &status);
+    oskar_grid_tiles_bin(grid_size, TILE_SIZE, num_threads, num_points,
+            grid_u, grid_v, supp, tile_start, tile_vis, &status);
+    if (!status)
+    {
+        /* Update the normalisation in the same order as the serial
+         * version. */
+        *num_skipped = 0;
+        for (i = 0; i < n; ++i)
+        {
+            if (supp[i] < 0)
+                *num_skipped += 1;
+            else
+                *norm += sums[i] * weight[i];
+        }
+
+        /* Convolve visibilities onto each tile of the grid. */
+        num_tiles_side = (grid_size + TILE_SIZE - 1) / TILE_SIZE;
+        num_tiles = num_tiles_side * num_tiles_side;
+        tile_start_ = oskar_mem_int_const(tile_start, &status);
+        tile_vis_ = oskar_mem_int_const(tile_vis, &status);
+#pragma omp parallel for private(t) schedule(dynamic, 1) \
+        num_threads(num_threads)
+        for (t = 0; t < num_tiles; ++t)
+        {
+            int m;
+            const int u0 = (t % num_tiles_side) * TILE_SIZE;
+            const int v0 = (t / num_tiles_side) * TILE_SIZE;
+            const int u1 = u0 + TILE_SIZE - 1;
+            const int v1 = v0 + TILE_SIZE - 1;
+            for (m = tile_start_[t]; m < tile_start_[t + 1]; ++m)
+            {
+                int j, k, j0, j1, k0, k1;
+                const int i_vis = tile_vis_[m];
+                const int gu = grid_u[i_vis], gv = grid_v[i_vis];
+                const int ou = off_u[i_vis], ov = off_v[i_vis];
+                const int w_support = supp[i_vis];
+                const size_t kernel_start = plane[i_vis] * kernel_dim;
+                const double conv_conj = (ww[i_vis] > 0.0) ? -1.0 : 1.0;
+                const double weight_i = weight[i_vis];
+                const double v_re = weight_i * vis[2 * i_vis];
+                const double v_im = weight_i * vis[2 * i_vis + 1];
+
+                /* Clip the kernel to the tile. */
+                j0 = (v0 - gv > -w_support) ? v0 - gv : -w_support;
+                j1 = (v1 - gv < w_support) ? v1 - gv : w_support;
+                k0 = (u0 - gu > -w_support) ? u0 - gu : -w_support;
+                k1 = (u1 - gu < w_support) ? u1 - gu : w_support;
+                for (j = j0; j <= j1; ++j)
+                {
+                    size_t p1, t1;
+                    p1 = gv + j;
+                    p1 *= grid_size; /* Tested to avoid int overflow. */
+                    p1 += gu;
+                    t1 = abs(ov + j * oversample);
+                    t1 *= conv_size_half;
+                    t1 += kernel_start;
+                    for (k = k0; k <= k1; ++k)
+                    {
+                        size_t p = (t1 + abs(ou + k * oversample)) << 1;
+                        const double c_re = conv_func[p];
+                        const double c_im = conv_func[p + 1] * conv_conj;
+                        p = (p1 + k) << 1;
+                        grid[p]     += (v_re * c_re - v_im * c_im);
+                        grid[p + 1] += (v_im * c_re + v_re * c_im);
+                    }
+                }
+            }
+        }
+    }
+    oskar_mem_free(tile_start, &status);
+    oskar_mem_free(tile_vis, &status);
+    free(grid_u);
+    free(grid_v);
+    free(off_u);
+    free(off_v);
+    free(supp);
+    free(plane);
+    free(sums);
+    return status;
+}
+
+
+/* Grids visibilities in parallel, with each thread updating whole tiles of
+ * the grid. Contributions are added to each grid cell in the same order as
+ * by the serial version, so the result does not depend on the number of
+ * threads. */
+static int oskar_grid_wproj_tiled_f(
+        const size_t num_w_planes,
+        const int* restrict support,
+        const int oversample,
+        const int conv_size_half,
+        const float* restrict conv_func,
+        const size_t num_points,
+        const float* restrict uu,
+        const float* restrict vv,
+        const float* restrict ww,
+        const float* restrict vis,
+        const float* restrict weight,
+        const float cell_size_rad,
+        const float w_scale,
+        const int grid_size,
+        const int num_threads,
+        size_t* restrict num_skipped,
+        double* restrict norm,
+        float* restrict grid)
+{
+    int i, t, status = 0, num_tiles_side, num_tiles;
+    int *grid_u, *grid_v, *off_u, *off_v, *supp, *plane;
+    const int *tile_start_, *tile_vis_;
+    double* sums;
+    oskar_Mem *tile_start, *tile_vis;
+    const int n = (int) num_points;
+    const size_t kernel_dim = conv_size_half * conv_size_half;
+    const int grid_centre = grid_size / 2;
+    const float grid_scale = grid_size * cell_size_rad;
+
+    /* Convert UV coordinates to grid coordinates and kernel offsets,
+     * and sum the kernel for each visibility. */
+    grid_u = (int*) malloc(num_points * sizeof(int));
+    grid_v = (int*) malloc(num_points * sizeof(int));
+    off_u  = (int*) malloc(num_points * sizeof(int));
+    off_v  = (int*) malloc(num_points * sizeof(int));
+    supp   = (int*) malloc(num_points * sizeof(int));
+    plane  = (int*) malloc(num_points * sizeof(int));
+    sums   = (double*) malloc(num_points * sizeof(double));
+    if (!grid_u || !grid_v || !off_u || !off_v || !supp || !plane || !sums)
+    {
+        free(grid_u);
+        free(grid_v);
+        free(off_u);
+        free(off_v);
+        free(supp);
+        free(plane);
+        free(sums);
+        return OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+    }
+#pragma omp parallel for private(i) num_threads(num_threads)
+    for (i = 0; i < n; ++i)
+    {
+        double sum = 0.0;
+        int j, k, w_support;
+        size_t kernel_start;
+        const float pos_u = -uu[i] * grid_scale;
+        const float pos_v = vv[i] * grid_scale;
+        const size_t grid_w = (size_t)roundf(sqrtf(fabsf(ww[i] * w_scale)));
+        grid_u[i] = (int)roundf(pos_u) + grid_centre;
+        grid_v[i] = (int)roundf(pos_v) + grid_centre;
+        off_u[i] = (int)roundf((roundf(pos_u) - pos_u) * oversample);
+        off_v[i] = (int)roundf((roundf(pos_v) - pos_v) * oversample);
+        plane[i] = (int)(grid_w < num_w_planes ? grid_w : num_w_planes - 1);
+        w_support = support[plane[i]];
+        kernel_start = plane[i] * kernel_dim;
+        supp[i] = w_support;
+        if (grid_u[i] + w_support >= grid_size || grid_u[i] - w_support < 0 ||
+                grid_v[i] + w_support >= grid_size ||
+                grid_v[i] - w_support < 0)
+        {
+            supp[i] = -1;
+            continue;
+        }
+        for (j = -w_support; j <= w_support; ++j)
+        {
+            size_t t1;
+            t1 = abs(off_v[i] + j * oversample);
+            t1 *= conv_size_half;
+            t1 += kernel_start;
+            for (k = -w_support; k <= w_support; ++k)
+            {
+                const size_t p = (t1 + abs(off_u[i] + k * oversample)) << 1;
+                const float c_re = conv_func[p];
+                sum += c_re; /* Real part only. */
+            }
+        }
+        sums[i] = sum;
+    }
+
+    /* Sort visibilities into tiles. */
+    tile_start = oskar_mem_create(OSKAR_INT, OSKAR_CPU, 0, &status);
+    tile_vis = oskar_mem_create(OSKAR_INT, OSKAR_CPU, 0, &status);
+    oskar_grid_tiles_bin(grid_size, TILE_SIZE, num_threads, num_points,
+            grid_u, grid_v, supp, tile_start, tile_vis, &status);
+    if (!status)
+    {
+        /* Update the normalisation in the same order as the serial
+         * version. */
+        *num_skipped = 0;
+        for (i = 0; i < n; ++i)
+        {
+            if (supp[i] < 0)
+                *num_skipped += 1;
+            else
+                *norm += sums[i] * weight[i];
+        }
+
+        /* Convolve visibilities onto each tile of the grid. */
+        num_tiles_side = (grid_size + TILE_SIZE - 1) / TILE_SIZE;
+        num_tiles = num_tiles_side * num_tiles_side;
+        tile_start_ = oskar_mem_int_const(tile_start, &status);
+        tile_vis_ = oskar_mem_int_const(tile_vis, &status);
+#pragma omp parallel for private(t) schedule(dynamic, 1) \
+        num_threads(num_threads)
+        for (t = 0; t < num_tiles; ++t)
+        {
+            int m;
+            const int u0 = (t % num_tiles_side) * TILE_SIZE;
+            const int v0 = (t / num_tiles_side) * TILE_SIZE;
+            const int u1 = u0 + TILE_SIZE - 1;
+            const int v1 = v0 + TILE_SIZE - 1;
+            for (m = tile_start_[t]; m < tile_start_[t + 1]; ++m)
+            {
+                int j, k, j0, j1, k0, k1;
+                const int i_vis = tile_vis_[m];
+                const int gu = grid_u[i_vis], gv = grid_v[i_vis];
+                const int ou = off_u[i_vis], ov = off_v[i_vis];
+                const int w_support = supp[i_vis];
+                const size_t kernel_start = plane[i_vis] * kernel_dim;
+                const float conv_conj = (ww[i_vis] > 0.0f) ? -1.0f : 1.0f;
+                const float weight_i = weight[i_vis];
+                const float v_re = weight_i * vis[2 * i_vis];
+                const float v_im = weight_i * vis[2 * i_vis + 1];
+
+                /* Clip the kernel to the tile. */
+                j0 = (v0 - gv > -w_support) ? v0 - gv : -w_support;
+                j1 = (v1 - gv < w_support) ? v1 - gv : w_support;
+                k0 = (u0 - gu > -w_support) ? u0 - gu : -w_support;
+                k1 = (u1 - gu < w_support) ? u1 - gu : w_support;
+                for (j = j0; j <= j1; ++j)
+                {
+                    size_t p1, t1;
+                    p1 = gv + j;
+                    p1 *= grid_size; /* Tested to avoid int overflow. */
+                    p1 += gu;
+                    t1 = abs(ov + j * oversample);
+                    t1 *= conv_size_half;
+                    t1 += kernel_start;
+                    for (k = k0; k <= k1; ++k)
+                    {
+                        size_t p = (t1 + abs(ou + k * oversample)) << 1;
+                        const float c_re = conv_func[p];
+                        const float c_im = conv_func[p + 1] * conv_conj;
+                        p = (p1 + k) << 1;
+                        grid[p]     += (v_re * c_re - v_im * c_im);
+                        grid[p + 1] += (v_im * c_re + v_re * c_im);
+                    }
+                }
+            }
+        }
+    }
+    oskar_mem_free(tile_start, &status);
+    oskar_mem_free(tile_vis, &status);
+    free(grid_u);
+    free(grid_v);
+    free(off_u);
+    free(off_v);
+    free(supp);
+    free(plane);
+    free(sums);
+    return status;
+}
+
+
 void oskar_grid_wproj_d(
         const size_t num_w_planes,
         const int* restrict support,
@@ -54,10 +417,19 @@ void oskar_grid_wproj_d(
         double* restrict grid)
 {
     size_t i;
+    int num_threads;
     const size_t kernel_dim = conv_size_half * conv_size_half;
     const int grid_centre = grid_size / 2;
     const double grid_scale = grid_size * cell_size_rad;
 
+    /* Grid in parallel if there are enough visibilities. */
+    num_threads = oskar_grid_tiles_num_threads(num_points);
+    if (num_threads > 1 && !oskar_grid_wproj_tiled_d(num_w_planes,
+            support, oversample, conv_size_half, conv_func, num_points,
+            uu, vv, ww, vis, weight, cell_size_rad, w_scale, grid_size,
+            num_threads, num_skipped, norm, grid))
+        return;
+
     /* Loop over visibilities. */
     *num_skipped = 0;
     for (i = 0; i < num_points; ++i)
@@ -143,10 +515,19 @@ void oskar_grid_wproj_f(
         float* restrict grid)
 {
     size_t i;
+    int num_threads;
     const size_t kernel_dim = conv_size_half * conv_size_half;
     const int grid_centre = grid_size / 2;
     const float grid_scale = grid_size * cell_size_rad;
 
+    /* Grid in parallel if there are enough visibilities. */
+    num_threads = oskar_grid_tiles_num_threads(num_points);
+    if (num_threads > 1 && !oskar_grid_wproj_tiled_f(num_w_planes,
+            support, oversample, conv_size_half, conv_func, num_points,
+            uu, vv, ww, vis, weight, cell_size_rad, w_scale, grid_size,
+            num_threads, num_skipped, norm, grid))
+        return;
+
     /* Loop over visibilities. */
     *num_skipped = 0;
     for (i = 0; i < num_points; ++i)
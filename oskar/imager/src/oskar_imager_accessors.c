@@ -57,6 +57,7 @@ const char* oskar_imager_algorithm(const oskar_Imager* h)
     case OSKAR_ALGORITHM_WPROJ:  return "W-projection";
     case OSKAR_ALGORITHM_DFT_2D: return "DFT 2D";
     case OSKAR_ALGORITHM_DFT_3D: return "DFT 3D";
+    case OSKAR_ALGORITHM_WSTACK: return "W-stacking";
     default:                     return "";
     }
 }
@@ -142,6 +143,12 @@ char* const* oskar_imager_input_files(const oskar_Imager* h)
 }
 
 
+int oskar_imager_max_w_layers_in_memory(const oskar_Imager* h)
+{
+    return h->max_w_layers_mem;
+}
+
+
 const char* oskar_imager_ms_column(const oskar_Imager* h)
 {
     return h->ms_column;
@@ -176,7 +183,8 @@ int oskar_imager_plane_size(oskar_Imager* h)
 {
     if (h->grid_size == 0)
     {
-        if (h->algorithm == OSKAR_ALGORITHM_WPROJ)
+        if (h->algorithm == OSKAR_ALGORITHM_WPROJ ||
+                h->algorithm == OSKAR_ALGORITHM_WSTACK)
         {
             (void) oskar_imager_composite_nearest_even(h->image_padding *
                     ((double)(h->image_size)) - 0.5, 0, &h->grid_size);
@@ -227,6 +235,15 @@ void oskar_imager_set_algorithm(oskar_Imager* h, const char* type,
         h->support = 3;
         h->oversample = 100;
     }
+    else if (!strncmp(type, "W-S", 3) || !strncmp(type, "w-s", 3) ||
+            !strncmp(type, "W-s", 3))
+    {
+        h->algorithm = OSKAR_ALGORITHM_WSTACK;
+        h->kernel_type = 'S';
+        h->support = 3;
+        h->oversample = 100;
+        h->image_padding = 1.2;
+    }
     else if (!strncmp(type, "W", 1) || !strncmp(type, "w", 1))
     {
         h->algorithm = OSKAR_ALGORITHM_WPROJ;
@@ -282,7 +299,8 @@ void oskar_imager_set_coords_only(oskar_Imager* h, int flag)
             h->ww_rms = sqrt(h->ww_rms / h->ww_points);
 
         /* Calculate required number of w-planes if not set. */
-        if ((h->ww_max > 0.0) && (h->num_w_planes < 1))
+        if ((h->ww_max > 0.0) && (h->num_w_planes < 1) &&
+                h->algorithm == OSKAR_ALGORITHM_WPROJ)
         {
             double max_uvw, ww_mid;
             max_uvw = 1.05 * h->ww_max;
@@ -494,6 +512,12 @@ void oskar_imager_set_log(oskar_Imager* h, oskar_Log* log)
 }
 
 
+void oskar_imager_set_max_w_layers_in_memory(oskar_Imager* h, int value)
+{
+    h->max_w_layers_mem = value;
+}
+
+
 void oskar_imager_set_ms_column(oskar_Imager* h, const char* column,
         int* status)
 {
@@ -26,18 +26,14 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
-#ifdef OSKAR_HAVE_CUDA
-#include <cufft.h>
-#endif
-
 #include "imager/private_imager.h"
 #include "imager/oskar_imager.h"
 
 #include "imager/oskar_grid_correction.h"
 #include "imager/oskar_grid_functions_pillbox.h"
 #include "imager/oskar_grid_functions_spheroidal.h"
-#include "math/oskar_fftpack_cfft.h"
-#include "math/oskar_fftpack_cfft_f.h"
+#include "imager/private_imager_flush_w_layers.h"
+#include "imager/private_imager_generate_w_phase_screen.h"
 #include "math/oskar_fftphase.h"
 #include "mem/oskar_mem.h"
 #include "utility/oskar_device_utils.h"
@@ -52,6 +48,12 @@
 extern "C" {
 #endif
 
+static void add_screened_d(int n, const double2* restrict layer,
+        const double2* restrict screen, double2* restrict image);
+static void add_screened_f(int n, const float2* restrict layer,
+        const float2* restrict screen, float2* restrict image);
+static void fft_grid(oskar_Imager* h, oskar_Mem* grid, int* status);
+static int is_zero(const oskar_Mem* mem, int* status);
 static void write_plane(oskar_Imager* h, oskar_Mem* plane,
         int c, int p, int* status);
 
@@ -201,84 +203,32 @@ void oskar_imager_finalise_plane(oskar_Imager* h,
         return;
     }
 
-    /* Check plane size is as expected. */
+    /* Check plane size is as expected.
+     * If using W-stacking, transform any remaining W-layers, and keep only
+     * the accumulated image at the start of the plane. */
     size = oskar_imager_plane_size(h);
     num_cells = size * size;
-    if (oskar_mem_length(plane) != num_cells)
-    {
-        *status = OSKAR_ERR_DIMENSION_MISMATCH;
-        return;
-    }
-
-    /* Perform FFT shift of the input grid. */
     oskar_timer_resume(h->tmr_grid_finalise);
-    if (oskar_mem_precision(plane) == OSKAR_DOUBLE)
-        oskar_fftphase_cd(size, size, oskar_mem_double(plane, status));
-    else
-        oskar_fftphase_cf(size, size, oskar_mem_float(plane, status));
-
-    /* Call FFT. */
-#ifdef OSKAR_HAVE_CUDA
-    if (h->fft_on_gpu && h->num_gpus > 0)
+    if (h->algorithm == OSKAR_ALGORITHM_WSTACK)
     {
-        size_t work_size = 0;
-        oskar_Mem *plane_gpu = 0, *plane_ptr = 0;
-        oskar_device_set(h->gpu_ids[0], status);
-        if (cufftGetSize(h->cufft_plan, &work_size) != CUFFT_SUCCESS)
-            cufftPlan2d(&h->cufft_plan, size, size,
-                    (h->imager_prec == OSKAR_DOUBLE) ? CUFFT_Z2Z : CUFFT_C2C);
-        plane_ptr = plane;
-        if (oskar_mem_location(plane) != OSKAR_GPU)
-        {
-            plane_gpu = oskar_mem_create_copy(plane, OSKAR_GPU, status);
-            plane_ptr = plane_gpu;
-        }
-        if (h->imager_prec == OSKAR_DOUBLE)
-            cufftExecZ2Z(h->cufft_plan, oskar_mem_void(plane_ptr),
-                    oskar_mem_void(plane_ptr), CUFFT_FORWARD);
-        else
-            cufftExecC2C(h->cufft_plan, oskar_mem_void(plane_ptr),
-                    oskar_mem_void(plane_ptr), CUFFT_FORWARD);
-        if (oskar_mem_location(plane) != OSKAR_GPU)
-            oskar_mem_copy(plane, plane_ptr, status);
-        oskar_mem_free(plane_gpu, status);
+        oskar_imager_flush_w_layers(h, plane, status);
+        oskar_mem_realloc(plane, num_cells, status);
     }
+    else if (oskar_mem_length(plane) != num_cells)
+        *status = OSKAR_ERR_DIMENSION_MISMATCH;
     else
-#endif
+        fft_grid(h, plane, status);
+    if (*status)
     {
-        if (!h->fftpack_work)
-            h->fftpack_work = oskar_mem_create(h->imager_prec, OSKAR_CPU,
-                    2 * num_cells, status);
-        if (!h->fftpack_wsave)
-        {
-            int len = 4 * size + 2 * (int)(log((double)size) / log(2.0)) + 8;
-            h->fftpack_wsave = oskar_mem_create(h->imager_prec, OSKAR_CPU,
-                    len, status);
-            if (h->imager_prec == OSKAR_DOUBLE)
-                oskar_fftpack_cfft2i(size, size,
-                        oskar_mem_double(h->fftpack_wsave, status));
-            else
-                oskar_fftpack_cfft2i_f(size, size,
-                        oskar_mem_float(h->fftpack_wsave, status));
-        }
-        if (h->imager_prec == OSKAR_DOUBLE)
-            oskar_fftpack_cfft2f(size, size, size,
-                    oskar_mem_double(plane, status),
-                    oskar_mem_double(h->fftpack_wsave, status),
-                    oskar_mem_double(h->fftpack_work, status));
-        else
-            oskar_fftpack_cfft2f_f(size, size, size,
-                    oskar_mem_float(plane, status),
-                    oskar_mem_float(h->fftpack_wsave, status),
-                    oskar_mem_float(h->fftpack_work, status));
-        oskar_mem_scale_real(plane, (double)num_cells, status);
+        oskar_timer_pause(h->tmr_grid_finalise);
+        return;
     }
 
     /* Generate grid correction function if required. */
     if (!h->corr_func)
     {
         h->corr_func = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, size, status);
-        if (h->algorithm != OSKAR_ALGORITHM_FFT)
+        if (h->algorithm == OSKAR_ALGORITHM_WPROJ)
             oskar_grid_correction_function_spheroidal(size, h->oversample,
                     oskar_mem_double(h->corr_func, status));
         else
@@ -356,6 +306,170 @@ void oskar_imager_trim_image(oskar_Imager* h, oskar_Mem* plane,
 }
 
 
+void oskar_imager_flush_w_layers(oskar_Imager* h, oskar_Mem* plane,
+        int* status)
+{
+    int i_layer, iy, size, half;
+    size_t num_cells;
+    oskar_Mem *image, *layer;
+    if (*status) return;
+
+    /* Return if there are no W-layers in the plane. */
+    size = oskar_imager_plane_size(h);
+    half = size / 2;
+    num_cells = size * size;
+    if (oskar_mem_length(plane) < (1 + h->num_w_layers_mem) * num_cells)
+        return;
+
+    /* Create the taper and the phase screen if required. */
+    if (!h->w_taper)
+    {
+        h->w_taper = oskar_mem_create(h->imager_prec, OSKAR_CPU,
+                size, status);
+        oskar_mem_set_value_real(h->w_taper, 1.0, 0, size, status);
+    }
+    if (!h->w_screen)
+        h->w_screen = oskar_mem_create(h->imager_prec | OSKAR_COMPLEX,
+                OSKAR_CPU, num_cells, status);
+
+    /* Transform each layer, apply its W-screen, and add it to the image.
+     * The screen is generated with its centre in the first pixel,
+     * so it is shifted to match the image: each row is split into two
+     * contiguous spans at the point where the shifted index wraps. */
+    image = oskar_mem_create_alias(plane, 0, num_cells, status);
+    layer = oskar_mem_create_alias(0, 0, 0, status);
+    for (i_layer = 0; i_layer < h->num_w_layers_mem; ++i_layer)
+    {
+        double w;
+        if (*status) break;
+        if (h->w_layer_start + i_layer >= h->num_w_planes) break;
+        oskar_mem_set_alias(layer, plane, (1 + i_layer) * num_cells,
+                num_cells, status);
+        if (is_zero(layer, status)) continue;
+        fft_grid(h, layer, status);
+        w = h->w_layer_min +
+                (h->w_layer_start + i_layer + 0.5) * h->w_layer_inc;
+        oskar_imager_generate_w_phase_screen(w != 0.0 ? 1 : 0, size, size,
+                fabs(h->cellsize_rad), w != 0.0 ? -1.0 / w : 1.0,
+                h->w_taper, h->w_screen, status);
+        if (*status) break;
+        if (h->imager_prec == OSKAR_DOUBLE)
+        {
+            double2 *img, *lyr;
+            const double2* scr;
+            img = oskar_mem_double2(image, status);
+            lyr = oskar_mem_double2(layer, status);
+            scr = oskar_mem_double2_const(h->w_screen, status);
+#pragma omp parallel for private(iy)
+            for (iy = 0; iy < size; ++iy)
+            {
+                const size_t row_in = ((iy + half) % size) * size;
+                const size_t row_out = iy * size;
+                add_screened_d(size - half, lyr + row_out,
+                        scr + row_in + half, img + row_out);
+                add_screened_d(half, lyr + row_out + size - half,
+                        scr + row_in, img + row_out + size - half);
+            }
+        }
+        else
+        {
+            float2 *img, *lyr;
+            const float2* scr;
+            img = oskar_mem_float2(image, status);
+            lyr = oskar_mem_float2(layer, status);
+            scr = oskar_mem_float2_const(h->w_screen, status);
+#pragma omp parallel for private(iy)
+            for (iy = 0; iy < size; ++iy)
+            {
+                const size_t row_in = ((iy + half) % size) * size;
+                const size_t row_out = iy * size;
+                add_screened_f(size - half, lyr + row_out,
+                        scr + row_in + half, img + row_out);
+                add_screened_f(half, lyr + row_out + size - half,
+                        scr + row_in, img + row_out + size - half);
+            }
+        }
+        oskar_mem_clear_contents(layer, status);
+    }
+    oskar_mem_free(image, status);
+    oskar_mem_free(layer, status);
+}
+
+
+void add_screened_d(int n, const double2* restrict layer,
+        const double2* restrict screen, double2* restrict image)
+{
+    int i;
+    for (i = 0; i < n; ++i)
+    {
+        const double2 a = layer[i], b = screen[i];
+        image[i].x += a.x * b.x - a.y * b.y;
+        image[i].y += a.x * b.y + a.y * b.x;
+    }
+}
+
+
+void add_screened_f(int n, const float2* restrict layer,
+        const float2* restrict screen, float2* restrict image)
+{
+    int i;
+    for (i = 0; i < n; ++i)
+    {
+        const float2 a = layer[i], b = screen[i];
+        image[i].x += a.x * b.x - a.y * b.y;
+        image[i].y += a.x * b.y + a.y * b.x;
+    }
+}
+
+
+int is_zero(const oskar_Mem* mem, int* status)
+{
+    size_t i, n;
+    n = oskar_mem_length(mem);
+    if (oskar_mem_is_complex(mem)) n *= 2;
+    if (oskar_mem_precision(mem) == OSKAR_DOUBLE)
+    {
+        const double* p = oskar_mem_double_const(mem, status);
+        for (i = 0; i < n; ++i) if (p[i] != 0.0) return 0;
+    }
+    else
+    {
+        const float* p = oskar_mem_float_const(mem, status);
+        for (i = 0; i < n; ++i) if (p[i] != 0.0f) return 0;
+    }
+    return 1;
+}
+
+
+void fft_grid(oskar_Imager* h, oskar_Mem* grid, int* status)
+{
+    const int size = oskar_imager_plane_size(h);
+    if (*status) return;
+
+    /* Perform FFT shift of the input grid. */
+    if (oskar_mem_precision(grid) == OSKAR_DOUBLE)
+        oskar_fftphase_cd(size, size, oskar_mem_double(grid, status));
+    else
+        oskar_fftphase_cf(size, size, oskar_mem_float(grid, status));
+
+    /* Create the FFT plan if required, and call FFT. */
+    if (h->fft && oskar_fft_grid_size(h->fft) != size)
+    {
+        oskar_fft_free(h->fft);
+        h->fft = 0;
+    }
+    if (h->fft_on_gpu && h->num_gpus > 0)
+    {
+        oskar_device_set(h->gpu_ids[0], status);
+        if (!h->fft)
+            h->fft = oskar_fft_create(h->imager_prec, OSKAR_GPU, size, status);
+    }
+    else if (!h->fft)
+        h->fft = oskar_fft_create(h->imager_prec, OSKAR_CPU, size, status);
+    oskar_fft_exec(h->fft, grid, status);
+}
+
+
 void write_plane(oskar_Imager* h, oskar_Mem* plane,
         int c, int p, int* status)
 {
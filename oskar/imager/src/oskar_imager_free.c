@@ -54,6 +54,7 @@ void oskar_imager_free(oskar_Imager* h, int* status)
     oskar_mem_free(h->weight_im, status);
     oskar_mem_free(h->weight_tmp, status);
     oskar_mem_free(h->time_im, status);
+    oskar_mem_free(h->sel_phasor, status);
     oskar_timer_free(h->tmr_grid_finalise);
     oskar_timer_free(h->tmr_grid_update);
     oskar_timer_free(h->tmr_init);
@@ -26,10 +26,6 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
-#ifdef OSKAR_HAVE_CUDA
-#include <cufft.h>
-#endif
-
 #include "imager/private_imager.h"
 #include "imager/oskar_imager_reset_cache.h"
 #include <fitsio.h>
@@ -54,15 +50,9 @@ void oskar_imager_reset_cache(oskar_Imager* h, int* status)
 
     /* Clear FFT caches. */
     oskar_mem_free(h->corr_func, status);
-    oskar_mem_free(h->fftpack_wsave, status);
-    oskar_mem_free(h->fftpack_work, status);
-#ifdef OSKAR_HAVE_CUDA
-    cufftDestroy(h->cufft_plan);
-    h->cufft_plan = 0;
-#endif
+    oskar_fft_free(h->fft);
     h->corr_func = 0;
-    h->fftpack_wsave = 0;
-    h->fftpack_work = 0;
+    h->fft = 0;
 
     /* Clear algorithm-specific caches. */
     oskar_mem_free(h->l, status); h->l = 0;
@@ -71,6 +61,20 @@ void oskar_imager_reset_cache(oskar_Imager* h, int* status)
     oskar_mem_free(h->conv_func, status); h->conv_func = 0;
     oskar_mem_free(h->w_kernels, status); h->w_kernels = 0;
     oskar_mem_free(h->w_support, status); h->w_support = 0;
+    oskar_mem_free(h->w_screen, status); h->w_screen = 0;
+    oskar_mem_free(h->w_taper, status); h->w_taper = 0;
+    oskar_mem_free(h->w_layer, status); h->w_layer = 0;
+    oskar_mem_free(h->w_uu, status); h->w_uu = 0;
+    oskar_mem_free(h->w_vv, status); h->w_vv = 0;
+    oskar_mem_free(h->w_amp, status); h->w_amp = 0;
+    oskar_mem_free(h->w_weight, status); h->w_weight = 0;
+    free(h->w_layer_offset); h->w_layer_offset = 0;
+    free(h->w_layer_fill); h->w_layer_fill = 0;
+    free(h->sel_index); h->sel_index = 0;
+    free(h->sel_pos); h->sel_pos = 0;
+    h->sel_capacity = 0;
+    h->num_w_layers_mem = 0;
+    h->w_layer_start = 0;
 
     /* Free the image planes. */
     if (h->planes)
@@ -99,6 +103,7 @@ void oskar_imager_reset_cache(oskar_Imager* h, int* status)
     oskar_mem_realloc(h->weight_im, 0, status);
     oskar_mem_realloc(h->weight_tmp, 0, status);
     oskar_mem_realloc(h->time_im, 0, status);
+    oskar_mem_realloc(h->sel_phasor, 0, status);
     oskar_mem_free(h->stokes, status);
     h->stokes = 0;
 
@@ -27,10 +27,13 @@
  */
 
 #include "imager/private_imager.h"
+#include "imager/private_imager_flush_w_layers.h"
 #include "imager/private_imager_read_coords.h"
 #include "imager/private_imager_read_data.h"
 #include "imager/private_imager_read_dims.h"
+#include "imager/private_imager_set_num_planes.h"
 #include "imager/oskar_imager.h"
+#include "utility/oskar_get_memory_usage.h"
 
 #include <stdlib.h>
 #include <string.h>
@@ -40,12 +43,13 @@ extern "C" {
 #endif
 
 static int oskar_imager_is_ms(const char* filename);
+static int oskar_imager_num_w_passes(oskar_Imager* h, int* status);
 
 void oskar_imager_run(oskar_Imager* h,
         int num_output_images, oskar_Mem** output_images,
         int num_output_grids, oskar_Mem** output_grids, int* status)
 {
-    int i, num_files, percent_done = 0, percent_next = 10;
+    int i, num_files, num_passes, pass, percent_done = 0, percent_next = 10;
     const char* filename;
     if (*status) return;
 
@@ -102,7 +106,8 @@ void oskar_imager_run(oskar_Imager* h,
 
     /* Read baseline coordinates and weights if required. */
     if (h->weighting == OSKAR_WEIGHTING_UNIFORM ||
-            h->algorithm == OSKAR_ALGORITHM_WPROJ)
+            h->algorithm == OSKAR_ALGORITHM_WPROJ ||
+            h->algorithm == OSKAR_ALGORITHM_WSTACK)
     {
         oskar_imager_set_coords_only(h, 1);
         if (h->log)
@@ -137,6 +142,7 @@ void oskar_imager_run(oskar_Imager* h,
     if (h->log)
         oskar_log_section(h->log, 'M', "Initialising algorithm...");
     oskar_imager_check_init(h, status);
+    num_passes = oskar_imager_num_w_passes(h, status);
     if (h->log && !*status)
     {
         oskar_log_message(h->log, 'M', 0, "Plane size is %d x %d.",
@@ -151,24 +157,64 @@ void oskar_imager_run(oskar_Imager* h,
             oskar_log_message(h->log, 'M', 0, "Using %d W-planes.",
                     oskar_imager_num_w_planes(h));
         }
+        else if (h->algorithm == OSKAR_ALGORITHM_WSTACK)
+        {
+            oskar_log_message(h->log, 'M', 0,
+                    "Baseline W values (wavelengths)");
+            oskar_log_message(h->log, 'M', 1, "Min: %.12e", h->ww_min);
+            oskar_log_message(h->log, 'M', 1, "Max: %.12e", h->ww_max);
+            oskar_log_message(h->log, 'M', 0, "Using %d W-layers.",
+                    oskar_imager_num_w_planes(h));
+            if (num_passes > 1)
+                oskar_log_message(h->log, 'M', 0, "Holding %d W-layers in "
+                        "memory, using %d passes.", h->num_w_layers_mem,
+                        num_passes);
+        }
         oskar_log_section(h->log, 'M', "Reading visibility data...");
     }
 
-    /* Loop over input files. */
-    percent_done = 0; percent_next = 10;
-    for (i = 0; i < num_files; ++i)
+    /* Loop over passes through the data (more than one only if
+     * not all W-layers can be held in memory). */
+    for (pass = 0; pass < num_passes; ++pass)
     {
-        /* Read visibility data. */
         if (*status) break;
-        filename = h->input_files[i];
-        if (h->log)
-            oskar_log_message(h->log, 'M', 0, "Opening '%s'", filename);
-        if (oskar_imager_is_ms(filename))
-            oskar_imager_read_data_ms(h, filename, i, num_files,
-                    &percent_done, &percent_next, status);
-        else
-            oskar_imager_read_data_vis(h, filename, i, num_files,
-                    &percent_done, &percent_next, status);
+        if (num_passes > 1)
+        {
+            int last;
+            h->w_layer_start = pass * h->num_w_layers_mem;
+            last = h->w_layer_start + h->num_w_layers_mem;
+            if (last > h->num_w_planes) last = h->num_w_planes;
+            if (h->log)
+                oskar_log_message(h->log, 'M', 0,
+                        "Pass %d of %d (W-layers %d to %d)", pass + 1,
+                        num_passes, h->w_layer_start + 1, last);
+        }
+
+        /* Loop over input files. */
+        percent_done = 0; percent_next = 10;
+        for (i = 0; i < num_files; ++i)
+        {
+            /* Read visibility data. */
+            if (*status) break;
+            filename = h->input_files[i];
+            if (h->log)
+                oskar_log_message(h->log, 'M', 0, "Opening '%s'", filename);
+            if (oskar_imager_is_ms(filename))
+                oskar_imager_read_data_ms(h, filename, i, num_files,
+                        &percent_done, &percent_next, status);
+            else
+                oskar_imager_read_data_vis(h, filename, i, num_files,
+                        &percent_done, &percent_next, status);
+        }
+
+        /* Transform the W-layers before gridding the next range. */
+        if (pass < num_passes - 1 && h->planes)
+        {
+            oskar_timer_resume(h->tmr_grid_finalise);
+            for (i = 0; i < h->num_planes; ++i)
+                oskar_imager_flush_w_layers(h, h->planes[i], status);
+            oskar_timer_pause(h->tmr_grid_finalise);
+        }
     }
 
     /* Check for errors. */
@@ -197,6 +243,32 @@ int oskar_imager_is_ms(const char* filename)
 }
 
 
+static int oskar_imager_num_w_passes(oskar_Imager* h, int* status)
+{
+    int max_layers;
+    if (*status || h->algorithm != OSKAR_ALGORITHM_WSTACK) return 1;
+
+    /* Get the number of W-layers that can be held in memory for all
+     * planes, allowing for the accumulated image in each plane. */
+    max_layers = h->max_w_layers_mem;
+    if (max_layers < 1)
+    {
+        size_t layer_bytes, plane_size;
+        oskar_imager_set_num_planes(h, status);
+        if (*status) return 1;
+        plane_size = (size_t) oskar_imager_plane_size(h);
+        layer_bytes = plane_size * plane_size * h->num_planes *
+                oskar_mem_element_size(h->imager_prec | OSKAR_COMPLEX);
+        max_layers = (int) (oskar_get_total_physical_memory() / 2 /
+                layer_bytes) - 1;
+        if (max_layers < 1) max_layers = 1;
+    }
+    h->num_w_layers_mem = max_layers < h->num_w_planes ?
+            max_layers : h->num_w_planes;
+    return (h->num_w_planes + h->num_w_layers_mem - 1) / h->num_w_layers_mem;
+}
+
+
 #ifdef __cplusplus
 }
 #endif
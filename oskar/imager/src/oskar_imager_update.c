@@ -35,12 +35,15 @@
 #include "imager/private_imager_filter_time.h"
 #include "imager/private_imager_filter_uv.h"
 #include "imager/private_imager_set_num_planes.h"
-#include "imager/private_imager_select_data.h"
+#include "imager/private_imager_select_coords.h"
+#include "imager/private_imager_select_vis.h"
 #include "imager/private_imager_update_plane_dft.h"
 #include "imager/private_imager_update_plane_fft.h"
 #include "imager/private_imager_update_plane_wproj.h"
+#include "imager/private_imager_update_plane_wstack.h"
 #include "imager/private_imager_weight_radial.h"
 #include "imager/private_imager_weight_uniform.h"
+#include "math/oskar_cmath.h"
 
 #include <math.h>
 #include <stdlib.h>
@@ -55,6 +58,10 @@ static void oskar_imager_update_weights_grid(oskar_Imager* h,
         size_t num_points, const oskar_Mem* uu, const oskar_Mem* vv,
         const oskar_Mem* ww, const oskar_Mem* weight, oskar_Mem* weights_grid,
         int* status);
+static void oskar_imager_select_phasors(oskar_Imager* h, size_t num_vis,
+        int* status);
+static void oskar_imager_resize_sel_index(oskar_Imager* h, size_t num_vis,
+        int* status);
 
 void oskar_imager_update_from_block(oskar_Imager* h,
         const oskar_VisHeader* header, const oskar_VisBlock* block,
@@ -179,7 +186,7 @@ void oskar_imager_update(oskar_Imager* h, size_t num_rows, int start_chan,
         const oskar_Mem* ww, const oskar_Mem* amps, const oskar_Mem* weight,
         const oskar_Mem* time_centroid, int* status)
 {
-    int c, p, plane;
+    int c, p, plane, num_channels, rotate;
     size_t max_num_vis;
     oskar_Mem *tu = 0, *tv = 0, *tw = 0, *ta = 0, *th = 0;
     const oskar_Mem *u_in, *v_in, *w_in, *amp_in = 0, *weight_in;
@@ -247,63 +254,84 @@ void oskar_imager_update(oskar_Imager* h, size_t num_rows, int start_chan,
         weight_in = th;
     }
 
+    /* Check if visibilities need to be phase rotated. */
+    rotate = (h->direction_type == 'R' && !h->coords_only &&
+            h->im_type != OSKAR_IMAGE_TYPE_PSF);
+
     /* Ensure work arrays are large enough. */
+    num_channels = 1 + end_chan - start_chan;
     max_num_vis = num_rows;
-    if (!h->chan_snaps) max_num_vis *= (1 + end_chan - start_chan);
+    if (!h->chan_snaps) max_num_vis *= num_channels;
     oskar_mem_realloc(h->uu_im, max_num_vis, status);
     oskar_mem_realloc(h->vv_im, max_num_vis, status);
     oskar_mem_realloc(h->ww_im, max_num_vis, status);
     oskar_mem_realloc(h->vis_im, max_num_vis, status);
     oskar_mem_realloc(h->weight_im, max_num_vis, status);
+    oskar_imager_resize_sel_index(h, max_num_vis, status);
     if (h->direction_type == 'R')
     {
         oskar_mem_realloc(h->uu_tmp, max_num_vis, status);
         oskar_mem_realloc(h->vv_tmp, max_num_vis, status);
         oskar_mem_realloc(h->ww_tmp, max_num_vis, status);
     }
+    if (rotate)
+        oskar_mem_realloc(h->sel_phasor, max_num_vis, status);
 
-    /* Loop over each image plane being made. */
+    /* Loop over each image channel being made.
+     * The baseline coordinates, filters and phase rotation depend only
+     * on the channel, so they are shared by all polarisations. */
     for (c = 0; c < h->num_im_channels; ++c)
     {
+        oskar_Mem *pu, *pv, *pw;
+        size_t num_vis = 0;
+        if (*status) break;
+
+        /* Get the baseline coordinates needed to update this channel. */
+        pu = h->uu_im; pv = h->vv_im; pw = h->ww_im;
+        if (h->direction_type == 'R')
+        {
+            pu = h->uu_tmp; pv = h->vv_tmp; pw = h->ww_tmp;
+        }
+        oskar_imager_select_coords(h, num_rows, start_chan, end_chan,
+                u_in, v_in, w_in, time_centroid, h->im_freqs[c],
+                &num_vis, pu, pv, pw, h->time_im, h->sel_index, status);
+
+        /* Skip if nothing was selected. */
+        if (num_vis == 0) continue;
+
+        /* Rotate baseline coordinates if required. */
+        if (h->direction_type == 'R')
+            oskar_imager_rotate_coords(h, num_vis,
+                    h->uu_tmp, h->vv_tmp, h->ww_tmp,
+                    h->uu_im, h->vv_im, h->ww_im);
+
+        /* Apply time and baseline length filters if required.
+         * If phase rotating, keep track of the unfiltered positions,
+         * as the unrotated coordinates are needed for the phasors. */
+        if (rotate)
+        {
+            size_t i;
+            for (i = 0; i < num_vis; ++i) h->sel_pos[i] = i;
+        }
+        oskar_imager_filter_time(h, &num_vis, h->uu_im, h->vv_im, h->ww_im,
+                rotate ? h->sel_pos : h->sel_index, h->time_im, status);
+        oskar_imager_filter_uv(h, &num_vis, h->uu_im, h->vv_im, h->ww_im,
+                rotate ? h->sel_pos : h->sel_index, status);
+        if (rotate)
+            oskar_imager_select_phasors(h, num_vis, status);
+
         for (p = 0; p < h->num_im_pols; ++p)
         {
-            oskar_Mem *pu, *pv, *pw;
-            size_t num_vis = 0;
             if (*status) break;
 
-            /* Get all visibility data needed to update this plane. */
-            pu = h->uu_im; pv = h->vv_im; pw = h->ww_im;
-            if (h->direction_type == 'R')
-            {
-                pu = h->uu_tmp; pv = h->vv_tmp; pw = h->ww_tmp;
-            }
-            oskar_imager_select_data(h, num_rows, start_chan, end_chan,
-                    num_pols, u_in, v_in, w_in, amp_in, weight_in,
-                    time_centroid, h->im_freqs[c], p,
-                    &num_vis, pu, pv, pw, h->vis_im, h->weight_im,
-                    h->time_im, status);
-
-            /* Skip if nothing was selected. */
-            if (num_vis == 0) continue;
-
-            /* Rotate baseline coordinates if required. */
-            if (h->direction_type == 'R')
-                oskar_imager_rotate_coords(h, num_vis,
-                        h->uu_tmp, h->vv_tmp, h->ww_tmp,
-                        h->uu_im, h->vv_im, h->ww_im);
-
-            /* Overwrite visibilities if making PSF, or phase rotate. */
+            /* Get the visibility data needed to update this plane. */
+            oskar_imager_select_vis(h, num_vis, num_channels, num_pols, p,
+                    h->sel_index, rotate ? h->sel_phasor : 0,
+                    amp_in, weight_in, h->vis_im, h->weight_im, status);
+
+            /* Overwrite visibilities if making PSF. */
             if (h->im_type == OSKAR_IMAGE_TYPE_PSF)
                 oskar_mem_set_value_real(h->vis_im, 1.0, 0, 0, status);
-            else if (h->direction_type == 'R' && !h->coords_only)
-                oskar_imager_rotate_vis(h, num_vis,
-                        h->uu_tmp, h->vv_tmp, h->ww_tmp, h->vis_im);
-
-            /* Apply time and baseline length filters if required. */
-            oskar_imager_filter_time(h, &num_vis, h->uu_im, h->vv_im,
-                    h->ww_im, h->vis_im, h->weight_im, h->time_im, status);
-            oskar_imager_filter_uv(h, &num_vis, h->uu_im, h->vv_im,
-                    h->ww_im, h->vis_im, h->weight_im, status);
 
             /* Update this image plane with the visibilities. */
             plane = h->num_im_pols * c + p;
@@ -419,6 +447,10 @@ void oskar_imager_update_plane(oskar_Imager* h, size_t num_vis,
             oskar_imager_update_plane_wproj(h, num_vis, pu, pv, pw, pa, ph,
                     plane, plane_norm, &num_skipped, status);
             break;
+        case OSKAR_ALGORITHM_WSTACK:
+            oskar_imager_update_plane_wstack(h, num_vis, pu, pv, pw, pa, ph,
+                    plane, plane_norm, &num_skipped, status);
+            break;
         default:
             *status = OSKAR_ERR_FUNCTION_NOT_AVAILABLE;
             break;
@@ -478,7 +510,8 @@ void oskar_imager_update_weights_grid(oskar_Imager* h, size_t num_points,
     }
 
     /* Update baseline W minimum, maximum and RMS. */
-    if (h->algorithm == OSKAR_ALGORITHM_WPROJ)
+    if (h->algorithm == OSKAR_ALGORITHM_WPROJ ||
+            h->algorithm == OSKAR_ALGORITHM_WSTACK)
     {
         size_t j;
         double val;
@@ -512,6 +545,7 @@ void oskar_imager_update_weights_grid(oskar_Imager* h, size_t num_points,
 void oskar_imager_allocate_planes(oskar_Imager* h, int *status)
 {
     int i, plane_size;
+    size_t num_cells;
     if (*status) return;
 
     /* Allocate empty weights grids if required. */
@@ -532,15 +566,99 @@ void oskar_imager_allocate_planes(oskar_Imager* h, int *status)
     h->planes = (oskar_Mem**) calloc(h->num_planes, sizeof(oskar_Mem*));
     h->plane_norm = (double*) calloc(h->num_planes, sizeof(double));
     plane_size = oskar_imager_plane_size(h);
+    num_cells = plane_size * plane_size;
+    if (h->algorithm == OSKAR_ALGORITHM_WSTACK)
+        num_cells *= (1 + h->num_w_layers_mem);
     for (i = 0; i < h->num_planes; ++i)
         h->planes[i] = oskar_mem_create(oskar_imager_plane_type(h), OSKAR_CPU,
-                plane_size * plane_size, status);
+                num_cells, status);
 
     /* Create FITS files for the planes if required. */
     oskar_imager_create_fits_files(h, status);
 }
 
 
+static void oskar_imager_select_phasors(oskar_Imager* h, size_t num_vis,
+        int* status)
+{
+#ifdef OSKAR_OS_WIN
+    int i;
+    const int num = (const int) num_vis;
+#else
+    size_t i;
+    const size_t num = num_vis;
+#endif
+    size_t *pos, *idx;
+    double2* ph;
+    const double delta_l = h->delta_l;
+    const double delta_m = h->delta_m;
+    const double delta_n = h->delta_n;
+    const double twopi = 2.0 * M_PI;
+    if (*status) return;
+
+    /* Evaluate the phasors from the unrotated coordinates. */
+    pos = h->sel_pos;
+    idx = h->sel_index;
+    ph = oskar_mem_double2(h->sel_phasor, status);
+    if (h->imager_prec == OSKAR_DOUBLE)
+    {
+        const double *u, *v, *w;
+        u = oskar_mem_double_const(h->uu_tmp, status);
+        v = oskar_mem_double_const(h->vv_tmp, status);
+        w = oskar_mem_double_const(h->ww_tmp, status);
+#pragma omp parallel for private(i)
+        for (i = 0; i < num; ++i)
+        {
+            const size_t j = pos[i];
+            const double arg = twopi *
+                    (u[j] * delta_l + v[j] * delta_m + w[j] * delta_n);
+            ph[i].x = cos(arg);
+            ph[i].y = sin(arg);
+        }
+    }
+    else
+    {
+        const float *u, *v, *w;
+        u = oskar_mem_float_const(h->uu_tmp, status);
+        v = oskar_mem_float_const(h->vv_tmp, status);
+        w = oskar_mem_float_const(h->ww_tmp, status);
+#pragma omp parallel for private(i)
+        for (i = 0; i < num; ++i)
+        {
+            const size_t j = pos[i];
+            const double arg = twopi *
+                    (u[j] * delta_l + v[j] * delta_m + w[j] * delta_n);
+            ph[i].x = cos(arg);
+            ph[i].y = sin(arg);
+        }
+    }
+
+    /* Remove indices of filtered visibilities. Positions are increasing,
+     * so the index array can be updated in-place. */
+    for (i = 0; i < num; ++i) idx[i] = idx[pos[i]];
+}
+
+
+static void oskar_imager_resize_sel_index(oskar_Imager* h, size_t num_vis,
+        int* status)
+{
+    size_t *t_index, *t_pos;
+    if (*status || num_vis <= h->sel_capacity) return;
+
+    /* Indices can exceed the range of int for large blocks. */
+    t_index = (size_t*) realloc(h->sel_index, num_vis * sizeof(size_t));
+    if (t_index) h->sel_index = t_index;
+    t_pos = (size_t*) realloc(h->sel_pos, num_vis * sizeof(size_t));
+    if (t_pos) h->sel_pos = t_pos;
+    if (!t_index || !t_pos)
+    {
+        *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+        return;
+    }
+    h->sel_capacity = num_vis;
+}
+
+
 #ifdef __cplusplus
 }
 #endif
@@ -36,8 +36,8 @@ extern "C" {
 #endif
 
 void oskar_imager_filter_time(const oskar_Imager* h, size_t* num_vis,
-        oskar_Mem* uu, oskar_Mem* vv, oskar_Mem* ww, oskar_Mem* amp,
-        oskar_Mem* weight, oskar_Mem* time_centroid, int* status)
+        oskar_Mem* uu, oskar_Mem* vv, oskar_Mem* ww, size_t* index,
+        oskar_Mem* time_centroid, int* status)
 {
     size_t i, n;
     double t, range[2], *time_centroid_;
@@ -61,13 +61,10 @@ void oskar_imager_filter_time(const oskar_Imager* h, size_t* num_vis,
     time_centroid_ = oskar_mem_double(time_centroid, status);
     if (h->imager_prec == OSKAR_DOUBLE)
     {
-        double *uu_, *vv_, *ww_, *weight_;
-        double2* amp_;
+        double *uu_, *vv_, *ww_;
         uu_ = oskar_mem_double(uu, status);
         vv_ = oskar_mem_double(vv, status);
         ww_ = oskar_mem_double(ww, status);
-        amp_ = oskar_mem_double2(amp, status);
-        weight_ = oskar_mem_double(weight, status);
 
         for (i = 0; i < n; ++i)
         {
@@ -77,8 +74,7 @@ void oskar_imager_filter_time(const oskar_Imager* h, size_t* num_vis,
                 uu_[*num_vis] = uu_[i];
                 vv_[*num_vis] = vv_[i];
                 ww_[*num_vis] = ww_[i];
-                amp_[*num_vis] = amp_[i];
-                weight_[*num_vis] = weight_[i];
+                index[*num_vis] = index[i];
                 time_centroid_[*num_vis] = t;
                 (*num_vis)++;
             }
@@ -86,13 +82,10 @@ void oskar_imager_filter_time(const oskar_Imager* h, size_t* num_vis,
     }
     else
     {
-        float *uu_, *vv_, *ww_, *weight_;
-        float2* amp_;
+        float *uu_, *vv_, *ww_;
         uu_ = oskar_mem_float(uu, status);
         vv_ = oskar_mem_float(vv, status);
         ww_ = oskar_mem_float(ww, status);
-        amp_ = oskar_mem_float2(amp, status);
-        weight_ = oskar_mem_float(weight, status);
 
         for (i = 0; i < n; ++i)
         {
@@ -102,8 +95,7 @@ void oskar_imager_filter_time(const oskar_Imager* h, size_t* num_vis,
                 uu_[*num_vis] = uu_[i];
                 vv_[*num_vis] = vv_[i];
                 ww_[*num_vis] = ww_[i];
-                amp_[*num_vis] = amp_[i];
-                weight_[*num_vis] = weight_[i];
+                index[*num_vis] = index[i];
                 time_centroid_[*num_vis] = t;
                 (*num_vis)++;
             }
@@ -36,8 +36,8 @@ extern "C" {
 #endif
 
 void oskar_imager_filter_uv(const oskar_Imager* h, size_t* num_vis,
-        oskar_Mem* uu, oskar_Mem* vv, oskar_Mem* ww, oskar_Mem* amp,
-        oskar_Mem* weight, int* status)
+        oskar_Mem* uu, oskar_Mem* vv, oskar_Mem* ww, size_t* index,
+        int* status)
 {
     size_t i, n;
     double r, range[2];
@@ -59,13 +59,10 @@ void oskar_imager_filter_uv(const oskar_Imager* h, size_t* num_vis,
     /* Apply the UV baseline length filter. */
     if (h->imager_prec == OSKAR_DOUBLE)
     {
-        double *uu_, *vv_, *ww_, *weight_;
-        double2* amp_;
+        double *uu_, *vv_, *ww_;
         uu_ = oskar_mem_double(uu, status);
         vv_ = oskar_mem_double(vv, status);
         ww_ = oskar_mem_double(ww, status);
-        amp_ = oskar_mem_double2(amp, status);
-        weight_ = oskar_mem_double(weight, status);
 
         for (i = 0; i < n; ++i)
         {
@@ -75,21 +72,17 @@ void oskar_imager_filter_uv(const oskar_Imager* h, size_t* num_vis,
                 uu_[*num_vis] = uu_[i];
                 vv_[*num_vis] = vv_[i];
                 ww_[*num_vis] = ww_[i];
-                amp_[*num_vis] = amp_[i];
-                weight_[*num_vis] = weight_[i];
+                index[*num_vis] = index[i];
                 (*num_vis)++;
             }
         }
     }
     else
     {
-        float *uu_, *vv_, *ww_, *weight_;
-        float2* amp_;
+        float *uu_, *vv_, *ww_;
         uu_ = oskar_mem_float(uu, status);
         vv_ = oskar_mem_float(vv, status);
         ww_ = oskar_mem_float(ww, status);
-        amp_ = oskar_mem_float2(amp, status);
-        weight_ = oskar_mem_float(weight, status);
 
         for (i = 0; i < n; ++i)
         {
@@ -99,8 +92,7 @@ void oskar_imager_filter_uv(const oskar_Imager* h, size_t* num_vis,
                 uu_[*num_vis] = uu_[i];
                 vv_[*num_vis] = vv_[i];
                 ww_[*num_vis] = ww_[i];
-                amp_[*num_vis] = amp_[i];
-                weight_[*num_vis] = weight_[i];
+                index[*num_vis] = index[i];
                 (*num_vis)++;
             }
         }
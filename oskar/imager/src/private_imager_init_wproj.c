@@ -26,10 +26,6 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
-#ifdef OSKAR_HAVE_CUDA
-#include <cufft.h>
-#endif
-
 #include "imager/private_imager.h"
 #include "imager/oskar_imager.h"
 
@@ -38,8 +34,7 @@
 #include "imager/private_imager_init_wproj.h"
 #include "imager/oskar_grid_functions_spheroidal.h"
 #include "math/oskar_cmath.h"
-#include "math/oskar_fftpack_cfft.h"
-#include "math/oskar_fftpack_cfft_f.h"
+#include "math/oskar_fft.h"
 #include "utility/oskar_get_memory_usage.h"
 #include "utility/oskar_device_utils.h"
 
@@ -66,12 +61,9 @@ void oskar_imager_init_wproj(oskar_Imager* h, int* status)
     int conv_size, conv_size_half, inner, nearest;
     double l_max, max_conv_size, max_uvw, max_val, sampling, sum;
     double *maxes;
-#ifdef OSKAR_HAVE_CUDA
-    cufftHandle cufft_plan = 0;
-#endif
+    oskar_FFT* fft = 0;
     oskar_Mem *screen = 0, *screen_gpu = 0, *screen_ptr = 0;
     oskar_Mem *taper = 0, *taper_gpu = 0, *taper_ptr = 0;
-    oskar_Mem *wsave = 0, *work = 0;
     char *ptr_out, *ptr_in, *fname = 0;
     if (*status) return;
 
@@ -139,26 +131,10 @@ void oskar_imager_init_wproj(oskar_Imager* h, int* status)
         screen_gpu = oskar_mem_create(prec | OSKAR_COMPLEX,
                 OSKAR_GPU, conv_size * conv_size, status);
         screen_ptr = screen_gpu;
-        if (prec == OSKAR_DOUBLE)
-            cufftPlan2d(&cufft_plan, conv_size, conv_size, CUFFT_Z2Z);
-        else
-            cufftPlan2d(&cufft_plan, conv_size, conv_size, CUFFT_C2C);
     }
-    else
 #endif
-    {
-        int len_save = 4 * conv_size +
-                2 * (int)(log((double)conv_size) / log(2.0)) + 8;
-        wsave = oskar_mem_create(prec, OSKAR_CPU, len_save, status);
-        work = oskar_mem_create(prec, OSKAR_CPU,
-                2 * conv_size * conv_size, status);
-        if (prec == OSKAR_DOUBLE)
-            oskar_fftpack_cfft2i(conv_size, conv_size,
-                    oskar_mem_double(wsave, status));
-        else
-            oskar_fftpack_cfft2i_f(conv_size, conv_size,
-                    oskar_mem_float(wsave, status));
-    }
+    fft = oskar_fft_create(prec, oskar_mem_location(screen_ptr),
+            conv_size, status);
 
     /* Generate 1D spheroidal tapering function to cover the inner region. */
     taper = oskar_mem_create(prec, OSKAR_CPU, inner, status);
@@ -205,31 +181,9 @@ void oskar_imager_init_wproj(oskar_Imager* h, int* status)
         if (*status) break;
 
         /* Perform the FFT to get the kernel. No shifts are required. */
-#ifdef OSKAR_HAVE_CUDA
-        if (h->generate_w_kernels_on_gpu && h->num_gpus > 0)
-        {
-            if (oskar_mem_precision(screen) == OSKAR_DOUBLE)
-                cufftExecZ2Z(cufft_plan, oskar_mem_void(screen_ptr),
-                        oskar_mem_void(screen_ptr), CUFFT_FORWARD);
-            else
-                cufftExecC2C(cufft_plan, oskar_mem_void(screen_ptr),
-                        oskar_mem_void(screen_ptr), CUFFT_FORWARD);
+        oskar_fft_exec(fft, screen_ptr, status);
+        if (screen_ptr != screen)
             oskar_mem_copy(screen, screen_ptr, status);
-        }
-        else
-#endif
-        {
-            if (oskar_mem_precision(screen_ptr) == OSKAR_DOUBLE)
-                oskar_fftpack_cfft2f(conv_size, conv_size, conv_size,
-                        oskar_mem_double(screen_ptr, status),
-                        oskar_mem_double(wsave, status),
-                        oskar_mem_double(work, status));
-            else
-                oskar_fftpack_cfft2f_f(conv_size, conv_size, conv_size,
-                        oskar_mem_float(screen_ptr, status),
-                        oskar_mem_float(wsave, status),
-                        oskar_mem_float(work, status));
-        }
         if (*status) break;
 
         /* Get the maximum (from the first element). */
@@ -256,15 +210,11 @@ void oskar_imager_init_wproj(oskar_Imager* h, int* status)
     }
 
     /* Clean up. */
-#ifdef OSKAR_HAVE_CUDA
-    cufftDestroy(cufft_plan);
-#endif
+    oskar_fft_free(fft);
     oskar_mem_free(screen, status);
     oskar_mem_free(screen_gpu, status);
     oskar_mem_free(taper, status);
     oskar_mem_free(taper_gpu, status);
-    oskar_mem_free(wsave, status);
-    oskar_mem_free(work, status);
 
     /* Normalise each plane by the maximum. */
     if (*status) return;
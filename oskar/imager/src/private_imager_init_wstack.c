@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "imager/private_imager.h"
+#include "imager/oskar_imager.h"
+
+#include "imager/private_imager_init_fft.h"
+#include "imager/private_imager_init_wstack.h"
+#include "math/oskar_cmath.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void oskar_imager_init_wstack(oskar_Imager* h, int* status)
+{
+    double l_max, n_min, r_sq, w_min, w_max;
+    if (*status) return;
+
+    /* Generate the (small) convolution function used for all layers. */
+    oskar_imager_init_fft(h, status);
+
+    /* Get the range of baseline W values, if known.
+     * The sign of W does not matter, as visibilities with negative W
+     * are gridded as their conjugates. */
+    if (h->ww_max > 0.0 && h->ww_min <= h->ww_max)
+    {
+        w_min = h->ww_min;
+        w_max = h->ww_max;
+    }
+    else
+    {
+        w_min = 0.0;
+        w_max = 0.25 / fabs(h->cellsize_rad);
+    }
+
+    /* Calculate required number of W-layers if not set.
+     * The phase error in the corners of the image due to the distance
+     * to the nearest layer centre is then limited to 0.2 radians. */
+    l_max = 0.5 * oskar_imager_plane_size(h) * fabs(h->cellsize_rad);
+    r_sq = 2.0 * l_max * l_max;
+    n_min = r_sq < 1.0 ? sqrt(1.0 - r_sq) : 0.0;
+    if (h->num_w_planes < 1)
+        h->num_w_planes = (int) ceil(M_PI * (w_max - w_min) *
+                (1.0 - n_min) / 0.2);
+    if (h->num_w_planes < 1)
+        h->num_w_planes = 1;
+
+    /* Layers are centred in equal intervals across the range of W.
+     * Hold all of them in memory unless told otherwise. */
+    h->w_layer_min = w_min;
+    h->w_layer_inc = (w_max - w_min) / h->num_w_planes;
+    h->w_layer_start = 0;
+    if (h->num_w_layers_mem < 1 || h->num_w_layers_mem > h->num_w_planes)
+        h->num_w_layers_mem = h->num_w_planes;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -29,7 +29,7 @@
 #include "imager/private_imager.h"
 #include "imager/oskar_imager.h"
 
-#include "imager/private_imager_select_data.h"
+#include "imager/private_imager_select_coords.h"
 #include <math.h>
 
 #ifdef __cplusplus
@@ -38,36 +38,28 @@ extern "C" {
 
 #define C0 299792458.0
 
-static
-void copy_vis_pol(size_t num_rows, int num_channels, int num_pols,
-        int c, int p, const oskar_Mem* vis_in, const oskar_Mem* weight_in,
-        oskar_Mem* vis_out, oskar_Mem* weight_out, size_t out_offset,
-        int* status);
+static void set_index(size_t num_rows, int num_channels, int c,
+        size_t* index_out, int* status);
 
-void oskar_imager_select_data(
+void oskar_imager_select_coords(
         const oskar_Imager* h,
         size_t num_rows,
         int start_chan,
         int end_chan,
-        int num_pols,
         const oskar_Mem* uu_in,
         const oskar_Mem* vv_in,
         const oskar_Mem* ww_in,
-        const oskar_Mem* vis_in,
-        const oskar_Mem* weight_in,
         const oskar_Mem* time_in,
         double im_freq_hz,
-        int im_pol,
         size_t* num_out,
         oskar_Mem* uu_out,
         oskar_Mem* vv_out,
         oskar_Mem* ww_out,
-        oskar_Mem* vis_out,
-        oskar_Mem* weight_out,
         oskar_Mem* time_out,
+        size_t* index_out,
         int* status)
 {
-    int i, c, p, num_channels;
+    int i, c, num_channels;
     double inv_wavelength;
     const double s = 0.05;
     const double df = h->freq_inc_hz != 0.0 ? h->freq_inc_hz : 1.0;
@@ -77,13 +69,6 @@ void oskar_imager_select_data(
     if (*status) return;
     *num_out = 0;
 
-    /* Override pol_offset if required. */
-    p = h->pol_offset;
-    if (h->im_type == OSKAR_IMAGE_TYPE_STOKES ||
-            h->im_type == OSKAR_IMAGE_TYPE_LINEAR)
-        p = im_pol;
-    if (num_pols == 1) p = 0;
-
     /* Check whether using frequency snapshots or frequency synthesis. */
     num_channels = 1 + end_chan - start_chan;
     if (h->chan_snaps)
@@ -102,10 +87,8 @@ void oskar_imager_select_data(
         oskar_mem_scale_real(vv_out, inv_wavelength, status);
         oskar_mem_scale_real(ww_out, inv_wavelength, status);
 
-        /* Copy visibility data and weights if present. */
-        copy_vis_pol(num_rows, num_channels, num_pols,
-                c - start_chan, p, vis_in, weight_in,
-                vis_out, weight_out, 0, status);
+        /* Store the index of each visibility in the input block. */
+        set_index(num_rows, num_channels, c - start_chan, index_out, status);
 
         /* Copy time centroids if present. */
         if (time_in && time_out)
@@ -140,10 +123,9 @@ void oskar_imager_select_data(
             oskar_mem_scale_real(vv_, inv_wavelength, status);
             oskar_mem_scale_real(ww_, inv_wavelength, status);
 
-            /* Copy visibility data and weights if present. */
-            copy_vis_pol(num_rows, num_channels, num_pols,
-                    c - start_chan, p, vis_in, weight_in,
-                    vis_out, weight_out, *num_out, status);
+            /* Store the index of each visibility in the input block. */
+            set_index(num_rows, num_channels, c - start_chan,
+                    index_out + *num_out, status);
 
             /* Copy time centroids if present. */
             if (time_in && time_out)
@@ -163,51 +145,13 @@ void oskar_imager_select_data(
 }
 
 
-void copy_vis_pol(size_t num_rows, int num_channels, int num_pols,
-        int c, int p, const oskar_Mem* vis_in, const oskar_Mem* weight_in,
-        oskar_Mem* vis_out, oskar_Mem* weight_out, size_t out_offset,
-        int* status)
+static void set_index(size_t num_rows, int num_channels, int c,
+        size_t* index_out, int* status)
 {
     size_t r;
     if (*status) return;
-    if (oskar_mem_precision(vis_out) == OSKAR_SINGLE)
-    {
-        float* w_out;
-        const float* w_in;
-        w_out = oskar_mem_float(weight_out, status) + out_offset;
-        w_in = oskar_mem_float_const(weight_in, status);
-        for (r = 0; r < num_rows; ++r)
-            w_out[r] = w_in[num_pols * r + p];
-
-        if (vis_in)
-        {
-            float2* v_out;
-            const float2* v_in;
-            v_out = oskar_mem_float2(vis_out, status) + out_offset;
-            v_in = oskar_mem_float2_const(vis_in, status);
-            for (r = 0; r < num_rows; ++r)
-                v_out[r] = v_in[num_pols * (num_channels * r + c) + p];
-        }
-    }
-    else
-    {
-        double* w_out;
-        const double* w_in;
-        w_out = oskar_mem_double(weight_out, status) + out_offset;
-        w_in = oskar_mem_double_const(weight_in, status);
-        for (r = 0; r < num_rows; ++r)
-            w_out[r] = w_in[num_pols * r + p];
-
-        if (vis_in)
-        {
-            double2* v_out;
-            const double2* v_in;
-            v_out = oskar_mem_double2(vis_out, status) + out_offset;
-            v_in = oskar_mem_double2_const(vis_in, status);
-            for (r = 0; r < num_rows; ++r)
-                v_out[r] = v_in[num_pols * (num_channels * r + c) + p];
-        }
-    }
+    for (r = 0; r < num_rows; ++r)
+        index_out[r] = num_channels * r + c;
 }
 
 
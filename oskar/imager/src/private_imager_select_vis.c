@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "imager/private_imager.h"
+#include "imager/oskar_imager.h"
+
+#include "imager/private_imager_select_vis.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void oskar_imager_select_vis(
+        const oskar_Imager* h,
+        size_t num_vis,
+        int num_channels,
+        int num_pols,
+        int im_pol,
+        const size_t* index,
+        const oskar_Mem* phasor,
+        const oskar_Mem* vis_in,
+        const oskar_Mem* weight_in,
+        oskar_Mem* vis_out,
+        oskar_Mem* weight_out,
+        int* status)
+{
+#ifdef OSKAR_OS_WIN
+    int i;
+    const int num = (const int) num_vis;
+#else
+    size_t i;
+    const size_t num = num_vis;
+#endif
+    int p;
+    const double2* ph = 0;
+    if (*status) return;
+
+    /* Override pol_offset if required. */
+    p = h->pol_offset;
+    if (h->im_type == OSKAR_IMAGE_TYPE_STOKES ||
+            h->im_type == OSKAR_IMAGE_TYPE_LINEAR)
+        p = im_pol;
+    if (num_pols == 1) p = 0;
+
+    /* Gather the weights and visibilities, rotating if required. */
+    if (phasor) ph = oskar_mem_double2_const(phasor, status);
+    if (oskar_mem_precision(weight_out) == OSKAR_SINGLE)
+    {
+        float* w_out;
+        const float* w_in;
+        w_out = oskar_mem_float(weight_out, status);
+        w_in = oskar_mem_float_const(weight_in, status);
+#pragma omp parallel for private(i)
+        for (i = 0; i < num; ++i)
+            w_out[i] = w_in[num_pols * (index[i] / num_channels) + p];
+
+        if (vis_in)
+        {
+            float2* v_out;
+            const float2* v_in;
+            v_out = oskar_mem_float2(vis_out, status);
+            v_in = oskar_mem_float2_const(vis_in, status);
+#pragma omp parallel for private(i)
+            for (i = 0; i < num; ++i)
+            {
+                const float2 a = v_in[num_pols * index[i] + p];
+                if (ph)
+                {
+                    v_out[i].x = (float) (a.x * ph[i].x - a.y * ph[i].y);
+                    v_out[i].y = (float) (a.x * ph[i].y + a.y * ph[i].x);
+                }
+                else v_out[i] = a;
+            }
+        }
+    }
+    else
+    {
+        double* w_out;
+        const double* w_in;
+        w_out = oskar_mem_double(weight_out, status);
+        w_in = oskar_mem_double_const(weight_in, status);
+#pragma omp parallel for private(i)
+        for (i = 0; i < num; ++i)
+            w_out[i] = w_in[num_pols * (index[i] / num_channels) + p];
+
+        if (vis_in)
+        {
+            double2* v_out;
+            const double2* v_in;
+            v_out = oskar_mem_double2(vis_out, status);
+            v_in = oskar_mem_double2_const(vis_in, status);
+#pragma omp parallel for private(i)
+            for (i = 0; i < num; ++i)
+            {
+                const double2 a = v_in[num_pols * index[i] + p];
+                if (ph)
+                {
+                    v_out[i].x = a.x * ph[i].x - a.y * ph[i].y;
+                    v_out[i].y = a.x * ph[i].y + a.y * ph[i].x;
+                }
+                else v_out[i] = a;
+            }
+        }
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -44,7 +44,19 @@
 extern "C" {
 #endif
 
+/* Number of pixels and visibilities in each tile of the CPU DFT. */
+#define TILE_PIX 256
+#define TILE_VIS 128
+
 static void* run_blocks(void* arg);
+static void dft_tiled_d(int num_threads, int num_vis, const double* uu,
+        const double* vv, const double* ww, const double2* amp,
+        const double* weight, int num_pixels, const double* l, const double* m,
+        const double* n, double* plane);
+static void dft_tiled_f(int num_threads, int num_vis, const float* uu,
+        const float* vv, const float* ww, const float2* amp,
+        const float* weight, int num_pixels, const float* l, const float* m,
+        const float* n, float* plane);
 
 struct ThreadArgs
 {
@@ -75,51 +87,89 @@ void oskar_imager_update_plane_dft(oskar_Imager* h, size_t num_vis,
         oskar_mem_realloc(plane, num_pixels, status);
     if (*status) return;
 
-    /* Copy visibility data to each device. */
-    num_threads = (size_t) (h->num_devices);
-    for (i = 0; i < num_threads; ++i)
+    /* Use tiles on the CPU if there are no GPUs, with one thread
+     * for each CPU device. */
+    if (h->num_gpus == 0)
     {
-        if (i < (size_t) (h->num_gpus))
-            oskar_device_set(h->gpu_ids[i], status);
-        oskar_mem_copy(h->d[i].uu, uu, status);
-        oskar_mem_copy(h->d[i].vv, vv, status);
-        oskar_mem_copy(h->d[i].amp, amps, status);
-        oskar_mem_copy(h->d[i].weight, weight, status);
-        if (h->algorithm == OSKAR_ALGORITHM_DFT_3D)
-            oskar_mem_copy(h->d[i].ww, ww, status);
+        const int is_3d = (h->algorithm == OSKAR_ALGORITHM_DFT_3D);
+        if (oskar_mem_location(uu) != OSKAR_CPU ||
+                oskar_mem_location(amps) != OSKAR_CPU ||
+                oskar_mem_location(weight) != OSKAR_CPU ||
+                oskar_mem_location(plane) != OSKAR_CPU)
+        {
+            *status = OSKAR_ERR_BAD_LOCATION;
+            return;
+        }
+        if (h->imager_prec == OSKAR_DOUBLE)
+            dft_tiled_d(h->num_devices, (int) num_vis,
+                    oskar_mem_double_const(uu, status),
+                    oskar_mem_double_const(vv, status),
+                    is_3d ? oskar_mem_double_const(ww, status) : 0,
+                    oskar_mem_double2_const(amps, status),
+                    oskar_mem_double_const(weight, status), (int) num_pixels,
+                    oskar_mem_double_const(h->l, status),
+                    oskar_mem_double_const(h->m, status),
+                    is_3d ? oskar_mem_double_const(h->n, status) : 0,
+                    oskar_mem_double(plane, status));
+        else
+            dft_tiled_f(h->num_devices, (int) num_vis,
+                    oskar_mem_float_const(uu, status),
+                    oskar_mem_float_const(vv, status),
+                    is_3d ? oskar_mem_float_const(ww, status) : 0,
+                    oskar_mem_float2_const(amps, status),
+                    oskar_mem_float_const(weight, status), (int) num_pixels,
+                    oskar_mem_float_const(h->l, status),
+                    oskar_mem_float_const(h->m, status),
+                    is_3d ? oskar_mem_float_const(h->n, status) : 0,
+                    oskar_mem_float(plane, status));
     }
-
-    /* Set up worker threads. */
-    threads = (oskar_Thread**) calloc(num_threads, sizeof(oskar_Thread*));
-    args = (ThreadArgs*) calloc(num_threads, sizeof(ThreadArgs));
-    for (i = 0; i < num_threads; ++i)
+    else
     {
-        args[i].h = h;
-        args[i].thread_id = (int) i;
-        args[i].num_vis = (int) num_vis;
-        args[i].plane = plane;
-    }
+        /* Copy visibility data to each device. */
+        num_threads = (size_t) (h->num_devices);
+        for (i = 0; i < num_threads; ++i)
+        {
+            if (i < (size_t) (h->num_gpus))
+                oskar_device_set(h->gpu_ids[i], status);
+            oskar_mem_copy(h->d[i].uu, uu, status);
+            oskar_mem_copy(h->d[i].vv, vv, status);
+            oskar_mem_copy(h->d[i].amp, amps, status);
+            oskar_mem_copy(h->d[i].weight, weight, status);
+            if (h->algorithm == OSKAR_ALGORITHM_DFT_3D)
+                oskar_mem_copy(h->d[i].ww, ww, status);
+        }
 
-    /* Set status code. */
-    h->status = *status;
+        /* Set up worker threads. */
+        threads = (oskar_Thread**) calloc(num_threads, sizeof(oskar_Thread*));
+        args = (ThreadArgs*) calloc(num_threads, sizeof(ThreadArgs));
+        for (i = 0; i < num_threads; ++i)
+        {
+            args[i].h = h;
+            args[i].thread_id = (int) i;
+            args[i].num_vis = (int) num_vis;
+            args[i].plane = plane;
+        }
 
-    /* Start the worker threads. */
-    h->i_block = 0;
-    for (i = 0; i < num_threads; ++i)
-        threads[i] = oskar_thread_create(run_blocks, (void*)&args[i], 0);
+        /* Set status code. */
+        h->status = *status;
 
-    /* Wait for worker threads to finish. */
-    for (i = 0; i < num_threads; ++i)
-    {
-        oskar_thread_join(threads[i]);
-        oskar_thread_free(threads[i]);
-    }
-    free(threads);
-    free(args);
+        /* Start the worker threads. */
+        h->i_block = 0;
+        for (i = 0; i < num_threads; ++i)
+            threads[i] = oskar_thread_create(run_blocks, (void*)&args[i], 0);
 
-    /* Get status code. */
-    *status = h->status;
+        /* Wait for worker threads to finish. */
+        for (i = 0; i < num_threads; ++i)
+        {
+            oskar_thread_join(threads[i]);
+            oskar_thread_free(threads[i]);
+        }
+        free(threads);
+        free(args);
 
+        /* Get status code. */
+        *status = h->status;
+    }
     /* Update normalisation. */
     if (oskar_mem_precision(weight) == OSKAR_DOUBLE)
     {
@@ -221,6 +271,136 @@ static void* run_blocks(void* arg)
     return 0;
 }
 
+/* Each thread takes a tile of pixels, and accumulates the contribution
+ * from each tile of visibilities in turn, so that the pixel coordinates,
+ * the visibilities and the partial sums all stay in the cache.
+ * The phases, sines and cosines are evaluated in a loop over contiguous
+ * pixels for each visibility, so that the loop can be vectorised. */
+static void dft_tiled_d(int num_threads, int num_vis, const double* uu,
+        const double* vv, const double* ww, const double2* amp,
+        const double* weight, int num_pixels, const double* l, const double* m,
+        const double* n, double* plane)
+{
+    int p0;
+#ifndef _OPENMP
+    (void)num_threads;
+#endif
+#pragma omp parallel for private(p0) schedule(dynamic) num_threads(num_threads)
+    for (p0 = 0; p0 < num_pixels; p0 += TILE_PIX)
+    {
+        int i, j, p, num_p;
+        double sum[TILE_PIX];
+        double t_u[TILE_VIS], t_v[TILE_VIS], t_w[TILE_VIS];
+        double t_re[TILE_VIS], t_im[TILE_VIS];
+        const double *t_l = l + p0, *t_m = m + p0, *t_n = n ? n + p0 : 0;
+        num_p = (num_pixels - p0 < TILE_PIX) ? num_pixels - p0 : TILE_PIX;
+        for (p = 0; p < num_p; ++p) sum[p] = 0.0;
+        for (i = 0; i < num_vis; i += TILE_VIS)
+        {
+            const int num_v = (num_vis - i < TILE_VIS) ? num_vis - i : TILE_VIS;
+
+            /* Scale and weight the visibilities in the tile. */
+            for (j = 0; j < num_v; ++j)
+            {
+                t_u[j] = -2.0 * M_PI * uu[i + j];
+                t_v[j] = -2.0 * M_PI * vv[i + j];
+                t_w[j] = ww ? -2.0 * M_PI * ww[i + j] : 0.0;
+                t_re[j] = amp[i + j].x * weight[i + j];
+                t_im[j] = amp[i + j].y * weight[i + j];
+            }
+
+            /* Output is real, so only evaluate the real part. */
+            for (j = 0; j < num_v; ++j)
+            {
+                const double u = t_u[j], v = t_v[j], w = t_w[j];
+                const double re = t_re[j], im = t_im[j];
+                if (t_n)
+                {
+                    for (p = 0; p < num_p; ++p)
+                    {
+                        const double a = u * t_l[p] + v * t_m[p] + w * t_n[p];
+                        sum[p] += re * cos(a) - im * sin(a);
+                    }
+                }
+                else
+                {
+                    for (p = 0; p < num_p; ++p)
+                    {
+                        const double a = u * t_l[p] + v * t_m[p];
+                        sum[p] += re * cos(a) - im * sin(a);
+                    }
+                }
+            }
+        }
+        for (p = 0; p < num_p; ++p) plane[p0 + p] += sum[p];
+    }
+}
+
+/* Partial sums over each tile of visibilities are accumulated in
+ * double precision. */
+static void dft_tiled_f(int num_threads, int num_vis, const float* uu,
+        const float* vv, const float* ww, const float2* amp,
+        const float* weight, int num_pixels, const float* l, const float* m,
+        const float* n, float* plane)
+{
+    int p0;
+#ifndef _OPENMP
+    (void)num_threads;
+#endif
+#pragma omp parallel for private(p0) schedule(dynamic) num_threads(num_threads)
+    for (p0 = 0; p0 < num_pixels; p0 += TILE_PIX)
+    {
+        int i, j, p, num_p;
+        double sum[TILE_PIX];
+        float t_sum[TILE_PIX];
+        float t_u[TILE_VIS], t_v[TILE_VIS], t_w[TILE_VIS];
+        float t_re[TILE_VIS], t_im[TILE_VIS];
+        const float *t_l = l + p0, *t_m = m + p0, *t_n = n ? n + p0 : 0;
+        num_p = (num_pixels - p0 < TILE_PIX) ? num_pixels - p0 : TILE_PIX;
+        for (p = 0; p < num_p; ++p) sum[p] = 0.0;
+        for (i = 0; i < num_vis; i += TILE_VIS)
+        {
+            const int num_v = (num_vis - i < TILE_VIS) ? num_vis - i : TILE_VIS;
+
+            /* Scale and weight the visibilities in the tile. */
+            for (j = 0; j < num_v; ++j)
+            {
+                t_u[j] = (float) (-2.0 * M_PI) * uu[i + j];
+                t_v[j] = (float) (-2.0 * M_PI) * vv[i + j];
+                t_w[j] = ww ? (float) (-2.0 * M_PI) * ww[i + j] : 0.0f;
+                t_re[j] = amp[i + j].x * weight[i + j];
+                t_im[j] = amp[i + j].y * weight[i + j];
+            }
+
+            /* Output is real, so only evaluate the real part. */
+            for (p = 0; p < num_p; ++p) t_sum[p] = 0.0f;
+            for (j = 0; j < num_v; ++j)
+            {
+                const float u = t_u[j], v = t_v[j], w = t_w[j];
+                const float re = t_re[j], im = t_im[j];
+                if (t_n)
+                {
+                    for (p = 0; p < num_p; ++p)
+                    {
+                        const float a = u * t_l[p] + v * t_m[p] + w * t_n[p];
+                        t_sum[p] += re * cosf(a) - im * sinf(a);
+                    }
+                }
+                else
+                {
+                    for (p = 0; p < num_p; ++p)
+                    {
+                        const float a = u * t_l[p] + v * t_m[p];
+                        t_sum[p] += re * cosf(a) - im * sinf(a);
+                    }
+                }
+            }
+            for (p = 0; p < num_p; ++p) sum[p] += t_sum[p];
+        }
+        for (p = 0; p < num_p; ++p) plane[p0 + p] += (float) sum[p];
+    }
+}
+
 #ifdef __cplusplus
 }
 #endif
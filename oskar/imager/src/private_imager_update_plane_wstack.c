@@ -0,0 +1,244 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "imager/private_imager.h"
+#include "imager/oskar_imager.h"
+
+#include "imager/private_imager_update_plane_wstack.h"
+#include "imager/oskar_grid_simple.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void oskar_imager_update_plane_wstack(oskar_Imager* h, size_t num_vis,
+        const oskar_Mem* uu, const oskar_Mem* vv, const oskar_Mem* ww,
+        const oskar_Mem* amps, const oskar_Mem* weight, oskar_Mem* plane,
+        double* plane_norm, size_t* num_skipped, int* status)
+{
+    int grid_size, k, num_layers, w_layer_start, w_layer_end;
+    size_t i, j, num_cells, *offset, *fill;
+    int* layer;
+    double w_min, w_inc;
+    const void* w_ptr;
+    oskar_Mem *uu_, *vv_, *amp_, *weight_;
+    if (*status) return;
+    grid_size = oskar_imager_plane_size(h);
+    num_cells = grid_size * grid_size;
+    num_layers = h->num_w_layers_mem;
+    if (oskar_mem_precision(plane) != h->imager_prec)
+        *status = OSKAR_ERR_TYPE_MISMATCH;
+    if (oskar_mem_length(plane) < (1 + num_layers) * num_cells)
+        oskar_mem_realloc(plane, (1 + num_layers) * num_cells, status);
+    if (*status) return;
+
+    /* Create the work arrays, which are kept until the cache is reset. */
+    if (!h->w_layer)
+    {
+        h->w_layer = oskar_mem_create(OSKAR_INT, OSKAR_CPU, 0, status);
+        h->w_uu = oskar_mem_create(h->imager_prec, OSKAR_CPU, 0, status);
+        h->w_vv = oskar_mem_create(h->imager_prec, OSKAR_CPU, 0, status);
+        h->w_amp = oskar_mem_create(h->imager_prec | OSKAR_COMPLEX,
+                OSKAR_CPU, 0, status);
+        h->w_weight = oskar_mem_create(h->imager_prec, OSKAR_CPU, 0, status);
+    }
+    if (!h->w_layer_offset)
+    {
+        h->w_layer_offset = (size_t*) malloc(
+                (num_layers + 1) * sizeof(size_t));
+        h->w_layer_fill = (size_t*) malloc(num_layers * sizeof(size_t));
+        if (!h->w_layer_offset || !h->w_layer_fill)
+        {
+            free(h->w_layer_offset);
+            free(h->w_layer_fill);
+            h->w_layer_offset = 0;
+            h->w_layer_fill = 0;
+            *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+        }
+    }
+    if (oskar_mem_length(h->w_layer) < num_vis)
+        oskar_mem_realloc(h->w_layer, num_vis, status);
+    if (*status) return;
+    offset = h->w_layer_offset;
+    fill = h->w_layer_fill;
+    uu_ = h->w_uu;
+    vv_ = h->w_vv;
+    amp_ = h->w_amp;
+    weight_ = h->w_weight;
+
+    /* Find the W-layer for each visibility, and count the number in each
+     * of the layers held in memory. */
+    w_min = h->w_layer_min;
+    w_inc = h->w_layer_inc;
+    w_layer_start = h->w_layer_start;
+    w_layer_end = w_layer_start + num_layers;
+    for (k = 0; k <= num_layers; ++k) offset[k] = 0;
+    layer = oskar_mem_int(h->w_layer, status);
+    w_ptr = oskar_mem_void_const(ww);
+    for (i = 0; i < num_vis; ++i)
+    {
+        const double w = fabs(h->imager_prec == OSKAR_DOUBLE ?
+                ((const double*) w_ptr)[i] : ((const float*) w_ptr)[i]);
+        k = (w_inc > 0.0) ? (int) floor((w - w_min) / w_inc) : 0;
+        if (k < 0) k = 0;
+        if (k >= h->num_w_planes) k = h->num_w_planes - 1;
+        if (k < w_layer_start || k >= w_layer_end)
+            layer[i] = -1;
+        else
+        {
+            layer[i] = k - w_layer_start;
+            offset[layer[i] + 1]++;
+        }
+    }
+    for (k = 0; k < num_layers; ++k)
+    {
+        offset[k + 1] += offset[k];
+        fill[k] = offset[k];
+    }
+
+    /* Sort the visibilities by layer. Visibilities with negative W are
+     * replaced by their conjugates, as only the real part of the image
+     * is needed. */
+    if (oskar_mem_length(uu_) < offset[num_layers])
+    {
+        oskar_mem_realloc(uu_, offset[num_layers], status);
+        oskar_mem_realloc(vv_, offset[num_layers], status);
+        oskar_mem_realloc(amp_, offset[num_layers], status);
+        oskar_mem_realloc(weight_, offset[num_layers], status);
+    }
+    if (*status)
+    {
+        /* Nothing to do. */
+    }
+    else if (h->imager_prec == OSKAR_DOUBLE)
+    {
+        const double *u_in, *v_in, *w_in, *wt_in;
+        const double2* a_in;
+        double *u_out, *v_out, *wt_out;
+        double2* a_out;
+        u_in = oskar_mem_double_const(uu, status);
+        v_in = oskar_mem_double_const(vv, status);
+        w_in = oskar_mem_double_const(ww, status);
+        a_in = oskar_mem_double2_const(amps, status);
+        wt_in = oskar_mem_double_const(weight, status);
+        u_out = oskar_mem_double(uu_, status);
+        v_out = oskar_mem_double(vv_, status);
+        a_out = oskar_mem_double2(amp_, status);
+        wt_out = oskar_mem_double(weight_, status);
+        for (i = 0; i < num_vis; ++i)
+        {
+            if (layer[i] < 0) continue;
+            j = fill[layer[i]]++;
+            wt_out[j] = wt_in[i];
+            if (w_in[i] < 0.0)
+            {
+                u_out[j] = -u_in[i];
+                v_out[j] = -v_in[i];
+                a_out[j].x = a_in[i].x;
+                a_out[j].y = -a_in[i].y;
+            }
+            else
+            {
+                u_out[j] = u_in[i];
+                v_out[j] = v_in[i];
+                a_out[j] = a_in[i];
+            }
+        }
+    }
+    else
+    {
+        const float *u_in, *v_in, *w_in, *wt_in;
+        const float2* a_in;
+        float *u_out, *v_out, *wt_out;
+        float2* a_out;
+        u_in = oskar_mem_float_const(uu, status);
+        v_in = oskar_mem_float_const(vv, status);
+        w_in = oskar_mem_float_const(ww, status);
+        a_in = oskar_mem_float2_const(amps, status);
+        wt_in = oskar_mem_float_const(weight, status);
+        u_out = oskar_mem_float(uu_, status);
+        v_out = oskar_mem_float(vv_, status);
+        a_out = oskar_mem_float2(amp_, status);
+        wt_out = oskar_mem_float(weight_, status);
+        for (i = 0; i < num_vis; ++i)
+        {
+            if (layer[i] < 0) continue;
+            j = fill[layer[i]]++;
+            wt_out[j] = wt_in[i];
+            if (w_in[i] < 0.0f)
+            {
+                u_out[j] = -u_in[i];
+                v_out[j] = -v_in[i];
+                a_out[j].x = a_in[i].x;
+                a_out[j].y = -a_in[i].y;
+            }
+            else
+            {
+                u_out[j] = u_in[i];
+                v_out[j] = v_in[i];
+                a_out[j] = a_in[i];
+            }
+        }
+    }
+
+    /* Grid the visibilities in each layer using the small kernel.
+     * The first grid in the plane is used for the accumulated image. */
+    for (k = 0; k < num_layers && !*status; ++k)
+    {
+        size_t layer_skipped = 0;
+        const size_t start = offset[k], num = offset[k + 1] - offset[k];
+        const size_t grid_offset = 2 * (1 + k) * num_cells;
+        if (num == 0) continue;
+        if (h->imager_prec == OSKAR_DOUBLE)
+            oskar_grid_simple_d(h->support, h->oversample,
+                    oskar_mem_double_const(h->conv_func, status), num,
+                    oskar_mem_double_const(uu_, status) + start,
+                    oskar_mem_double_const(vv_, status) + start,
+                    oskar_mem_double_const(amp_, status) + 2 * start,
+                    oskar_mem_double_const(weight_, status) + start,
+                    h->cellsize_rad, grid_size, &layer_skipped, plane_norm,
+                    oskar_mem_double(plane, status) + grid_offset);
+        else
+            oskar_grid_simple_f(h->support, h->oversample,
+                    oskar_mem_float_const(h->conv_func, status), num,
+                    oskar_mem_float_const(uu_, status) + start,
+                    oskar_mem_float_const(vv_, status) + start,
+                    oskar_mem_float_const(amp_, status) + 2 * start,
+                    oskar_mem_float_const(weight_, status) + start,
+                    (float) (h->cellsize_rad), grid_size, &layer_skipped,
+                    plane_norm, oskar_mem_float(plane, status) + grid_offset);
+        *num_skipped += layer_skipped;
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -28,6 +28,14 @@
 
 #include <gtest/gtest.h>
 #include "imager/oskar_imager.h"
+#include "imager/oskar_grid_simple.h"
+#include "imager/oskar_grid_wproj.h"
+#include "imager/oskar_grid_tiles.h"
+#include <cstring>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 // #define WRITE_FITS 1
 #ifdef WRITE_FITS
@@ -110,3 +118,149 @@ TEST(imager, grid_sum)
     oskar_mem_free(weight, &status);
     oskar_mem_free(grid, &status);
 }
+
+
+#ifdef _OPENMP
+TEST(imager, grid_parallel)
+{
+    int status = 0, grid_size = 256, oversample = 4, conv_size_half = 64;
+    int num_vis = 20000, num_w_planes = 3, w_support[] = {3, 7, 12};
+    size_t num_cells = grid_size * grid_size;
+    double cell_size_rad = 1e-3, w_scale = 0.01;
+
+    // Create visibility data, including some points off the grid.
+    oskar_Mem* uu = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_vis, &status);
+    oskar_Mem* vv = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_vis, &status);
+    oskar_Mem* ww = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_vis, &status);
+    oskar_Mem* vis = oskar_mem_create(OSKAR_DOUBLE_COMPLEX, OSKAR_CPU,
+            num_vis, &status);
+    oskar_Mem* weight = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU,
+            num_vis, &status);
+    oskar_mem_random_gaussian(uu, 0, 1, 2, 3, 200.0, &status);
+    oskar_mem_random_gaussian(vv, 4, 5, 6, 7, 200.0, &status);
+    oskar_mem_random_gaussian(ww, 8, 9, 10, 11, 100.0, &status);
+    oskar_mem_random_gaussian(vis, 12, 13, 14, 15, 1.0, &status);
+    oskar_mem_random_uniform(weight, 16, 17, 18, 19, &status);
+
+    // Create arbitrary convolution kernels.
+    oskar_Mem* kernel = oskar_mem_create(OSKAR_DOUBLE_COMPLEX, OSKAR_CPU,
+            num_w_planes * conv_size_half * conv_size_half, &status);
+    oskar_mem_random_uniform(kernel, 20, 21, 22, 23, &status);
+    ASSERT_EQ(0, status);
+
+    // Grid with one thread and with several threads.
+    int num_threads = omp_get_max_threads();
+    oskar_Mem* grid[2];
+    double norm[2];
+    size_t num_skipped[2];
+    for (int algorithm = 0; algorithm < 2; ++algorithm)
+    {
+        for (int i = 0; i < 2; ++i)
+        {
+            omp_set_num_threads(i == 0 ? 1 : 4);
+            norm[i] = 0.0;
+            grid[i] = oskar_mem_create(OSKAR_DOUBLE_COMPLEX, OSKAR_CPU,
+                    num_cells, &status);
+            oskar_mem_clear_contents(grid[i], &status);
+            if (algorithm == 0)
+                oskar_grid_simple_d(w_support[1], oversample,
+                        oskar_mem_double_const(kernel, &status), num_vis,
+                        oskar_mem_double_const(uu, &status),
+                        oskar_mem_double_const(vv, &status),
+                        oskar_mem_double_const(vis, &status),
+                        oskar_mem_double_const(weight, &status),
+                        cell_size_rad, grid_size, &num_skipped[i], &norm[i],
+                        oskar_mem_double(grid[i], &status));
+            else
+                oskar_grid_wproj_d(num_w_planes, w_support, oversample,
+                        conv_size_half,
+                        oskar_mem_double_const(kernel, &status), num_vis,
+                        oskar_mem_double_const(uu, &status),
+                        oskar_mem_double_const(vv, &status),
+                        oskar_mem_double_const(ww, &status),
+                        oskar_mem_double_const(vis, &status),
+                        oskar_mem_double_const(weight, &status),
+                        cell_size_rad, w_scale, grid_size, &num_skipped[i],
+                        &norm[i], oskar_mem_double(grid[i], &status));
+        }
+        omp_set_num_threads(num_threads);
+        ASSERT_EQ(0, status);
+
+        // Check the results are bitwise identical.
+        EXPECT_GT(num_skipped[0], 0u);
+        EXPECT_LT(num_skipped[0], (size_t) num_vis);
+        EXPECT_EQ(num_skipped[0], num_skipped[1]);
+        EXPECT_EQ(0, memcmp(&norm[0], &norm[1], sizeof(double)));
+        EXPECT_EQ(0, memcmp(oskar_mem_void_const(grid[0]),
+                oskar_mem_void_const(grid[1]), num_cells * sizeof(double2)));
+        oskar_mem_free(grid[0], &status);
+        oskar_mem_free(grid[1], &status);
+    }
+
+    // Clean up.
+    oskar_mem_free(uu, &status);
+    oskar_mem_free(vv, &status);
+    oskar_mem_free(ww, &status);
+    oskar_mem_free(vis, &status);
+    oskar_mem_free(weight, &status);
+    oskar_mem_free(kernel, &status);
+}
+
+
+TEST(imager, grid_tiles_fewer_threads)
+{
+    int status = 0, grid_size = 256, tile_size = 32, num_vis = 5000;
+    int num_tiles = (grid_size / tile_size) * (grid_size / tile_size);
+
+    // Create grid coordinates, with some points ignored.
+    int* grid_u = (int*) malloc(num_vis * sizeof(int));
+    int* grid_v = (int*) malloc(num_vis * sizeof(int));
+    int* support = (int*) malloc(num_vis * sizeof(int));
+    for (int i = 0; i < num_vis; ++i)
+    {
+        support[i] = (i % 17 == 0) ? -1 : 1 + i % 5;
+        grid_u[i] = support[i] + (i * 7919) % (grid_size - 2 * 6);
+        grid_v[i] = support[i] + (i * 104729) % (grid_size - 2 * 6);
+    }
+
+    // Bin with four ranges, first with all threads available, then from
+    // inside a parallel region where only one thread can be used.
+    oskar_Mem* tile_start[2];
+    oskar_Mem* tile_vis[2];
+    for (int i = 0; i < 2; ++i)
+    {
+        tile_start[i] = oskar_mem_create(OSKAR_INT, OSKAR_CPU, 0, &status);
+        tile_vis[i] = oskar_mem_create(OSKAR_INT, OSKAR_CPU, 0, &status);
+    }
+    oskar_grid_tiles_bin(grid_size, tile_size, 4, num_vis, grid_u, grid_v,
+            support, tile_start[0], tile_vis[0], &status);
+    int max_levels = omp_get_max_active_levels();
+    omp_set_max_active_levels(1);
+#pragma omp parallel num_threads(2)
+    {
+#pragma omp single
+        oskar_grid_tiles_bin(grid_size, tile_size, 4, num_vis, grid_u,
+                grid_v, support, tile_start[1], tile_vis[1], &status);
+    }
+    omp_set_max_active_levels(max_levels);
+    ASSERT_EQ(0, status);
+
+    // Check that no visibilities were dropped.
+    const int* start = oskar_mem_int_const(tile_start[1], &status);
+    ASSERT_EQ(0, memcmp(oskar_mem_void_const(tile_start[0]), start,
+            (num_tiles + 1) * sizeof(int)));
+    EXPECT_EQ(0, memcmp(oskar_mem_void_const(tile_vis[0]),
+            oskar_mem_void_const(tile_vis[1]), start[num_tiles] * sizeof(int)));
+    EXPECT_GT(start[num_tiles], num_vis - num_vis / 17 - 1);
+
+    // Clean up.
+    for (int i = 0; i < 2; ++i)
+    {
+        oskar_mem_free(tile_start[i], &status);
+        oskar_mem_free(tile_vis[i], &status);
+    }
+    free(grid_u);
+    free(grid_v);
+    free(support);
+}
+#endif
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+#include "imager/oskar_imager.h"
+#include "math/oskar_cmath.h"
+#include "math/oskar_dft_c2r.h"
+#include "math/oskar_evaluate_image_lmn_grid.h"
+#include "utility/oskar_get_error_string.h"
+#include <cmath>
+#include <cstring>
+
+static double sum_weights(const oskar_Mem* weight, int* status)
+{
+    double sum = 0.0;
+    size_t num = oskar_mem_length(weight);
+    if (oskar_mem_precision(weight) == OSKAR_DOUBLE)
+    {
+        const double* w = oskar_mem_double_const(weight, status);
+        for (size_t i = 0; i < num; ++i) sum += w[i];
+    }
+    else
+    {
+        const float* w = oskar_mem_float_const(weight, status);
+        for (size_t i = 0; i < num; ++i) sum += w[i];
+    }
+    return sum;
+}
+
+static void check_dft(int prec, const char* algorithm, double tol)
+{
+    // Use pixel and visibility counts that do not fill whole tiles.
+    int status = 0, size = 38, num_vis = 1000;
+    int num_pixels = size * size;
+    double fov_deg = 5.0;
+    const int is_3d = !strcmp(algorithm, "DFT 3D");
+
+    // Generate some visibilities.
+    oskar_Mem* uu = oskar_mem_create(prec, OSKAR_CPU, num_vis, &status);
+    oskar_Mem* vv = oskar_mem_create(prec, OSKAR_CPU, num_vis, &status);
+    oskar_Mem* ww = oskar_mem_create(prec, OSKAR_CPU, num_vis, &status);
+    oskar_Mem* time = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_vis,
+            &status);
+    oskar_Mem* vis = oskar_mem_create(prec | OSKAR_COMPLEX, OSKAR_CPU,
+            num_vis, &status);
+    oskar_Mem* weight = oskar_mem_create(prec, OSKAR_CPU, num_vis, &status);
+    oskar_mem_random_gaussian(uu, 0, 1, 2, 3, 200.0, &status);
+    oskar_mem_random_gaussian(vv, 4, 5, 6, 7, 200.0, &status);
+    oskar_mem_random_gaussian(ww, 8, 9, 10, 11, 200.0, &status);
+    oskar_mem_random_gaussian(vis, 12, 13, 14, 15, 1.0, &status);
+    oskar_mem_random_uniform(weight, 16, 17, 18, 19, &status);
+    oskar_mem_clear_contents(time, &status);
+    ASSERT_EQ(0, status);
+
+    // Make the image on the CPU, using a few threads.
+    oskar_Imager* im = oskar_imager_create(prec, &status);
+    oskar_imager_set_gpus(im, 0, 0, &status);
+    oskar_imager_set_num_devices(im, 3);
+    oskar_imager_set_algorithm(im, algorithm, &status);
+    oskar_imager_set_fov(im, fov_deg);
+    oskar_imager_set_size(im, size, &status);
+    oskar_imager_set_vis_frequency(im, 299792458.0, 1.0, 1);
+    oskar_imager_update(im, num_vis, 0, 0, 1,
+            uu, vv, ww, vis, weight, time, &status);
+    oskar_Mem* image = oskar_mem_create(prec, OSKAR_CPU, num_pixels, &status);
+    oskar_imager_finalise(im, 1, &image, 0, 0, &status);
+    oskar_imager_free(im, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Make the reference image.
+    oskar_Mem* l = oskar_mem_create(prec, OSKAR_CPU, num_pixels, &status);
+    oskar_Mem* m = oskar_mem_create(prec, OSKAR_CPU, num_pixels, &status);
+    oskar_Mem* n = oskar_mem_create(prec, OSKAR_CPU, num_pixels, &status);
+    oskar_Mem* ref = oskar_mem_create(prec, OSKAR_CPU, num_pixels, &status);
+    oskar_evaluate_image_lmn_grid(size, size, fov_deg * M_PI / 180.0,
+            fov_deg * M_PI / 180.0, 0, l, m, n, &status);
+    oskar_mem_add_real(n, -1.0, &status);
+    oskar_dft_c2r(num_vis, 2.0 * M_PI, uu, vv, is_3d ? ww : 0, vis, weight,
+            num_pixels, l, m, is_3d ? n : 0, ref, &status);
+    oskar_mem_scale_real(ref, 1.0 / sum_weights(weight, &status), &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Compare the images.
+    double max_err = 0.0;
+    for (int i = 0; i < num_pixels; ++i)
+    {
+        const double a = oskar_mem_get_element(image, i, &status);
+        const double b = oskar_mem_get_element(ref, i, &status);
+        if (fabs(a - b) > max_err) max_err = fabs(a - b);
+    }
+    EXPECT_LT(max_err, tol) << algorithm;
+
+    oskar_mem_free(uu, &status);
+    oskar_mem_free(vv, &status);
+    oskar_mem_free(ww, &status);
+    oskar_mem_free(time, &status);
+    oskar_mem_free(vis, &status);
+    oskar_mem_free(weight, &status);
+    oskar_mem_free(image, &status);
+    oskar_mem_free(l, &status);
+    oskar_mem_free(m, &status);
+    oskar_mem_free(n, &status);
+    oskar_mem_free(ref, &status);
+}
+
+TEST(imager, dft_2d_double)
+{
+    check_dft(OSKAR_DOUBLE, "DFT 2D", 1e-12);
+}
+
+TEST(imager, dft_3d_double)
+{
+    check_dft(OSKAR_DOUBLE, "DFT 3D", 1e-12);
+}
+
+TEST(imager, dft_2d_single)
+{
+    check_dft(OSKAR_SINGLE, "DFT 2D", 1e-5);
+}
+
+TEST(imager, dft_3d_single)
+{
+    check_dft(OSKAR_SINGLE, "DFT 3D", 1e-5);
+}
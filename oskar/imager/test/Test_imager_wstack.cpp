@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+#include "binary/oskar_binary.h"
+#include "imager/oskar_imager.h"
+#include "math/oskar_cmath.h"
+#include "vis/oskar_vis_block.h"
+#include "vis/oskar_vis_header.h"
+#include <cmath>
+#include <cstdio>
+
+static oskar_Mem* make_image(const char* algorithm,
+        const oskar_Mem* uu, const oskar_Mem* vv, const oskar_Mem* ww,
+        const oskar_Mem* vis, const oskar_Mem* weight, const oskar_Mem* time,
+        int size, double fov_deg, int* status)
+{
+    oskar_Imager* im = oskar_imager_create(OSKAR_DOUBLE, status);
+    oskar_imager_set_algorithm(im, algorithm, status);
+    oskar_imager_set_fov(im, fov_deg);
+    oskar_imager_set_size(im, size, status);
+    oskar_imager_set_vis_frequency(im, 299792458.0, 1.0, 1);
+    oskar_imager_set_coords_only(im, 1);
+    oskar_imager_update(im, oskar_mem_length(uu), 0, 0, 1,
+            uu, vv, ww, vis, weight, time, status);
+    oskar_imager_set_coords_only(im, 0);
+    oskar_imager_update(im, oskar_mem_length(uu), 0, 0, 1,
+            uu, vv, ww, vis, weight, time, status);
+    oskar_Mem* image = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU,
+            size * size, status);
+    oskar_imager_finalise(im, 1, &image, 0, 0, status);
+    oskar_imager_free(im, status);
+    return image;
+}
+
+static double rms_diff(const oskar_Mem* a, const oskar_Mem* b, int* status)
+{
+    const double *p = oskar_mem_double_const(a, status);
+    const double *q = oskar_mem_double_const(b, status);
+    size_t num = oskar_mem_length(a);
+    double sum = 0.0;
+    for (size_t i = 0; i < num; ++i) sum += (p[i] - q[i]) * (p[i] - q[i]);
+    return sqrt(sum / num);
+}
+
+TEST(imager, wstack)
+{
+    int status = 0, size = 128;
+    double fov_deg = 20.0, l0 = 0.12, m0 = -0.09;
+    double n0 = sqrt(1.0 - l0 * l0 - m0 * m0);
+
+    // Simulate a point source far from the phase centre, with large w.
+    int num_vis = 4000;
+    oskar_Mem* uu = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_vis, &status);
+    oskar_Mem* vv = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_vis, &status);
+    oskar_Mem* ww = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_vis, &status);
+    oskar_Mem* time = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_vis,
+            &status);
+    oskar_Mem* vis = oskar_mem_create(OSKAR_DOUBLE_COMPLEX, OSKAR_CPU,
+            num_vis, &status);
+    oskar_Mem* weight = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_vis,
+            &status);
+    oskar_mem_random_gaussian(uu, 0, 1, 2, 3, 40.0, &status);
+    oskar_mem_random_gaussian(vv, 4, 5, 6, 7, 40.0, &status);
+    oskar_mem_random_gaussian(ww, 8, 9, 10, 11, 150.0, &status);
+    oskar_mem_clear_contents(time, &status);
+    oskar_mem_set_value_real(weight, 1.0, 0, num_vis, &status);
+    const double *u = oskar_mem_double_const(uu, &status);
+    const double *v = oskar_mem_double_const(vv, &status);
+    const double *w = oskar_mem_double_const(ww, &status);
+    double2* t = oskar_mem_double2(vis, &status);
+    for (int i = 0; i < num_vis; ++i)
+    {
+        const double phase = 2.0 * M_PI *
+                (u[i] * l0 + v[i] * m0 + w[i] * (n0 - 1.0));
+        t[i].x = cos(phase);
+        t[i].y = sin(phase);
+    }
+    ASSERT_EQ(0, status);
+
+    // Make images using each algorithm.
+    oskar_Mem* dft = make_image("DFT 3D", uu, vv, ww, vis, weight, time,
+            size, fov_deg, &status);
+    oskar_Mem* fft = make_image("FFT", uu, vv, ww, vis, weight, time,
+            size, fov_deg, &status);
+    oskar_Mem* wstack = make_image("W-stacking", uu, vv, ww, vis, weight,
+            time, size, fov_deg, &status);
+    ASSERT_EQ(0, status);
+
+    // W-stacking should be much closer to the DFT than a plain FFT.
+    double err_fft = rms_diff(fft, dft, &status);
+    double err_wstack = rms_diff(wstack, dft, &status);
+    EXPECT_LT(err_wstack, 0.1 * err_fft);
+
+    // Check the peak value at the source position.
+    const double *p_dft = oskar_mem_double_const(dft, &status);
+    const double *p_wstack = oskar_mem_double_const(wstack, &status);
+    int i_max = 0;
+    for (int i = 0; i < size * size; ++i)
+        if (p_dft[i] > p_dft[i_max]) i_max = i;
+    EXPECT_GT(p_dft[i_max], 0.9);
+    EXPECT_NEAR(p_dft[i_max], p_wstack[i_max], 0.01);
+
+    oskar_mem_free(uu, &status);
+    oskar_mem_free(vv, &status);
+    oskar_mem_free(ww, &status);
+    oskar_mem_free(time, &status);
+    oskar_mem_free(vis, &status);
+    oskar_mem_free(weight, &status);
+    oskar_mem_free(dft, &status);
+    oskar_mem_free(fft, &status);
+    oskar_mem_free(wstack, &status);
+}
+
+static int run_imager(const char* filename, int max_layers,
+        int size, double fov_deg, oskar_Mem* image, int* status)
+{
+    oskar_Imager* im = oskar_imager_create(OSKAR_DOUBLE, status);
+    oskar_imager_set_algorithm(im, "W-stacking", status);
+    oskar_imager_set_fov(im, fov_deg);
+    oskar_imager_set_size(im, size, status);
+    oskar_imager_set_max_w_layers_in_memory(im, max_layers);
+    oskar_imager_set_input_files(im, 1, &filename, status);
+    oskar_imager_run(im, 1, &image, 0, 0, status);
+    int num_layers = oskar_imager_num_w_planes(im);
+    oskar_imager_free(im, status);
+    return num_layers;
+}
+
+TEST(imager, wstack_multi_pass)
+{
+    int status = 0, size = 128, num_stations = 90;
+    double fov_deg = 20.0, l0 = 0.12, m0 = -0.09;
+    double n0 = sqrt(1.0 - l0 * l0 - m0 * m0);
+    const char* filename = "temp_test_imager_wstack_multi_pass.vis";
+
+    // Write a point source far from the phase centre to a visibility file.
+    oskar_VisHeader* hdr = oskar_vis_header_create(OSKAR_DOUBLE_COMPLEX,
+            OSKAR_DOUBLE, 1, 1, 1, 1, num_stations, 0, 1, &status);
+    oskar_vis_header_set_freq_start_hz(hdr, 299792458.0);
+    oskar_vis_header_set_freq_inc_hz(hdr, 1.0);
+    oskar_VisBlock* blk = oskar_vis_block_create_from_header(OSKAR_CPU,
+            hdr, &status);
+    oskar_Mem* uu = oskar_vis_block_baseline_uu_metres(blk);
+    oskar_Mem* vv = oskar_vis_block_baseline_vv_metres(blk);
+    oskar_Mem* ww = oskar_vis_block_baseline_ww_metres(blk);
+    int num_vis = (int) oskar_mem_length(uu);
+    oskar_mem_random_gaussian(uu, 0, 1, 2, 3, 40.0, &status);
+    oskar_mem_random_gaussian(vv, 4, 5, 6, 7, 40.0, &status);
+    oskar_mem_random_gaussian(ww, 8, 9, 10, 11, 150.0, &status);
+    const double *u = oskar_mem_double_const(uu, &status);
+    const double *v = oskar_mem_double_const(vv, &status);
+    const double *w = oskar_mem_double_const(ww, &status);
+    double2* t = oskar_mem_double2(
+            oskar_vis_block_cross_correlations(blk), &status);
+    for (int i = 0; i < num_vis; ++i)
+    {
+        const double phase = 2.0 * M_PI *
+                (u[i] * l0 + v[i] * m0 + w[i] * (n0 - 1.0));
+        t[i].x = cos(phase);
+        t[i].y = sin(phase);
+    }
+    oskar_Binary* file = oskar_vis_header_write(hdr, filename, &status);
+    oskar_vis_block_write(blk, file, 0, &status);
+    oskar_binary_free(file);
+    oskar_vis_block_free(blk, &status);
+    oskar_vis_header_free(hdr, &status);
+    ASSERT_EQ(0, status);
+
+    // Image with all W-layers in memory, and with only a few at a time.
+    oskar_Mem* single = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU,
+            size * size, &status);
+    oskar_Mem* multi = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU,
+            size * size, &status);
+    run_imager(filename, 0, size, fov_deg, single, &status);
+    int num_layers = run_imager(filename, 3, size, fov_deg, multi, &status);
+    ASSERT_EQ(0, status);
+    ASSERT_GT(num_layers, 3);
+
+    // Both should give the same image, with the source present.
+    const double *p_single = oskar_mem_double_const(single, &status);
+    const double *p_multi = oskar_mem_double_const(multi, &status);
+    int i_max = 0;
+    for (int i = 0; i < size * size; ++i)
+    {
+        ASSERT_NEAR(p_single[i], p_multi[i], 1e-10);
+        if (p_single[i] > p_single[i_max]) i_max = i;
+    }
+    EXPECT_GT(p_single[i_max], 0.9);
+
+    oskar_mem_free(single, &status);
+    oskar_mem_free(multi, &status);
+    remove(filename);
+}
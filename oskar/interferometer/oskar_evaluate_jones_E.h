@@ -50,8 +50,14 @@ extern "C" {
  * Evaluates station beams for a telescope model at the specified source
  * positions, storing the results in the Jones matrix data structure.
  *
- * If all stations are marked as identical, the results for the first station
- * are copied into the results for the others.
+ * If all stations are marked as identical, only the results for the first
+ * station are evaluated, and the Jones matrix block is marked as shared
+ * between all stations (see oskar_jones_set_shared_stations()).
+ *
+ * Otherwise, if the data are in CPU memory and more than one OpenMP thread
+ * is available, the stations are evaluated in parallel in chunks of
+ * directions, using a work buffer structure for each thread from the pool
+ * owned by \p work (see oskar_station_work_thread_pool()).
  *
  * @param[out] E            Output set of Jones matrices.
  * @param[in]  num_points   Number of direction cosines given.
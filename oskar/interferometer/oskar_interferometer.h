@@ -117,6 +117,14 @@ OSKAR_EXPORT
 void oskar_interferometer_set_max_sources_per_chunk(oskar_Interferometer* h,
 int value);
 
+OSKAR_EXPORT
+void oskar_interferometer_set_max_station_beam_cache_mb(
+        oskar_Interferometer* h, int value);
+
+OSKAR_EXPORT
+void oskar_interferometer_set_max_station_work_mb(oskar_Interferometer* h,
+        int value);
+
 OSKAR_EXPORT
 void oskar_interferometer_set_max_times_per_block(oskar_Interferometer* h,
         int value);
@@ -124,6 +132,10 @@ void oskar_interferometer_set_max_times_per_block(oskar_Interferometer* h,
 OSKAR_EXPORT
 void oskar_interferometer_set_num_devices(oskar_Interferometer* h, int value);
 
+OSKAR_EXPORT
+void oskar_interferometer_set_num_threads_per_device(
+        oskar_Interferometer* h, int value);
+
 OSKAR_EXPORT
 void oskar_interferometer_set_observation_frequency(oskar_Interferometer* h,
         double start_hz, double inc_hz, int num_channels);
@@ -148,6 +160,10 @@ OSKAR_EXPORT
 void oskar_interferometer_set_sky_model(oskar_Interferometer* h,
         const oskar_Sky* sky, int* status);
 
+OSKAR_EXPORT
+void oskar_interferometer_set_station_beam_cache_tolerance(
+        oskar_Interferometer* h, double tolerance_deg);
+
 OSKAR_EXPORT
 void oskar_interferometer_set_telescope_model(oskar_Interferometer* h,
         const oskar_Telescope* model, int* status);
@@ -56,6 +56,7 @@ typedef struct oskar_Jones oskar_Jones;
 #include <interferometer/oskar_jones_get_station_pointer.h>
 #include <interferometer/oskar_jones_join.h>
 #include <interferometer/oskar_jones_set_real_scalar.h>
+#include <interferometer/oskar_jones_set_shared_stations.h>
 #include <interferometer/oskar_jones_set_size.h>
 
 #endif /* OSKAR_JONES_H_ */
@@ -69,6 +69,21 @@ int oskar_jones_num_sources(const oskar_Jones* jones);
 OSKAR_EXPORT
 int oskar_jones_num_stations(const oskar_Jones* jones);
 
+/**
+ * @brief
+ * Returns true if all stations share the same Jones matrices.
+ *
+ * @details
+ * Returns true if the Jones matrix block holds data only for station 0,
+ * which is used for all stations (a station stride of zero).
+ *
+ * @param[in]     jones  Pointer to data structure.
+ *
+ * @return True if the station data are shared.
+ */
+OSKAR_EXPORT
+int oskar_jones_shared_stations(const oskar_Jones* jones);
+
 /**
  * @brief
  * Returns the enumerated data type of the Jones matrix block.
@@ -55,6 +55,10 @@ extern "C" {
  * same for J3, J1 and J2, and the data type (single precision or double
  * precision) must also be consistent.
  *
+ * If either input shares its data between all stations, it is used for
+ * every station of the output. The output can only be shared if both
+ * inputs are.
+ *
  * The element size of J3 should be greater than or equal to the element
  * size of J2. For example, J3 could be a full 2x2 complex matrix and J2 a
  * complex scalar, but not vice versa.
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OSKAR_JONES_SET_SHARED_STATIONS_H_
+#define OSKAR_JONES_SET_SHARED_STATIONS_H_
+
+/**
+ * @file oskar_jones_set_shared_stations.h
+ */
+
+#include <oskar_global.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Sets whether all stations share the same Jones matrices.
+ *
+ * @details
+ * If set, only the data for station 0 are stored, and these are used for
+ * every station (a station stride of zero). This is used for the station
+ * beams of a telescope with identical stations, so that they do not need
+ * to be copied for each station.
+ *
+ * oskar_jones_join() and oskar_auto_correlate() handle shared data directly.
+ * oskar_cross_correlate() requires data for every station.
+ *
+ * The flag can only be cleared if the capacity is large enough to hold
+ * data for all stations.
+ *
+ * @param[in] jones Pointer to the structure.
+ * @param[in] value If true, all stations share the data of station 0.
+ * @param[in,out]  status   Status return code.
+ */
+OSKAR_EXPORT
+void oskar_jones_set_shared_stations(oskar_Jones* jones, int value,
+        int* status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OSKAR_JONES_SET_SHARED_STATIONS_H_ */
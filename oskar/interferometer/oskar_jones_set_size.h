@@ -47,6 +47,7 @@ extern "C" {
  * a resize.
  *
  * The new size must be less than or equal to the existing capacity.
+ * If the station data are shared, only one station needs to fit.
  *
  * @param[in] jones Pointer to the structure.
  * @param[in] num_stations Number of elements in the station dimension.
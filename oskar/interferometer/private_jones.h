@@ -37,6 +37,7 @@ struct oskar_Jones
     int num_sources;  /* Fastest varying dimension. */
     int cap_stations; /* Slowest varying dimension. */
     int cap_sources;  /* Fastest varying dimension. */
+    int shared;       /* If true, all stations use the data of station 0. */
     oskar_Mem* data;  /* Matrix data. */
 };
 
@@ -30,10 +30,26 @@
 #include "interferometer/oskar_jones_get_station_pointer.h"
 #include "telescope/station/oskar_evaluate_station_beam.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* Preferred number of directions evaluated by each task. */
+#define CHUNK_SIZE 4096
+
+/* Smallest number of directions worth evaluating as a separate task. */
+#define MIN_CHUNK_SIZE 256
+
+static void evaluate_stations_parallel(oskar_Jones* E, int num_points,
+        int coord_type, const oskar_Mem* x, const oskar_Mem* y,
+        const oskar_Mem* z, const oskar_Telescope* tel, double gast,
+        double frequency_hz, oskar_StationWork* work, int time_index,
+        int num_threads, int* status);
+
 void oskar_evaluate_jones_E(oskar_Jones* E, int num_points, int coord_type,
         oskar_Mem* x, oskar_Mem* y, oskar_Mem* z, const oskar_Telescope* tel,
         double gast, double frequency_hz, oskar_StationWork* work,
@@ -58,46 +74,139 @@ void oskar_evaluate_jones_E(oskar_Jones* E, int num_points, int coord_type,
     if (oskar_telescope_allow_station_beam_duplication(tel) &&
             oskar_telescope_identical_stations(tel))
     {
-        /* Identical stations. */
-        oskar_Mem *E0; /* Pointer to row of E for station 0. */
-        const oskar_Station* station0;
-
-        /* Evaluate the beam pattern for station 0 */
-        E0 = oskar_mem_create_alias(0, 0, 0, status);
-        station0 = oskar_telescope_station_const(tel, 0);
-        oskar_jones_get_station_pointer(E0, E, 0, status);
-
-        oskar_evaluate_station_beam(E0, num_points, coord_type, x, y, z,
+        /* Identical stations: evaluate the beam pattern for station 0,
+         * and share it between all stations. */
+        oskar_jones_set_shared_stations(E, 1, status);
+        oskar_jones_get_station_pointer(E_st, E, 0, status);
+        oskar_evaluate_station_beam(E_st, num_points, coord_type, x, y, z,
                 oskar_telescope_phase_centre_ra_rad(tel),
                 oskar_telescope_phase_centre_dec_rad(tel),
-                station0, work, time_index, frequency_hz, gast, status);
-
-        /* Copy E for station 0 into memory for other stations. */
-        for (i = 1; i < num_stations; ++i)
-        {
-            oskar_jones_get_station_pointer(E_st, E, i, status);
-            oskar_mem_copy_contents(E_st, E0, 0, 0,
-                    oskar_mem_length(E0), status);
-        }
-        oskar_mem_free(E0, status);
+                oskar_telescope_station_const(tel, 0), work, time_index,
+                frequency_hz, gast, status);
     }
     else
     {
         /* Different stations. */
-        for (i = 0; i < num_stations; ++i)
+        int num_threads = 1;
+        oskar_jones_set_shared_stations(E, 0, status);
+#ifdef _OPENMP
+        if (oskar_jones_mem_location(E) == OSKAR_CPU)
+            num_threads = omp_get_max_threads();
+#endif
+        if (num_threads > 1)
         {
-            const oskar_Station* station;
-            station = oskar_telescope_station_const(tel, i);
-            oskar_jones_get_station_pointer(E_st, E, i, status);
-            oskar_evaluate_station_beam(E_st, num_points, coord_type, x, y, z,
-                    oskar_telescope_phase_centre_ra_rad(tel),
-                    oskar_telescope_phase_centre_dec_rad(tel),
-                    station, work, time_index, frequency_hz, gast, status);
+            evaluate_stations_parallel(E, num_points, coord_type, x, y, z,
+                    tel, gast, frequency_hz, work, time_index, num_threads,
+                    status);
+        }
+        else
+        {
+            for (i = 0; i < num_stations; ++i)
+            {
+                const oskar_Station* station;
+                station = oskar_telescope_station_const(tel, i);
+                oskar_jones_get_station_pointer(E_st, E, i, status);
+                oskar_evaluate_station_beam(E_st, num_points, coord_type,
+                        x, y, z, oskar_telescope_phase_centre_ra_rad(tel),
+                        oskar_telescope_phase_centre_dec_rad(tel),
+                        station, work, time_index, frequency_hz, gast,
+                        status);
+            }
         }
     }
     oskar_mem_free(E_st, status);
 }
 
+/* Evaluates station beams on the CPU in parallel, as tasks made from
+ * chunks of directions for each station. Each thread has its own work
+ * buffers and its own copy of the directions in the chunk, as the station
+ * beam function writes an extra direction at the end for normalisation. */
+static void evaluate_stations_parallel(oskar_Jones* E, int num_points,
+        int coord_type, const oskar_Mem* x, const oskar_Mem* y,
+        const oskar_Mem* z, const oskar_Telescope* tel, double gast,
+        double frequency_hz, oskar_StationWork* work, int time_index,
+        int num_threads, int* status)
+{
+    int num_stations, num_chunks, min_chunks, chunk_size, num_tasks;
+    int stride, type;
+    double ra0, dec0;
+    oskar_StationWork** pool;
+
+    /* Get a set of work buffers for each thread. */
+    pool = oskar_station_work_thread_pool(work, num_threads, status);
+    if (*status || num_points <= 0) return;
+
+    /* Generate element errors once for all chunks, unless the cache
+     * already holds them. */
+    oskar_station_work_evaluate_element_errors(work, tel, time_index, 1,
+            status);
+    if (*status) return;
+
+    /* Split the directions so there are enough tasks for all threads. */
+    num_stations = oskar_telescope_num_stations(tel);
+    num_chunks = (num_points + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    min_chunks = (2 * num_threads + num_stations - 1) / num_stations;
+    if (num_chunks < min_chunks) num_chunks = min_chunks;
+    chunk_size = (num_points + num_chunks - 1) / num_chunks;
+    if (chunk_size < MIN_CHUNK_SIZE) chunk_size = MIN_CHUNK_SIZE;
+    num_chunks = (num_points + chunk_size - 1) / chunk_size;
+    num_tasks = num_stations * num_chunks;
+    if (chunk_size > num_points) chunk_size = num_points;
+    stride = oskar_jones_num_sources(E);
+    type = oskar_mem_type(x);
+    ra0 = oskar_telescope_phase_centre_ra_rad(tel);
+    dec0 = oskar_telescope_phase_centre_dec_rad(tel);
+
+#pragma omp parallel num_threads(num_threads)
+    {
+        int t, thread_id = 0, thread_status = 0;
+        oskar_Mem *E_chunk, *x_chunk, *y_chunk, *z_chunk;
+        oskar_StationWork* thread_work;
+#ifdef _OPENMP
+        thread_id = omp_get_thread_num();
+#endif
+        thread_work = pool[thread_id];
+        E_chunk = oskar_mem_create_alias(0, 0, 0, &thread_status);
+        x_chunk = oskar_mem_create(type, OSKAR_CPU, chunk_size + 1,
+                &thread_status);
+        y_chunk = oskar_mem_create(type, OSKAR_CPU, chunk_size + 1,
+                &thread_status);
+        z_chunk = oskar_mem_create(type, OSKAR_CPU, chunk_size + 1,
+                &thread_status);
+
+#pragma omp for schedule(dynamic, 1)
+        for (t = 0; t < num_tasks; ++t)
+        {
+            int i_station, start, num;
+            if (thread_status) continue;
+            i_station = t / num_chunks;
+            start = (t % num_chunks) * chunk_size;
+            num = num_points - start;
+            if (num > chunk_size) num = chunk_size;
+            oskar_mem_copy_contents(x_chunk, x, 0, start, num,
+                    &thread_status);
+            oskar_mem_copy_contents(y_chunk, y, 0, start, num,
+                    &thread_status);
+            oskar_mem_copy_contents(z_chunk, z, 0, start, num,
+                    &thread_status);
+            oskar_mem_set_alias(E_chunk, oskar_jones_mem(E),
+                    i_station * stride + start, num, &thread_status);
+            oskar_evaluate_station_beam(E_chunk, num, coord_type,
+                    x_chunk, y_chunk, z_chunk, ra0, dec0,
+                    oskar_telescope_station_const(tel, i_station),
+                    thread_work, time_index, frequency_hz, gast,
+                    &thread_status);
+        }
+
+        oskar_mem_free(E_chunk, &thread_status);
+        oskar_mem_free(x_chunk, &thread_status);
+        oskar_mem_free(y_chunk, &thread_status);
+        oskar_mem_free(z_chunk, &thread_status);
+#pragma omp critical (evaluate_jones_E)
+        if (thread_status && !*status) *status = thread_status;
+    }
+}
+
 #ifdef __cplusplus
 }
 #endif
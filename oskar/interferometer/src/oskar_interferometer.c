@@ -31,6 +31,7 @@
 #include "convert/oskar_convert_ecef_to_baseline_uvw.h"
 #include "convert/oskar_convert_mjd_to_gast_fast.h"
 #include "correlate/oskar_auto_correlate.h"
+#include "correlate/oskar_correlate_fused.h"
 #include "correlate/oskar_cross_correlate.h"
 #include "interferometer/oskar_evaluate_jones_R.h"
 #include "interferometer/oskar_evaluate_jones_Z.h"
@@ -65,6 +66,18 @@
 extern "C" {
 #endif
 
+/* Number of channels over which Jones K is advanced by multiplication
+ * before it is evaluated directly again, to limit rounding errors.
+ * This only applies on GPUs, where the full Jones K is formed. */
+#define K_EVALUATE_INTERVAL 16
+
+/* Default memory limit for the station beam cache on each device, in MB. */
+#define DEFAULT_BEAM_CACHE_MB 1024
+
+/* True if sources must be filtered by flux density when evaluating K. */
+#define USE_SOURCE_FILTER(h) \
+    ((h)->source_min_jy > -DBL_MAX || (h)->source_max_jy < DBL_MAX)
+
 /* Memory allocated per compute device (may be either CPU or GPU). */
 struct DeviceData
 {
@@ -72,15 +85,25 @@ struct DeviceData
     oskar_VisBlock* vis_block_cpu[2]; /* On host, for copy back & write. */
 
     /* Device memory. */
-    int previous_chunk_index;
+    int previous_chunk_index, num_blocks_done, num_chunk_copies;
+    double chunk_copy_bytes;
     oskar_VisBlock* vis_block;  /* Device memory block. */
     oskar_Mem *u, *v, *w;
     oskar_Sky* chunk;           /* The unmodified sky chunk being processed. */
     oskar_Sky* chunk_clip;      /* Copy of the chunk after horizon clipping. */
     oskar_Telescope* tel;       /* Telescope model, created as a copy. */
     oskar_Jones *J, *R, *E, *K, *Z;
+    oskar_Jones *K_inc;         /* Jones K for the frequency step (GPU). */
     oskar_StationWork* station_work;
 
+    /* Station beam cache (only if enabled). */
+    oskar_Jones** E_cache;      /* Jones E for each channel. */
+    int* E_cache_valid;         /* True if Jones E for the channel is valid. */
+    int E_cache_size, E_cache_chunk, E_cache_num_src;
+    int num_E_hits, num_E_lookups;
+    double E_cache_bucket;      /* Quantised GAST of the cached beams. */
+    oskar_Mem *E_cache_ra, *E_cache_dec; /* Clipped source positions. */
+
     /* Timers. */
     oskar_Timer* tmr_compute;   /* Total time spent filling vis blocks. */
     oskar_Timer* tmr_copy;      /* Time spent copying data. */
@@ -89,6 +112,7 @@ struct DeviceData
     oskar_Timer* tmr_join;      /* Time spent combining Jones matrices. */
     oskar_Timer* tmr_E;         /* Time spent evaluating E-Jones. */
     oskar_Timer* tmr_K;         /* Time spent evaluating K-Jones. */
+    oskar_Timer* tmr_idle;      /* Time spent waiting for an output buffer. */
 };
 typedef struct DeviceData DeviceData;
 
@@ -97,17 +121,20 @@ struct oskar_Interferometer
 {
     /* Settings. */
     int prec, num_devices, num_gpus, *gpu_ids, num_channels, num_time_steps;
-    int max_sources_per_chunk, max_times_per_block;
+    int num_threads_per_device, auto_num_devices;
+    int max_sources_per_chunk, max_times_per_block, max_station_work_mb;
     int apply_horizon_clip, force_polarised_ms, zero_failed_gaussians;
-    int coords_only;
+    int coords_only, max_beam_cache_mb;
     double freq_start_hz, freq_inc_hz, time_start_mjd_utc, time_inc_sec;
-    double source_min_jy, source_max_jy;
+    double source_min_jy, source_max_jy, beam_cache_tolerance_rad;
     char correlation_type, *vis_name, *ms_name, *settings_path;
 
     /* State. */
-    int init_sky, work_unit_index, status;
+    int init_sky, status;
+    volatile int work_unit_index;
+    int num_blocks_written;
     oskar_Mutex* mutex;
-    oskar_Barrier* barrier;
+    oskar_ConditionVar* cond;
 
     /* Sky model and telescope model. */
     int num_sources_total, num_sky_chunks;
@@ -134,9 +161,27 @@ typedef struct oskar_Interferometer oskar_Interferometer;
 
 /* Private method prototypes. */
 
+static void start_block(oskar_Interferometer* h, DeviceData* d,
+        int block_index, int* status);
+static int num_time_slices(const oskar_Interferometer* h,
+        int num_times_block);
+static int num_work_units_block(const oskar_Interferometer* h,
+        int num_times_block);
+static void run_work_unit(oskar_Interferometer* h, int block_index,
+        int i_work_unit, int device_id, int* status);
+static void wait_for_write(oskar_Interferometer* h, DeviceData* d,
+        int block_index);
+static void finish_block(oskar_Interferometer* h, DeviceData* d,
+        int block_index, int* status);
+static void update_beam_cache(oskar_Interferometer* h, DeviceData* d,
+        const oskar_Sky* sky, double gast, int* status);
+static int has_time_variable_errors(const oskar_Station* station,
+        int* status);
+static void sim_time(oskar_Interferometer* h, DeviceData* d,
+        oskar_Sky* sky, double gast, int* status);
 static void sim_baselines(oskar_Interferometer* h, DeviceData* d,
         oskar_Sky* sky, int channel_index_block, int time_index_block,
-        int time_index_simulation, int* status);
+        int time_index_simulation, double gast, int* status);
 static void free_device_data(oskar_Interferometer* h, int* status);
 static void set_up_device_data(oskar_Interferometer* h, int* status);
 static void set_up_vis_header(oskar_Interferometer* h, int* status);
@@ -215,10 +260,12 @@ oskar_Interferometer* oskar_interferometer_create(int precision, int* status)
     h->tmr_write = oskar_timer_create(OSKAR_TIMER_NATIVE);
     h->temp      = oskar_mem_create(precision, OSKAR_CPU, 0, status);
     h->mutex     = oskar_mutex_create();
-    h->barrier   = oskar_barrier_create(0);
+    h->cond      = oskar_condition_create();
 
     /* Set sensible defaults. */
     h->max_sources_per_chunk = 16384;
+    h->max_beam_cache_mb = DEFAULT_BEAM_CACHE_MB;
+    h->num_threads_per_device = 1;
     oskar_interferometer_set_gpus(h, -1, 0, status);
     oskar_interferometer_set_num_devices(h, -1);
     oskar_interferometer_set_correlation_type(h, "Cross-correlations", status);
@@ -314,7 +361,7 @@ void oskar_interferometer_free(oskar_Interferometer* h, int* status)
     oskar_timer_free(h->tmr_sim);
     oskar_timer_free(h->tmr_write);
     oskar_mutex_free(h->mutex);
-    oskar_barrier_free(h->barrier);
+    oskar_condition_free(h->cond);
     free(h->sky_chunks);
     free(h->gpu_ids);
     free(h->vis_name);
@@ -367,9 +414,7 @@ void oskar_interferometer_reset_work_unit_index(oskar_Interferometer* h)
 void oskar_interferometer_run_block(oskar_Interferometer* h, int block_index,
         int device_id, int* status)
 {
-    double obs_start_mjd, dt_dump_days;
-    int i_active, time_index_start, time_index_end;
-    int num_channels, num_times_block, total_chunks, total_times;
+    int num_work_units;
     DeviceData* d;
     if (*status) return;
 
@@ -387,112 +432,51 @@ void oskar_interferometer_run_block(oskar_Interferometer* h, int block_index,
     if (device_id >= 0 && device_id < h->num_gpus)
         oskar_device_set(h->gpu_ids[device_id], status);
 
-    /* Clear the visibility block. */
-    i_active = block_index % 2; /* Index of the active buffer. */
-    d = &(h->d[device_id]);
-    oskar_timer_resume(d->tmr_compute);
-    oskar_vis_block_clear(d->vis_block, status);
-
-    /* Set the visibility block meta-data. */
-    total_chunks = h->num_sky_chunks;
-    num_channels = h->num_channels;
-    total_times = h->num_time_steps;
-    obs_start_mjd = h->time_start_mjd_utc;
-    dt_dump_days = h->time_inc_sec / 86400.0;
-    time_index_start = block_index * h->max_times_per_block;
-    time_index_end = time_index_start + h->max_times_per_block - 1;
-    if (time_index_end >= total_times)
-        time_index_end = total_times - 1;
-    num_times_block = 1 + time_index_end - time_index_start;
+#ifdef _OPENMP
+    /* Set the number of threads to use within this device. */
+    omp_set_num_threads(device_id < h->num_gpus ?
+            1 : h->num_threads_per_device);
+#endif
 
-    /* Set the number of active times in the block. */
-    oskar_vis_block_set_num_times(d->vis_block, num_times_block, status);
-    oskar_vis_block_set_start_time_index(d->vis_block, time_index_start);
+    /* Clear the visibility block and set its meta-data. */
+    d = &(h->d[device_id]);
+    start_block(h, d, block_index, status);
 
     /* Go though all possible work units in the block. A work unit is defined
-     * as the simulation for one time and one sky chunk. */
-    while (!h->coords_only)
+     * as the simulation for one sky chunk and a range of times. */
+    num_work_units = num_work_units_block(h,
+            oskar_vis_block_num_times(d->vis_block));
+    while (1)
     {
-        oskar_Sky* sky;
-        int i_work_unit, i_chunk, i_time, i_channel, sim_time_idx;
-
-        oskar_mutex_lock(h->mutex);
-        i_work_unit = (h->work_unit_index)++;
-        oskar_mutex_unlock(h->mutex);
-        if ((i_work_unit >= num_times_block * total_chunks) || *status) break;
-
-        /* Convert slice index to chunk/time index. */
-        i_chunk      = i_work_unit / num_times_block;
-        i_time       = i_work_unit - i_chunk * num_times_block;
-        sim_time_idx = time_index_start + i_time;
-
-        /* Copy sky chunk to device only if different from the previous one. */
-        if (i_chunk != d->previous_chunk_index)
-        {
-            oskar_timer_resume(d->tmr_copy);
-            oskar_sky_copy(d->chunk, h->sky_chunks[i_chunk], status);
-            oskar_timer_pause(d->tmr_copy);
-        }
-        sky = h->apply_horizon_clip ? d->chunk_clip : d->chunk;
-
-        /* Apply horizon clip if required. */
-        if (h->apply_horizon_clip)
-        {
-            double gast, mjd;
-            mjd = obs_start_mjd + dt_dump_days * (sim_time_idx + 0.5);
-            gast = oskar_convert_mjd_to_gast_fast(mjd);
-            oskar_timer_resume(d->tmr_clip);
-            oskar_sky_horizon_clip(d->chunk_clip, d->chunk, d->tel, gast,
-                    d->station_work, status);
-            oskar_timer_pause(d->tmr_clip);
-        }
-
-        /* Simulate all baselines for all channels for this time and chunk. */
-        for (i_channel = 0; i_channel < num_channels; ++i_channel)
-        {
-            if (*status) break;
-            if (h->log)
-            {
-                oskar_mutex_lock(h->mutex);
-                oskar_log_message(h->log, 'S', 1, "Time %*i/%i, "
-                        "Chunk %*i/%i, Channel %*i/%i [Device %i, %i sources]",
-                        disp_width(total_times), sim_time_idx + 1, total_times,
-                        disp_width(total_chunks), i_chunk + 1, total_chunks,
-                        disp_width(num_channels), i_channel + 1, num_channels,
-                        device_id, oskar_sky_num_sources(sky));
-                oskar_mutex_unlock(h->mutex);
-            }
-            sim_baselines(h, d, sky, i_channel, i_time, sim_time_idx, status);
-        }
-        d->previous_chunk_index = i_chunk;
+        int i_work_unit;
+        i_work_unit = oskar_atomic_fetch_add_int(&h->work_unit_index, 1);
+        if ((i_work_unit >= num_work_units) || *status) break;
+        run_work_unit(h, block_index, i_work_unit, device_id, status);
     }
 
     /* Copy the visibility block to host memory. */
-    oskar_timer_resume(d->tmr_copy);
-    oskar_vis_block_copy(d->vis_block_cpu[i_active], d->vis_block, status);
-    oskar_timer_pause(d->tmr_copy);
-    oskar_timer_pause(d->tmr_compute);
+    finish_block(h, d, block_index, status);
 }
 
 
 struct ThreadArgs
 {
     oskar_Interferometer* h;
-    int num_threads, thread_id;
+    int thread_id;
 };
 typedef struct ThreadArgs ThreadArgs;
 
 static void* run_blocks(void* arg)
 {
     oskar_Interferometer* h;
-    int b, thread_id, device_id, num_blocks, num_threads, *status;
+    int b, i, thread_id, device_id, num_blocks, *status;
 
     /* Get thread function arguments. */
     h = ((ThreadArgs*)arg)->h;
-    num_threads = ((ThreadArgs*)arg)->num_threads;
     thread_id = ((ThreadArgs*)arg)->thread_id;
     device_id = thread_id - 1;
     status = &(h->status);
+    num_blocks = oskar_interferometer_num_vis_blocks(h);
 
 #ifdef _OPENMP
     /* Disable any nested parallelism. */
@@ -500,46 +484,102 @@ static void* run_blocks(void* arg)
     omp_set_num_threads(1);
 #endif
 
-    /* Loop over blocks of observation time, running simulation and file
-     * writing one block at a time. Simulation and file output are overlapped
-     * by using double buffering, and a dedicated thread is used for file
-     * output.
+    /* Simulation and file output are overlapped by using double buffering,
+     * and a dedicated thread is used for file output.
      *
      * Thread 0 is used for file writes.
      * Threads 1 to n (mapped to compute devices) do the simulation.
      *
-     * Note that no write is launched on the first loop counter (as no
-     * data are ready yet) and no simulation is performed for the last loop
-     * counter (which corresponds to the last block + 1) as this iteration
-     * simply writes the last block.
+     * Work units from all blocks are numbered consecutively and claimed
+     * using an atomic counter, so a device can start on the next block
+     * as soon as there is nothing left for it to do in the current one.
+     * A device must wait only before copying a block to host memory,
+     * until the host buffer is no longer needed by the write thread.
+     * The write thread waits until all devices have finished a block.
      */
-    num_blocks = oskar_interferometer_num_vis_blocks(h);
-    for (b = 0; b < num_blocks + 1; ++b)
+    if (thread_id == 0)
     {
-        if ((thread_id > 0 || num_threads == 1) && b < num_blocks)
-            oskar_interferometer_run_block(h, b, device_id, status);
-        if (thread_id == 0 && b > 0)
+        for (b = 0; b < num_blocks; ++b)
         {
             oskar_VisBlock* block;
-            block = oskar_interferometer_finalise_block(h, b - 1, status);
-            oskar_interferometer_write_block(h, block, b - 1, status);
-        }
 
-        /* Barrier 1: Reset work unit index and print status. */
-        oskar_barrier_wait(h->barrier);
-        if (thread_id == 0)
-        {
-            oskar_interferometer_reset_work_unit_index(h);
-            if (b < num_blocks && h->log && !*status)
+            /* Wait until all devices have finished this block. */
+            oskar_condition_lock(h->cond);
+            for (i = 0; i < h->num_devices; ++i)
+            {
+                while (h->d[i].num_blocks_done <= b)
+                    oskar_condition_wait(h->cond);
+            }
+            oskar_condition_unlock(h->cond);
+            if (h->log && !*status)
+            {
+                oskar_mutex_lock(h->mutex);
                 oskar_log_message(h->log, 'S', 0, "Block %*i/%i (%3.0f%%) "
                         "complete. Simulation time elapsed: %.3f s",
                         disp_width(num_blocks), b+1, num_blocks,
                         100.0 * (b+1) / (double)num_blocks,
                         oskar_timer_elapsed(h->tmr_sim));
+                oskar_mutex_unlock(h->mutex);
+            }
+
+            /* Combine and write the block, which releases its buffers. */
+            block = oskar_interferometer_finalise_block(h, b, status);
+            oskar_interferometer_write_block(h, block, b, status);
+        }
+    }
+    else
+    {
+        int current_block = -1, num_blocks_full, units_full, num_work_units;
+        DeviceData* d = &(h->d[device_id]);
+
+        /* Set the GPU to use. */
+        if (device_id < h->num_gpus)
+            oskar_device_set(h->gpu_ids[device_id], status);
+#ifdef _OPENMP
+        if (device_id >= h->num_gpus)
+            omp_set_num_threads(h->num_threads_per_device);
+#endif
+
+        /* Claim work units until there are none left.
+         * Only the last block can have fewer work units than the others. */
+        num_blocks_full = h->num_time_steps / h->max_times_per_block;
+        units_full = num_work_units_block(h, h->max_times_per_block);
+        num_work_units = num_blocks_full * units_full +
+                num_work_units_block(h, h->num_time_steps -
+                        num_blocks_full * h->max_times_per_block);
+        while (1)
+        {
+            int i_global;
+            i_global = oskar_atomic_fetch_add_int(&h->work_unit_index, 1);
+            if ((i_global >= num_work_units) || *status) break;
+            b = i_global / units_full;
+            while (current_block < b)
+            {
+                if (current_block >= 0)
+                {
+                    wait_for_write(h, d, current_block);
+                    finish_block(h, d, current_block, status);
+                }
+                start_block(h, d, ++current_block, status);
+            }
+            run_work_unit(h, b, i_global - b * units_full, device_id, status);
         }
 
-        /* Barrier 2: Synchronise before moving to the next block. */
-        oskar_barrier_wait(h->barrier);
+        /* Finish all remaining blocks, even if empty for this device. */
+        while (current_block < num_blocks - 1)
+        {
+            if (current_block >= 0)
+            {
+                wait_for_write(h, d, current_block);
+                finish_block(h, d, current_block, status);
+            }
+            start_block(h, d, ++current_block, status);
+        }
+        if (current_block >= 0)
+        {
+            wait_for_write(h, d, current_block);
+            finish_block(h, d, current_block, status);
+        }
     }
     return 0;
 }
@@ -573,13 +613,11 @@ void oskar_interferometer_run(oskar_Interferometer* h, int* status)
 
     /* Set up worker threads. */
     num_threads = h->num_devices + 1;
-    oskar_barrier_set_num_threads(h->barrier, num_threads);
     threads = (oskar_Thread**) calloc(num_threads, sizeof(oskar_Thread*));
     args = (ThreadArgs*) calloc(num_threads, sizeof(ThreadArgs));
     for (i = 0; i < num_threads; ++i)
     {
         args[i].h = h;
-        args[i].num_threads = num_threads;
         args[i].thread_id = i;
     }
 
@@ -778,6 +816,20 @@ void oskar_interferometer_set_max_sources_per_chunk(oskar_Interferometer* h,
 }
 
 
+void oskar_interferometer_set_max_station_beam_cache_mb(
+        oskar_Interferometer* h, int value)
+{
+    h->max_beam_cache_mb = value;
+}
+
+
+void oskar_interferometer_set_max_station_work_mb(oskar_Interferometer* h,
+        int value)
+{
+    h->max_station_work_mb = value;
+}
+
+
 void oskar_interferometer_set_max_times_per_block(oskar_Interferometer* h,
         int value)
 {
@@ -789,8 +841,11 @@ void oskar_interferometer_set_num_devices(oskar_Interferometer* h, int value)
 {
     int status = 0;
     free_device_data(h, &status);
+    h->auto_num_devices = (value < 1);
     if (value < 1)
-        value = (h->num_gpus == 0) ? (oskar_get_num_procs() - 1) : h->num_gpus;
+        value = (h->num_gpus == 0) ?
+                ((oskar_get_num_procs() - 1) / h->num_threads_per_device) :
+                h->num_gpus;
     if (value < 1) value = 1;
     h->num_devices = value;
     h->d = (DeviceData*) realloc(h->d, h->num_devices * sizeof(DeviceData));
@@ -798,6 +853,15 @@ void oskar_interferometer_set_num_devices(oskar_Interferometer* h, int value)
 }
 
 
+void oskar_interferometer_set_num_threads_per_device(
+        oskar_Interferometer* h, int value)
+{
+    h->num_threads_per_device = (value < 1) ? 1 : value;
+    if (h->auto_num_devices)
+        oskar_interferometer_set_num_devices(h, -1);
+}
+
+
 void oskar_interferometer_set_observation_frequency(oskar_Interferometer* h,
         double start_hz, double inc_hz, int num_channels)
 {
@@ -860,6 +924,13 @@ void oskar_interferometer_set_sky_model(oskar_Interferometer* h,
 }
 
 
+void oskar_interferometer_set_station_beam_cache_tolerance(
+        oskar_Interferometer* h, double tolerance_deg)
+{
+    h->beam_cache_tolerance_rad = tolerance_deg * M_PI / 180.0;
+}
+
+
 void oskar_interferometer_set_telescope_model(oskar_Interferometer* h,
         const oskar_Telescope* model, int* status)
 {
@@ -939,54 +1010,288 @@ const oskar_VisHeader* oskar_interferometer_vis_header(oskar_Interferometer* h)
 void oskar_interferometer_write_block(oskar_Interferometer* h,
         const oskar_VisBlock* block, int block_index, int* status)
 {
-    if (*status) return;
-
     /* Open files only if required, and write the block into them. */
-    oskar_timer_resume(h->tmr_write);
+    if (!*status)
+    {
+        oskar_timer_resume(h->tmr_write);
 #ifndef OSKAR_NO_MS
-    if (h->ms_name && !h->ms)
-        h->ms = oskar_vis_header_write_ms(h->header, h->ms_name, OSKAR_TRUE,
-                h->force_polarised_ms, status);
-    if (h->ms) oskar_vis_block_write_ms(block, h->header, h->ms, status);
+        if (h->ms_name && !h->ms)
+            h->ms = oskar_vis_header_write_ms(h->header, h->ms_name,
+                    OSKAR_TRUE, h->force_polarised_ms, status);
+        if (h->ms) oskar_vis_block_write_ms(block, h->header, h->ms, status);
 #endif
-    if (h->vis_name && !h->vis)
-        h->vis = oskar_vis_header_write(h->header, h->vis_name, status);
-    if (h->vis) oskar_vis_block_write(block, h->vis, block_index, status);
-    oskar_timer_pause(h->tmr_write);
+        if (h->vis_name && !h->vis)
+            h->vis = oskar_vis_header_write(h->header, h->vis_name, status);
+        if (h->vis) oskar_vis_block_write(block, h->vis, block_index, status);
+        oskar_timer_pause(h->tmr_write);
+    }
+
+    /* Release the host buffers used by the block, even after an error,
+     * so that no device waits for them indefinitely. */
+    oskar_condition_lock(h->cond);
+    if (h->num_blocks_written < block_index + 1)
+        h->num_blocks_written = block_index + 1;
+    oskar_condition_notify_all(h->cond);
+    oskar_condition_unlock(h->cond);
 }
 
 
 /* Private methods. */
 
-static void sim_baselines(oskar_Interferometer* h, DeviceData* d,
-        oskar_Sky* sky, int channel_index_block, int time_index_block,
-        int time_index_simulation, int* status)
+static void start_block(oskar_Interferometer* h, DeviceData* d,
+        int block_index, int* status)
 {
-    int num_baselines, num_stations, num_src, num_times_block, num_channels;
-    double dt_dump_days, t_start, t_dump, gast, frequency, ra0, dec0;
-    const oskar_Mem *x, *y, *z;
-    oskar_Mem* alias = 0;
+    int time_index_start, time_index_end;
+    if (*status) return;
 
-    /* Get dimensions. */
-    num_baselines   = oskar_telescope_num_baselines(d->tel);
-    num_stations    = oskar_telescope_num_stations(d->tel);
-    num_src         = oskar_sky_num_sources(sky);
+    /* Clear the visibility block. */
+    oskar_timer_resume(d->tmr_compute);
+    oskar_vis_block_clear(d->vis_block, status);
+
+    /* Set the visibility block meta-data. */
+    time_index_start = block_index * h->max_times_per_block;
+    time_index_end = time_index_start + h->max_times_per_block - 1;
+    if (time_index_end >= h->num_time_steps)
+        time_index_end = h->num_time_steps - 1;
+    oskar_vis_block_set_num_times(d->vis_block,
+            1 + time_index_end - time_index_start, status);
+    oskar_vis_block_set_start_time_index(d->vis_block, time_index_start);
+}
+
+
+static int num_time_slices(const oskar_Interferometer* h,
+        int num_times_block)
+{
+    int n;
+
+    /* Keep each sky chunk on one device for as many times as possible,
+     * but split its times into slices if there are not enough chunks
+     * to give each device at least two work units. */
+    if (h->num_sky_chunks <= 0) return 1;
+    n = (2 * h->num_devices + h->num_sky_chunks - 1) / h->num_sky_chunks;
+    if (n > num_times_block) n = num_times_block;
+    return (n < 1) ? 1 : n;
+}
+
+
+static int num_work_units_block(const oskar_Interferometer* h,
+        int num_times_block)
+{
+    if (h->coords_only || num_times_block <= 0) return 0;
+    return h->num_sky_chunks * num_time_slices(h, num_times_block);
+}
+
+
+static void run_work_unit(oskar_Interferometer* h, int block_index,
+        int i_work_unit, int device_id, int* status)
+{
+    oskar_Sky* sky;
+    DeviceData* d;
+    int i_chunk, i_slice, i_time, i_channel, sim_time_idx;
+    int num_channels, num_slices, num_times_block, total_chunks, total_times;
+    int time_start, time_end;
+    if (*status) return;
+
+    /* Convert work unit index to chunk index and time range.
+     * Work units are chunk-major, so that times are split into as few
+     * slices as possible and a chunk stays resident on a device.
+     * Chunks are visited in reverse order in alternate blocks, so that
+     * the last chunk of one block is likely to be reused in the next. */
+    d = &(h->d[device_id]);
+    total_chunks    = h->num_sky_chunks;
+    total_times     = h->num_time_steps;
+    num_channels    = h->num_channels;
     num_times_block = oskar_vis_block_num_times(d->vis_block);
-    num_channels    = oskar_vis_block_num_channels(d->vis_block);
+    num_slices      = num_time_slices(h, num_times_block);
+    i_chunk         = i_work_unit / num_slices;
+    i_slice         = i_work_unit - i_chunk * num_slices;
+    if (block_index % 2) i_chunk = total_chunks - 1 - i_chunk;
+    time_start      = (i_slice * num_times_block) / num_slices;
+    time_end        = ((i_slice + 1) * num_times_block) / num_slices;
+
+    /* Copy sky chunk to device only if different from the previous one. */
+    if (i_chunk != d->previous_chunk_index)
+    {
+        oskar_timer_resume(d->tmr_copy);
+        oskar_sky_copy(d->chunk, h->sky_chunks[i_chunk], status);
+        oskar_timer_pause(d->tmr_copy);
+        d->previous_chunk_index = i_chunk;
 
-    /* Return if there are no sources in the chunk,
-     * or if block time index requested is outside the valid range. */
-    if (num_src == 0 || time_index_block >= num_times_block) return;
+        /* Record the size of the copy: oskar_sky_copy() transfers
+         * 18 arrays per source. */
+        d->num_chunk_copies++;
+        d->chunk_copy_bytes += 18.0 * oskar_mem_element_size(h->prec) *
+                oskar_sky_num_sources(h->sky_chunks[i_chunk]);
+    }
+    sky = h->apply_horizon_clip ? d->chunk_clip : d->chunk;
 
-    /* Get the time and frequency of the visibility slice being simulated. */
-    dt_dump_days = h->time_inc_sec / 86400.0;
-    t_start = h->time_start_mjd_utc;
-    t_dump = t_start + dt_dump_days * (time_index_simulation + 0.5);
-    gast = oskar_convert_mjd_to_gast_fast(t_dump);
-    frequency = h->freq_start_hz + channel_index_block * h->freq_inc_hz;
+    /* Generate element errors for all times in the slice, so they can be
+     * reused for all channels and sky chunks. */
+    oskar_timer_resume(d->tmr_E);
+    oskar_station_work_evaluate_element_errors(d->station_work, d->tel,
+            block_index * h->max_times_per_block + time_start,
+            time_end - time_start, status);
+    oskar_timer_pause(d->tmr_E);
 
-    /* Scale source fluxes with spectral index and rotation measure. */
-    oskar_sky_scale_flux_with_frequency(sky, frequency, status);
+    for (i_time = time_start; i_time < time_end; ++i_time)
+    {
+        double gast, mjd;
+        if (*status) break;
+        sim_time_idx = block_index * h->max_times_per_block + i_time;
+        mjd = h->time_start_mjd_utc +
+                (h->time_inc_sec / 86400.0) * (sim_time_idx + 0.5);
+        gast = oskar_convert_mjd_to_gast_fast(mjd);
+
+        /* Apply horizon clip if required. */
+        if (h->apply_horizon_clip)
+        {
+            oskar_timer_resume(d->tmr_clip);
+            oskar_sky_horizon_clip(d->chunk_clip, d->chunk, d->tel, gast,
+                    d->station_work, status);
+            oskar_timer_pause(d->tmr_clip);
+        }
+
+        /* Evaluate terms that are the same for all channels. */
+        sim_time(h, d, sky, gast, status);
+
+        /* Simulate all baselines for all channels for this time. */
+        for (i_channel = 0; i_channel < num_channels; ++i_channel)
+        {
+            if (*status) break;
+            if (h->log)
+            {
+                oskar_mutex_lock(h->mutex);
+                oskar_log_message(h->log, 'S', 1, "Time %*i/%i, "
+                        "Chunk %*i/%i, Channel %*i/%i [Device %i, %i sources]",
+                        disp_width(total_times), sim_time_idx + 1,
+                        total_times, disp_width(total_chunks), i_chunk + 1,
+                        total_chunks, disp_width(num_channels),
+                        i_channel + 1, num_channels, device_id,
+                        oskar_sky_num_sources(sky));
+                oskar_mutex_unlock(h->mutex);
+            }
+            sim_baselines(h, d, sky, i_channel, i_time, sim_time_idx, gast,
+                    status);
+        }
+    }
+}
+
+
+static void wait_for_write(oskar_Interferometer* h, DeviceData* d,
+        int block_index)
+{
+    /* Wait until the write thread has finished with the host buffer,
+     * which was last used two blocks ago. This is needed only when blocks
+     * are pipelined by oskar_interferometer_run(): callers of
+     * oskar_interferometer_run_block() are not required to write blocks. */
+    oskar_timer_pause(d->tmr_compute);
+    oskar_timer_resume(d->tmr_idle);
+    oskar_condition_lock(h->cond);
+    while (h->num_blocks_written < block_index - 1)
+        oskar_condition_wait(h->cond);
+    oskar_condition_unlock(h->cond);
+    oskar_timer_pause(d->tmr_idle);
+    oskar_timer_resume(d->tmr_compute);
+}
+
+
+static void finish_block(oskar_Interferometer* h, DeviceData* d,
+        int block_index, int* status)
+{
+    /* Copy the visibility block to host memory. */
+    oskar_timer_resume(d->tmr_copy);
+    oskar_vis_block_copy(d->vis_block_cpu[block_index % 2], d->vis_block,
+            status);
+    oskar_timer_pause(d->tmr_copy);
+    oskar_timer_pause(d->tmr_compute);
+
+    /* Signal that this device has finished the block. */
+    oskar_condition_lock(h->cond);
+    d->num_blocks_done = block_index + 1;
+    oskar_condition_notify_all(h->cond);
+    oskar_condition_unlock(h->cond);
+}
+
+
+static void update_beam_cache(oskar_Interferometer* h, DeviceData* d,
+        const oskar_Sky* sky, double gast, int* status)
+{
+    int num_src, same;
+    double bucket;
+    const oskar_Mem *ra, *dec;
+    if (*status) return;
+
+    /* The cached beams are valid while the beam hour angle stays
+     * within the same tolerance interval, and the sources are the same. */
+    bucket = floor(gast / h->beam_cache_tolerance_rad);
+    num_src = oskar_sky_num_sources(sky);
+    ra = oskar_sky_ra_rad_const(sky);
+    dec = oskar_sky_dec_rad_const(sky);
+    same = (bucket == d->E_cache_bucket && num_src == d->E_cache_num_src &&
+            d->previous_chunk_index == d->E_cache_chunk);
+
+    /* If some sources in the chunk were clipped, check they are the same
+     * ones as before. This can only be done in CPU memory. */
+    if (same && num_src != oskar_sky_num_sources(d->chunk))
+    {
+        if (oskar_mem_location(ra) == OSKAR_CPU)
+            same = !oskar_mem_different(ra, d->E_cache_ra, num_src, status) &&
+                    !oskar_mem_different(dec, d->E_cache_dec, num_src, status);
+        else
+            same = 0;
+    }
+    if (same) return;
+
+    /* Invalidate the cache. */
+    memset(d->E_cache_valid, 0, d->E_cache_size * sizeof(int));
+    d->E_cache_bucket = bucket;
+    d->E_cache_num_src = num_src;
+    d->E_cache_chunk = d->previous_chunk_index;
+    if (oskar_mem_location(ra) == OSKAR_CPU)
+    {
+        oskar_mem_copy(d->E_cache_ra, ra, status);
+        oskar_mem_copy(d->E_cache_dec, dec, status);
+    }
+}
+
+
+static int has_time_variable_errors(const oskar_Station* station,
+        int* status)
+{
+    int i, num_elements;
+    double min_val, max_val, mean, std_dev;
+    if (*status || !station) return 0;
+    num_elements = oskar_station_num_elements(station);
+    if (oskar_station_has_child(station))
+    {
+        for (i = 0; i < num_elements; ++i)
+            if (has_time_variable_errors(
+                    oskar_station_child_const(station, i), status))
+                return 1;
+        return 0;
+    }
+    if (!oskar_station_apply_element_errors(station) || num_elements == 0)
+        return 0;
+    oskar_mem_stats(oskar_station_element_gain_error_const(station),
+            num_elements, &min_val, &max_val, &mean, &std_dev, status);
+    if (max_val > 0.0) return 1;
+    oskar_mem_stats(oskar_station_element_phase_error_rad_const(station),
+            num_elements, &min_val, &max_val, &mean, &std_dev, status);
+    return (max_val > 0.0);
+}
+
+
+static void sim_time(oskar_Interferometer* h, DeviceData* d,
+        oskar_Sky* sky, double gast, int* status)
+{
+    int num_stations, num_src;
+    double ra0, dec0;
+    const oskar_Mem *x, *y, *z;
+
+    /* Return if there are no sources in the chunk. */
+    num_stations = oskar_telescope_num_stations(d->tel);
+    num_src      = oskar_sky_num_sources(sky);
+    if (num_src == 0 || *status) return;
 
     /* Evaluate station u,v,w coordinates. */
     ra0 = oskar_telescope_phase_centre_ra_rad(d->tel);
@@ -997,21 +1302,93 @@ static void sim_baselines(oskar_Interferometer* h, DeviceData* d,
     oskar_convert_ecef_to_station_uvw(num_stations, x, y, z, ra0, dec0, gast,
             d->u, d->v, d->w, status);
 
+    /* Check whether cached station beams can still be used. */
+    if (d->E_cache)
+        update_beam_cache(h, d, sky, gast, status);
+
     /* Set dimensions of Jones matrices. */
     if (d->R)
         oskar_jones_set_size(d->R, num_stations, num_src, status);
     if (d->Z)
         oskar_jones_set_size(d->Z, num_stations, num_src, status);
-    oskar_jones_set_size(d->J, num_stations, num_src, status);
+    if (d->J)
+        oskar_jones_set_size(d->J, num_stations, num_src, status);
     oskar_jones_set_size(d->E, num_stations, num_src, status);
-    oskar_jones_set_size(d->K, num_stations, num_src, status);
+    if (d->K)
+        oskar_jones_set_size(d->K, num_stations, num_src, status);
+    if (d->K_inc)
+        oskar_jones_set_size(d->K_inc, num_stations, num_src, status);
 
-    /* Evaluate station beam (Jones E: may be matrix). */
-    oskar_timer_resume(d->tmr_E);
-    oskar_evaluate_jones_E(d->E, num_src, OSKAR_RELATIVE_DIRECTIONS,
-            oskar_sky_l(sky), oskar_sky_m(sky), oskar_sky_n(sky), d->tel,
-            gast, frequency, d->station_work, time_index_simulation, status);
-    oskar_timer_pause(d->tmr_E);
+    /* Evaluate parallactic angle (Jones R: matrix).
+     * TODO Move this into station beam evaluation instead. */
+    if (d->R)
+    {
+        oskar_timer_resume(d->tmr_E);
+        oskar_evaluate_jones_R(d->R, num_src, oskar_sky_ra_rad_const(sky),
+                oskar_sky_dec_rad_const(sky), d->tel, gast, status);
+        oskar_timer_pause(d->tmr_E);
+    }
+
+    /* Evaluate the interferometer phase for the frequency increment,
+     * so that Jones K can be advanced from one channel to the next.
+     * This is not needed on the CPU, where K is not stored. */
+    if (!d->K_inc || h->num_channels < 2 || USE_SOURCE_FILTER(h)) return;
+    oskar_timer_resume(d->tmr_K);
+    oskar_evaluate_jones_K(d->K_inc, num_src, oskar_sky_l_const(sky),
+            oskar_sky_m_const(sky), oskar_sky_n_const(sky), d->u, d->v, d->w,
+            h->freq_inc_hz, oskar_sky_I_const(sky), -DBL_MAX, DBL_MAX, status);
+    oskar_timer_pause(d->tmr_K);
+}
+
+
+static void sim_baselines(oskar_Interferometer* h, DeviceData* d,
+        oskar_Sky* sky, int channel_index_block, int time_index_block,
+        int time_index_simulation, double gast, int* status)
+{
+    int num_baselines, num_stations, num_src, num_times_block, num_channels;
+    double frequency;
+    oskar_Mem* alias = 0;
+    oskar_Jones* E;
+
+    /* Get dimensions. */
+    num_baselines   = oskar_telescope_num_baselines(d->tel);
+    num_stations    = oskar_telescope_num_stations(d->tel);
+    num_src         = oskar_sky_num_sources(sky);
+    num_times_block = oskar_vis_block_num_times(d->vis_block);
+    num_channels    = oskar_vis_block_num_channels(d->vis_block);
+
+    /* Return if there are no sources in the chunk,
+     * or if block time index requested is outside the valid range. */
+    if (num_src == 0 || time_index_block >= num_times_block) return;
+
+    /* Get the frequency of the visibility slice being simulated. */
+    frequency = h->freq_start_hz + channel_index_block * h->freq_inc_hz;
+
+    /* Scale source fluxes with spectral index and rotation measure. */
+    oskar_sky_scale_flux_with_frequency(sky, frequency, status);
+
+    /* Evaluate station beam (Jones E: may be matrix),
+     * unless it can be taken from the cache. */
+    E = d->E;
+    if (d->E_cache)
+    {
+        E = d->E_cache[channel_index_block];
+        d->num_E_lookups++;
+    }
+    if (d->E_cache && d->E_cache_valid[channel_index_block])
+        d->num_E_hits++;
+    else
+    {
+        oskar_timer_resume(d->tmr_E);
+        oskar_jones_set_size(E, num_stations, num_src, status);
+        oskar_evaluate_jones_E(E, num_src, OSKAR_RELATIVE_DIRECTIONS,
+                oskar_sky_l(sky), oskar_sky_m(sky), oskar_sky_n(sky), d->tel,
+                gast, frequency, d->station_work, time_index_simulation,
+                status);
+        oskar_timer_pause(d->tmr_E);
+        if (d->E_cache && !*status)
+            d->E_cache_valid[channel_index_block] = 1;
+    }
 
 #if 0
     /* Evaluate ionospheric phase (Jones Z: scalar) and join with Jones E.
@@ -1027,45 +1404,81 @@ static void sim_baselines(oskar_Interferometer* h, DeviceData* d,
     }
 #endif
 
-    /* Evaluate parallactic angle (Jones R: matrix), and join with Jones Z*E.
-     * TODO Move this into station beam evaluation instead. */
+    /* On the CPU, evaluate Jones K and correlate in one pass,
+     * without forming the full Jones J.
+     * The phase is evaluated directly for every channel here, as there is
+     * no stored Jones K to advance: the sincos is only O(stations * sources)
+     * against O(stations^2 * sources) for the correlation itself. */
+    if (!d->J)
+    {
+        oskar_Mem *xc = 0, *ac = 0;
+        oskar_timer_resume(d->tmr_correlate);
+        if (oskar_vis_block_has_auto_correlations(d->vis_block))
+            ac = oskar_mem_create_alias(
+                    oskar_vis_block_auto_correlations(d->vis_block),
+                    num_stations *
+                    (num_channels * time_index_block + channel_index_block),
+                    num_stations, status);
+        if (oskar_vis_block_has_cross_correlations(d->vis_block))
+            xc = oskar_mem_create_alias(
+                    oskar_vis_block_cross_correlations(d->vis_block),
+                    num_baselines *
+                    (num_channels * time_index_block + channel_index_block),
+                    num_baselines, status);
+        oskar_correlate_fused(xc, ac, num_src, E, d->R, sky, d->tel,
+                d->u, d->v, d->w, gast, frequency, h->source_min_jy,
+                h->source_max_jy, status);
+        oskar_mem_free(xc, status);
+        oskar_mem_free(ac, status);
+        oskar_timer_pause(d->tmr_correlate);
+        return;
+    }
+
+    /* Join Jones Z*E with Jones R. */
     if (d->R)
     {
-        oskar_timer_resume(d->tmr_E);
-        oskar_evaluate_jones_R(d->R, num_src, oskar_sky_ra_rad_const(sky),
-                oskar_sky_dec_rad_const(sky), d->tel, gast, status);
-        oskar_timer_pause(d->tmr_E);
         oskar_timer_resume(d->tmr_join);
-        oskar_jones_join(d->R, d->E, d->R, status);
+        oskar_jones_join(d->J, E, d->R, status);
         oskar_timer_pause(d->tmr_join);
     }
 
-    /* Evaluate interferometer phase (Jones K: scalar). */
+    /* Evaluate interferometer phase (Jones K: scalar).
+     * Unless a source flux filter must be applied, Jones K for all but
+     * every few channels is obtained by multiplying that of the previous
+     * channel by the phase for the frequency increment. */
     oskar_timer_resume(d->tmr_K);
-    oskar_evaluate_jones_K(d->K, num_src, oskar_sky_l_const(sky),
-            oskar_sky_m_const(sky), oskar_sky_n_const(sky), d->u, d->v, d->w,
-            frequency, oskar_sky_I_const(sky),
-            h->source_min_jy, h->source_max_jy, status);
+    if (USE_SOURCE_FILTER(h) ||
+            channel_index_block % K_EVALUATE_INTERVAL == 0)
+        oskar_evaluate_jones_K(d->K, num_src, oskar_sky_l_const(sky),
+                oskar_sky_m_const(sky), oskar_sky_n_const(sky),
+                d->u, d->v, d->w, frequency, oskar_sky_I_const(sky),
+                h->source_min_jy, h->source_max_jy, status);
+    else
+        oskar_jones_join(d->K, d->K, d->K_inc, status);
     oskar_timer_pause(d->tmr_K);
 
-    /* Join Jones K with Jones Z*E. */
+    /* Join Jones K with Jones R*Z*E. */
     oskar_timer_resume(d->tmr_join);
-    oskar_jones_join(d->J, d->K, d->R ? d->R : d->E, status);
+    oskar_jones_join(d->J, d->K, d->R ? d->J : E, status);
     oskar_timer_pause(d->tmr_join);
 
     /* Create alias for auto/cross-correlations. */
     oskar_timer_resume(d->tmr_correlate);
     alias = oskar_mem_create_alias(0, 0, 0, status);
 
-    /* Auto-correlate for this time and channel. */
+    /* Auto-correlate for this time and channel.
+     * Jones K does not change the auto-correlations, so if there is no
+     * Jones R, shared station beams can be used directly. */
     if (oskar_vis_block_has_auto_correlations(d->vis_block))
     {
+        const int use_E = !d->R && !USE_SOURCE_FILTER(h) &&
+                oskar_jones_shared_stations(E);
         oskar_mem_set_alias(alias,
                 oskar_vis_block_auto_correlations(d->vis_block),
                 num_stations *
                 (num_channels * time_index_block + channel_index_block),
                 num_stations, status);
-        oskar_auto_correlate(alias, num_src, d->J, sky, status);
+        oskar_auto_correlate(alias, num_src, use_E ? E : d->J, sky, status);
     }
 
     /* Cross-correlate for this time and channel. */
@@ -1156,17 +1569,56 @@ static void set_up_vis_header(oskar_Interferometer* h, int* status)
 
 static void set_up_device_data(oskar_Interferometer* h, int* status)
 {
-    int i, dev_loc, complx, vistype, num_stations, num_src;
+    int i, dev_loc, complx, vistype, num_stations, num_src, shared_E;
+    int use_E_cache;
     if (*status) return;
 
-    /* Get local variables. */
+    /* Get local variables.
+     * Station beams are shared if all stations are identical. */
     num_stations = oskar_telescope_num_stations(h->tel);
+    shared_E = oskar_telescope_allow_station_beam_duplication(h->tel) &&
+            oskar_telescope_identical_stations(h->tel);
     num_src      = h->max_sources_per_chunk;
     complx       = (h->prec) | OSKAR_COMPLEX;
     vistype      = complx;
     if (oskar_telescope_pol_mode(h->tel) == OSKAR_POL_MODE_FULL)
         vistype |= OSKAR_MATRIX;
 
+    /* Reset the block counters used to share the host buffers. */
+    h->num_blocks_written = 0;
+
+    /* Use the station beam cache only if it fits within its memory limit
+     * on each device, and if no station has time-variable element errors,
+     * which would otherwise be frozen within each cache interval. */
+    use_E_cache = (h->beam_cache_tolerance_rad > 0.0);
+    if (use_E_cache)
+    {
+        size_t cache_bytes, max_bytes;
+        cache_bytes = oskar_mem_element_size(vistype) * (size_t)num_src *
+                (size_t)(shared_E ? 1 : num_stations) * h->num_channels;
+        max_bytes = (size_t)(h->max_beam_cache_mb) * 1024 * 1024;
+        if (cache_bytes > max_bytes)
+        {
+            oskar_log_warning(h->log, "Station beam cache would need %.1f MB "
+                    "per device; not using it.", cache_bytes / 1048576.0);
+            use_E_cache = 0;
+        }
+    }
+    if (use_E_cache)
+    {
+        for (i = 0; i < num_stations; ++i)
+        {
+            if (has_time_variable_errors(
+                    oskar_telescope_station_const(h->tel, i), status))
+            {
+                oskar_log_warning(h->log, "Stations have time-variable "
+                        "element errors; not using station beam cache.");
+                use_E_cache = 0;
+                break;
+            }
+        }
+    }
+
     /* Expand the number of devices to the number of selected GPUs,
      * if required. */
     if (h->num_devices < h->num_gpus)
@@ -1176,6 +1628,11 @@ static void set_up_device_data(oskar_Interferometer* h, int* status)
     {
         DeviceData* d = &h->d[i];
         d->previous_chunk_index = -1;
+        d->num_blocks_done = 0;
+        d->num_chunk_copies = 0;
+        d->chunk_copy_bytes = 0.0;
+        d->num_E_hits = 0;
+        d->num_E_lookups = 0;
 
         /* Select the device. */
         if (i < h->num_gpus)
@@ -1198,6 +1655,7 @@ static void set_up_device_data(oskar_Interferometer* h, int* status)
             d->tmr_K         = oskar_timer_create(OSKAR_TIMER_NATIVE);
             d->tmr_join      = oskar_timer_create(OSKAR_TIMER_NATIVE);
             d->tmr_correlate = oskar_timer_create(OSKAR_TIMER_NATIVE);
+            d->tmr_idle      = oskar_timer_create(OSKAR_TIMER_NATIVE);
         }
 
         /* Visibility blocks. */
@@ -1223,18 +1681,50 @@ static void set_up_device_data(oskar_Interferometer* h, int* status)
             d->chunk = oskar_sky_create(h->prec, dev_loc, num_src, status);
             d->chunk_clip = oskar_sky_create(h->prec, dev_loc, num_src, status);
             d->tel = oskar_telescope_create_copy(h->tel, dev_loc, status);
-            d->J = oskar_jones_create(vistype, dev_loc, num_stations, num_src,
-                    status);
             d->R = oskar_type_is_matrix(vistype) ? oskar_jones_create(vistype,
                     dev_loc, num_stations, num_src, status) : 0;
-            d->E = oskar_jones_create(vistype, dev_loc, num_stations, num_src,
-                    status);
-            d->K = oskar_jones_create(complx, dev_loc, num_stations, num_src,
-                    status);
+            d->E = oskar_jones_create(vistype, dev_loc,
+                    shared_E ? 1 : num_stations, num_src, status);
+            oskar_jones_set_shared_stations(d->E, shared_E, status);
+
+            /* On the CPU, Jones K is formed inside the correlator,
+             * so the full Jones J and K are only needed on GPUs. */
+            if (dev_loc != OSKAR_CPU)
+            {
+                d->J = oskar_jones_create(vistype, dev_loc, num_stations,
+                        num_src, status);
+                d->K = oskar_jones_create(complx, dev_loc, num_stations,
+                        num_src, status);
+                d->K_inc = oskar_jones_create(complx, dev_loc, num_stations,
+                        num_src, status);
+            }
             d->Z = 0;
             d->station_work = oskar_station_work_create(h->prec, dev_loc,
                     status);
         }
+        oskar_station_work_set_max_memory(d->station_work,
+                (size_t) h->max_station_work_mb * 1024 * 1024);
+
+        /* Station beam cache. */
+        if (use_E_cache && !d->E_cache)
+        {
+            int c;
+            d->E_cache_size = h->num_channels;
+            d->E_cache = (oskar_Jones**) calloc(d->E_cache_size,
+                    sizeof(oskar_Jones*));
+            d->E_cache_valid = (int*) calloc(d->E_cache_size, sizeof(int));
+            for (c = 0; c < d->E_cache_size; ++c)
+            {
+                d->E_cache[c] = oskar_jones_create(vistype, dev_loc,
+                        shared_E ? 1 : num_stations, num_src, status);
+                oskar_jones_set_shared_stations(d->E_cache[c], shared_E,
+                        status);
+            }
+            d->E_cache_ra = oskar_mem_create(h->prec, OSKAR_CPU, 0, status);
+            d->E_cache_dec = oskar_mem_create(h->prec, OSKAR_CPU, 0, status);
+        }
+        d->E_cache_chunk = -1;
+        d->E_cache_num_src = -1;
     }
 }
 
@@ -1256,6 +1746,7 @@ static void free_device_data(oskar_Interferometer* h, int* status)
         oskar_timer_free(d->tmr_K);
         oskar_timer_free(d->tmr_join);
         oskar_timer_free(d->tmr_correlate);
+        oskar_timer_free(d->tmr_idle);
         oskar_vis_block_free(d->vis_block_cpu[0], status);
         oskar_vis_block_free(d->vis_block_cpu[1], status);
         oskar_vis_block_free(d->vis_block, status);
@@ -1269,7 +1760,18 @@ static void free_device_data(oskar_Interferometer* h, int* status)
         oskar_jones_free(d->J, status);
         oskar_jones_free(d->E, status);
         oskar_jones_free(d->K, status);
+        oskar_jones_free(d->K_inc, status);
         oskar_jones_free(d->R, status);
+        if (d->E_cache)
+        {
+            int c;
+            for (c = 0; c < d->E_cache_size; ++c)
+                oskar_jones_free(d->E_cache[c], status);
+            free(d->E_cache);
+            free(d->E_cache_valid);
+            oskar_mem_free(d->E_cache_ra, status);
+            oskar_mem_free(d->E_cache_dec, status);
+        }
         memset(d, 0, sizeof(DeviceData));
     }
 }
@@ -1303,6 +1805,24 @@ static void record_timing(oskar_Interferometer* h)
     for (i = 0; i < h->num_devices; ++i)
         oskar_log_value(h->log, 'M', 0, "Compute", "%.3f s [Device %i]",
                 compute_times[i], i);
+    for (i = 0; i < h->num_devices; ++i)
+        oskar_log_value(h->log, 'M', 0, "Idle", "%.3f s [Device %i]",
+                oskar_timer_elapsed(h->d[i].tmr_idle), i);
+    for (i = 0; i < h->num_devices; ++i)
+        oskar_log_value(h->log, 'M', 0, "Sky chunk copies",
+                "%d (%.1f MB) [Device %i]", h->d[i].num_chunk_copies,
+                h->d[i].chunk_copy_bytes / (1024. * 1024.), i);
+    for (i = 0; i < h->num_devices; ++i)
+        if (h->d[i].num_E_lookups > 0)
+            oskar_log_value(h->log, 'M', 0, "Station beam cache hits",
+                    "%.1f%% of %d [Device %i]", 100.0 *
+                    h->d[i].num_E_hits / h->d[i].num_E_lookups,
+                    h->d[i].num_E_lookups, i);
+    for (i = 0; i < h->num_devices; ++i)
+        if (h->d[i].station_work)
+            oskar_log_value(h->log, 'M', 0, "Station work memory",
+                    "%.1f MB peak [Device %i]", oskar_station_work_memory_peak(
+                    h->d[i].station_work) / (1024. * 1024.), i);
     oskar_log_value(h->log, 'M', 0, "Write", "%.3f s",
             oskar_timer_elapsed(h->tmr_write));
     oskar_log_message(h->log, 'M', 0, "Compute components:");
@@ -45,6 +45,11 @@ int oskar_jones_num_stations(const oskar_Jones* jones)
     return jones->num_stations;
 }
 
+int oskar_jones_shared_stations(const oskar_Jones* jones)
+{
+    return jones->shared;
+}
+
 int oskar_jones_type(const oskar_Jones* jones)
 {
     return oskar_mem_type(jones->data);
@@ -68,6 +68,7 @@ oskar_Jones* oskar_jones_create(int type, int location, int num_stations,
     jones->num_sources = num_sources;
     jones->cap_stations = num_stations;
     jones->cap_sources = num_sources;
+    jones->shared = 0;
     jones->data = oskar_mem_create(type, location, n_elements, status);
 
     /* Return pointer to the structure. */
@@ -41,7 +41,7 @@ void oskar_jones_get_station_pointer(oskar_Mem* J_station, const oskar_Jones* J,
     int num_sources, offset;
 
     num_sources = J->num_sources;
-    offset = station_index * num_sources;
+    offset = J->shared ? 0 : station_index * num_sources;
     oskar_mem_set_alias(J_station, J->data, offset, num_sources, status);
 }
 
@@ -36,8 +36,9 @@ extern "C" {
 void oskar_jones_join(oskar_Jones* j3, oskar_Jones* j1, const oskar_Jones* j2,
         int* status)
 {
-    int num_elements, n_sources1, n_sources2, n_sources3;
+    int i, num_elements, n_sources1, n_sources2, n_sources3;
     int n_stations1, n_stations2, n_stations3;
+    oskar_Mem *s1, *s2, *s3;
 
     /* Check if safe to proceed. */
     if (*status) return;
@@ -57,9 +58,33 @@ void oskar_jones_join(oskar_Jones* j3, oskar_Jones* j1, const oskar_Jones* j2,
     if (n_stations1 != n_stations2 || n_stations1 != n_stations3)
         *status = OSKAR_ERR_DIMENSION_MISMATCH;
 
+    /* The output can only be shared if both inputs are. */
+    if (j3->shared && !(j1->shared && j2->shared))
+        *status = OSKAR_ERR_DIMENSION_MISMATCH;
+
     /* Multiply the array elements. */
-    num_elements = n_sources1 * n_stations1;
-    oskar_mem_multiply(j3->data, j1->data, j2->data, num_elements, status);
+    if (j1->shared == j3->shared && j2->shared == j3->shared)
+    {
+        num_elements = n_sources1 * (j3->shared ? 1 : n_stations1);
+        oskar_mem_multiply(j3->data, j1->data, j2->data, num_elements,
+                status);
+        return;
+    }
+
+    /* Multiply station by station if an input is shared. */
+    s1 = oskar_mem_create_alias(0, 0, 0, status);
+    s2 = oskar_mem_create_alias(0, 0, 0, status);
+    s3 = oskar_mem_create_alias(0, 0, 0, status);
+    for (i = 0; i < n_stations3; ++i)
+    {
+        oskar_jones_get_station_pointer(s1, j1, i, status);
+        oskar_jones_get_station_pointer(s2, j2, i, status);
+        oskar_jones_get_station_pointer(s3, j3, i, status);
+        oskar_mem_multiply(s3, s1, s2, n_sources3, status);
+    }
+    oskar_mem_free(s1, status);
+    oskar_mem_free(s2, status);
+    oskar_mem_free(s3, status);
 }
 
 #ifdef __cplusplus
@@ -42,9 +42,10 @@ void oskar_jones_set_size(oskar_Jones* jones, int num_stations,
     /* Check if safe to proceed. */
     if (*status) return;
 
-    /* Check size is within existing capacity. */
+    /* Check size is within existing capacity.
+     * Only one station needs to be stored if the data are shared. */
     capacity = jones->cap_stations * jones->cap_sources;
-    if (num_stations * num_sources > capacity)
+    if ((jones->shared ? 1 : num_stations) * num_sources > capacity)
     {
         *status = OSKAR_ERR_OUT_OF_RANGE;
         return;
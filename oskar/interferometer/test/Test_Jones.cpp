@@ -357,6 +357,58 @@ TEST(Jones, join_in_place_matx_matx_matx_singleCPU_doubleCPU)
             DCM, DCM, CPU, CPU, 0, 0);
 }
 
+TEST(Jones, join_shared_stations)
+{
+    int status = 0;
+    oskar_Jones *K, *E_shared, *E_full, *J1, *J2;
+    oskar_Mem *row = oskar_mem_create_alias(0, 0, 0, &status);
+
+    // Create station beams shared by all stations, and a full copy.
+    E_shared = oskar_jones_create(DCM, CPU, 1, sources, &status);
+    oskar_jones_set_shared_stations(E_shared, 1, &status);
+    oskar_jones_set_size(E_shared, stations, sources, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    EXPECT_TRUE(oskar_jones_shared_stations(E_shared));
+    srand(2);
+    oskar_mem_random_range(oskar_jones_mem(E_shared), 1.0, 2.0, &status);
+    E_full = oskar_jones_create(DCM, CPU, stations, sources, &status);
+    for (int i = 0; i < stations; ++i)
+    {
+        oskar_jones_get_station_pointer(row, E_full, i, &status);
+        oskar_mem_copy_contents(row, oskar_jones_mem(E_shared),
+                0, 0, sources, &status);
+    }
+
+    // Clearing the flag needs room for all stations.
+    oskar_jones_set_shared_stations(E_shared, 0, &status);
+    EXPECT_EQ((int)OSKAR_ERR_OUT_OF_RANGE, status);
+    status = 0;
+
+    // Join with different per-station values and compare.
+    K = oskar_jones_create(DC, CPU, stations, sources, &status);
+    oskar_mem_random_range(oskar_jones_mem(K), 1.0, 2.0, &status);
+    J1 = oskar_jones_create(DCM, CPU, stations, sources, &status);
+    J2 = oskar_jones_create(DCM, CPU, stations, sources, &status);
+    oskar_jones_join(J1, E_shared, K, &status);
+    oskar_jones_join(J2, E_full, K, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    check_values(oskar_jones_mem(J1), oskar_jones_mem(J2));
+
+    // Output can only be shared if both inputs are.
+    oskar_jones_join(E_shared, E_shared, K, &status);
+    EXPECT_EQ((int)OSKAR_ERR_DIMENSION_MISMATCH, status);
+    status = 0;
+
+    // Free memory.
+    oskar_mem_free(row, &status);
+    oskar_jones_free(K, &status);
+    oskar_jones_free(E_shared, &status);
+    oskar_jones_free(E_full, &status);
+    oskar_jones_free(J1, &status);
+    oskar_jones_free(J2, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+}
+
 #ifdef OSKAR_HAVE_OPENCL
 
 // OpenCL only. ///////////////////////////////////////////////////////////////
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "interferometer/oskar_interferometer.h"
+#include "sky/oskar_sky.h"
+#include "telescope/oskar_telescope.h"
+#include "utility/oskar_get_error_string.h"
+#include "vis/oskar_vis_block.h"
+
+#include "math/oskar_cmath.h"
+
+static void run_blocks_without_writing(int coords_only)
+{
+    int status = 0, num_stations = 3, num_times = 7, max_times_per_block = 2;
+
+    // Construct a telescope model with isotropic stations.
+    oskar_Telescope* tel = oskar_telescope_create(OSKAR_DOUBLE,
+            OSKAR_CPU, num_stations, &status);
+    for (int i = 0; i < num_stations; ++i)
+    {
+        oskar_Station* s = oskar_telescope_station(tel, i);
+        oskar_station_resize(s, 1, &status);
+        oskar_station_resize_element_types(s, 1, &status);
+    }
+    oskar_telescope_set_station_ids(tel);
+    oskar_telescope_set_station_type(tel, "Isotropic", &status);
+    oskar_telescope_set_position(tel, 0.0, M_PI / 4.0, 0.0);
+    oskar_telescope_set_phase_centre(tel,
+            OSKAR_SPHERICAL_TYPE_EQUATORIAL, 0.0, M_PI / 4.0);
+    oskar_telescope_analyse(tel, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Construct a sky model with one source.
+    oskar_Sky* sky = oskar_sky_create(OSKAR_DOUBLE, OSKAR_CPU, 1, &status);
+    oskar_sky_set_source(sky, 0, 0.01, M_PI / 4.0, 1.0, 0.0, 0.0, 0.0,
+            100e6, 0.0, 0.0, 0.0, 0.0, 0.0, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Set up the simulator on one CPU device.
+    oskar_Interferometer* h = oskar_interferometer_create(OSKAR_DOUBLE,
+            &status);
+    oskar_interferometer_set_gpus(h, 0, 0, &status);
+    oskar_interferometer_set_num_devices(h, 1);
+    oskar_interferometer_set_observation_frequency(h, 100e6, 1e6, 1);
+    oskar_interferometer_set_observation_time(h, 51544.5, 60.0, num_times);
+    oskar_interferometer_set_max_times_per_block(h, max_times_per_block);
+    oskar_interferometer_set_telescope_model(h, tel, &status);
+    oskar_interferometer_set_sky_model(h, sky, &status);
+    oskar_interferometer_set_coords_only(h, coords_only, &status);
+    oskar_interferometer_check_init(h, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Run and finalise each block without writing any of them.
+    int num_blocks = oskar_interferometer_num_vis_blocks(h);
+    ASSERT_GE(num_blocks, 3);
+    for (int b = 0; b < num_blocks; ++b)
+    {
+        oskar_interferometer_reset_work_unit_index(h);
+        oskar_interferometer_run_block(h, b, 0, &status);
+        oskar_VisBlock* block = oskar_interferometer_finalise_block(h, b,
+                &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+        EXPECT_EQ(b * max_times_per_block,
+                oskar_vis_block_start_time_index(block));
+        if (!coords_only)
+        {
+            // The source has unit flux in Stokes I.
+            const double2* xc = oskar_mem_double2_const(
+                    oskar_vis_block_cross_correlations_const(block),
+                    &status);
+            EXPECT_NEAR(1.0, sqrt(xc[0].x * xc[0].x + xc[0].y * xc[0].y),
+                    1e-10);
+        }
+    }
+    oskar_interferometer_finalise(h, &status);
+    oskar_interferometer_free(h, &status);
+    oskar_sky_free(sky, &status);
+    oskar_telescope_free(tel, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+}
+
+TEST(interferometer, run_block_without_write)
+{
+    run_blocks_without_writing(0);
+}
+
+TEST(interferometer, run_block_coords_only_without_write)
+{
+    run_blocks_without_writing(1);
+}
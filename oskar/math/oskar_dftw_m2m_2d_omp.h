@@ -56,6 +56,9 @@ extern "C" {
  * It is accessed in such a way that the output dimension must be the
  * fastest varying.
  *
+ * Runs of equally-spaced output points are evaluated using a phase
+ * recurrence.
+ *
  * The computed points are returned in the \p output array, which must be
  * pre-sized to length n_out. The values in the \p output array are
  * the complex values for each output position.
@@ -93,6 +96,9 @@ void oskar_dftw_m2m_2d_omp_f(const int n_in, const float wavenumber,
  * It is accessed in such a way that the output dimension must be the
  * fastest varying.
  *
+ * Runs of equally-spaced output points are evaluated using a phase
+ * recurrence.
+ *
  * The computed points are returned in the \p output array, which must be
  * pre-sized to length n_out. The values in the \p output array are
  * the complex values for each output position.
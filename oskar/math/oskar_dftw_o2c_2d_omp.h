@@ -52,9 +52,8 @@ extern "C" {
  * The wavelength used to compute the supplied wavenumber must be in the
  * same units as the input positions.
  *
- * Each thread evaluates a single output point, looping over all the input
- * points while performing a complex multiply-accumulate with the supplied
- * input DFT weights.
+ * Runs of equally-spaced output points are evaluated using a phase
+ * recurrence.
  *
  * The computed points are returned in the \p output array, which must be
  * pre-sized to length n_out. The values in the \p output array are
@@ -88,9 +87,8 @@ void oskar_dftw_o2c_2d_omp_f(const int n_in, const float wavenumber,
  * The wavelength used to compute the supplied wavenumber must be in the
  * same units as the input positions.
  *
- * Each thread evaluates a single output point, looping over all the input
- * points while performing a complex multiply-accumulate with the supplied
- * input DFT weights.
+ * Runs of equally-spaced output points are evaluated using a phase
+ * recurrence.
  *
  * The computed points are returned in the \p output array, which must be
  * pre-sized to length n_out. The values in the \p output array are
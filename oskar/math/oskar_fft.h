@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OSKAR_FFT_H_
+#define OSKAR_FFT_H_
+
+/**
+ * @file oskar_fft.h
+ */
+
+#include <oskar_global.h>
+#include <mem/oskar_mem.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct oskar_FFT;
+#ifndef OSKAR_FFT_TYPEDEF_
+#define OSKAR_FFT_TYPEDEF_
+typedef struct oskar_FFT oskar_FFT;
+#endif /* OSKAR_FFT_TYPEDEF_ */
+
+/**
+ * @brief
+ * Creates a plan for in-place 2D complex-to-complex forward FFTs.
+ *
+ * @details
+ * Creates a plan for forward FFTs of square complex grids of the
+ * given size, which can be used for any number of grids of that size.
+ *
+ * If \p location is OSKAR_GPU, the transforms use cuFFT on the current
+ * device. Otherwise, they use FFTPACK on the CPU, with the transforms of
+ * the columns and then the rows shared between all available threads.
+ *
+ * @param[in] precision  Enumerated precision (OSKAR_SINGLE or OSKAR_DOUBLE).
+ * @param[in] location   Enumerated location (OSKAR_CPU or OSKAR_GPU).
+ * @param[in] grid_size  Side length of the grid.
+ * @param[in,out] status Status return code.
+ *
+ * @return A handle to the new plan.
+ */
+OSKAR_EXPORT
+oskar_FFT* oskar_fft_create(int precision, int location, int grid_size,
+        int* status);
+
+/**
+ * @brief
+ * Performs an in-place forward FFT of a complex grid.
+ *
+ * @details
+ * Transforms the supplied complex grid in place. The result is not
+ * normalised, so is the same as that given by cuFFT or FFTW.
+ *
+ * The grid may be in either CPU or GPU memory. If it is not in the same
+ * location as the plan, it is copied there and back again.
+ *
+ * @param[in] h           Handle to FFT plan.
+ * @param[in,out] grid    Complex grid to transform.
+ * @param[in,out] status  Status return code.
+ */
+OSKAR_EXPORT
+void oskar_fft_exec(oskar_FFT* h, oskar_Mem* grid, int* status);
+
+/**
+ * @brief
+ * Frees memory held by an FFT plan.
+ *
+ * @details
+ * Frees memory held by an FFT plan.
+ *
+ * @param[in,out] h  Handle to FFT plan.
+ */
+OSKAR_EXPORT
+void oskar_fft_free(oskar_FFT* h);
+
+/**
+ * @brief
+ * Returns the side length of the grid used by the FFT plan.
+ *
+ * @details
+ * Returns the side length of the grid used by the FFT plan.
+ *
+ * @param[in] h  Handle to FFT plan.
+ */
+OSKAR_EXPORT
+int oskar_fft_grid_size(const oskar_FFT* h);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OSKAR_FFT_H_ */
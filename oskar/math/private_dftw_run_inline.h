@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OSKAR_PRIVATE_DFTW_RUN_INLINE_H_
+#define OSKAR_PRIVATE_DFTW_RUN_INLINE_H_
+
+/**
+ * @file private_dftw_run_inline.h
+ *
+ * @details
+ * Helpers for the CPU DFT-weights kernels.
+ *
+ * When consecutive output points lie on a straight line at a constant
+ * spacing (a "run", as generated for every row of a regular image grid),
+ * the phase for each input point changes by a constant factor between
+ * neighbouring outputs. The phases along the run can then be generated by
+ * complex multiplication instead of calls to sin() and cos(), which are
+ * made only once per segment of OSKAR_DFTW_RUN_ANCHOR_* points to stop
+ * rounding errors from accumulating.
+ */
+
+#include <oskar_global.h>
+#include <float.h>
+#include <math.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/* Maximum number of output points processed in a single run. */
+#define OSKAR_DFTW_RUN_MAX 256
+
+/* Minimum run length for which the recurrence is used. */
+#define OSKAR_DFTW_RUN_MIN 8
+
+/* Number of recurrence steps between exact phase evaluations. */
+#define OSKAR_DFTW_RUN_ANCHOR_F 16
+#define OSKAR_DFTW_RUN_ANCHOR_D 64
+
+/* Number of input points per tile for directly-evaluated output points. */
+#define OSKAR_DFTW_POINT_TILE 64
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Single precision. */
+OSKAR_INLINE
+int oskar_dftw_run_length_f(const float* x, const float* y, const int start,
+        const int end)
+{
+    int i, max_end;
+    float dx, dy;
+    const float tol = 2.0f * FLT_EPSILON;
+    max_end = start + OSKAR_DFTW_RUN_MAX;
+    if (max_end > end) max_end = end;
+    if (max_end - start < OSKAR_DFTW_RUN_MIN) return 1;
+    dx = x[start + 1] - x[start];
+    dy = y[start + 1] - y[start];
+
+    /* Points must match the line to within the tolerance (and not be NaN). */
+    for (i = start + 2; i < max_end; ++i)
+    {
+        const float j = (float) (i - start);
+        if (!(fabsf(x[i] - (x[start] + j * dx)) <= tol &&
+                fabsf(y[i] - (y[start] + j * dy)) <= tol))
+            break;
+    }
+    return (i - start < OSKAR_DFTW_RUN_MIN) ? 1 : i - start;
+}
+
+/*
+ * Returns the number of output points in each block handed to a thread.
+ * Blocks are at most OSKAR_DFTW_RUN_MAX points long, but are made shorter
+ * if needed so that every thread gets at least one block.
+ */
+OSKAR_INLINE
+int oskar_dftw_block_size(const int n_out)
+{
+    int block_size, num_threads = 1;
+#ifdef _OPENMP
+    num_threads = omp_get_max_threads();
+#endif
+    block_size = (n_out + num_threads - 1) / num_threads;
+    if (block_size > OSKAR_DFTW_RUN_MAX) block_size = OSKAR_DFTW_RUN_MAX;
+    return (block_size < 1) ? 1 : block_size;
+}
+
+/* Double precision. */
+OSKAR_INLINE
+int oskar_dftw_run_length_d(const double* x, const double* y,
+        const int start, const int end)
+{
+    int i, max_end;
+    double dx, dy;
+    const double tol = 16.0 * DBL_EPSILON;
+    max_end = start + OSKAR_DFTW_RUN_MAX;
+    if (max_end > end) max_end = end;
+    if (max_end - start < OSKAR_DFTW_RUN_MIN) return 1;
+    dx = x[start + 1] - x[start];
+    dy = y[start + 1] - y[start];
+
+    /* Points must match the line to within the tolerance (and not be NaN). */
+    for (i = start + 2; i < max_end; ++i)
+    {
+        const double j = (double) (i - start);
+        if (!(fabs(x[i] - (x[start] + j * dx)) <= tol &&
+                fabs(y[i] - (y[start] + j * dy)) <= tol))
+            break;
+    }
+    return (i - start < OSKAR_DFTW_RUN_MIN) ? 1 : i - start;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OSKAR_PRIVATE_DFTW_RUN_INLINE_H_ */
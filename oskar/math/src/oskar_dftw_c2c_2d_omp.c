@@ -27,121 +27,358 @@
  */
 
 #include "math/oskar_dftw_c2c_2d_omp.h"
+#include "math/private_dftw_run_inline.h"
 #include <math.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-/* Single precision. */
-void oskar_dftw_c2c_2d_omp_f(const int n_in, const float wavenumber,
+static void dftw_point_f(const int n_in, const float wavenumber,
         const float* x_in, const float* y_in, const float2* weights_in,
-        const int n_out, const float* x_out, const float* y_out,
-        const float2* data, float2* output)
+        const float x_out, const float y_out,
+        const float2* data, const int n_out, float2* output)
 {
-    int i_out = 0;
+    int i, i0, k;
+    float xp_out, yp_out;
+    float2 out;
 
-    /* Loop over output points. */
-    #pragma omp parallel for private(i_out)
-    for (i_out = 0; i_out < n_out; ++i_out)
-    {
-        int i;
-        float xp_out, yp_out;
-        float2 out;
+    /* Clear output value. */
+    out.x = 0.0f;
+    out.y = 0.0f;
 
-        /* Clear output value. */
-        out.x = 0.0f;
-        out.y = 0.0f;
+    /* Get the output position. */
+    xp_out = wavenumber * x_out;
+    yp_out = wavenumber * y_out;
 
-        /* Get the output position. */
-        xp_out = wavenumber * x_out[i_out];
-        yp_out = wavenumber * y_out[i_out];
+    /* Loop over tiles of input points. */
+    for (i0 = 0; i0 < n_in; i0 += OSKAR_DFTW_POINT_TILE)
+    {
+        float phase[OSKAR_DFTW_POINT_TILE];
+        float cos_phase[OSKAR_DFTW_POINT_TILE];
+        float sin_phase[OSKAR_DFTW_POINT_TILE];
+        const int num_i = (n_in - i0 < OSKAR_DFTW_POINT_TILE) ?
+                n_in - i0 : OSKAR_DFTW_POINT_TILE;
 
-        /* Loop over input points. */
-        for (i = 0; i < n_in; ++i)
+        /* Calculate the phases for the output position, then their
+         * cosines and sines, in loops over contiguous arrays. */
+        for (k = 0; k < num_i; ++k)
+            phase[k] = xp_out * x_in[i0 + k] + yp_out * y_in[i0 + k];
+        for (k = 0; k < num_i; ++k)
         {
-            float2 temp, w;
-            float a;
+            cos_phase[k] = cosf(phase[k]);
+            sin_phase[k] = sinf(phase[k]);
+        }
+
+        /* Loop over input points in the tile. */
+        for (k = 0, i = i0; k < num_i; ++k, ++i)
+        {
+            float2 weight, w;
+            float t;
 
-            /* Calculate the phase for the output position. */
-            a = xp_out * x_in[i] + yp_out * y_in[i];
-            temp.x = cosf(a);
-            temp.y = sinf(a);
+            weight.x = cos_phase[k];
+            weight.y = sin_phase[k];
 
             /* Multiply the supplied DFT weight by the computed phase. */
             w = weights_in[i];
-            a = w.x;
-            w.x *= temp.x;
-            w.x -= w.y * temp.y;
-            w.y *= temp.x;
-            w.y += a * temp.y;
+            t = weight.x; /* Copy the real part. */
+            weight.x *= w.x;
+            weight.x -= w.y * weight.y;
+            weight.y *= w.x;
+            weight.y += w.y * t;
 
             /* Perform complex multiply-accumulate. */
-            temp = data[i * n_out + i_out];
-            out.x += w.x * temp.x;
-            out.x -= w.y * temp.y;
-            out.y += w.y * temp.x;
-            out.y += w.x * temp.y;
+            {
+                const float2 in = data[i * n_out];
+                out.x += weight.x * in.x;
+                out.x -= weight.y * in.y;
+                out.y += weight.y * in.x;
+                out.y += weight.x * in.y;
+            }
         }
+    }
+
+    /* Store the output point. */
+    *output = out;
+}
+
+static void dftw_run_f(const int n_in, const float wavenumber,
+        const float* x_in, const float* y_in, const float2* weights_in,
+        const int len, const float* x_out, const float* y_out,
+        const float2* data, const int n_out,
+        float2* output)
+{
+    int i, j, k;
+    float dx, dy;
+    float2 out[OSKAR_DFTW_RUN_MAX];
+
+    /* Clear output values. */
+    for (k = 0; k < len; ++k)
+    {
+        out[k].x = 0.0f;
+        out[k].y = 0.0f;
+    }
+
+    /* Get the spacing between output points. */
+    dx = wavenumber * (x_out[1] - x_out[0]);
+    dy = wavenumber * (y_out[1] - y_out[0]);
+
+    /* Loop over input points. */
+    for (i = 0; i < n_in; ++i)
+    {
+        float2 step, weight, w;
+        float t;
 
-        /* Store the output point. */
-        output[i_out] = out;
+        /* Calculate the phase step between adjacent output points. */
+        t = dx * x_in[i] + dy * y_in[i];
+        step.x = cosf(t);
+        step.y = sinf(t);
+        w = weights_in[i];
+
+        /* Loop over segments of the run. */
+        for (j = 0; j < len; j += OSKAR_DFTW_RUN_ANCHOR_F)
+        {
+            const int end = (j + OSKAR_DFTW_RUN_ANCHOR_F < len) ?
+                    j + OSKAR_DFTW_RUN_ANCHOR_F : len;
+
+            /* Calculate the phase exactly at the start of the segment. */
+            t = (wavenumber * x_out[j]) * x_in[i] +
+                    (wavenumber * y_out[j]) * y_in[i];
+            weight.x = cosf(t);
+            weight.y = sinf(t);
+
+            /* Multiply the supplied DFT weight by the computed phase. */
+            t = weight.x; /* Copy the real part. */
+            weight.x *= w.x;
+            weight.x -= w.y * weight.y;
+            weight.y *= w.x;
+            weight.y += w.y * t;
+
+            /* Advance the phase along the segment by complex multiplication. */
+            for (k = j; k < end; ++k)
+            {
+                const float2 in = data[i * n_out + k];
+                out[k].x += weight.x * in.x;
+                out[k].x -= weight.y * in.y;
+                out[k].y += weight.y * in.x;
+                out[k].y += weight.x * in.y;
+                t = weight.x;
+                weight.x = t * step.x - weight.y * step.y;
+                weight.y = t * step.y + weight.y * step.x;
+            }
+        }
     }
+
+    /* Store the output points. */
+    for (k = 0; k < len; ++k) output[k] = out[k];
 }
 
-/* Double precision. */
-void oskar_dftw_c2c_2d_omp_d(const int n_in, const double wavenumber,
+static void dftw_point_d(const int n_in, const double wavenumber,
         const double* x_in, const double* y_in, const double2* weights_in,
-        const int n_out, const double* x_out, const double* y_out,
-        const double2* data, double2* output)
+        const double x_out, const double y_out,
+        const double2* data, const int n_out, double2* output)
 {
-    int i_out = 0;
+    int i, i0, k;
+    double xp_out, yp_out;
+    double2 out;
 
-    /* Loop over output points. */
-    #pragma omp parallel for private(i_out)
-    for (i_out = 0; i_out < n_out; ++i_out)
-    {
-        int i;
-        double xp_out, yp_out;
-        double2 out;
+    /* Clear output value. */
+    out.x = 0.0;
+    out.y = 0.0;
 
-        /* Clear output value. */
-        out.x = 0.0;
-        out.y = 0.0;
+    /* Get the output position. */
+    xp_out = wavenumber * x_out;
+    yp_out = wavenumber * y_out;
 
-        /* Get the output position. */
-        xp_out = wavenumber * x_out[i_out];
-        yp_out = wavenumber * y_out[i_out];
+    /* Loop over tiles of input points. */
+    for (i0 = 0; i0 < n_in; i0 += OSKAR_DFTW_POINT_TILE)
+    {
+        double phase[OSKAR_DFTW_POINT_TILE];
+        double cos_phase[OSKAR_DFTW_POINT_TILE];
+        double sin_phase[OSKAR_DFTW_POINT_TILE];
+        const int num_i = (n_in - i0 < OSKAR_DFTW_POINT_TILE) ?
+                n_in - i0 : OSKAR_DFTW_POINT_TILE;
+
+        /* Calculate the phases for the output position, then their
+         * cosines and sines, in loops over contiguous arrays. */
+        for (k = 0; k < num_i; ++k)
+            phase[k] = xp_out * x_in[i0 + k] + yp_out * y_in[i0 + k];
+        for (k = 0; k < num_i; ++k)
+        {
+            cos_phase[k] = cos(phase[k]);
+            sin_phase[k] = sin(phase[k]);
+        }
 
-        /* Loop over input points. */
-        for (i = 0; i < n_in; ++i)
+        /* Loop over input points in the tile. */
+        for (k = 0, i = i0; k < num_i; ++k, ++i)
         {
-            double2 temp, w;
-            double a;
+            double2 weight, w;
+            double t;
 
-            /* Calculate the phase for the output position. */
-            a = xp_out * x_in[i] + yp_out * y_in[i];
-            temp.x = cos(a);
-            temp.y = sin(a);
+            weight.x = cos_phase[k];
+            weight.y = sin_phase[k];
 
             /* Multiply the supplied DFT weight by the computed phase. */
             w = weights_in[i];
-            a = w.x;
-            w.x *= temp.x;
-            w.x -= w.y * temp.y;
-            w.y *= temp.x;
-            w.y += a * temp.y;
+            t = weight.x; /* Copy the real part. */
+            weight.x *= w.x;
+            weight.x -= w.y * weight.y;
+            weight.y *= w.x;
+            weight.y += w.y * t;
 
             /* Perform complex multiply-accumulate. */
-            temp = data[i * n_out + i_out];
-            out.x += w.x * temp.x;
-            out.x -= w.y * temp.y;
-            out.y += w.y * temp.x;
-            out.y += w.x * temp.y;
+            {
+                const double2 in = data[i * n_out];
+                out.x += weight.x * in.x;
+                out.x -= weight.y * in.y;
+                out.y += weight.y * in.x;
+                out.y += weight.x * in.y;
+            }
+        }
+    }
+
+    /* Store the output point. */
+    *output = out;
+}
+
+static void dftw_run_d(const int n_in, const double wavenumber,
+        const double* x_in, const double* y_in, const double2* weights_in,
+        const int len, const double* x_out, const double* y_out,
+        const double2* data, const int n_out,
+        double2* output)
+{
+    int i, j, k;
+    double dx, dy;
+    double2 out[OSKAR_DFTW_RUN_MAX];
+
+    /* Clear output values. */
+    for (k = 0; k < len; ++k)
+    {
+        out[k].x = 0.0;
+        out[k].y = 0.0;
+    }
+
+    /* Get the spacing between output points. */
+    dx = wavenumber * (x_out[1] - x_out[0]);
+    dy = wavenumber * (y_out[1] - y_out[0]);
+
+    /* Loop over input points. */
+    for (i = 0; i < n_in; ++i)
+    {
+        double2 step, weight, w;
+        double t;
+
+        /* Calculate the phase step between adjacent output points. */
+        t = dx * x_in[i] + dy * y_in[i];
+        step.x = cos(t);
+        step.y = sin(t);
+        w = weights_in[i];
+
+        /* Loop over segments of the run. */
+        for (j = 0; j < len; j += OSKAR_DFTW_RUN_ANCHOR_D)
+        {
+            const int end = (j + OSKAR_DFTW_RUN_ANCHOR_D < len) ?
+                    j + OSKAR_DFTW_RUN_ANCHOR_D : len;
+
+            /* Calculate the phase exactly at the start of the segment. */
+            t = (wavenumber * x_out[j]) * x_in[i] +
+                    (wavenumber * y_out[j]) * y_in[i];
+            weight.x = cos(t);
+            weight.y = sin(t);
+
+            /* Multiply the supplied DFT weight by the computed phase. */
+            t = weight.x; /* Copy the real part. */
+            weight.x *= w.x;
+            weight.x -= w.y * weight.y;
+            weight.y *= w.x;
+            weight.y += w.y * t;
+
+            /* Advance the phase along the segment by complex multiplication. */
+            for (k = j; k < end; ++k)
+            {
+                const double2 in = data[i * n_out + k];
+                out[k].x += weight.x * in.x;
+                out[k].x -= weight.y * in.y;
+                out[k].y += weight.y * in.x;
+                out[k].y += weight.x * in.y;
+                t = weight.x;
+                weight.x = t * step.x - weight.y * step.y;
+                weight.y = t * step.y + weight.y * step.x;
+            }
+        }
+    }
+
+    /* Store the output points. */
+    for (k = 0; k < len; ++k) output[k] = out[k];
+}
+
+/* Single precision. */
+void oskar_dftw_c2c_2d_omp_f(const int n_in, const float wavenumber,
+        const float* x_in, const float* y_in, const float2* weights_in,
+        const int n_out, const float* x_out, const float* y_out,
+        const float2* data, float2* output)
+{
+    int b = 0;
+    const int block_size = oskar_dftw_block_size(n_out);
+    const int num_blocks = (n_out + block_size - 1) / block_size;
+
+    /* Loop over blocks of output points. */
+    #pragma omp parallel for private(b) schedule(dynamic, 1)
+    for (b = 0; b < num_blocks; ++b)
+    {
+        int i_out, len, end;
+        i_out = b * block_size;
+        end = (i_out + block_size < n_out) ? i_out + block_size : n_out;
+        for (; i_out < end; i_out += len)
+        {
+            /* Use the phase recurrence for regularly-spaced points. */
+            len = oskar_dftw_run_length_f(x_out, y_out, i_out, end);
+            if (len > 1)
+                dftw_run_f(n_in, wavenumber, x_in, y_in, weights_in, len,
+                        x_out + i_out, y_out + i_out,
+                        data + i_out, n_out,
+                        output + i_out);
+            else
+                dftw_point_f(n_in, wavenumber, x_in, y_in, weights_in,
+                        x_out[i_out], y_out[i_out], data + i_out,
+                        n_out,
+                        output + i_out);
         }
+    }
+}
 
-        /* Store the output point. */
-        output[i_out] = out;
+/* Double precision. */
+void oskar_dftw_c2c_2d_omp_d(const int n_in, const double wavenumber,
+        const double* x_in, const double* y_in, const double2* weights_in,
+        const int n_out, const double* x_out, const double* y_out,
+        const double2* data, double2* output)
+{
+    int b = 0;
+    const int block_size = oskar_dftw_block_size(n_out);
+    const int num_blocks = (n_out + block_size - 1) / block_size;
+
+    /* Loop over blocks of output points. */
+    #pragma omp parallel for private(b) schedule(dynamic, 1)
+    for (b = 0; b < num_blocks; ++b)
+    {
+        int i_out, len, end;
+        i_out = b * block_size;
+        end = (i_out + block_size < n_out) ? i_out + block_size : n_out;
+        for (; i_out < end; i_out += len)
+        {
+            /* Use the phase recurrence for regularly-spaced points. */
+            len = oskar_dftw_run_length_d(x_out, y_out, i_out, end);
+            if (len > 1)
+                dftw_run_d(n_in, wavenumber, x_in, y_in, weights_in, len,
+                        x_out + i_out, y_out + i_out,
+                        data + i_out, n_out,
+                        output + i_out);
+            else
+                dftw_point_d(n_in, wavenumber, x_in, y_in, weights_in,
+                        x_out[i_out], y_out[i_out], data + i_out,
+                        n_out,
+                        output + i_out);
+        }
     }
 }
 
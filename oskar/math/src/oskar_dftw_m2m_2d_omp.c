@@ -27,173 +27,430 @@
  */
 
 #include "math/oskar_dftw_m2m_2d_omp.h"
+#include "math/private_dftw_run_inline.h"
 #include <math.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-/* Single precision. */
-void oskar_dftw_m2m_2d_omp_f(const int n_in, const float wavenumber,
+static void dftw_point_f(const int n_in, const float wavenumber,
         const float* x_in, const float* y_in, const float2* weights_in,
-        const int n_out, const float* x_out, const float* y_out,
-        const float4c* data, float4c* output)
+        const float x_out, const float y_out,
+        const float4c* data, const int n_out, float4c* output)
 {
-    int i_out = 0;
+    int i, i0, k;
+    float xp_out, yp_out;
+    float4c out;
+
+    /* Clear output value. */
+    out.a.x = 0.0f;
+    out.a.y = 0.0f;
+    out.b.x = 0.0f;
+    out.b.y = 0.0f;
+    out.c.x = 0.0f;
+    out.c.y = 0.0f;
+    out.d.x = 0.0f;
+    out.d.y = 0.0f;
+
+    /* Get the output position. */
+    xp_out = wavenumber * x_out;
+    yp_out = wavenumber * y_out;
 
-    /* Loop over output points. */
-    #pragma omp parallel for private(i_out)
-    for (i_out = 0; i_out < n_out; ++i_out)
+    /* Loop over tiles of input points. */
+    for (i0 = 0; i0 < n_in; i0 += OSKAR_DFTW_POINT_TILE)
     {
-        int i;
-        float xp_out, yp_out;
-        float4c out;
-
-        /* Clear output value. */
-        out.a.x = 0.0f;
-        out.a.y = 0.0f;
-        out.b.x = 0.0f;
-        out.b.y = 0.0f;
-        out.c.x = 0.0f;
-        out.c.y = 0.0f;
-        out.d.x = 0.0f;
-        out.d.y = 0.0f;
-
-        /* Get the output position. */
-        xp_out = wavenumber * x_out[i_out];
-        yp_out = wavenumber * y_out[i_out];
-
-        /* Loop over input points. */
-        for (i = 0; i < n_in; ++i)
+        float phase[OSKAR_DFTW_POINT_TILE];
+        float cos_phase[OSKAR_DFTW_POINT_TILE];
+        float sin_phase[OSKAR_DFTW_POINT_TILE];
+        const int num_i = (n_in - i0 < OSKAR_DFTW_POINT_TILE) ?
+                n_in - i0 : OSKAR_DFTW_POINT_TILE;
+
+        /* Calculate the phases for the output position, then their
+         * cosines and sines, in loops over contiguous arrays. */
+        for (k = 0; k < num_i; ++k)
+            phase[k] = xp_out * x_in[i0 + k] + yp_out * y_in[i0 + k];
+        for (k = 0; k < num_i; ++k)
         {
-            float2 weight;
+            cos_phase[k] = cosf(phase[k]);
+            sin_phase[k] = sinf(phase[k]);
+        }
 
-            /* Calculate the DFT phase for the output position. */
-            {
-                float t;
-                float2 w;
-
-                /* Phase. */
-                t = xp_out * x_in[i] + yp_out * y_in[i];
-                weight.x = cosf(t);
-                weight.y = sinf(t);
-
-                /* Multiply the supplied DFT weight by the computed phase. */
-                w = weights_in[i];
-                t = weight.x; /* Copy the real part. */
-                weight.x *= w.x;
-                weight.x -= w.y * weight.y;
-                weight.y *= w.x;
-                weight.y += w.y * t;
-            }
+        /* Loop over input points in the tile. */
+        for (k = 0, i = i0; k < num_i; ++k, ++i)
+        {
+            float2 weight, w;
+            float t;
+
+            weight.x = cos_phase[k];
+            weight.y = sin_phase[k];
+
+            /* Multiply the supplied DFT weight by the computed phase. */
+            w = weights_in[i];
+            t = weight.x; /* Copy the real part. */
+            weight.x *= w.x;
+            weight.x -= w.y * weight.y;
+            weight.y *= w.x;
+            weight.y += w.y * t;
 
             /* Complex multiply-accumulate input signal and weight. */
             {
-                float4c in;
-                in = data[i * n_out + i_out];
-                out.a.x += in.a.x * weight.x;
-                out.a.x -= in.a.y * weight.y;
-                out.a.y += in.a.y * weight.x;
-                out.a.y += in.a.x * weight.y;
-                out.b.x += in.b.x * weight.x;
-                out.b.x -= in.b.y * weight.y;
-                out.b.y += in.b.y * weight.x;
-                out.b.y += in.b.x * weight.y;
-                out.c.x += in.c.x * weight.x;
-                out.c.x -= in.c.y * weight.y;
-                out.c.y += in.c.y * weight.x;
-                out.c.y += in.c.x * weight.y;
-                out.d.x += in.d.x * weight.x;
-                out.d.x -= in.d.y * weight.y;
-                out.d.y += in.d.y * weight.x;
-                out.d.y += in.d.x * weight.y;
+                const float4c in = data[i * n_out];
+                out.a.x += weight.x * in.a.x;
+                out.a.x -= weight.y * in.a.y;
+                out.a.y += weight.y * in.a.x;
+                out.a.y += weight.x * in.a.y;
+                out.b.x += weight.x * in.b.x;
+                out.b.x -= weight.y * in.b.y;
+                out.b.y += weight.y * in.b.x;
+                out.b.y += weight.x * in.b.y;
+                out.c.x += weight.x * in.c.x;
+                out.c.x -= weight.y * in.c.y;
+                out.c.y += weight.y * in.c.x;
+                out.c.y += weight.x * in.c.y;
+                out.d.x += weight.x * in.d.x;
+                out.d.x -= weight.y * in.d.y;
+                out.d.y += weight.y * in.d.x;
+                out.d.y += weight.x * in.d.y;
             }
         }
+    }
+
+    /* Store the output point. */
+    *output = out;
+}
+
+static void dftw_run_f(const int n_in, const float wavenumber,
+        const float* x_in, const float* y_in, const float2* weights_in,
+        const int len, const float* x_out, const float* y_out,
+        const float4c* data, const int n_out,
+        float4c* output)
+{
+    int i, j, k;
+    float dx, dy;
+    float4c out[OSKAR_DFTW_RUN_MAX];
+
+    /* Clear output values. */
+    for (k = 0; k < len; ++k)
+    {
+        out[k].a.x = 0.0f;
+        out[k].a.y = 0.0f;
+        out[k].b.x = 0.0f;
+        out[k].b.y = 0.0f;
+        out[k].c.x = 0.0f;
+        out[k].c.y = 0.0f;
+        out[k].d.x = 0.0f;
+        out[k].d.y = 0.0f;
+    }
+
+    /* Get the spacing between output points. */
+    dx = wavenumber * (x_out[1] - x_out[0]);
+    dy = wavenumber * (y_out[1] - y_out[0]);
 
-        /* Store the output point. */
-        output[i_out] = out;
+    /* Loop over input points. */
+    for (i = 0; i < n_in; ++i)
+    {
+        float2 step, weight, w;
+        float t;
+
+        /* Calculate the phase step between adjacent output points. */
+        t = dx * x_in[i] + dy * y_in[i];
+        step.x = cosf(t);
+        step.y = sinf(t);
+        w = weights_in[i];
+
+        /* Loop over segments of the run. */
+        for (j = 0; j < len; j += OSKAR_DFTW_RUN_ANCHOR_F)
+        {
+            const int end = (j + OSKAR_DFTW_RUN_ANCHOR_F < len) ?
+                    j + OSKAR_DFTW_RUN_ANCHOR_F : len;
+
+            /* Calculate the phase exactly at the start of the segment. */
+            t = (wavenumber * x_out[j]) * x_in[i] +
+                    (wavenumber * y_out[j]) * y_in[i];
+            weight.x = cosf(t);
+            weight.y = sinf(t);
+
+            /* Multiply the supplied DFT weight by the computed phase. */
+            t = weight.x; /* Copy the real part. */
+            weight.x *= w.x;
+            weight.x -= w.y * weight.y;
+            weight.y *= w.x;
+            weight.y += w.y * t;
+
+            /* Advance the phase along the segment by complex multiplication. */
+            for (k = j; k < end; ++k)
+            {
+                const float4c in = data[i * n_out + k];
+                out[k].a.x += weight.x * in.a.x;
+                out[k].a.x -= weight.y * in.a.y;
+                out[k].a.y += weight.y * in.a.x;
+                out[k].a.y += weight.x * in.a.y;
+                out[k].b.x += weight.x * in.b.x;
+                out[k].b.x -= weight.y * in.b.y;
+                out[k].b.y += weight.y * in.b.x;
+                out[k].b.y += weight.x * in.b.y;
+                out[k].c.x += weight.x * in.c.x;
+                out[k].c.x -= weight.y * in.c.y;
+                out[k].c.y += weight.y * in.c.x;
+                out[k].c.y += weight.x * in.c.y;
+                out[k].d.x += weight.x * in.d.x;
+                out[k].d.x -= weight.y * in.d.y;
+                out[k].d.y += weight.y * in.d.x;
+                out[k].d.y += weight.x * in.d.y;
+                t = weight.x;
+                weight.x = t * step.x - weight.y * step.y;
+                weight.y = t * step.y + weight.y * step.x;
+            }
+        }
     }
+
+    /* Store the output points. */
+    for (k = 0; k < len; ++k) output[k] = out[k];
 }
 
-/* Double precision. */
-void oskar_dftw_m2m_2d_omp_d(const int n_in, const double wavenumber,
+static void dftw_point_d(const int n_in, const double wavenumber,
         const double* x_in, const double* y_in, const double2* weights_in,
-        const int n_out, const double* x_out, const double* y_out,
-        const double4c* data, double4c* output)
+        const double x_out, const double y_out,
+        const double4c* data, const int n_out, double4c* output)
 {
-    int i_out = 0;
+    int i, i0, k;
+    double xp_out, yp_out;
+    double4c out;
 
-    /* Loop over output points. */
-    #pragma omp parallel for private(i_out)
-    for (i_out = 0; i_out < n_out; ++i_out)
+    /* Clear output value. */
+    out.a.x = 0.0;
+    out.a.y = 0.0;
+    out.b.x = 0.0;
+    out.b.y = 0.0;
+    out.c.x = 0.0;
+    out.c.y = 0.0;
+    out.d.x = 0.0;
+    out.d.y = 0.0;
+
+    /* Get the output position. */
+    xp_out = wavenumber * x_out;
+    yp_out = wavenumber * y_out;
+
+    /* Loop over tiles of input points. */
+    for (i0 = 0; i0 < n_in; i0 += OSKAR_DFTW_POINT_TILE)
     {
-        int i;
-        double xp_out, yp_out;
-        double4c out;
-
-        /* Clear output value. */
-        out.a.x = 0.0;
-        out.a.y = 0.0;
-        out.b.x = 0.0;
-        out.b.y = 0.0;
-        out.c.x = 0.0;
-        out.c.y = 0.0;
-        out.d.x = 0.0;
-        out.d.y = 0.0;
-
-        /* Get the output position. */
-        xp_out = wavenumber * x_out[i_out];
-        yp_out = wavenumber * y_out[i_out];
-
-        /* Loop over input points. */
-        for (i = 0; i < n_in; ++i)
+        double phase[OSKAR_DFTW_POINT_TILE];
+        double cos_phase[OSKAR_DFTW_POINT_TILE];
+        double sin_phase[OSKAR_DFTW_POINT_TILE];
+        const int num_i = (n_in - i0 < OSKAR_DFTW_POINT_TILE) ?
+                n_in - i0 : OSKAR_DFTW_POINT_TILE;
+
+        /* Calculate the phases for the output position, then their
+         * cosines and sines, in loops over contiguous arrays. */
+        for (k = 0; k < num_i; ++k)
+            phase[k] = xp_out * x_in[i0 + k] + yp_out * y_in[i0 + k];
+        for (k = 0; k < num_i; ++k)
         {
-            double2 weight;
+            cos_phase[k] = cos(phase[k]);
+            sin_phase[k] = sin(phase[k]);
+        }
+
+        /* Loop over input points in the tile. */
+        for (k = 0, i = i0; k < num_i; ++k, ++i)
+        {
+            double2 weight, w;
+            double t;
+
+            weight.x = cos_phase[k];
+            weight.y = sin_phase[k];
+
+            /* Multiply the supplied DFT weight by the computed phase. */
+            w = weights_in[i];
+            t = weight.x; /* Copy the real part. */
+            weight.x *= w.x;
+            weight.x -= w.y * weight.y;
+            weight.y *= w.x;
+            weight.y += w.y * t;
 
-            /* Calculate the DFT phase for the output position. */
+            /* Complex multiply-accumulate input signal and weight. */
             {
-                double t;
-                double2 w;
-
-                /* Phase. */
-                t = xp_out * x_in[i] + yp_out * y_in[i];
-                weight.x = cos(t);
-                weight.y = sin(t);
-
-                /* Multiply the supplied DFT weight by the computed phase. */
-                w = weights_in[i];
-                t = weight.x; /* Copy the real part. */
-                weight.x *= w.x;
-                weight.x -= w.y * weight.y;
-                weight.y *= w.x;
-                weight.y += w.y * t;
+                const double4c in = data[i * n_out];
+                out.a.x += weight.x * in.a.x;
+                out.a.x -= weight.y * in.a.y;
+                out.a.y += weight.y * in.a.x;
+                out.a.y += weight.x * in.a.y;
+                out.b.x += weight.x * in.b.x;
+                out.b.x -= weight.y * in.b.y;
+                out.b.y += weight.y * in.b.x;
+                out.b.y += weight.x * in.b.y;
+                out.c.x += weight.x * in.c.x;
+                out.c.x -= weight.y * in.c.y;
+                out.c.y += weight.y * in.c.x;
+                out.c.y += weight.x * in.c.y;
+                out.d.x += weight.x * in.d.x;
+                out.d.x -= weight.y * in.d.y;
+                out.d.y += weight.y * in.d.x;
+                out.d.y += weight.x * in.d.y;
             }
+        }
+    }
 
-            /* Complex multiply-accumulate input signal and weight. */
+    /* Store the output point. */
+    *output = out;
+}
+
+static void dftw_run_d(const int n_in, const double wavenumber,
+        const double* x_in, const double* y_in, const double2* weights_in,
+        const int len, const double* x_out, const double* y_out,
+        const double4c* data, const int n_out,
+        double4c* output)
+{
+    int i, j, k;
+    double dx, dy;
+    double4c out[OSKAR_DFTW_RUN_MAX];
+
+    /* Clear output values. */
+    for (k = 0; k < len; ++k)
+    {
+        out[k].a.x = 0.0;
+        out[k].a.y = 0.0;
+        out[k].b.x = 0.0;
+        out[k].b.y = 0.0;
+        out[k].c.x = 0.0;
+        out[k].c.y = 0.0;
+        out[k].d.x = 0.0;
+        out[k].d.y = 0.0;
+    }
+
+    /* Get the spacing between output points. */
+    dx = wavenumber * (x_out[1] - x_out[0]);
+    dy = wavenumber * (y_out[1] - y_out[0]);
+
+    /* Loop over input points. */
+    for (i = 0; i < n_in; ++i)
+    {
+        double2 step, weight, w;
+        double t;
+
+        /* Calculate the phase step between adjacent output points. */
+        t = dx * x_in[i] + dy * y_in[i];
+        step.x = cos(t);
+        step.y = sin(t);
+        w = weights_in[i];
+
+        /* Loop over segments of the run. */
+        for (j = 0; j < len; j += OSKAR_DFTW_RUN_ANCHOR_D)
+        {
+            const int end = (j + OSKAR_DFTW_RUN_ANCHOR_D < len) ?
+                    j + OSKAR_DFTW_RUN_ANCHOR_D : len;
+
+            /* Calculate the phase exactly at the start of the segment. */
+            t = (wavenumber * x_out[j]) * x_in[i] +
+                    (wavenumber * y_out[j]) * y_in[i];
+            weight.x = cos(t);
+            weight.y = sin(t);
+
+            /* Multiply the supplied DFT weight by the computed phase. */
+            t = weight.x; /* Copy the real part. */
+            weight.x *= w.x;
+            weight.x -= w.y * weight.y;
+            weight.y *= w.x;
+            weight.y += w.y * t;
+
+            /* Advance the phase along the segment by complex multiplication. */
+            for (k = j; k < end; ++k)
             {
-                double4c in;
-                in = data[i * n_out + i_out];
-                out.a.x += in.a.x * weight.x;
-                out.a.x -= in.a.y * weight.y;
-                out.a.y += in.a.y * weight.x;
-                out.a.y += in.a.x * weight.y;
-                out.b.x += in.b.x * weight.x;
-                out.b.x -= in.b.y * weight.y;
-                out.b.y += in.b.y * weight.x;
-                out.b.y += in.b.x * weight.y;
-                out.c.x += in.c.x * weight.x;
-                out.c.x -= in.c.y * weight.y;
-                out.c.y += in.c.y * weight.x;
-                out.c.y += in.c.x * weight.y;
-                out.d.x += in.d.x * weight.x;
-                out.d.x -= in.d.y * weight.y;
-                out.d.y += in.d.y * weight.x;
-                out.d.y += in.d.x * weight.y;
+                const double4c in = data[i * n_out + k];
+                out[k].a.x += weight.x * in.a.x;
+                out[k].a.x -= weight.y * in.a.y;
+                out[k].a.y += weight.y * in.a.x;
+                out[k].a.y += weight.x * in.a.y;
+                out[k].b.x += weight.x * in.b.x;
+                out[k].b.x -= weight.y * in.b.y;
+                out[k].b.y += weight.y * in.b.x;
+                out[k].b.y += weight.x * in.b.y;
+                out[k].c.x += weight.x * in.c.x;
+                out[k].c.x -= weight.y * in.c.y;
+                out[k].c.y += weight.y * in.c.x;
+                out[k].c.y += weight.x * in.c.y;
+                out[k].d.x += weight.x * in.d.x;
+                out[k].d.x -= weight.y * in.d.y;
+                out[k].d.y += weight.y * in.d.x;
+                out[k].d.y += weight.x * in.d.y;
+                t = weight.x;
+                weight.x = t * step.x - weight.y * step.y;
+                weight.y = t * step.y + weight.y * step.x;
             }
         }
+    }
+
+    /* Store the output points. */
+    for (k = 0; k < len; ++k) output[k] = out[k];
+}
+
+/* Single precision. */
+void oskar_dftw_m2m_2d_omp_f(const int n_in, const float wavenumber,
+        const float* x_in, const float* y_in, const float2* weights_in,
+        const int n_out, const float* x_out, const float* y_out,
+        const float4c* data, float4c* output)
+{
+    int b = 0;
+    const int block_size = oskar_dftw_block_size(n_out);
+    const int num_blocks = (n_out + block_size - 1) / block_size;
+
+    /* Loop over blocks of output points. */
+    #pragma omp parallel for private(b) schedule(dynamic, 1)
+    for (b = 0; b < num_blocks; ++b)
+    {
+        int i_out, len, end;
+        i_out = b * block_size;
+        end = (i_out + block_size < n_out) ? i_out + block_size : n_out;
+        for (; i_out < end; i_out += len)
+        {
+            /* Use the phase recurrence for regularly-spaced points. */
+            len = oskar_dftw_run_length_f(x_out, y_out, i_out, end);
+            if (len > 1)
+                dftw_run_f(n_in, wavenumber, x_in, y_in, weights_in, len,
+                        x_out + i_out, y_out + i_out,
+                        data + i_out, n_out,
+                        output + i_out);
+            else
+                dftw_point_f(n_in, wavenumber, x_in, y_in, weights_in,
+                        x_out[i_out], y_out[i_out], data + i_out,
+                        n_out,
+                        output + i_out);
+        }
+    }
+}
 
-        /* Store the output point. */
-        output[i_out] = out;
+/* Double precision. */
+void oskar_dftw_m2m_2d_omp_d(const int n_in, const double wavenumber,
+        const double* x_in, const double* y_in, const double2* weights_in,
+        const int n_out, const double* x_out, const double* y_out,
+        const double4c* data, double4c* output)
+{
+    int b = 0;
+    const int block_size = oskar_dftw_block_size(n_out);
+    const int num_blocks = (n_out + block_size - 1) / block_size;
+
+    /* Loop over blocks of output points. */
+    #pragma omp parallel for private(b) schedule(dynamic, 1)
+    for (b = 0; b < num_blocks; ++b)
+    {
+        int i_out, len, end;
+        i_out = b * block_size;
+        end = (i_out + block_size < n_out) ? i_out + block_size : n_out;
+        for (; i_out < end; i_out += len)
+        {
+            /* Use the phase recurrence for regularly-spaced points. */
+            len = oskar_dftw_run_length_d(x_out, y_out, i_out, end);
+            if (len > 1)
+                dftw_run_d(n_in, wavenumber, x_in, y_in, weights_in, len,
+                        x_out + i_out, y_out + i_out,
+                        data + i_out, n_out,
+                        output + i_out);
+            else
+                dftw_point_d(n_in, wavenumber, x_in, y_in, weights_in,
+                        x_out[i_out], y_out[i_out], data + i_out,
+                        n_out,
+                        output + i_out);
+        }
     }
 }
 
@@ -0,0 +1,295 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef OSKAR_HAVE_CUDA
+#include <cufft.h>
+#endif
+
+#include "math/oskar_fft.h"
+#include "math/oskar_fftpack_cfft.h"
+#include "math/oskar_fftpack_cfft_f.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Number of columns transformed together, to use whole cache lines. */
+#define BLOCK_COLS 16
+
+/* Upper limit on the number of grid cells in a block of rows. */
+#define BLOCK_ROW_CELLS 16384
+
+struct oskar_FFT
+{
+    int precision, location, grid_size, num_threads, block_rows;
+    oskar_Mem *fftpack_wsave, *fftpack_work;
+#ifdef OSKAR_HAVE_CUDA
+    cufftHandle cufft_plan;
+#endif
+};
+
+static void fftpack_2d_d(oskar_FFT* h, double* grid);
+static void fftpack_2d_f(oskar_FFT* h, float* grid);
+#ifdef OSKAR_HAVE_CUDA
+static void check_cufft(cufftResult result, int* status);
+#endif
+
+
+oskar_FFT* oskar_fft_create(int precision, int location, int grid_size,
+        int* status)
+{
+    oskar_FFT* h = 0;
+    if (*status) return 0;
+    if (precision != OSKAR_SINGLE && precision != OSKAR_DOUBLE)
+    {
+        *status = OSKAR_ERR_BAD_DATA_TYPE;
+        return 0;
+    }
+    h = (oskar_FFT*) calloc(1, sizeof(oskar_FFT));
+    if (!h)
+    {
+        *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+        return 0;
+    }
+    h->precision = precision;
+    h->location = location;
+    h->grid_size = grid_size;
+    if (location == OSKAR_GPU)
+    {
+#ifdef OSKAR_HAVE_CUDA
+        check_cufft(cufftPlan2d(&h->cufft_plan, grid_size, grid_size,
+                precision == OSKAR_DOUBLE ? CUFFT_Z2Z : CUFFT_C2C), status);
+#else
+        *status = OSKAR_ERR_CUDA_NOT_AVAILABLE;
+#endif
+    }
+    else if (location == OSKAR_CPU)
+    {
+        /* The same factorisation is used for rows and columns.
+         * Each thread needs its own work array. */
+        int len_save = 2 * grid_size +
+                (int)(log((double)grid_size) / log(2.0)) + 4;
+        h->num_threads = 1;
+#ifdef _OPENMP
+        h->num_threads = omp_get_max_threads();
+#endif
+        h->block_rows = BLOCK_ROW_CELLS / grid_size;
+        if (h->block_rows < 1) h->block_rows = 1;
+        if (h->block_rows > BLOCK_COLS) h->block_rows = BLOCK_COLS;
+        h->fftpack_wsave = oskar_mem_create(precision, OSKAR_CPU,
+                len_save, status);
+        h->fftpack_work = oskar_mem_create(precision, OSKAR_CPU,
+                2 * BLOCK_COLS * grid_size * h->num_threads, status);
+        if (*status) return h;
+        if (precision == OSKAR_DOUBLE)
+            oskar_fftpack_cfftmi(grid_size,
+                    oskar_mem_double(h->fftpack_wsave, status));
+        else
+            oskar_fftpack_cfftmi_f(grid_size,
+                    oskar_mem_float(h->fftpack_wsave, status));
+    }
+    else
+        *status = OSKAR_ERR_BAD_LOCATION;
+    return h;
+}
+
+
+void oskar_fft_exec(oskar_FFT* h, oskar_Mem* grid, int* status)
+{
+    oskar_Mem *grid_copy = 0, *grid_ptr = grid;
+    if (*status) return;
+    if (oskar_mem_precision(grid) != h->precision ||
+            !oskar_mem_is_complex(grid))
+    {
+        *status = OSKAR_ERR_TYPE_MISMATCH;
+        return;
+    }
+    if (oskar_mem_length(grid) < (size_t)h->grid_size * h->grid_size)
+    {
+        *status = OSKAR_ERR_DIMENSION_MISMATCH;
+        return;
+    }
+    if (oskar_mem_location(grid) != h->location)
+    {
+        grid_copy = oskar_mem_create_copy(grid, h->location, status);
+        grid_ptr = grid_copy;
+    }
+    if (h->location == OSKAR_GPU && !*status)
+    {
+#ifdef OSKAR_HAVE_CUDA
+        if (h->precision == OSKAR_DOUBLE)
+            check_cufft(cufftExecZ2Z(h->cufft_plan, oskar_mem_void(grid_ptr),
+                    oskar_mem_void(grid_ptr), CUFFT_FORWARD), status);
+        else
+            check_cufft(cufftExecC2C(h->cufft_plan, oskar_mem_void(grid_ptr),
+                    oskar_mem_void(grid_ptr), CUFFT_FORWARD), status);
+#endif
+    }
+    else if (h->location == OSKAR_CPU && !*status)
+    {
+        if (h->precision == OSKAR_DOUBLE)
+            fftpack_2d_d(h, oskar_mem_double(grid_ptr, status));
+        else
+            fftpack_2d_f(h, oskar_mem_float(grid_ptr, status));
+    }
+    if (grid_copy)
+        oskar_mem_copy(grid, grid_copy, status);
+    oskar_mem_free(grid_copy, status);
+}
+
+
+void oskar_fft_free(oskar_FFT* h)
+{
+    int status = 0;
+    if (!h) return;
+    oskar_mem_free(h->fftpack_wsave, &status);
+    oskar_mem_free(h->fftpack_work, &status);
+#ifdef OSKAR_HAVE_CUDA
+    if (h->location == OSKAR_GPU)
+        cufftDestroy(h->cufft_plan);
+#endif
+    free(h);
+}
+
+
+int oskar_fft_grid_size(const oskar_FFT* h)
+{
+    return h->grid_size;
+}
+
+
+/* Columns are transformed first, then rows, each in blocks shared between
+ * threads. FFTPACK normalises each forward transform by its length,
+ * so the rows are scaled by the number of grid cells to remove it. */
+static void fftpack_2d_d(oskar_FFT* h, double* grid)
+{
+    int i, status = 0;
+    const int n = h->grid_size, block_rows = h->block_rows;
+    const double scale = (double)n * (double)n;
+    double *wsave, *work;
+    wsave = oskar_mem_double(h->fftpack_wsave, &status);
+    work = oskar_mem_double(h->fftpack_work, &status);
+#pragma omp parallel num_threads(h->num_threads) private(i)
+    {
+        int thread_id = 0;
+        double* t_work;
+#ifdef _OPENMP
+        thread_id = omp_get_thread_num();
+#endif
+        t_work = work + (size_t)thread_id * 2 * BLOCK_COLS * n;
+#pragma omp for schedule(dynamic)
+        for (i = 0; i < n; i += BLOCK_COLS)
+        {
+            const int lot = (n - i < BLOCK_COLS) ? n - i : BLOCK_COLS;
+            oskar_fftpack_cfftmf(lot, 1, n, n, grid + 2 * (size_t)i,
+                    wsave, t_work);
+        }
+#pragma omp for schedule(dynamic)
+        for (i = 0; i < n; i += block_rows)
+        {
+            size_t j, num;
+            const int lot = (n - i < block_rows) ? n - i : block_rows;
+            double* rows = grid + 2 * (size_t)i * n;
+            oskar_fftpack_cfftmf(lot, n, n, 1, rows, wsave, t_work);
+            num = 2 * (size_t)lot * n;
+            for (j = 0; j < num; ++j) rows[j] *= scale;
+        }
+    }
+}
+
+
+static void fftpack_2d_f(oskar_FFT* h, float* grid)
+{
+    int i, status = 0;
+    const int n = h->grid_size, block_rows = h->block_rows;
+    const float scale = (float) ((double)n * (double)n);
+    float *wsave, *work;
+    wsave = oskar_mem_float(h->fftpack_wsave, &status);
+    work = oskar_mem_float(h->fftpack_work, &status);
+#pragma omp parallel num_threads(h->num_threads) private(i)
+    {
+        int thread_id = 0;
+        float* t_work;
+#ifdef _OPENMP
+        thread_id = omp_get_thread_num();
+#endif
+        t_work = work + (size_t)thread_id * 2 * BLOCK_COLS * n;
+#pragma omp for schedule(dynamic)
+        for (i = 0; i < n; i += BLOCK_COLS)
+        {
+            const int lot = (n - i < BLOCK_COLS) ? n - i : BLOCK_COLS;
+            oskar_fftpack_cfftmf_f(lot, 1, n, n, grid + 2 * (size_t)i,
+                    wsave, t_work);
+        }
+#pragma omp for schedule(dynamic)
+        for (i = 0; i < n; i += block_rows)
+        {
+            size_t j, num;
+            const int lot = (n - i < block_rows) ? n - i : block_rows;
+            float* rows = grid + 2 * (size_t)i * n;
+            oskar_fftpack_cfftmf_f(lot, n, n, 1, rows, wsave, t_work);
+            num = 2 * (size_t)lot * n;
+            for (j = 0; j < num; ++j) rows[j] *= scale;
+        }
+    }
+}
+
+
+#ifdef OSKAR_HAVE_CUDA
+/* Converts a cuFFT return code to an OSKAR error code. */
+static void check_cufft(cufftResult result, int* status)
+{
+    if (result == CUFFT_SUCCESS || *status) return;
+    switch (result)
+    {
+    case CUFFT_ALLOC_FAILED:
+        *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+        break;
+    case CUFFT_INVALID_PLAN:
+    case CUFFT_INVALID_TYPE:
+    case CUFFT_INVALID_VALUE:
+    case CUFFT_INVALID_SIZE:
+        *status = OSKAR_ERR_INVALID_ARGUMENT;
+        break;
+    default:
+        *status = OSKAR_ERR_KERNEL_LAUNCH_FAILURE;
+        break;
+    }
+}
+#endif
+
+#ifdef __cplusplus
+}
+#endif
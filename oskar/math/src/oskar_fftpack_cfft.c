@@ -84,11 +84,6 @@
 
 #define min(a,b) ((a) < (b) ? (a) : (b))
 
-static void cfftmb(const int lot, const int jump, const int n, const int inc,
-        double *c, double *wsave, double *work);
-static void cfftmf(const int lot, const int jump, const int n, const int inc,
-        double *c, double *wsave, double *work);
-static void cfftmi(const int n, double *wsave);
 static void cmfm1b(const int lot, const int jump, const int n, const int inc,
         double *restrict c, double *restrict ch, const double *restrict wa,
         const double fnf, const double *restrict fac);
@@ -140,11 +135,11 @@ void oskar_fftpack_cfft2b(const int ldim, const int l, const int m,
         double *c, double *wsave, double *work)
 {
     /* Transform X lines of C array */
-    cfftmb(l, 1, m, ldim, c,
+    oskar_fftpack_cfftmb(l, 1, m, ldim, c,
             &wsave[(l << 1) + (int) (log((double) l) / log(2.0)) + 2], work);
 
     /* Transform Y lines of C array */
-    cfftmb(m, ldim, l, 1, c, wsave, work);
+    oskar_fftpack_cfftmb(m, ldim, l, 1, c, wsave, work);
 }
 
 
@@ -152,23 +147,24 @@ void oskar_fftpack_cfft2f(const int ldim, const int l, const int m,
         double *c, double *wsave, double *work)
 {
     /* Transform X lines of C array */
-    cfftmf(l, 1, m, ldim, c,
+    oskar_fftpack_cfftmf(l, 1, m, ldim, c,
             &wsave[(l << 1) + (int) (log((double) l) / log(2.0)) + 2], work);
 
     /* Transform Y lines of C array */
-    cfftmf(m, ldim, l, 1, c, wsave, work);
+    oskar_fftpack_cfftmf(m, ldim, l, 1, c, wsave, work);
 }
 
 
 void oskar_fftpack_cfft2i(const int l, const int m, double *wsave)
 {
-    cfftmi(l, wsave);
-    cfftmi(m, &wsave[(l << 1) + (int) (log((double) l) / log(2.0)) + 2]);
+    oskar_fftpack_cfftmi(l, wsave);
+    oskar_fftpack_cfftmi(m,
+            &wsave[(l << 1) + (int) (log((double) l) / log(2.0)) + 2]);
 }
 
 
-void cfftmb(const int lot, const int jump, const int n, const int inc,
-        double *c, double *wsave, double *work)
+void oskar_fftpack_cfftmb(const int lot, const int jump, const int n,
+        const int inc, double *c, double *wsave, double *work)
 {
     int iw1;
     if (n == 1) return;
@@ -177,8 +173,8 @@ void cfftmb(const int lot, const int jump, const int n, const int inc,
 }
 
 
-void cfftmf(const int lot, const int jump, const int n, const int inc,
-        double *c, double *wsave, double *work)
+void oskar_fftpack_cfftmf(const int lot, const int jump, const int n,
+        const int inc, double *c, double *wsave, double *work)
 {
     int iw1;
     if (n == 1) return;
@@ -187,7 +183,7 @@ void cfftmf(const int lot, const int jump, const int n, const int inc,
 }
 
 
-void cfftmi(const int n, double *wsave)
+void oskar_fftpack_cfftmi(const int n, double *wsave)
 {
     int iw1;
     if (n == 1) return;
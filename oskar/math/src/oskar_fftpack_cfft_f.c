@@ -84,11 +84,6 @@
 
 #define min(a,b) ((a) < (b) ? (a) : (b))
 
-static void cfftmb(const int lot, const int jump, const int n, const int inc,
-        float *c, float *wsave, float *work);
-static void cfftmf(const int lot, const int jump, const int n, const int inc,
-        float *c, float *wsave, float *work);
-static void cfftmi(const int n, float *wsave);
 static void cmfm1b(const int lot, const int jump, const int n, const int inc,
         float *restrict c, float *restrict ch, const float *restrict wa,
         const float fnf, const float *restrict fac);
@@ -140,11 +135,11 @@ void oskar_fftpack_cfft2b_f(const int ldim, const int l, const int m,
         float *c, float *wsave, float *work)
 {
     /* Transform X lines of C array */
-    cfftmb(l, 1, m, ldim, c,
+    oskar_fftpack_cfftmb_f(l, 1, m, ldim, c,
             &wsave[(l << 1) + (int) (log((float) l) / log(2.0)) + 2], work);
 
     /* Transform Y lines of C array */
-    cfftmb(m, ldim, l, 1, c, wsave, work);
+    oskar_fftpack_cfftmb_f(m, ldim, l, 1, c, wsave, work);
 }
 
 
@@ -152,23 +147,24 @@ void oskar_fftpack_cfft2f_f(const int ldim, const int l, const int m,
         float *c, float *wsave, float *work)
 {
     /* Transform X lines of C array */
-    cfftmf(l, 1, m, ldim, c,
+    oskar_fftpack_cfftmf_f(l, 1, m, ldim, c,
             &wsave[(l << 1) + (int) (log((float) l) / log(2.0)) + 2], work);
 
     /* Transform Y lines of C array */
-    cfftmf(m, ldim, l, 1, c, wsave, work);
+    oskar_fftpack_cfftmf_f(m, ldim, l, 1, c, wsave, work);
 }
 
 
 void oskar_fftpack_cfft2i_f(const int l, const int m, float *wsave)
 {
-    cfftmi(l, wsave);
-    cfftmi(m, &wsave[(l << 1) + (int) (log((float) l) / log(2.0)) + 2]);
+    oskar_fftpack_cfftmi_f(l, wsave);
+    oskar_fftpack_cfftmi_f(m,
+            &wsave[(l << 1) + (int) (log((float) l) / log(2.0)) + 2]);
 }
 
 
-void cfftmb(const int lot, const int jump, const int n, const int inc,
-        float *c, float *wsave, float *work)
+void oskar_fftpack_cfftmb_f(const int lot, const int jump, const int n,
+        const int inc, float *c, float *wsave, float *work)
 {
     int iw1;
     if (n == 1) return;
@@ -177,8 +173,8 @@ void cfftmb(const int lot, const int jump, const int n, const int inc,
 }
 
 
-void cfftmf(const int lot, const int jump, const int n, const int inc,
-        float *c, float *wsave, float *work)
+void oskar_fftpack_cfftmf_f(const int lot, const int jump, const int n,
+        const int inc, float *c, float *wsave, float *work)
 {
     int iw1;
     if (n == 1) return;
@@ -187,7 +183,7 @@ void cfftmf(const int lot, const int jump, const int n, const int inc,
 }
 
 
-void cfftmi(const int n, float *wsave)
+void oskar_fftpack_cfftmi_f(const int n, float *wsave)
 {
     int iw1;
     if (n == 1) return;
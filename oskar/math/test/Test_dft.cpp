@@ -29,11 +29,14 @@
 #include <gtest/gtest.h>
 
 #include "math/oskar_dft_c2r.h"
+#include "math/oskar_dftw.h"
+#include "math/oskar_dftw_indexed_input.h"
 #include "math/oskar_cmath.h"
 #include "math/oskar_evaluate_image_lmn_grid.h"
 #include "utility/oskar_get_error_string.h"
 #include "utility/oskar_cl_utils.h"
 
+#include <cmath>
 #include <cstdlib>
 #include <cstdio>
 
@@ -123,3 +126,229 @@ TEST(dft, c2r)
     oskar_mem_free(v, &status);
     oskar_mem_free(w, &status);
 }
+
+static double dftw_max_error(int precision, int num_in, double wavenumber,
+        const oskar_Mem* x_in, const oskar_Mem* y_in,
+        const oskar_Mem* weights_in, int num_out,
+        const oskar_Mem* x_out, const oskar_Mem* y_out,
+        const oskar_Mem* data, int* status)
+{
+    double max_err = 0.0, norm = 0.0;
+    oskar_Mem *xi, *yi, *wi, *xo, *yo, *d = 0, *out, *out_d;
+
+    /* Convert inputs to the required precision and run the DFT. */
+    xi = oskar_mem_convert_precision(x_in, precision, status);
+    yi = oskar_mem_convert_precision(y_in, precision, status);
+    wi = oskar_mem_convert_precision(weights_in, precision, status);
+    xo = oskar_mem_convert_precision(x_out, precision, status);
+    yo = oskar_mem_convert_precision(y_out, precision, status);
+    if (data) d = oskar_mem_convert_precision(data, precision, status);
+    out = oskar_mem_create(precision | OSKAR_COMPLEX, OSKAR_CPU,
+            num_out, status);
+    oskar_dftw(num_in, wavenumber, xi, yi, 0, wi, num_out,
+            xo, yo, 0, d, out, status);
+    out_d = oskar_mem_convert_precision(out, OSKAR_DOUBLE, status);
+    if (*status) return 0.0;
+
+    /* Compare against a direct evaluation in double precision. */
+    const double* xi_ = oskar_mem_double_const(x_in, status);
+    const double* yi_ = oskar_mem_double_const(y_in, status);
+    const double2* wi_ = oskar_mem_double2_const(weights_in, status);
+    const double* xo_ = oskar_mem_double_const(x_out, status);
+    const double* yo_ = oskar_mem_double_const(y_out, status);
+    const double2* d_ = data ? oskar_mem_double2_const(data, status) : 0;
+    const double2* out_ = oskar_mem_double2_const(out_d, status);
+    for (int i = 0; i < num_in; ++i)
+        norm += sqrt(wi_[i].x * wi_[i].x + wi_[i].y * wi_[i].y);
+    for (int j = 0; j < num_out; ++j)
+    {
+        double re = 0.0, im = 0.0;
+        for (int i = 0; i < num_in; ++i)
+        {
+            double t = wavenumber * (xo_[j] * xi_[i] + yo_[j] * yi_[i]);
+            double c = cos(t), s = sin(t);
+            double w_re = c * wi_[i].x - s * wi_[i].y;
+            double w_im = c * wi_[i].y + s * wi_[i].x;
+            if (d_)
+            {
+                const double2 v = d_[i * num_out + j];
+                re += w_re * v.x - w_im * v.y;
+                im += w_re * v.y + w_im * v.x;
+            }
+            else
+            {
+                re += w_re;
+                im += w_im;
+            }
+        }
+        double err = sqrt(pow(out_[j].x - re, 2.0) +
+                pow(out_[j].y - im, 2.0));
+        if (err > max_err) max_err = err;
+    }
+    oskar_mem_free(xi, status);
+    oskar_mem_free(yi, status);
+    oskar_mem_free(wi, status);
+    oskar_mem_free(xo, status);
+    oskar_mem_free(yo, status);
+    oskar_mem_free(d, status);
+    oskar_mem_free(out, status);
+    oskar_mem_free(out_d, status);
+    return max_err / norm;
+}
+
+TEST(dft, dftw_2d_accuracy)
+{
+    int status = 0, side = 96, num_in = 256;
+    int num_out = side * side;
+    double wavenumber = 2 * M_PI * 100e6 / 299792458.;
+    double fov = 170.0 * M_PI / 180.0;
+    oskar_Mem *x_in = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU,
+            num_in, &status);
+    oskar_Mem *y_in = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU,
+            num_in, &status);
+    oskar_Mem *weights = oskar_mem_create(OSKAR_DOUBLE_COMPLEX, OSKAR_CPU,
+            num_in, &status);
+    oskar_Mem *data = oskar_mem_create(OSKAR_DOUBLE_COMPLEX, OSKAR_CPU,
+            num_in * num_out, &status);
+    oskar_Mem *l = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU,
+            num_out, &status);
+    oskar_Mem *m = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU,
+            num_out, &status);
+    oskar_Mem *n = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU,
+            num_out, &status);
+    oskar_Mem *l_p = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU,
+            num_out, &status);
+    oskar_Mem *m_p = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU,
+            num_out, &status);
+
+    /* Generate a station and a regular grid of output directions. */
+    oskar_mem_random_range(x_in, -20.0, 20.0, &status);
+    oskar_mem_random_range(y_in, -20.0, 20.0, &status);
+    oskar_mem_random_range(weights, -1.0, 1.0, &status);
+    oskar_mem_random_range(data, -1.0, 1.0, &status);
+    oskar_evaluate_image_lmn_grid(side, side, fov, fov, 0, l, m, n, &status);
+
+    /* Generate an irregular set of output directions. */
+    oskar_mem_random_range(l_p, -1e-4, 1e-4, &status);
+    oskar_mem_random_range(m_p, -1e-4, 1e-4, &status);
+    oskar_mem_add(l_p, l_p, l, num_out, &status);
+    oskar_mem_add(m_p, m_p, m, num_out, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    /* Check errors for both regular and irregular directions. */
+    for (int j = 0; j < 2; ++j)
+    {
+        const oskar_Mem* d = j ? data : 0;
+        double err_reg_f = dftw_max_error(OSKAR_SINGLE, num_in, wavenumber,
+                x_in, y_in, weights, num_out, l, m, d, &status);
+        double err_irr_f = dftw_max_error(OSKAR_SINGLE, num_in, wavenumber,
+                x_in, y_in, weights, num_out, l_p, m_p, d, &status);
+        double err_reg_d = dftw_max_error(OSKAR_DOUBLE, num_in, wavenumber,
+                x_in, y_in, weights, num_out, l, m, d, &status);
+        double err_irr_d = dftw_max_error(OSKAR_DOUBLE, num_in, wavenumber,
+                x_in, y_in, weights, num_out, l_p, m_p, d, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+        EXPECT_LT(err_reg_f, 5e-6);
+        EXPECT_LT(err_irr_f, 5e-6);
+        EXPECT_LT(err_reg_d, 1e-13);
+        EXPECT_LT(err_irr_d, 1e-13);
+    }
+
+    oskar_mem_free(x_in, &status);
+    oskar_mem_free(y_in, &status);
+    oskar_mem_free(weights, &status);
+    oskar_mem_free(data, &status);
+    oskar_mem_free(l, &status);
+    oskar_mem_free(m, &status);
+    oskar_mem_free(n, &status);
+    oskar_mem_free(l_p, &status);
+    oskar_mem_free(m_p, &status);
+}
+
+static double dftw_indexed_input_max_diff(int type, int num_in,
+        int num_types, int num_out, int* status)
+{
+    double wavenumber = 2 * M_PI * 100e6 / 299792458., max_diff = 0.0;
+    oskar_Mem *x_in, *y_in, *z_in, *weights, *index, *data, *data_full;
+    oskar_Mem *x_out, *y_out, *z_out, *out, *out_indexed;
+    x_in = oskar_mem_create(type & 0x0F, OSKAR_CPU, num_in, status);
+    y_in = oskar_mem_create(type & 0x0F, OSKAR_CPU, num_in, status);
+    z_in = oskar_mem_create(type & 0x0F, OSKAR_CPU, num_in, status);
+    x_out = oskar_mem_create(type & 0x0F, OSKAR_CPU, num_out, status);
+    y_out = oskar_mem_create(type & 0x0F, OSKAR_CPU, num_out, status);
+    z_out = oskar_mem_create(type & 0x0F, OSKAR_CPU, num_out, status);
+    weights = oskar_mem_create((type & 0x0F) | OSKAR_COMPLEX, OSKAR_CPU,
+            num_in, status);
+    index = oskar_mem_create(OSKAR_INT, OSKAR_CPU, num_in, status);
+    data = oskar_mem_create(type, OSKAR_CPU, num_types * num_out, status);
+    data_full = oskar_mem_create(type, OSKAR_CPU, num_in * num_out, status);
+    out = oskar_mem_create(type, OSKAR_CPU, num_out, status);
+    out_indexed = oskar_mem_create(type, OSKAR_CPU, num_out, status);
+    oskar_mem_random_range(x_in, -20.0, 20.0, status);
+    oskar_mem_random_range(y_in, -20.0, 20.0, status);
+    oskar_mem_random_range(z_in, -1.0, 1.0, status);
+    oskar_mem_random_range(x_out, -0.5, 0.5, status);
+    oskar_mem_random_range(y_out, -0.5, 0.5, status);
+    oskar_mem_random_range(z_out, 0.5, 1.0, status);
+    oskar_mem_random_range(weights, -1.0, 1.0, status);
+    oskar_mem_random_range(data, -1.0, 1.0, status);
+    if (*status) return 0.0;
+
+    /* Expand the indexed input data into a full data block. */
+    int* idx = oskar_mem_int(index, status);
+    for (int i = 0; i < num_in; ++i)
+    {
+        idx[i] = (7 * i + i / 5) % num_types;
+        oskar_mem_copy_contents(data_full, data, i * num_out,
+                idx[i] * num_out, num_out, status);
+    }
+
+    /* Run both DFTs and compare the results. */
+    oskar_dftw(num_in, wavenumber, x_in, y_in, z_in, weights, num_out,
+            x_out, y_out, z_out, data_full, out, status);
+    oskar_dftw_indexed_input(num_in, wavenumber, x_in, y_in, z_in, weights,
+            index, num_out, x_out, y_out, z_out, data, out_indexed, status);
+    int num_values = num_out * oskar_mem_element_size(type) /
+            oskar_mem_element_size(type & 0x0F);
+    for (int i = 0; i < num_values && !*status; ++i)
+    {
+        double diff;
+        if ((type & 0x0F) == OSKAR_DOUBLE)
+            diff = fabs(oskar_mem_double(out, status)[i] -
+                    oskar_mem_double(out_indexed, status)[i]);
+        else
+            diff = fabs(oskar_mem_float(out, status)[i] -
+                    oskar_mem_float(out_indexed, status)[i]);
+        if (diff > max_diff) max_diff = diff;
+    }
+
+    oskar_mem_free(x_in, status);
+    oskar_mem_free(y_in, status);
+    oskar_mem_free(z_in, status);
+    oskar_mem_free(x_out, status);
+    oskar_mem_free(y_out, status);
+    oskar_mem_free(z_out, status);
+    oskar_mem_free(weights, status);
+    oskar_mem_free(index, status);
+    oskar_mem_free(data, status);
+    oskar_mem_free(data_full, status);
+    oskar_mem_free(out, status);
+    oskar_mem_free(out_indexed, status);
+    return max_diff;
+}
+
+TEST(dft, dftw_indexed_input)
+{
+    int status = 0;
+    const int types[] = {
+            OSKAR_SINGLE_COMPLEX, OSKAR_DOUBLE_COMPLEX,
+            OSKAR_SINGLE_COMPLEX_MATRIX, OSKAR_DOUBLE_COMPLEX_MATRIX
+    };
+    for (int i = 0; i < 4; ++i)
+    {
+        double max_diff = dftw_indexed_input_max_diff(types[i],
+                200, 3, 1000, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+        EXPECT_LT(max_diff, (types[i] & OSKAR_DOUBLE) ? 1e-12 : 1e-4);
+    }
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "math/oskar_fft.h"
+#include "math/oskar_fftpack_cfft.h"
+#include "math/oskar_fftpack_cfft_f.h"
+
+#include <cmath>
+
+static void compare_with_fftpack(int prec, int size, double tol)
+{
+    int status = 0;
+    size_t num_cells = size * size;
+    oskar_Mem* grid = oskar_mem_create(prec | OSKAR_COMPLEX, OSKAR_CPU,
+            num_cells, &status);
+    oskar_mem_random_gaussian(grid, 1, 2, 3, 4, 1.0, &status);
+    oskar_Mem* grid_cmp = oskar_mem_create_copy(grid, OSKAR_CPU, &status);
+
+    // Transform using the FFT plan.
+    oskar_FFT* fft = oskar_fft_create(prec, OSKAR_CPU, size, &status);
+    ASSERT_EQ(0, status);
+    EXPECT_EQ(size, oskar_fft_grid_size(fft));
+    oskar_fft_exec(fft, grid, &status);
+    ASSERT_EQ(0, status);
+    oskar_fft_free(fft);
+
+    // Transform using the serial FFTPACK function, and remove its scaling.
+    int len_save = 4 * size + 2 * (int)(log((double)size) / log(2.0)) + 8;
+    oskar_Mem* wsave = oskar_mem_create(prec, OSKAR_CPU, len_save, &status);
+    oskar_Mem* work = oskar_mem_create(prec, OSKAR_CPU, 2 * num_cells,
+            &status);
+    if (prec == OSKAR_DOUBLE)
+    {
+        oskar_fftpack_cfft2i(size, size, oskar_mem_double(wsave, &status));
+        oskar_fftpack_cfft2f(size, size, size,
+                oskar_mem_double(grid_cmp, &status),
+                oskar_mem_double(wsave, &status),
+                oskar_mem_double(work, &status));
+    }
+    else
+    {
+        oskar_fftpack_cfft2i_f(size, size, oskar_mem_float(wsave, &status));
+        oskar_fftpack_cfft2f_f(size, size, size,
+                oskar_mem_float(grid_cmp, &status),
+                oskar_mem_float(wsave, &status),
+                oskar_mem_float(work, &status));
+    }
+    oskar_mem_scale_real(grid_cmp, (double)num_cells, &status);
+
+    // Check results are the same.
+    double max_err = 0.0, avg_err = 0.0;
+    oskar_mem_evaluate_relative_error(grid, grid_cmp, 0, &max_err,
+            &avg_err, 0, &status);
+    ASSERT_EQ(0, status);
+    EXPECT_LT(max_err, tol);
+    EXPECT_LT(avg_err, tol);
+
+    oskar_mem_free(grid, &status);
+    oskar_mem_free(grid_cmp, &status);
+    oskar_mem_free(wsave, &status);
+    oskar_mem_free(work, &status);
+}
+
+TEST(fft, fftpack_double)
+{
+    compare_with_fftpack(OSKAR_DOUBLE, 256, 1e-10);
+    compare_with_fftpack(OSKAR_DOUBLE, 90, 1e-10);
+}
+
+TEST(fft, fftpack_single)
+{
+    compare_with_fftpack(OSKAR_SINGLE, 256, 1e-3);
+    compare_with_fftpack(OSKAR_SINGLE, 90, 1e-3);
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OSKAR_DIERCKX_BISPEV_BICUBIC_OMP_H_
+#define OSKAR_DIERCKX_BISPEV_BICUBIC_OMP_H_
+
+/**
+ * @file oskar_dierckx_bispev_bicubic_omp.h
+ */
+
+#include <oskar_global.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief
+ * Function to evaluate a bicubic B-spline surface using OpenMP
+ * (single precision).
+ *
+ * @details
+ * This function evaluates a bicubic B-spline surface at the specified
+ * points.
+ *
+ * Points are processed in blocks. The knot intervals and basis functions
+ * for all points in a block are found first, and are then used to sum the
+ * coefficients. The results match those from oskar_dierckx_bispev_f().
+ *
+ * The value at point \p i is written to \p z[i * stride].
+ *
+ * @param[in] tx     Array of knot positions in x.
+ * @param[in] nx     Number of knot positions in x.
+ * @param[in] ty     Array of knot positions in y.
+ * @param[in] ny     Number of knot positions in y.
+ * @param[in] c      Array of spline coefficients.
+ * @param[in] n      Number of points to evaluate.
+ * @param[in] x      Input x positions.
+ * @param[in] y      Input y positions.
+ * @param[in] stride Memory stride of output values.
+ * @param[out] z     Output surface values.
+ */
+OSKAR_EXPORT
+void oskar_dierckx_bispev_bicubic_omp_f(const float* tx, int nx,
+        const float* ty, int ny, const float* c, int n, const float* x,
+        const float* y, int stride, float* z);
+
+/**
+ * @brief
+ * Function to evaluate a bicubic B-spline surface using OpenMP
+ * (double precision).
+ *
+ * @details
+ * This function evaluates a bicubic B-spline surface at the specified
+ * points.
+ *
+ * Points are processed in blocks. The knot intervals and basis functions
+ * for all points in a block are found first, and are then used to sum the
+ * coefficients. The results match those from oskar_dierckx_bispev_d().
+ *
+ * The value at point \p i is written to \p z[i * stride].
+ *
+ * @param[in] tx     Array of knot positions in x.
+ * @param[in] nx     Number of knot positions in x.
+ * @param[in] ty     Array of knot positions in y.
+ * @param[in] ny     Number of knot positions in y.
+ * @param[in] c      Array of spline coefficients.
+ * @param[in] n      Number of points to evaluate.
+ * @param[in] x      Input x positions.
+ * @param[in] y      Input y positions.
+ * @param[in] stride Memory stride of output values.
+ * @param[out] z     Output surface values.
+ */
+OSKAR_EXPORT
+void oskar_dierckx_bispev_bicubic_omp_d(const double* tx, int nx,
+        const double* ty, int ny, const double* c, int n, const double* x,
+        const double* y, int stride, double* z);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OSKAR_DIERCKX_BISPEV_BICUBIC_OMP_H_ */
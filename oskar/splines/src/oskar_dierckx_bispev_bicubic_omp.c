@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "splines/oskar_dierckx_bispev_bicubic_omp.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Number of points handled together when evaluating the surface. */
+#define BLOCK_SIZE 64
+
+/*
+ * Returns the knot interval l such that t[l] <= x < t[l + 1], with
+ * 4 <= l <= nk1. This gives the same result as the linear search in fpbisp,
+ * since the knots are non-decreasing.
+ */
+static int find_interval_f(const float* t, const int nk1, const float x)
+{
+    int lo = 4, hi = nk1;
+    while (lo < hi)
+    {
+        const int mid = (lo + hi) / 2;
+        if (x < t[mid]) hi = mid; else lo = mid + 1;
+    }
+    return lo;
+}
+
+static int find_interval_d(const double* t, const int nk1, const double x)
+{
+    int lo = 4, hi = nk1;
+    while (lo < hi)
+    {
+        const int mid = (lo + hi) / 2;
+        if (x < t[mid]) hi = mid; else lo = mid + 1;
+    }
+    return lo;
+}
+
+/*
+ * Evaluates the four non-zero cubic B-splines at x, using the stable
+ * recurrence relation of de Boor and Cox (as fpbspl).
+ */
+static void fpbspl_bicubic_f(const float* t, const float x, const int l,
+        float* h)
+{
+    float f, hh[3];
+    int i, j, li, lj;
+
+    h[0] = 1.0f;
+    for (j = 1; j <= 3; ++j)
+    {
+        for (i = 0; i < j; ++i)
+        {
+            hh[i] = h[i];
+        }
+        h[0] = 0.0f;
+        for (i = 0; i < j; ++i)
+        {
+            li = l + i;
+            lj = li - j;
+            f = hh[i] / (t[li] - t[lj]);
+            h[i] += f * (t[li] - x);
+            h[i + 1] = f * (x - t[lj]);
+        }
+    }
+}
+
+static void fpbspl_bicubic_d(const double* t, const double x, const int l,
+        double* h)
+{
+    double f, hh[3];
+    int i, j, li, lj;
+
+    h[0] = 1.0;
+    for (j = 1; j <= 3; ++j)
+    {
+        for (i = 0; i < j; ++i)
+        {
+            hh[i] = h[i];
+        }
+        h[0] = 0.0;
+        for (i = 0; i < j; ++i)
+        {
+            li = l + i;
+            lj = li - j;
+            f = hh[i] / (t[li] - t[lj]);
+            h[i] += f * (t[li] - x);
+            h[i + 1] = f * (x - t[lj]);
+        }
+    }
+}
+
+/* Single precision. */
+void oskar_dierckx_bispev_bicubic_omp_f(const float* tx, int nx,
+        const float* ty, int ny, const float* c, int n, const float* x,
+        const float* y, int stride, float* z)
+{
+    int b;
+    const int nkx1 = nx - 4, nky1 = ny - 4;
+    const int num_blocks = (n + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+#pragma omp parallel for schedule(static)
+    for (b = 0; b < num_blocks; ++b)
+    {
+        int i, j, k, l1[BLOCK_SIZE];
+        float wx[4][BLOCK_SIZE], wy[4][BLOCK_SIZE];
+        const int start = b * BLOCK_SIZE;
+        const int num = (n - start < BLOCK_SIZE) ? n - start : BLOCK_SIZE;
+
+        /* Find the knot intervals and basis functions for each point. */
+        for (i = 0; i < num; ++i)
+        {
+            int lx, ly;
+            float h[4], xi = x[start + i], yi = y[start + i];
+            if (xi < tx[3]) xi = tx[3];
+            if (xi > tx[nkx1]) xi = tx[nkx1];
+            if (yi < ty[3]) yi = ty[3];
+            if (yi > ty[nky1]) yi = ty[nky1];
+            lx = find_interval_f(tx, nkx1, xi);
+            fpbspl_bicubic_f(tx, xi, lx, h);
+            for (k = 0; k < 4; ++k) wx[k][i] = h[k];
+            ly = find_interval_f(ty, nky1, yi);
+            fpbspl_bicubic_f(ty, yi, ly, h);
+            for (k = 0; k < 4; ++k) wy[k][i] = h[k];
+            l1[i] = (lx - 4) * nky1 + (ly - 4);
+        }
+
+        /* Evaluate the surface at all points in the block. */
+        for (i = 0; i < num; ++i)
+        {
+            float t = 0.0f;
+            int l2 = l1[i];
+            for (k = 0; k < 4; ++k)
+            {
+                for (j = 0; j < 4; ++j)
+                    t += c[l2 + j] * wx[k][i] * wy[j][i];
+                l2 += nky1;
+            }
+            z[(start + i) * stride] = t;
+        }
+    }
+}
+
+/* Double precision. */
+void oskar_dierckx_bispev_bicubic_omp_d(const double* tx, int nx,
+        const double* ty, int ny, const double* c, int n, const double* x,
+        const double* y, int stride, double* z)
+{
+    int b;
+    const int nkx1 = nx - 4, nky1 = ny - 4;
+    const int num_blocks = (n + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+#pragma omp parallel for schedule(static)
+    for (b = 0; b < num_blocks; ++b)
+    {
+        int i, j, k, l1[BLOCK_SIZE];
+        double wx[4][BLOCK_SIZE], wy[4][BLOCK_SIZE];
+        const int start = b * BLOCK_SIZE;
+        const int num = (n - start < BLOCK_SIZE) ? n - start : BLOCK_SIZE;
+
+        /* Find the knot intervals and basis functions for each point. */
+        for (i = 0; i < num; ++i)
+        {
+            int lx, ly;
+            double h[4], xi = x[start + i], yi = y[start + i];
+            if (xi < tx[3]) xi = tx[3];
+            if (xi > tx[nkx1]) xi = tx[nkx1];
+            if (yi < ty[3]) yi = ty[3];
+            if (yi > ty[nky1]) yi = ty[nky1];
+            lx = find_interval_d(tx, nkx1, xi);
+            fpbspl_bicubic_d(tx, xi, lx, h);
+            for (k = 0; k < 4; ++k) wx[k][i] = h[k];
+            ly = find_interval_d(ty, nky1, yi);
+            fpbspl_bicubic_d(ty, yi, ly, h);
+            for (k = 0; k < 4; ++k) wy[k][i] = h[k];
+            l1[i] = (lx - 4) * nky1 + (ly - 4);
+        }
+
+        /* Evaluate the surface at all points in the block. */
+        for (i = 0; i < num; ++i)
+        {
+            double t = 0.0;
+            int l2 = l1[i];
+            for (k = 0; k < 4; ++k)
+            {
+                for (j = 0; j < 4; ++j)
+                    t += c[l2 + j] * wx[k][i] * wy[j][i];
+                l2 += nky1;
+            }
+            z[(start + i) * stride] = t;
+        }
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -26,8 +26,8 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
-#include "splines/oskar_dierckx_bispev.h"
 #include "splines/oskar_dierckx_bispev_bicubic_cuda.h"
+#include "splines/oskar_dierckx_bispev_bicubic_omp.h"
 #include "splines/oskar_splines.h"
 #include "utility/oskar_device_utils.h"
 
@@ -94,24 +94,8 @@ void oskar_splines_evaluate(oskar_Mem* output, int offset, int stride,
             }
             else
             {
-                /* Set up workspace. */
-                float x1, y1, wrk[8];
-                int iwrk1[2], kwrk1 = 2, lwrk = 8, err = 0;
-
-                /* Evaluate surface at the points. */
-                for (i = 0; i < num_points; ++i)
-                {
-                    x1 = x_[i];
-                    y1 = y_[i];
-                    oskar_dierckx_bispev_f(tx, nx, ty, ny, coeff, 3, 3,
-                            &x1, 1, &y1, 1, &out[i * stride],
-                            wrk, lwrk, iwrk1, kwrk1, &err);
-                    if (err != 0)
-                    {
-                        *status = OSKAR_ERR_SPLINE_EVAL_FAIL;
-                        return;
-                    }
-                }
+                oskar_dierckx_bispev_bicubic_omp_f(tx, nx, ty, ny, coeff,
+                        num_points, x_, y_, stride, out);
             }
         }
         else if (location == OSKAR_GPU)
@@ -154,24 +138,8 @@ void oskar_splines_evaluate(oskar_Mem* output, int offset, int stride,
             }
             else
             {
-                /* Set up workspace. */
-                double x1, y1, wrk[8];
-                int iwrk1[2], kwrk1 = 2, lwrk = 8, err = 0;
-
-                /* Evaluate surface at the points. */
-                for (i = 0; i < num_points; ++i)
-                {
-                    x1 = x_[i];
-                    y1 = y_[i];
-                    oskar_dierckx_bispev_d(tx, nx, ty, ny, coeff, 3, 3,
-                            &x1, 1, &y1, 1, &out[i * stride],
-                            wrk, lwrk, iwrk1, kwrk1, &err);
-                    if (err != 0)
-                    {
-                        *status = OSKAR_ERR_SPLINE_EVAL_FAIL;
-                        return;
-                    }
-                }
+                oskar_dierckx_bispev_bicubic_omp_d(tx, nx, ty, ny, coeff,
+                        num_points, x_, y_, stride, out);
             }
         }
         else if (location == OSKAR_GPU)
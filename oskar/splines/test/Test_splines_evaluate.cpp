@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "splines/oskar_splines.h"
+#include "splines/oskar_dierckx_bispev.h"
+#include "splines/private_splines.h"
+#include "utility/oskar_get_error_string.h"
+
+#include "math/oskar_cmath.h"
+#include <cstdlib>
+#include <vector>
+
+// Surface fitting is done in double precision only, so convert afterwards.
+static void convert_splines(oskar_Splines* dst, const oskar_Splines* src,
+        int* status)
+{
+    oskar_mem_free(dst->knots_x_theta, status);
+    oskar_mem_free(dst->knots_y_phi, status);
+    oskar_mem_free(dst->coeff, status);
+    dst->num_knots_x_theta = src->num_knots_x_theta;
+    dst->num_knots_y_phi = src->num_knots_y_phi;
+    dst->knots_x_theta = oskar_mem_convert_precision(src->knots_x_theta,
+            dst->precision, status);
+    dst->knots_y_phi = oskar_mem_convert_precision(src->knots_y_phi,
+            dst->precision, status);
+    dst->coeff = oskar_mem_convert_precision(src->coeff,
+            dst->precision, status);
+}
+
+static void run_test(int precision)
+{
+    int status = 0, num_x = 30, num_y = 30, num_pts = 2000;
+    oskar_Splines *s0, *s1;
+    oskar_Mem *x, *y, *out;
+
+    // Fit a surface to some test data on a regular grid.
+    std::vector<double> gx, gy, gz, gw;
+    for (int j = 0; j < num_y; ++j)
+    {
+        for (int i = 0; i < num_x; ++i)
+        {
+            double xx = i / (num_x - 1.0), yy = j / (num_y - 1.0);
+            gx.push_back(xx);
+            gy.push_back(yy);
+            gz.push_back(sin(4.0 * xx) * cos(3.0 * yy) + xx * yy);
+            gw.push_back(1.0);
+        }
+    }
+    double avg_frac_err = 1e-3;
+    s0 = oskar_splines_create(OSKAR_DOUBLE, OSKAR_CPU, &status);
+    s1 = oskar_splines_create(precision, OSKAR_CPU, &status);
+    oskar_splines_fit(s0, (int)gx.size(), &gx[0], &gy[0], &gz[0], &gw[0],
+            OSKAR_SPLINES_LINEAR, 1, &avg_frac_err, 1.5, 1.0, 1e-14,
+            &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    convert_splines(s1, s0, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Evaluate at random points, including some outside the knot range.
+    // Use a stride of 2 and write to the second element of each pair.
+    x = oskar_mem_create(precision, OSKAR_CPU, num_pts, &status);
+    y = oskar_mem_create(precision, OSKAR_CPU, num_pts, &status);
+    out = oskar_mem_create(precision, OSKAR_CPU, 2 * num_pts, &status);
+    oskar_mem_clear_contents(out, &status);
+    srand(1);
+    oskar_mem_random_range(x, -0.1, 1.1, &status);
+    oskar_mem_random_range(y, -0.1, 1.1, &status);
+    oskar_splines_evaluate(out, 1, 2, s1, num_pts, x, y, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Compare with the reference implementation, point by point.
+    const int nx = oskar_splines_num_knots_x_theta(s1);
+    const int ny = oskar_splines_num_knots_y_phi(s1);
+    int iwrk[2], err = 0;
+    if (precision == OSKAR_DOUBLE)
+    {
+        double wrk[8], z;
+        const double* tx = oskar_mem_double_const(
+                oskar_splines_knots_x_theta_const(s1), &status);
+        const double* ty = oskar_mem_double_const(
+                oskar_splines_knots_y_phi_const(s1), &status);
+        const double* c = oskar_mem_double_const(
+                oskar_splines_coeff_const(s1), &status);
+        const double* x_ = oskar_mem_double_const(x, &status);
+        const double* y_ = oskar_mem_double_const(y, &status);
+        const double* out_ = oskar_mem_double_const(out, &status);
+        for (int i = 0; i < num_pts; ++i)
+        {
+            oskar_dierckx_bispev_d(tx, nx, ty, ny, c, 3, 3,
+                    &x_[i], 1, &y_[i], 1, &z, wrk, 8, iwrk, 2, &err);
+            ASSERT_EQ(0, err);
+            ASSERT_DOUBLE_EQ(z, out_[2 * i + 1]) << "point " << i;
+            ASSERT_EQ(0.0, out_[2 * i]) << "point " << i;
+        }
+    }
+    else
+    {
+        float wrk[8], z;
+        const float* tx = oskar_mem_float_const(
+                oskar_splines_knots_x_theta_const(s1), &status);
+        const float* ty = oskar_mem_float_const(
+                oskar_splines_knots_y_phi_const(s1), &status);
+        const float* c = oskar_mem_float_const(
+                oskar_splines_coeff_const(s1), &status);
+        const float* x_ = oskar_mem_float_const(x, &status);
+        const float* y_ = oskar_mem_float_const(y, &status);
+        const float* out_ = oskar_mem_float_const(out, &status);
+        for (int i = 0; i < num_pts; ++i)
+        {
+            oskar_dierckx_bispev_f(tx, nx, ty, ny, c, 3, 3,
+                    &x_[i], 1, &y_[i], 1, &z, wrk, 8, iwrk, 2, &err);
+            ASSERT_EQ(0, err);
+            ASSERT_FLOAT_EQ(z, out_[2 * i + 1]) << "point " << i;
+            ASSERT_EQ(0.0f, out_[2 * i]) << "point " << i;
+        }
+    }
+
+    oskar_mem_free(x, &status);
+    oskar_mem_free(y, &status);
+    oskar_mem_free(out, &status);
+    oskar_splines_free(s0, &status);
+    oskar_splines_free(s1, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+}
+
+TEST(splines, evaluate_double)
+{
+    run_test(OSKAR_DOUBLE);
+}
+
+TEST(splines, evaluate_single)
+{
+    run_test(OSKAR_SINGLE);
+}
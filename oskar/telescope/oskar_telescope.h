@@ -76,5 +76,6 @@ enum OSKAR_POL_MODE_TYPE
 #include <telescope/oskar_telescope_set_station_coords_ecef.h>
 #include <telescope/oskar_telescope_set_station_coords_enu.h>
 #include <telescope/oskar_telescope_set_station_coords_wgs84.h>
+#include <telescope/oskar_telescope_tabulate_element_patterns.h>
 
 #endif /* OSKAR_TELESCOPE_H_ */
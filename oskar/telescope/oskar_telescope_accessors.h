@@ -344,6 +344,23 @@ int oskar_telescope_allow_station_beam_duplication(
 OSKAR_EXPORT
 int oskar_telescope_enable_numerical_patterns(const oskar_Telescope* model);
 
+/**
+ * @brief
+ * Returns the generation number of the telescope model.
+ *
+ * @details
+ * Returns a value that is unique to this telescope model, and which changes
+ * whenever the model is created, copied, analysed or updated using
+ * oskar_telescope_update_generation(). Data derived from the model
+ * can be cached against it.
+ *
+ * @param[in] model   Pointer to telescope model.
+ *
+ * @return The generation number (never zero).
+ */
+OSKAR_EXPORT
+unsigned int oskar_telescope_generation(const oskar_Telescope* model);
+
 /**
  * @brief
  * Returns the maximum number of elements in a station.
@@ -837,6 +854,21 @@ OSKAR_EXPORT
 void oskar_telescope_set_enable_numerical_patterns(oskar_Telescope* model,
         int value);
 
+/**
+ * @brief
+ * Gives the telescope model a new generation number.
+ *
+ * @details
+ * Gives the telescope model a new generation number, so that any data
+ * cached against the old one are recomputed. This is called by
+ * oskar_telescope_analyse(), which should be used after the model has
+ * been modified.
+ *
+ * @param[in] model    Pointer to telescope model.
+ */
+OSKAR_EXPORT
+void oskar_telescope_update_generation(oskar_Telescope* model);
+
 /**
  * @brief
  * Sets the Gaussian station beam parameters.
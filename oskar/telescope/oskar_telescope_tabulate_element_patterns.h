@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OSKAR_TELESCOPE_TABULATE_ELEMENT_PATTERNS_H_
+#define OSKAR_TELESCOPE_TABULATE_ELEMENT_PATTERNS_H_
+
+/**
+ * @file oskar_telescope_tabulate_element_patterns.h
+ */
+
+#include <oskar_global.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief
+ * Generates element pattern lookup tables for all stations.
+ *
+ * @details
+ * This function calls oskar_element_tabulate() for every element type
+ * in every station (including child stations) of the telescope model.
+ * Tables are generated only once for elements holding the same pattern
+ * data, and copied to the others.
+ *
+ * Set \p num_theta or \p num_phi to zero to remove all tables.
+ *
+ * The telescope model must be in CPU memory.
+ *
+ * @param[in,out] telescope  Pointer to telescope model.
+ * @param[in] num_theta      Number of grid points in theta.
+ * @param[in] num_phi        Number of grid points in phi.
+ * @param[in] interp_type    Interpolation type (OSKAR_ELEMENT_TABLE_*).
+ * @param[out] max_rel_error Maximum fractional interpolation error (or NULL).
+ * @param[in,out] status     Status return code.
+ */
+OSKAR_EXPORT
+void oskar_telescope_tabulate_element_patterns(oskar_Telescope* telescope,
+        int num_theta, int num_phi, int interp_type, double* max_rel_error,
+        int* status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OSKAR_TELESCOPE_TABULATE_ELEMENT_PATTERNS_H_ */
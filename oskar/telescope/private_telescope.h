@@ -76,6 +76,7 @@ struct oskar_Telescope
     int identical_stations;                           /* True if all stations are identical. */
     int allow_station_beam_duplication;               /* True if station beam duplication is allowed. */
     int enable_numerical_patterns;                    /* True if numerical element patterns are enabled. */
+    unsigned int generation;                          /* Unique value, changed whenever the model is created or analysed. */
 };
 
 #ifndef OSKAR_TELESCOPE_TYPEDEF_
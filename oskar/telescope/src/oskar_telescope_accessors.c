@@ -37,6 +37,9 @@
 extern "C" {
 #endif
 
+/* Last generation number given to a telescope model. */
+static unsigned int generation_counter = 0;
+
 /* Properties and metadata. */
 
 int oskar_telescope_precision(const oskar_Telescope* model)
@@ -145,6 +148,11 @@ int oskar_telescope_enable_numerical_patterns(const oskar_Telescope* model)
     return model->enable_numerical_patterns;
 }
 
+unsigned int oskar_telescope_generation(const oskar_Telescope* model)
+{
+    return model->generation;
+}
+
 int oskar_telescope_max_station_size(const oskar_Telescope* model)
 {
     return model->max_station_size;
@@ -342,6 +350,15 @@ void oskar_telescope_set_enable_numerical_patterns(oskar_Telescope* model,
     model->enable_numerical_patterns = value;
 }
 
+void oskar_telescope_update_generation(oskar_Telescope* model)
+{
+#pragma omp critical (oskar_telescope_generation)
+    {
+        if (++generation_counter == 0) ++generation_counter;
+        model->generation = generation_counter;
+    }
+}
+
 static void oskar_telescope_set_gaussian_station_beam_p(oskar_Station* station,
         double fwhm_rad, double ref_freq_hz)
 {
@@ -83,8 +83,9 @@ void oskar_telescope_analyse(oskar_Telescope* model, int* status)
     /* Check if safe to proceed. */
     if (*status) return;
 
-    /* Set default flags. */
+    /* Set default flags, and invalidate data cached against the model. */
     model->identical_stations = 1;
+    oskar_telescope_update_generation(model);
 
     /* Recursively find the maximum number of elements in any station. */
     num_stations = model->num_stations;
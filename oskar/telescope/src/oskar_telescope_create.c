@@ -71,6 +71,7 @@ oskar_Telescope* oskar_telescope_create(int type, int location,
     telescope->identical_stations = 0;
     telescope->allow_station_beam_duplication = 0;
     telescope->enable_numerical_patterns = 1;
+    oskar_telescope_update_generation(telescope);
     telescope->lon_rad = 0.0;
     telescope->lat_rad = 0.0;
     telescope->alt_metres = 0.0;
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "telescope/oskar_telescope.h"
+
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct ElementList
+{
+    int num, capacity;
+    const oskar_Element** items;
+};
+typedef struct ElementList ElementList;
+
+static void tabulate_station(oskar_Station* station, int num_theta,
+        int num_phi, int interp_type, ElementList* done,
+        double* max_rel_error, int* status);
+
+void oskar_telescope_tabulate_element_patterns(oskar_Telescope* telescope,
+        int num_theta, int num_phi, int interp_type, double* max_rel_error,
+        int* status)
+{
+    int i;
+    double err = 0.0;
+    ElementList done = {0, 0, 0};
+
+    /* Check if safe to proceed. */
+    if (max_rel_error) *max_rel_error = 0.0;
+    if (*status) return;
+
+    /* Tabulate elements in all stations. */
+    for (i = 0; i < oskar_telescope_num_stations(telescope); ++i)
+        tabulate_station(oskar_telescope_station(telescope, i), num_theta,
+                num_phi, interp_type, &done, &err, status);
+    if (max_rel_error) *max_rel_error = err;
+    free(done.items);
+}
+
+static void tabulate_station(oskar_Station* station, int num_theta,
+        int num_phi, int interp_type, ElementList* done,
+        double* max_rel_error, int* status)
+{
+    int i, j;
+    double err = 0.0;
+    if (*status || !station) return;
+
+    for (i = 0; i < oskar_station_num_element_types(station); ++i)
+    {
+        oskar_Element* element = oskar_station_element(station, i);
+
+        /* Copy the tables if the same pattern has already been done. */
+        for (j = 0; j < done->num; ++j)
+        {
+            if (!oskar_element_different(done->items[j], element, status))
+            {
+                oskar_element_copy_tables(element, done->items[j], status);
+                break;
+            }
+        }
+        if (j < done->num) continue;
+
+        /* Otherwise, generate new tables. */
+        oskar_element_tabulate(element, num_theta, num_phi, interp_type,
+                &err, status);
+        if (err > *max_rel_error) *max_rel_error = err;
+        if (done->num == done->capacity)
+        {
+            const oskar_Element** t;
+            t = (const oskar_Element**) realloc(done->items,
+                    (done->capacity + 16) * sizeof(const oskar_Element*));
+            if (!t)
+            {
+                *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+                return;
+            }
+            done->items = t;
+            done->capacity += 16;
+        }
+        done->items[done->num++] = element;
+    }
+
+    /* Recursively tabulate elements in child stations. */
+    if (oskar_station_has_child(station))
+    {
+        for (i = 0; i < oskar_station_num_elements(station); ++i)
+            tabulate_station(oskar_station_child(station, i), num_theta,
+                    num_phi, interp_type, done, max_rel_error, status);
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
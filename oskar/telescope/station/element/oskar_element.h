@@ -66,6 +66,12 @@ enum OSKAR_ELEMENT_COORD_SYS
     OSKAR_ELEMENT_COORD_SYS_TANGENT_PLANE = 1
 };
 
+enum OSKAR_ELEMENT_TABLE_INTERP
+{
+    OSKAR_ELEMENT_TABLE_BILINEAR = 0,
+    OSKAR_ELEMENT_TABLE_BICUBIC = 1
+};
+
 /* FIXME(FD) Deprecated. */
 enum OSKAR_ELEMENT_TYPE
 {
@@ -98,6 +104,7 @@ enum OSKAR_ELEMENT_TAPER
 #include <telescope/station/element/oskar_element_resize_freq_data.h>
 #include <telescope/station/element/oskar_element_read.h>
 #include <telescope/station/element/oskar_element_save.h>
+#include <telescope/station/element/oskar_element_tabulate.h>
 #include <telescope/station/element/oskar_element_write.h>
 
 #endif /* OSKAR_ELEMENT_H_ */
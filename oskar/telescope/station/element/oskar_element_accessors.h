@@ -62,6 +62,9 @@ int oskar_element_num_freq(const oskar_Element* data);
 OSKAR_EXPORT
 const double* oskar_element_freqs_hz_const(const oskar_Element* data);
 
+OSKAR_EXPORT
+int oskar_element_interpolate_freq(const oskar_Element* data);
+
 OSKAR_EXPORT
 int oskar_element_type(const oskar_Element* data);
 
@@ -191,6 +194,9 @@ void oskar_element_set_gaussian_fwhm_rad(oskar_Element* data, double value);
 OSKAR_EXPORT
 void oskar_element_set_cosine_power(oskar_Element* data, double value);
 
+OSKAR_EXPORT
+void oskar_element_set_interpolate_freq(oskar_Element* data, int value);
+
 OSKAR_EXPORT
 void oskar_element_set_dipole_length(oskar_Element* data, double value,
         const char* units, int* status);
@@ -54,6 +54,25 @@ OSKAR_EXPORT
 void oskar_element_copy(oskar_Element* dst, const oskar_Element* src,
         int* status);
 
+/**
+ * @brief
+ * Copies element pattern lookup tables from one element to another.
+ *
+ * @details
+ * This function copies only the lookup tables generated by
+ * oskar_element_tabulate(), which is useful if the two elements are
+ * known to hold the same pattern data.
+ *
+ * Tables are not copied if the destination is not in CPU memory.
+ *
+ * @param[out] dst          Pointer to destination data structure to copy into.
+ * @param[in]  src          Pointer to source data structure to copy from.
+ * @param[in,out]  status   Status return code.
+ */
+OSKAR_EXPORT
+void oskar_element_copy_tables(oskar_Element* dst, const oskar_Element* src,
+        int* status);
+
 #ifdef __cplusplus
 }
 #endif
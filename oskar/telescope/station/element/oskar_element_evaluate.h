@@ -67,6 +67,38 @@ void oskar_element_evaluate(const oskar_Element* model, oskar_Mem* output,
         const oskar_Mem* x, const oskar_Mem* y, const oskar_Mem* z,
         double frequency_hz, oskar_Mem* theta, oskar_Mem* phi, int* status);
 
+/**
+ * @brief
+ * Evaluates the element model at the given source positions.
+ *
+ * @details
+ * This function evaluates the element pattern model at the given source
+ * positions, as oskar_element_evaluate(), but takes a work array that is
+ * used when interpolating between fitted frequencies. Supplying the same
+ * work array on each call avoids allocating it every time.
+ *
+ * @param[in] model      Pointer to element model structure.
+ * @param[in,out] output Pointer to memory into which to accumulate output data.
+ * @param[in] orientation_x Azimuth of X dipole in radians.
+ * @param[in] orientation_y Azimuth of Y dipole in radians.
+ * @param[in] num_points Number of points at which to evaluate beam.
+ * @param[in] x          Pointer to x-direction cosines.
+ * @param[in] y          Pointer to y-direction cosines.
+ * @param[in] z          Pointer to z-direction cosines.
+ * @param[in] frequency_hz Current observing frequency in Hz.
+ * @param[out] theta     Pointer to work array for computing theta values.
+ * @param[out] phi       Pointer to work array for computing phi values.
+ * @param[out] work      Work array used to interpolate between fitted
+ *                       frequencies (may be NULL).
+ * @param[in,out] status Status return code.
+ */
+OSKAR_EXPORT
+void oskar_element_evaluate_with_work(const oskar_Element* model,
+        oskar_Mem* output, double orientation_x, double orientation_y,
+        int num_points, const oskar_Mem* x, const oskar_Mem* y,
+        const oskar_Mem* z, double frequency_hz, oskar_Mem* theta,
+        oskar_Mem* phi, oskar_Mem* work, int* status);
+
 #ifdef __cplusplus
 }
 #endif
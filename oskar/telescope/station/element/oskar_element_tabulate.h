@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OSKAR_ELEMENT_TABULATE_H_
+#define OSKAR_ELEMENT_TABULATE_H_
+
+/**
+ * @file oskar_element_tabulate.h
+ */
+
+#include <oskar_global.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief
+ * Tabulates numerically-defined element patterns on a regular grid.
+ *
+ * @details
+ * This function evaluates the fitted element pattern surfaces at every
+ * frequency on a regular (theta, phi) grid, and stores the results in the
+ * element model. Subsequent calls to oskar_element_evaluate() in CPU memory
+ * will then interpolate the tables instead of evaluating the splines
+ * directly, which is much faster when the pattern is required at a large
+ * number of directions.
+ *
+ * The grid has \p num_theta points from 0 to pi inclusive, and \p num_phi
+ * points from 0 to 2 pi. If \p num_phi is odd, it is increased by one.
+ * Set \p num_theta or \p num_phi to zero to remove any existing tables.
+ *
+ * On exit, \p max_rel_error holds the largest difference between the
+ * interpolated tables and the splines, evaluated at the centre of each grid
+ * cell and expressed as a fraction of the peak value of each surface.
+ *
+ * The element model must be in CPU memory.
+ *
+ * @param[in,out] model      Pointer to element model data structure.
+ * @param[in] num_theta      Number of grid points in theta.
+ * @param[in] num_phi        Number of grid points in phi.
+ * @param[in] interp_type    Interpolation type (OSKAR_ELEMENT_TABLE_*).
+ * @param[out] max_rel_error Maximum fractional interpolation error (or NULL).
+ * @param[in,out] status     Status return code.
+ */
+OSKAR_EXPORT
+void oskar_element_tabulate(oskar_Element* model, int num_theta, int num_phi,
+        int interp_type, double* max_rel_error, int* status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OSKAR_ELEMENT_TABULATE_H_ */
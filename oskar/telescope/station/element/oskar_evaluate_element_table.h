@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OSKAR_EVALUATE_ELEMENT_TABLE_H_
+#define OSKAR_EVALUATE_ELEMENT_TABLE_H_
+
+/**
+ * @file oskar_evaluate_element_table.h
+ */
+
+#include <oskar_global.h>
+#include <mem/oskar_mem.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief
+ * Interpolates tabulated element pattern surfaces (single precision).
+ *
+ * @details
+ * This function interpolates a set of surfaces tabulated on a regular
+ * (theta, phi) grid at the supplied positions.
+ *
+ * The grid has \p num_theta rows spanning 0 to pi inclusive, and
+ * \p num_phi columns spanning 0 to 2 pi, which wrap around. The value of
+ * surface \p s at grid point (i, j) is stored at
+ * table[(i * num_phi + j) * num_surfaces + s].
+ *
+ * The result for surface \p s at point \p k is written to
+ * output[k * stride + s].
+ *
+ * @param[in] num_theta     Number of grid points in theta.
+ * @param[in] num_phi       Number of grid points in phi (must be even).
+ * @param[in] interp_type   Interpolation type (enumerator).
+ * @param[in] num_surfaces  Number of surfaces in the table.
+ * @param[in] table         Tabulated surface values.
+ * @param[in] num_points    Number of positions.
+ * @param[in] theta         Position theta values, in radians.
+ * @param[in] phi           Position phi values, in radians.
+ * @param[in] stride        Memory stride of output values.
+ * @param[out] output       Output values.
+ */
+OSKAR_EXPORT
+void oskar_evaluate_element_table_f(int num_theta, int num_phi,
+        int interp_type, int num_surfaces, const float* table,
+        int num_points, const float* theta, const float* phi, int stride,
+        float* output);
+
+/**
+ * @brief
+ * Interpolates tabulated element pattern surfaces (double precision).
+ *
+ * @details
+ * This function interpolates a set of surfaces tabulated on a regular
+ * (theta, phi) grid at the supplied positions.
+ *
+ * The grid has \p num_theta rows spanning 0 to pi inclusive, and
+ * \p num_phi columns spanning 0 to 2 pi, which wrap around. The value of
+ * surface \p s at grid point (i, j) is stored at
+ * table[(i * num_phi + j) * num_surfaces + s].
+ *
+ * The result for surface \p s at point \p k is written to
+ * output[k * stride + s].
+ *
+ * @param[in] num_theta     Number of grid points in theta.
+ * @param[in] num_phi       Number of grid points in phi (must be even).
+ * @param[in] interp_type   Interpolation type (enumerator).
+ * @param[in] num_surfaces  Number of surfaces in the table.
+ * @param[in] table         Tabulated surface values.
+ * @param[in] num_points    Number of positions.
+ * @param[in] theta         Position theta values, in radians.
+ * @param[in] phi           Position phi values, in radians.
+ * @param[in] stride        Memory stride of output values.
+ * @param[out] output       Output values.
+ */
+OSKAR_EXPORT
+void oskar_evaluate_element_table_d(int num_theta, int num_phi,
+        int interp_type, int num_surfaces, const double* table,
+        int num_points, const double* theta, const double* phi, int stride,
+        double* output);
+
+/**
+ * @brief
+ * Interpolates tabulated element pattern surfaces.
+ *
+ * @details
+ * This function interpolates a set of surfaces tabulated on a regular
+ * (theta, phi) grid at the supplied positions, writing the result for
+ * surface \p s into the output array starting at \p offset + \p s,
+ * with the given stride.
+ *
+ * The table must be of real type. The output array may be real or complex,
+ * and the offset and stride are given in units of real values.
+ * All arrays must be in CPU memory.
+ *
+ * @param[in] table         Tabulated surface values.
+ * @param[in] num_theta     Number of grid points in theta.
+ * @param[in] num_phi       Number of grid points in phi (must be even).
+ * @param[in] interp_type   Interpolation type (enumerator).
+ * @param[in] num_surfaces  Number of surfaces in the table.
+ * @param[in] num_points    Number of positions.
+ * @param[in] theta         Position theta values, in radians.
+ * @param[in] phi           Position phi values, in radians.
+ * @param[out] output       Output values.
+ * @param[in] offset        Offset into output array for the first surface.
+ * @param[in] stride        Memory stride of output values.
+ * @param[in,out] status    Status return code.
+ */
+OSKAR_EXPORT
+void oskar_evaluate_element_table(const oskar_Mem* table, int num_theta,
+        int num_phi, int interp_type, int num_surfaces, int num_points,
+        const oskar_Mem* theta, const oskar_Mem* phi, oskar_Mem* output,
+        int offset, int stride, int* status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OSKAR_EVALUATE_ELEMENT_TABLE_H_ */
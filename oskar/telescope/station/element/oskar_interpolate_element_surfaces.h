@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OSKAR_INTERPOLATE_ELEMENT_SURFACES_H_
+#define OSKAR_INTERPOLATE_ELEMENT_SURFACES_H_
+
+/**
+ * @file oskar_interpolate_element_surfaces.h
+ */
+
+#include <oskar_global.h>
+#include <mem/oskar_mem.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief
+ * Interpolates element responses between two fitted frequencies
+ * (single precision).
+ *
+ * @details
+ * This function interpolates element responses evaluated at the fitted
+ * frequencies either side of the observing frequency. Each pair of
+ * surfaces holds the real and imaginary parts of a complex response, which
+ * is interpolated in amplitude and phase.
+ *
+ * The response at the lower frequency for pair \p k at point \p i is read
+ * from, and the result written to, output[i * stride + 2 * k] and the
+ * element following it. The response at the upper frequency is read from
+ * upper[(i * num_pairs + k) * 2] and the element following it.
+ *
+ * @param[in] num_points   Number of points.
+ * @param[in] num_pairs    Number of complex surfaces.
+ * @param[in] frac         Fractional distance from the lower frequency.
+ * @param[in] upper        Responses at the upper frequency.
+ * @param[in,out] output   Responses at the lower frequency, overwritten.
+ * @param[in] stride       Stride between points in the output array.
+ */
+OSKAR_EXPORT
+void oskar_interpolate_element_surfaces_f(int num_points, int num_pairs,
+        float frac, const float* upper, float* output, int stride);
+
+/**
+ * @brief
+ * Interpolates element responses between two fitted frequencies
+ * (double precision).
+ *
+ * @details
+ * This function interpolates element responses evaluated at the fitted
+ * frequencies either side of the observing frequency. Each pair of
+ * surfaces holds the real and imaginary parts of a complex response, which
+ * is interpolated in amplitude and phase.
+ *
+ * The response at the lower frequency for pair \p k at point \p i is read
+ * from, and the result written to, output[i * stride + 2 * k] and the
+ * element following it. The response at the upper frequency is read from
+ * upper[(i * num_pairs + k) * 2] and the element following it.
+ *
+ * @param[in] num_points   Number of points.
+ * @param[in] num_pairs    Number of complex surfaces.
+ * @param[in] frac         Fractional distance from the lower frequency.
+ * @param[in] upper        Responses at the upper frequency.
+ * @param[in,out] output   Responses at the lower frequency, overwritten.
+ * @param[in] stride       Stride between points in the output array.
+ */
+OSKAR_EXPORT
+void oskar_interpolate_element_surfaces_d(int num_points, int num_pairs,
+        double frac, const double* upper, double* output, int stride);
+
+/**
+ * @brief
+ * Wrapper function to interpolate element responses between two fitted
+ * frequencies.
+ *
+ * @details
+ * This function interpolates element responses evaluated at the fitted
+ * frequencies either side of the observing frequency, in amplitude and
+ * phase. The arrays must be in the same location.
+ *
+ * The \p offset and \p stride are given in units of the real type, so a
+ * complex matrix output has a stride of 8.
+ *
+ * @param[in] num_points   Number of points.
+ * @param[in] num_pairs    Number of complex surfaces.
+ * @param[in] frac         Fractional distance from the lower frequency.
+ * @param[in] upper        Responses at the upper frequency.
+ * @param[in,out] output   Responses at the lower frequency, overwritten.
+ * @param[in] offset       Offset of the first response in the output array.
+ * @param[in] stride       Stride between points in the output array.
+ * @param[in,out] status   Status return code.
+ */
+OSKAR_EXPORT
+void oskar_interpolate_element_surfaces(int num_points, int num_pairs,
+        double frac, const oskar_Mem* upper, oskar_Mem* output, int offset,
+        int stride, int* status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OSKAR_INTERPOLATE_ELEMENT_SURFACES_H_ */
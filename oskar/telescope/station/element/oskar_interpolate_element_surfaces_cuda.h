@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OSKAR_INTERPOLATE_ELEMENT_SURFACES_CUDA_H_
+#define OSKAR_INTERPOLATE_ELEMENT_SURFACES_CUDA_H_
+
+/**
+ * @file oskar_interpolate_element_surfaces_cuda.h
+ */
+
+#include <oskar_global.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief
+ * Interpolates element responses between two fitted frequencies using CUDA
+ * (single precision).
+ *
+ * @details
+ * This CUDA function interpolates element responses evaluated at the
+ * fitted frequencies either side of the observing frequency, in amplitude
+ * and phase.
+ *
+ * @param[in] num_points   Number of points.
+ * @param[in] num_pairs    Number of complex surfaces.
+ * @param[in] frac         Fractional distance from the lower frequency.
+ * @param[in] d_upper      Responses at the upper frequency.
+ * @param[in,out] d_output Responses at the lower frequency, overwritten.
+ * @param[in] stride       Stride between points in the output array.
+ */
+OSKAR_EXPORT
+void oskar_interpolate_element_surfaces_cuda_f(int num_points, int num_pairs,
+        float frac, const float* d_upper, float* d_output, int stride);
+
+/**
+ * @brief
+ * Interpolates element responses between two fitted frequencies using CUDA
+ * (double precision).
+ *
+ * @details
+ * This CUDA function interpolates element responses evaluated at the
+ * fitted frequencies either side of the observing frequency, in amplitude
+ * and phase.
+ *
+ * @param[in] num_points   Number of points.
+ * @param[in] num_pairs    Number of complex surfaces.
+ * @param[in] frac         Fractional distance from the lower frequency.
+ * @param[in] d_upper      Responses at the upper frequency.
+ * @param[in,out] d_output Responses at the lower frequency, overwritten.
+ * @param[in] stride       Stride between points in the output array.
+ */
+OSKAR_EXPORT
+void oskar_interpolate_element_surfaces_cuda_d(int num_points, int num_pairs,
+        double frac, const double* d_upper, double* d_output, int stride);
+
+#ifdef __CUDACC__
+
+/* Kernels. */
+
+__global__
+void oskar_interpolate_element_surfaces_cudak_f(const int num_points,
+        const int num_pairs, const float frac, const float* upper,
+        float* output, const int stride);
+
+__global__
+void oskar_interpolate_element_surfaces_cudak_d(const int num_points,
+        const int num_pairs, const double frac, const double* upper,
+        double* output, const int stride);
+
+#endif /* __CUDACC__ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OSKAR_INTERPOLATE_ELEMENT_SURFACES_CUDA_H_ */
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OSKAR_INTERPOLATE_ELEMENT_SURFACES_INLINE_H_
+#define OSKAR_INTERPOLATE_ELEMENT_SURFACES_INLINE_H_
+
+/**
+ * @file oskar_interpolate_element_surfaces_inline.h
+ */
+
+#include <oskar_global.h>
+#include <math/oskar_cmath.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief
+ * Interpolates a complex response between two frequencies
+ * (single precision).
+ *
+ * @details
+ * This inline function interpolates linearly in amplitude and phase
+ * between the complex values \p a and \p b, so that the phase does not
+ * cut across a wrap between them. The result is written to \p a.
+ *
+ * @param[in,out] a  Real and imaginary parts at the lower frequency.
+ * @param[in] b      Real and imaginary parts at the upper frequency.
+ * @param[in] frac   Fractional distance from the lower frequency.
+ */
+OSKAR_INLINE
+void oskar_interpolate_element_surfaces_inline_f(float* a, const float* b,
+        const float frac)
+{
+    float amp, ph, d_ph;
+    amp = (1.0f - frac) * sqrtf(a[0] * a[0] + a[1] * a[1]) +
+            frac * sqrtf(b[0] * b[0] + b[1] * b[1]);
+    ph = atan2f(a[1], a[0]);
+    d_ph = atan2f(b[1], b[0]) - ph;
+    if (d_ph > M_PIf) d_ph -= 2.0f * M_PIf;
+    else if (d_ph < -M_PIf) d_ph += 2.0f * M_PIf;
+    ph += frac * d_ph;
+    a[0] = amp * cosf(ph);
+    a[1] = amp * sinf(ph);
+}
+
+/**
+ * @brief
+ * Interpolates a complex response between two frequencies
+ * (double precision).
+ *
+ * @details
+ * This inline function interpolates linearly in amplitude and phase
+ * between the complex values \p a and \p b, so that the phase does not
+ * cut across a wrap between them. The result is written to \p a.
+ *
+ * @param[in,out] a  Real and imaginary parts at the lower frequency.
+ * @param[in] b      Real and imaginary parts at the upper frequency.
+ * @param[in] frac   Fractional distance from the lower frequency.
+ */
+OSKAR_INLINE
+void oskar_interpolate_element_surfaces_inline_d(double* a, const double* b,
+        const double frac)
+{
+    double amp, ph, d_ph;
+    amp = (1.0 - frac) * sqrt(a[0] * a[0] + a[1] * a[1]) +
+            frac * sqrt(b[0] * b[0] + b[1] * b[1]);
+    ph = atan2(a[1], a[0]);
+    d_ph = atan2(b[1], b[0]) - ph;
+    if (d_ph > M_PI) d_ph -= 2.0 * M_PI;
+    else if (d_ph < -M_PI) d_ph += 2.0 * M_PI;
+    ph += frac * d_ph;
+    a[0] = amp * cos(ph);
+    a[1] = amp * sin(ph);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OSKAR_INTERPOLATE_ELEMENT_SURFACES_INLINE_H_ */
@@ -64,6 +64,7 @@ struct oskar_Element
     /* The arrays of fitted data are per-frequency. */
     int coord_sys;
     double max_radius_rad;
+    int interpolate_freq; /* If set, interpolate between fitted frequencies. */
     int num_freq;
     double* freqs_hz; /* Array of frequencies in Hz. */
     oskar_Mem** filename_x;
@@ -79,6 +80,14 @@ struct oskar_Element
     oskar_Splines** y_v_im;
     oskar_Splines** scalar_re;
     oskar_Splines** scalar_im;
+
+    /* Optional lookup tables of the fitted surfaces, per frequency. */
+    int table_num_theta;
+    int table_num_phi;
+    int table_interp;
+    oskar_Mem** x_table;      /* Interleaved h_re, h_im, v_re, v_im. */
+    oskar_Mem** y_table;      /* Interleaved h_re, h_im, v_re, v_im. */
+    oskar_Mem** scalar_table; /* Interleaved re, im. */
 };
 
 #ifndef OSKAR_ELEMENT_TYPEDEF_
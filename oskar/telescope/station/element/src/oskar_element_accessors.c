@@ -111,6 +111,11 @@ int oskar_element_dipole_length_units(const oskar_Element* data)
     return data->dipole_length_units;
 }
 
+int oskar_element_interpolate_freq(const oskar_Element* data)
+{
+    return data->interpolate_freq;
+}
+
 oskar_Mem* oskar_element_x_filename(oskar_Element* data, int freq_id)
 {
     return data->filename_x[freq_id];
@@ -319,6 +324,11 @@ void oskar_element_set_cosine_power(oskar_Element* data, double value)
     data->cosine_power = value;
 }
 
+void oskar_element_set_interpolate_freq(oskar_Element* data, int value)
+{
+    data->interpolate_freq = value;
+}
+
 void oskar_element_set_dipole_length(oskar_Element* data, double value,
         const char* units, int* status)
 {
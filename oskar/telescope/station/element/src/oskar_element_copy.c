@@ -48,6 +48,7 @@ void oskar_element_copy(oskar_Element* dst, const oskar_Element* src,
     dst->gaussian_fwhm_rad = src->gaussian_fwhm_rad;
     dst->dipole_length = src->dipole_length;
     dst->dipole_length_units = src->dipole_length_units;
+    dst->interpolate_freq = src->interpolate_freq;
 
     /* Resize the arrays. */
     oskar_element_resize_freq_data(dst, src->num_freq, status);
@@ -70,6 +71,35 @@ void oskar_element_copy(oskar_Element* dst, const oskar_Element* src,
         oskar_splines_copy(dst->scalar_re[i], src->scalar_re[i], status);
         oskar_splines_copy(dst->scalar_im[i], src->scalar_im[i], status);
     }
+
+    /* Copy any lookup tables. */
+    oskar_element_copy_tables(dst, src, status);
+}
+
+void oskar_element_copy_tables(oskar_Element* dst, const oskar_Element* src,
+        int* status)
+{
+    int i;
+
+    /* Check if safe to proceed. */
+    if (*status) return;
+
+    /* Lookup tables are only used in CPU memory. */
+    if (dst->mem_location != OSKAR_CPU) return;
+    if (dst->num_freq != src->num_freq)
+    {
+        *status = OSKAR_ERR_DIMENSION_MISMATCH;
+        return;
+    }
+    dst->table_num_theta = src->table_num_theta;
+    dst->table_num_phi = src->table_num_phi;
+    dst->table_interp = src->table_interp;
+    for (i = 0; i < src->num_freq; ++i)
+    {
+        oskar_mem_copy(dst->x_table[i], src->x_table[i], status);
+        oskar_mem_copy(dst->y_table[i], src->y_table[i], status);
+        oskar_mem_copy(dst->scalar_table[i], src->scalar_table[i], status);
+    }
 }
 
 #ifdef __cplusplus
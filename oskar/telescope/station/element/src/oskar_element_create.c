@@ -60,6 +60,7 @@ oskar_Element* oskar_element_create(int precision, int location, int* status)
         *status = OSKAR_ERR_BAD_DATA_TYPE;
 
     /* Initialise arrays (to zero length). */
+    data->interpolate_freq = 0;
     data->num_freq = 0;
     data->freqs_hz = 0;
     data->filename_x = 0;
@@ -75,6 +76,12 @@ oskar_Element* oskar_element_create(int precision, int location, int* status)
     data->y_v_im = 0;
     data->scalar_re = 0;
     data->scalar_im = 0;
+    data->table_num_theta = 0;
+    data->table_num_phi = 0;
+    data->table_interp = OSKAR_ELEMENT_TABLE_BILINEAR;
+    data->x_table = 0;
+    data->y_table = 0;
+    data->scalar_table = 0;
 
     /* Return pointer to the structure. */
     return data;
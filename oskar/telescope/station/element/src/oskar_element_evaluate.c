@@ -32,12 +32,15 @@
 #include "telescope/station/element/oskar_apply_element_taper_cosine.h"
 #include "telescope/station/element/oskar_apply_element_taper_gaussian.h"
 #include "telescope/station/element/oskar_evaluate_dipole_pattern.h"
+#include "telescope/station/element/oskar_evaluate_element_table.h"
 #include "telescope/station/element/oskar_evaluate_geometric_dipole_pattern.h"
+#include "telescope/station/element/oskar_interpolate_element_surfaces.h"
 #include "convert/oskar_convert_enu_directions_to_theta_phi.h"
 #include "convert/oskar_convert_ludwig3_to_theta_phi_components.h"
 #include "math/oskar_find_closest_match.h"
 
 #include "math/oskar_cmath.h"
+#include <float.h>
 
 #define C_0 299792458.0
 
@@ -45,13 +48,116 @@
 extern "C" {
 #endif
 
+/* Fitted frequencies and interpolation weight for an evaluation. */
+struct FreqInterp
+{
+    int lo, hi;
+    double frac;
+    oskar_Mem* work;
+};
+typedef struct FreqInterp FreqInterp;
+
+static void evaluate(const oskar_Element* model, oskar_Mem* output,
+        double orientation_x, double orientation_y, int num_points,
+        const oskar_Mem* x, const oskar_Mem* y, const oskar_Mem* z,
+        double frequency_hz, FreqInterp* f, oskar_Mem* theta, oskar_Mem* phi,
+        int* status);
+static void evaluate_fitted(const oskar_Element* model,
+        oskar_Mem* const* tables, oskar_Splines* const* const* surfaces,
+        int num_surfaces, FreqInterp* f, int num_points,
+        const oskar_Mem* theta, const oskar_Mem* phi, oskar_Mem* output,
+        int offset, int stride, int* status);
+static void evaluate_surfaces(const oskar_Element* model,
+        oskar_Mem* const* tables, oskar_Splines* const* const* surfaces,
+        int num_surfaces, int freq_id, int num_points,
+        const oskar_Mem* theta, const oskar_Mem* phi, oskar_Mem* output,
+        int offset, int stride, int* status);
+
+static int use_table(const oskar_Mem* table, const oskar_Mem* output)
+{
+    return oskar_mem_length(table) > 0 &&
+            oskar_mem_location(table) == OSKAR_CPU &&
+            oskar_mem_location(output) == OSKAR_CPU;
+}
+
 void oskar_element_evaluate(const oskar_Element* model, oskar_Mem* output,
         double orientation_x, double orientation_y, int num_points,
         const oskar_Mem* x, const oskar_Mem* y, const oskar_Mem* z,
         double frequency_hz, oskar_Mem* theta, oskar_Mem* phi, int* status)
 {
-    int element_type, taper_type, freq_id;
+    oskar_element_evaluate_with_work(model, output, orientation_x,
+            orientation_y, num_points, x, y, z, frequency_hz, theta, phi, 0,
+            status);
+}
+
+void oskar_element_evaluate_with_work(const oskar_Element* model,
+        oskar_Mem* output, double orientation_x, double orientation_y,
+        int num_points, const oskar_Mem* x, const oskar_Mem* y,
+        const oskar_Mem* z, double frequency_hz, oskar_Mem* theta,
+        oskar_Mem* phi, oskar_Mem* work, int* status)
+{
+    int i;
+    double f_lo = -DBL_MAX, f_hi = DBL_MAX;
+    FreqInterp f;
+
+    /* Check if safe to proceed. */
+    if (*status) return;
+
+    /* Get the index of the closest fitted frequency. */
+    f.lo = f.hi = 0;
+    f.frac = 0.0;
+    f.work = work;
+    if (model->num_freq > 0)
+        f.lo = f.hi = oskar_find_closest_match_d(frequency_hz,
+                model->num_freq, model->freqs_hz);
+
+    /* Find the fitted frequencies either side, if interpolating. */
+    if (model->interpolate_freq && model->num_freq > 1)
+    {
+        for (i = 0; i < model->num_freq; ++i)
+        {
+            const double freq = model->freqs_hz[i];
+            if (freq <= frequency_hz && freq > f_lo)
+            {
+                f_lo = freq;
+                f.lo = i;
+            }
+            if (freq >= frequency_hz && freq < f_hi)
+            {
+                f_hi = freq;
+                f.hi = i;
+            }
+        }
+
+        /* Use the closest frequency if out of range, or an exact match. */
+        if (f_lo == -DBL_MAX || f_hi == DBL_MAX || f_lo == f_hi)
+            f.hi = f.lo = oskar_find_closest_match_d(frequency_hz,
+                    model->num_freq, model->freqs_hz);
+        else
+            f.frac = (frequency_hz - f_lo) / (f_hi - f_lo);
+    }
+
+    /* A work array is needed to interpolate, if not supplied. */
+    if (f.lo != f.hi && !work)
+        f.work = oskar_mem_create(oskar_mem_precision(output),
+                oskar_mem_location(output), 0, status);
+    evaluate(model, output, orientation_x, orientation_y, num_points,
+            x, y, z, frequency_hz, &f, theta, phi, status);
+    if (f.work != work)
+        oskar_mem_free(f.work, status);
+}
+
+static void evaluate(const oskar_Element* model, oskar_Mem* output,
+        double orientation_x, double orientation_y, int num_points,
+        const oskar_Mem* x, const oskar_Mem* y, const oskar_Mem* z,
+        double frequency_hz, FreqInterp* f, oskar_Mem* theta, oskar_Mem* phi,
+        int* status)
+{
+    int element_type, taper_type;
     double dipole_length_m;
+    oskar_Splines* const* x_surfaces[4];
+    oskar_Splines* const* y_surfaces[4];
+    oskar_Splines* const* scalar_surfaces[2];
 
     /* Check if safe to proceed. */
     if (*status) return;
@@ -94,20 +200,13 @@ void oskar_element_evaluate(const oskar_Element* model, oskar_Mem* output,
         /* Check if spline data present for dipole X. */
         if (oskar_element_has_x_spline_data(model))
         {
-            /* Get the frequency index. */
-            freq_id = oskar_find_closest_match_d(frequency_hz,
-                    oskar_element_num_freq(model),
-                    oskar_element_freqs_hz_const(model));
-
             /* Evaluate spline pattern for dipole X. */
-            oskar_splines_evaluate(output, 0, 8, model->x_h_re[freq_id],
-                    num_points, theta, phi, status);
-            oskar_splines_evaluate(output, 1, 8, model->x_h_im[freq_id],
-                    num_points, theta, phi, status);
-            oskar_splines_evaluate(output, 2, 8, model->x_v_re[freq_id],
-                    num_points, theta, phi, status);
-            oskar_splines_evaluate(output, 3, 8, model->x_v_im[freq_id],
-                    num_points, theta, phi, status);
+            x_surfaces[0] = model->x_h_re;
+            x_surfaces[1] = model->x_h_im;
+            x_surfaces[2] = model->x_v_re;
+            x_surfaces[3] = model->x_v_im;
+            evaluate_fitted(model, model->x_table, x_surfaces, 4, f,
+                    num_points, theta, phi, output, 0, 8, status);
 
             /* Convert from Ludwig-3 to spherical representation. */
             oskar_convert_ludwig3_to_theta_phi_components(output, 0, 4,
@@ -133,20 +232,13 @@ void oskar_element_evaluate(const oskar_Element* model, oskar_Mem* output,
         /* Check if spline data present for dipole Y. */
         if (oskar_element_has_y_spline_data(model))
         {
-            /* Get the frequency index. */
-            freq_id = oskar_find_closest_match_d(frequency_hz,
-                    oskar_element_num_freq(model),
-                    oskar_element_freqs_hz_const(model));
-
             /* Evaluate spline pattern for dipole Y. */
-            oskar_splines_evaluate(output, 4, 8, model->y_h_re[freq_id],
-                    num_points, theta, phi, status);
-            oskar_splines_evaluate(output, 5, 8, model->y_h_im[freq_id],
-                    num_points, theta, phi, status);
-            oskar_splines_evaluate(output, 6, 8, model->y_v_re[freq_id],
-                    num_points, theta, phi, status);
-            oskar_splines_evaluate(output, 7, 8, model->y_v_im[freq_id],
-                    num_points, theta, phi, status);
+            y_surfaces[0] = model->y_h_re;
+            y_surfaces[1] = model->y_h_im;
+            y_surfaces[2] = model->y_v_re;
+            y_surfaces[3] = model->y_v_im;
+            evaluate_fitted(model, model->y_table, y_surfaces, 4, f,
+                    num_points, theta, phi, output, 4, 8, status);
 
             /* Convert from Ludwig-3 to spherical representation. */
             oskar_convert_ludwig3_to_theta_phi_components(output, 2, 4,
@@ -172,15 +264,10 @@ void oskar_element_evaluate(const oskar_Element* model, oskar_Mem* output,
         /* Check if scalar spline data present. */
         if (oskar_element_has_scalar_spline_data(model))
         {
-            /* Get the frequency index. */
-            freq_id = oskar_find_closest_match_d(frequency_hz,
-                    oskar_element_num_freq(model),
-                    oskar_element_freqs_hz_const(model));
-
-            oskar_splines_evaluate(output, 0, 2, model->scalar_re[freq_id],
-                    num_points, theta, phi, status);
-            oskar_splines_evaluate(output, 1, 2, model->scalar_im[freq_id],
-                    num_points, theta, phi, status);
+            scalar_surfaces[0] = model->scalar_re;
+            scalar_surfaces[1] = model->scalar_im;
+            evaluate_fitted(model, model->scalar_table, scalar_surfaces, 2, f,
+                    num_points, theta, phi, output, 0, 2, status);
         }
         else if (element_type == OSKAR_ELEMENT_TYPE_DIPOLE)
         {
@@ -207,6 +294,51 @@ void oskar_element_evaluate(const oskar_Element* model, oskar_Mem* output,
     }
 }
 
+/* Evaluates the fitted surfaces, interpolating in frequency if required.
+ * Each pair of surfaces holds the real and imaginary parts of a complex
+ * response, which is interpolated in amplitude and phase, so that the
+ * phase does not cut across a wrap between the two frequencies. */
+static void evaluate_fitted(const oskar_Element* model,
+        oskar_Mem* const* tables, oskar_Splines* const* const* surfaces,
+        int num_surfaces, FreqInterp* f, int num_points,
+        const oskar_Mem* theta, const oskar_Mem* phi, oskar_Mem* output,
+        int offset, int stride, int* status)
+{
+    size_t len;
+    evaluate_surfaces(model, tables, surfaces, num_surfaces, f->lo,
+            num_points, theta, phi, output, offset, stride, status);
+    if (f->lo == f->hi || *status) return;
+    len = (size_t)num_surfaces * num_points;
+    if (oskar_mem_length(f->work) < len)
+        oskar_mem_realloc(f->work, len, status);
+    evaluate_surfaces(model, tables, surfaces, num_surfaces, f->hi,
+            num_points, theta, phi, f->work, 0, num_surfaces, status);
+    oskar_interpolate_element_surfaces(num_points, num_surfaces / 2,
+            f->frac, f->work, output, offset, stride, status);
+}
+
+static void evaluate_surfaces(const oskar_Element* model,
+        oskar_Mem* const* tables, oskar_Splines* const* const* surfaces,
+        int num_surfaces, int freq_id, int num_points,
+        const oskar_Mem* theta, const oskar_Mem* phi, oskar_Mem* output,
+        int offset, int stride, int* status)
+{
+    int i;
+    if (use_table(tables[freq_id], output))
+    {
+        oskar_evaluate_element_table(tables[freq_id],
+                model->table_num_theta, model->table_num_phi,
+                model->table_interp, num_surfaces, num_points, theta, phi,
+                output, offset, stride, status);
+    }
+    else
+    {
+        for (i = 0; i < num_surfaces; ++i)
+            oskar_splines_evaluate(output, offset + i, stride,
+                    surfaces[i][freq_id], num_points, theta, phi, status);
+    }
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -54,6 +54,9 @@ void oskar_element_free(oskar_Element* data, int* status)
         oskar_splines_free(data->y_h_im[i], status);
         oskar_splines_free(data->scalar_re[i], status);
         oskar_splines_free(data->scalar_im[i], status);
+        oskar_mem_free(data->x_table[i], status);
+        oskar_mem_free(data->y_table[i], status);
+        oskar_mem_free(data->scalar_table[i], status);
     }
     free(data->freqs_hz);
     free(data->filename_x);
@@ -69,6 +72,9 @@ void oskar_element_free(oskar_Element* data, int* status)
     free(data->y_v_im);
     free(data->scalar_re);
     free(data->scalar_im);
+    free(data->x_table);
+    free(data->y_table);
+    free(data->scalar_table);
 
     /* Free the structure itself. */
     free(data);
@@ -70,6 +70,10 @@ void oskar_element_resize_freq_data(oskar_Element* model, int size,
             model->y_h_im[i] = oskar_splines_create(precision, loc, status);
             model->scalar_re[i] = oskar_splines_create(precision, loc, status);
             model->scalar_im[i] = oskar_splines_create(precision, loc, status);
+            model->x_table[i] = oskar_mem_create(precision, loc, 0, status);
+            model->y_table[i] = oskar_mem_create(precision, loc, 0, status);
+            model->scalar_table[i] = oskar_mem_create(precision, loc, 0,
+                    status);
         }
     }
     else if (size < old_size)
@@ -90,6 +94,9 @@ void oskar_element_resize_freq_data(oskar_Element* model, int size,
             oskar_splines_free(model->y_h_im[i], status);
             oskar_splines_free(model->scalar_re[i], status);
             oskar_splines_free(model->scalar_im[i], status);
+            oskar_mem_free(model->x_table[i], status);
+            oskar_mem_free(model->y_table[i], status);
+            oskar_mem_free(model->scalar_table[i], status);
         }
         realloc_arrays(model, size, status);
     }
@@ -133,6 +140,12 @@ static void realloc_arrays(oskar_Element* e, int size, int* status)
     if (!e->scalar_re) *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
     e->scalar_im = realloc(e->scalar_im, size * sizeof(oskar_Splines*));
     if (!e->scalar_im) *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+    e->x_table = realloc(e->x_table, size * sizeof(oskar_Mem*));
+    if (!e->x_table) *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+    e->y_table = realloc(e->y_table, size * sizeof(oskar_Mem*));
+    if (!e->y_table) *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+    e->scalar_table = realloc(e->scalar_table, size * sizeof(oskar_Mem*));
+    if (!e->scalar_table) *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
 }
 
 #ifdef __cplusplus
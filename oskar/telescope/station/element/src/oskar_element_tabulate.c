@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "telescope/station/element/private_element.h"
+#include "telescope/station/element/oskar_element.h"
+#include "telescope/station/element/oskar_evaluate_element_table.h"
+
+#include "math/oskar_cmath.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static void tabulate(oskar_Mem* table, int num_surfaces,
+        const oskar_Splines** splines, int num_theta, int num_phi,
+        int interp_type, const oskar_Mem* theta, const oskar_Mem* phi,
+        const oskar_Mem* theta_c, const oskar_Mem* phi_c, oskar_Mem* ref,
+        oskar_Mem* test, double* max_rel_error, int* status);
+
+void oskar_element_tabulate(oskar_Element* model, int num_theta, int num_phi,
+        int interp_type, double* max_rel_error, int* status)
+{
+    int i, j, k, type, num_points, num_cells;
+    double inc_theta, inc_phi, err = 0.0;
+    const oskar_Splines* splines[4];
+    oskar_Mem *theta, *phi, *theta_c, *phi_c, *ref, *test;
+
+    /* Check if safe to proceed. */
+    if (max_rel_error) *max_rel_error = 0.0;
+    if (*status) return;
+
+    /* Check the location. */
+    if (model->mem_location != OSKAR_CPU)
+    {
+        *status = OSKAR_ERR_BAD_LOCATION;
+        return;
+    }
+
+    /* Remove existing tables if required. */
+    if (num_theta <= 0 || num_phi <= 0)
+    {
+        for (i = 0; i < model->num_freq; ++i)
+        {
+            oskar_mem_realloc(model->x_table[i], 0, status);
+            oskar_mem_realloc(model->y_table[i], 0, status);
+            oskar_mem_realloc(model->scalar_table[i], 0, status);
+        }
+        model->table_num_theta = 0;
+        model->table_num_phi = 0;
+        return;
+    }
+
+    /* Check the parameters. */
+    if (num_phi % 2) num_phi++;
+    if (num_theta < 2 || (interp_type != OSKAR_ELEMENT_TABLE_BILINEAR &&
+            interp_type != OSKAR_ELEMENT_TABLE_BICUBIC))
+    {
+        *status = OSKAR_ERR_INVALID_ARGUMENT;
+        return;
+    }
+    model->table_num_theta = num_theta;
+    model->table_num_phi = num_phi;
+    model->table_interp = interp_type;
+
+    /* Generate the grid points, and the centres of the grid cells. */
+    type = model->precision;
+    num_points = num_theta * num_phi;
+    num_cells = (num_theta - 1) * num_phi;
+    inc_theta = M_PI / (num_theta - 1);
+    inc_phi = 2.0 * M_PI / num_phi;
+    theta = oskar_mem_create(type, OSKAR_CPU, num_points, status);
+    phi = oskar_mem_create(type, OSKAR_CPU, num_points, status);
+    theta_c = oskar_mem_create(type, OSKAR_CPU, num_cells, status);
+    phi_c = oskar_mem_create(type, OSKAR_CPU, num_cells, status);
+    ref = oskar_mem_create(type, OSKAR_CPU, 4 * num_cells, status);
+    test = oskar_mem_create(type, OSKAR_CPU, 4 * num_cells, status);
+    for (j = 0, k = 0; j < num_theta && !*status; ++j)
+    {
+        for (i = 0; i < num_phi; ++i, ++k)
+        {
+            oskar_mem_set_element_real(theta, k, j * inc_theta, status);
+            oskar_mem_set_element_real(phi, k, i * inc_phi, status);
+            if (j == num_theta - 1) continue;
+            oskar_mem_set_element_real(theta_c, k, (j + 0.5) * inc_theta,
+                    status);
+            oskar_mem_set_element_real(phi_c, k, (i + 0.5) * inc_phi, status);
+        }
+    }
+
+    /* Tabulate all surfaces at all frequencies. */
+    for (i = 0; i < model->num_freq; ++i)
+    {
+        splines[0] = model->x_h_re[i];
+        splines[1] = model->x_h_im[i];
+        splines[2] = model->x_v_re[i];
+        splines[3] = model->x_v_im[i];
+        tabulate(model->x_table[i], 4, splines, num_theta, num_phi,
+                interp_type, theta, phi, theta_c, phi_c, ref, test,
+                &err, status);
+        splines[0] = model->y_h_re[i];
+        splines[1] = model->y_h_im[i];
+        splines[2] = model->y_v_re[i];
+        splines[3] = model->y_v_im[i];
+        tabulate(model->y_table[i], 4, splines, num_theta, num_phi,
+                interp_type, theta, phi, theta_c, phi_c, ref, test,
+                &err, status);
+        splines[0] = model->scalar_re[i];
+        splines[1] = model->scalar_im[i];
+        tabulate(model->scalar_table[i], 2, splines, num_theta, num_phi,
+                interp_type, theta, phi, theta_c, phi_c, ref, test,
+                &err, status);
+    }
+    if (max_rel_error) *max_rel_error = err;
+
+    /* Free scratch arrays. */
+    oskar_mem_free(theta, status);
+    oskar_mem_free(phi, status);
+    oskar_mem_free(theta_c, status);
+    oskar_mem_free(phi_c, status);
+    oskar_mem_free(ref, status);
+    oskar_mem_free(test, status);
+}
+
+static void tabulate(oskar_Mem* table, int num_surfaces,
+        const oskar_Splines** splines, int num_theta, int num_phi,
+        int interp_type, const oskar_Mem* theta, const oskar_Mem* phi,
+        const oskar_Mem* theta_c, const oskar_Mem* phi_c, oskar_Mem* ref,
+        oskar_Mem* test, double* max_rel_error, int* status)
+{
+    int i, s, have_data = 0, num_points, num_cells;
+    double peak, diff, err;
+    if (*status) return;
+
+    /* Don't store a table if there are no surfaces. */
+    for (s = 0; s < num_surfaces; ++s)
+        if (oskar_splines_have_coeffs(splines[s])) have_data = 1;
+    if (!have_data)
+    {
+        oskar_mem_realloc(table, 0, status);
+        return;
+    }
+
+    /* Evaluate the splines at the grid points. */
+    num_points = num_theta * num_phi;
+    num_cells = (num_theta - 1) * num_phi;
+    oskar_mem_realloc(table, num_surfaces * num_points, status);
+    oskar_mem_clear_contents(table, status);
+    for (s = 0; s < num_surfaces; ++s)
+        oskar_splines_evaluate(table, s, num_surfaces, splines[s],
+                num_points, theta, phi, status);
+
+    /* Compare the splines and the interpolated table at the cell centres,
+     * where the interpolation error is expected to be largest. */
+    oskar_mem_clear_contents(ref, status);
+    for (s = 0; s < num_surfaces; ++s)
+        oskar_splines_evaluate(ref, s, num_surfaces, splines[s],
+                num_cells, theta_c, phi_c, status);
+    oskar_evaluate_element_table(table, num_theta, num_phi, interp_type,
+            num_surfaces, num_cells, theta_c, phi_c, test, 0, num_surfaces,
+            status);
+    if (*status) return;
+    for (s = 0; s < num_surfaces; ++s)
+    {
+        peak = 0.0;
+        err = 0.0;
+        for (i = 0; i < num_points; ++i)
+        {
+            diff = fabs(oskar_mem_get_element(table,
+                    i * num_surfaces + s, status));
+            if (diff > peak) peak = diff;
+        }
+        for (i = 0; i < num_cells; ++i)
+        {
+            diff = fabs(oskar_mem_get_element(ref, i * num_surfaces + s,
+                    status) - oskar_mem_get_element(test,
+                            i * num_surfaces + s, status));
+            if (diff > err) err = diff;
+        }
+        if (peak > 0.0 && err / peak > *max_rel_error)
+            *max_rel_error = err / peak;
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,275 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "telescope/station/element/oskar_evaluate_element_table.h"
+#include "telescope/station/element/oskar_element.h"
+
+#include "math/oskar_cmath.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static void cubic_weights_f(const float t, float w[4])
+{
+    /* Catmull-Rom cubic convolution kernel. */
+    w[0] = ((-0.5f * t + 1.0f) * t - 0.5f) * t;
+    w[1] = (1.5f * t - 2.5f) * t * t + 1.0f;
+    w[2] = ((-1.5f * t + 2.0f) * t + 0.5f) * t;
+    w[3] = (0.5f * t - 0.5f) * t * t;
+}
+
+static void cubic_weights_d(const double t, double w[4])
+{
+    /* Catmull-Rom cubic convolution kernel. */
+    w[0] = ((-0.5 * t + 1.0) * t - 0.5) * t;
+    w[1] = (1.5 * t - 2.5) * t * t + 1.0;
+    w[2] = ((-1.5 * t + 2.0) * t + 0.5) * t;
+    w[3] = (0.5 * t - 0.5) * t * t;
+}
+
+/* Single precision. */
+void oskar_evaluate_element_table_f(int num_theta, int num_phi,
+        int interp_type, int num_surfaces, const float* table,
+        int num_points, const float* theta, const float* phi, int stride,
+        float* output)
+{
+    int k;
+    const float inc_theta = (float) (M_PI / (num_theta - 1));
+    const float inc_phi = (float) (2.0 * M_PI / num_phi);
+    const int half_phi = num_phi / 2;
+#pragma omp parallel for private(k)
+    for (k = 0; k < num_points; ++k)
+    {
+        int a, b, i0, j0, s;
+        float u, v, wu[4], wv[4];
+        float* out = output + k * stride;
+
+        /* Find the grid cell containing the point. */
+        u = theta[k] / inc_theta;
+        v = phi[k] / inc_phi;
+        i0 = (int) floor(u);
+        j0 = (int) floor(v);
+        u -= i0;
+        v -= j0;
+        if (i0 < 0)
+        {
+            i0 = 0;
+            u = 0;
+        }
+        else if (i0 > num_theta - 2)
+        {
+            i0 = num_theta - 2;
+            u = 1;
+        }
+        j0 %= num_phi;
+        if (j0 < 0) j0 += num_phi;
+        for (s = 0; s < num_surfaces; ++s) out[s] = 0;
+
+        if (interp_type == OSKAR_ELEMENT_TABLE_BICUBIC)
+        {
+            cubic_weights_f(u, wu);
+            cubic_weights_f(v, wv);
+            for (a = 0; a < 4; ++a)
+            {
+                /* Rows beyond either pole continue on the opposite
+                 * meridian. */
+                int row = i0 - 1 + a, shift = 0;
+                if (row < 0)
+                {
+                    row = -row;
+                    shift = half_phi;
+                }
+                else if (row >= num_theta)
+                {
+                    row = 2 * (num_theta - 1) - row;
+                    shift = half_phi;
+                }
+                for (b = 0; b < 4; ++b)
+                {
+                    const int col = (j0 + num_phi - 1 + b + shift) % num_phi;
+                    const float w = wu[a] * wv[b];
+                    const float* p = table +
+                            (row * num_phi + col) * num_surfaces;
+                    for (s = 0; s < num_surfaces; ++s) out[s] += w * p[s];
+                }
+            }
+        }
+        else
+        {
+            const int j1 = (j0 + 1) % num_phi;
+            const float* p00 = table + (i0 * num_phi + j0) * num_surfaces;
+            const float* p01 = table + (i0 * num_phi + j1) * num_surfaces;
+            const float* p10 = p00 + num_phi * num_surfaces;
+            const float* p11 = p01 + num_phi * num_surfaces;
+            for (s = 0; s < num_surfaces; ++s)
+            {
+                out[s] = (1 - u) * ((1 - v) * p00[s] + v * p01[s]) +
+                        u * ((1 - v) * p10[s] + v * p11[s]);
+            }
+        }
+    }
+}
+
+/* Double precision. */
+void oskar_evaluate_element_table_d(int num_theta, int num_phi,
+        int interp_type, int num_surfaces, const double* table,
+        int num_points, const double* theta, const double* phi, int stride,
+        double* output)
+{
+    int k;
+    const double inc_theta = (double) (M_PI / (num_theta - 1));
+    const double inc_phi = (double) (2.0 * M_PI / num_phi);
+    const int half_phi = num_phi / 2;
+#pragma omp parallel for private(k)
+    for (k = 0; k < num_points; ++k)
+    {
+        int a, b, i0, j0, s;
+        double u, v, wu[4], wv[4];
+        double* out = output + k * stride;
+
+        /* Find the grid cell containing the point. */
+        u = theta[k] / inc_theta;
+        v = phi[k] / inc_phi;
+        i0 = (int) floor(u);
+        j0 = (int) floor(v);
+        u -= i0;
+        v -= j0;
+        if (i0 < 0)
+        {
+            i0 = 0;
+            u = 0;
+        }
+        else if (i0 > num_theta - 2)
+        {
+            i0 = num_theta - 2;
+            u = 1;
+        }
+        j0 %= num_phi;
+        if (j0 < 0) j0 += num_phi;
+        for (s = 0; s < num_surfaces; ++s) out[s] = 0;
+
+        if (interp_type == OSKAR_ELEMENT_TABLE_BICUBIC)
+        {
+            cubic_weights_d(u, wu);
+            cubic_weights_d(v, wv);
+            for (a = 0; a < 4; ++a)
+            {
+                /* Rows beyond either pole continue on the opposite
+                 * meridian. */
+                int row = i0 - 1 + a, shift = 0;
+                if (row < 0)
+                {
+                    row = -row;
+                    shift = half_phi;
+                }
+                else if (row >= num_theta)
+                {
+                    row = 2 * (num_theta - 1) - row;
+                    shift = half_phi;
+                }
+                for (b = 0; b < 4; ++b)
+                {
+                    const int col = (j0 + num_phi - 1 + b + shift) % num_phi;
+                    const double w = wu[a] * wv[b];
+                    const double* p = table +
+                            (row * num_phi + col) * num_surfaces;
+                    for (s = 0; s < num_surfaces; ++s) out[s] += w * p[s];
+                }
+            }
+        }
+        else
+        {
+            const int j1 = (j0 + 1) % num_phi;
+            const double* p00 = table + (i0 * num_phi + j0) * num_surfaces;
+            const double* p01 = table + (i0 * num_phi + j1) * num_surfaces;
+            const double* p10 = p00 + num_phi * num_surfaces;
+            const double* p11 = p01 + num_phi * num_surfaces;
+            for (s = 0; s < num_surfaces; ++s)
+            {
+                out[s] = (1 - u) * ((1 - v) * p00[s] + v * p01[s]) +
+                        u * ((1 - v) * p10[s] + v * p11[s]);
+            }
+        }
+    }
+}
+
+/* Wrapper. */
+void oskar_evaluate_element_table(const oskar_Mem* table, int num_theta,
+        int num_phi, int interp_type, int num_surfaces, int num_points,
+        const oskar_Mem* theta, const oskar_Mem* phi, oskar_Mem* output,
+        int offset, int stride, int* status)
+{
+    int type;
+
+    /* Check if safe to proceed. */
+    if (*status) return;
+
+    /* Check data types, location and dimensions. */
+    type = oskar_mem_type(table);
+    if (oskar_mem_type(theta) != type || oskar_mem_type(phi) != type ||
+            oskar_mem_precision(output) != type)
+    {
+        *status = OSKAR_ERR_TYPE_MISMATCH;
+        return;
+    }
+    if (oskar_mem_location(table) != OSKAR_CPU ||
+            oskar_mem_location(theta) != OSKAR_CPU ||
+            oskar_mem_location(phi) != OSKAR_CPU ||
+            oskar_mem_location(output) != OSKAR_CPU)
+    {
+        *status = OSKAR_ERR_BAD_LOCATION;
+        return;
+    }
+    if (num_theta < 2 || num_phi < 2 || num_phi % 2 != 0 ||
+            (int)oskar_mem_length(table) < num_theta * num_phi * num_surfaces)
+    {
+        *status = OSKAR_ERR_DIMENSION_MISMATCH;
+        return;
+    }
+
+    /* Interpolate the table. */
+    if (type == OSKAR_SINGLE)
+        oskar_evaluate_element_table_f(num_theta, num_phi, interp_type,
+                num_surfaces, oskar_mem_float_const(table, status),
+                num_points, oskar_mem_float_const(theta, status),
+                oskar_mem_float_const(phi, status), stride,
+                oskar_mem_float(output, status) + offset);
+    else if (type == OSKAR_DOUBLE)
+        oskar_evaluate_element_table_d(num_theta, num_phi, interp_type,
+                num_surfaces, oskar_mem_double_const(table, status),
+                num_points, oskar_mem_double_const(theta, status),
+                oskar_mem_double_const(phi, status), stride,
+                oskar_mem_double(output, status) + offset);
+    else
+        *status = OSKAR_ERR_BAD_DATA_TYPE;
+}
+
+#ifdef __cplusplus
+}
+#endif
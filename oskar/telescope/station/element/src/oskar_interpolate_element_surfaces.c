@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "telescope/station/element/oskar_interpolate_element_surfaces.h"
+#include "telescope/station/element/oskar_interpolate_element_surfaces_cuda.h"
+#include "telescope/station/element/oskar_interpolate_element_surfaces_inline.h"
+#include "utility/oskar_device_utils.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Single precision. */
+void oskar_interpolate_element_surfaces_f(int num_points, int num_pairs,
+        float frac, const float* upper, float* output, int stride)
+{
+    int i;
+#pragma omp parallel for private(i)
+    for (i = 0; i < num_points; ++i)
+    {
+        int k;
+        for (k = 0; k < num_pairs; ++k)
+            oskar_interpolate_element_surfaces_inline_f(
+                    output + (size_t)i * stride + 2 * k,
+                    upper + ((size_t)i * num_pairs + k) * 2, frac);
+    }
+}
+
+/* Double precision. */
+void oskar_interpolate_element_surfaces_d(int num_points, int num_pairs,
+        double frac, const double* upper, double* output, int stride)
+{
+    int i;
+#pragma omp parallel for private(i)
+    for (i = 0; i < num_points; ++i)
+    {
+        int k;
+        for (k = 0; k < num_pairs; ++k)
+            oskar_interpolate_element_surfaces_inline_d(
+                    output + (size_t)i * stride + 2 * k,
+                    upper + ((size_t)i * num_pairs + k) * 2, frac);
+    }
+}
+
+/* Wrapper. */
+void oskar_interpolate_element_surfaces(int num_points, int num_pairs,
+        double frac, const oskar_Mem* upper, oskar_Mem* output, int offset,
+        int stride, int* status)
+{
+    int precision, location;
+
+    /* Check if safe to proceed. */
+    if (*status) return;
+
+    /* Get the meta-data. */
+    precision = oskar_mem_precision(output);
+    location = oskar_mem_location(output);
+
+    /* Check arrays are co-located. */
+    if (oskar_mem_location(upper) != location)
+    {
+        *status = OSKAR_ERR_LOCATION_MISMATCH;
+        return;
+    }
+
+    /* Check types for consistency. */
+    if (oskar_mem_precision(upper) != precision)
+    {
+        *status = OSKAR_ERR_TYPE_MISMATCH;
+        return;
+    }
+
+    /* Check precision. */
+    if (precision == OSKAR_SINGLE)
+    {
+        const float* upper_ = oskar_mem_float_const(upper, status);
+        float* output_ = oskar_mem_float(output, status) + offset;
+        if (location == OSKAR_GPU)
+        {
+#ifdef OSKAR_HAVE_CUDA
+            oskar_interpolate_element_surfaces_cuda_f(num_points, num_pairs,
+                    (float)frac, upper_, output_, stride);
+            oskar_device_check_error(status);
+#else
+            *status = OSKAR_ERR_CUDA_NOT_AVAILABLE;
+#endif
+        }
+        else if (location == OSKAR_CPU)
+            oskar_interpolate_element_surfaces_f(num_points, num_pairs,
+                    (float)frac, upper_, output_, stride);
+        else
+            *status = OSKAR_ERR_BAD_LOCATION;
+    }
+    else if (precision == OSKAR_DOUBLE)
+    {
+        const double* upper_ = oskar_mem_double_const(upper, status);
+        double* output_ = oskar_mem_double(output, status) + offset;
+        if (location == OSKAR_GPU)
+        {
+#ifdef OSKAR_HAVE_CUDA
+            oskar_interpolate_element_surfaces_cuda_d(num_points, num_pairs,
+                    frac, upper_, output_, stride);
+            oskar_device_check_error(status);
+#else
+            *status = OSKAR_ERR_CUDA_NOT_AVAILABLE;
+#endif
+        }
+        else if (location == OSKAR_CPU)
+            oskar_interpolate_element_surfaces_d(num_points, num_pairs,
+                    frac, upper_, output_, stride);
+        else
+            *status = OSKAR_ERR_BAD_LOCATION;
+    }
+    else
+        *status = OSKAR_ERR_BAD_DATA_TYPE;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "telescope/station/element/oskar_interpolate_element_surfaces_cuda.h"
+#include "telescope/station/element/oskar_interpolate_element_surfaces_inline.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Kernel wrappers. ======================================================== */
+
+void oskar_interpolate_element_surfaces_cuda_f(int num_points, int num_pairs,
+        float frac, const float* d_upper, float* d_output, int stride)
+{
+    int num_blocks, num_threads = 256;
+    num_blocks = (num_points + num_threads - 1) / num_threads;
+    oskar_interpolate_element_surfaces_cudak_f
+    OSKAR_CUDAK_CONF(num_blocks, num_threads) (num_points, num_pairs, frac,
+            d_upper, d_output, stride);
+}
+
+void oskar_interpolate_element_surfaces_cuda_d(int num_points, int num_pairs,
+        double frac, const double* d_upper, double* d_output, int stride)
+{
+    int num_blocks, num_threads = 256;
+    num_blocks = (num_points + num_threads - 1) / num_threads;
+    oskar_interpolate_element_surfaces_cudak_d
+    OSKAR_CUDAK_CONF(num_blocks, num_threads) (num_points, num_pairs, frac,
+            d_upper, d_output, stride);
+}
+
+
+/* Kernels. ================================================================ */
+
+/* Single precision. */
+__global__
+void oskar_interpolate_element_surfaces_cudak_f(const int num_points,
+        const int num_pairs, const float frac, const float* upper,
+        float* output, const int stride)
+{
+    int k;
+
+    /* Point index being processed by thread. */
+    const int i = blockIdx.x * blockDim.x + threadIdx.x;
+    if (i >= num_points) return;
+
+    for (k = 0; k < num_pairs; ++k)
+        oskar_interpolate_element_surfaces_inline_f(
+                output + (size_t)i * stride + 2 * k,
+                upper + ((size_t)i * num_pairs + k) * 2, frac);
+}
+
+/* Double precision. */
+__global__
+void oskar_interpolate_element_surfaces_cudak_d(const int num_points,
+        const int num_pairs, const double frac, const double* upper,
+        double* output, const int stride)
+{
+    int k;
+
+    /* Point index being processed by thread. */
+    const int i = blockIdx.x * blockDim.x + threadIdx.x;
+    if (i >= num_points) return;
+
+    for (k = 0; k < num_pairs; ++k)
+        oskar_interpolate_element_surfaces_inline_d(
+                output + (size_t)i * stride + 2 * k,
+                upper + ((size_t)i * num_pairs + k) * 2, frac);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OSKAR_EVALUATE_ARRAY_PATTERN_FFT_H_
+#define OSKAR_EVALUATE_ARRAY_PATTERN_FFT_H_
+
+/**
+ * @file oskar_evaluate_array_pattern_fft.h
+ */
+
+#include <oskar_global.h>
+#include <telescope/station/oskar_station.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief
+ * Evaluates the array pattern of a lattice station using an FFT.
+ *
+ * @details
+ * If the elements of a planar station lie on a regular lattice (as found by
+ * oskar_station_analyse()), the array pattern is a 2D Fourier series in the
+ * projections of the direction onto the lattice basis vectors. This function
+ * evaluates it using a non-uniform FFT: the beamforming weights are placed
+ * on a zero-padded grid, which is transformed using an FFT and then
+ * interpolated to each direction using a Gaussian kernel.
+ *
+ * The width of the interpolation kernel is chosen to meet the tolerance set
+ * using oskar_station_set_array_fft_tolerance(), and the result is checked
+ * against a direct DFT at a subset of the directions. The search starts
+ * from the kernel width found by oskar_evaluate_array_pattern_fft_analyse().
+ *
+ * The function returns false without evaluating the array pattern if the
+ * FFT is not enabled, if the station is not a planar lattice, if the data
+ * are not in CPU memory, if a direct DFT would be faster, or if the
+ * tolerance cannot be met (including when this was found at analysis).
+ * In this case, the caller should use oskar_dftw() instead.
+ *
+ * @param[in] station       Pointer to station model.
+ * @param[in] wavenumber    Wavenumber (2 pi / wavelength).
+ * @param[in] weights       Complex beamforming weights for each element.
+ * @param[in] num_points    Number of directions.
+ * @param[in] x             Direction cosines, horizontal x-component.
+ * @param[in] y             Direction cosines, horizontal y-component.
+ * @param[out] pattern      Complex array pattern for each direction.
+ * @param[in,out] status    Status return code.
+ *
+ * @return True if the array pattern was evaluated.
+ */
+OSKAR_EXPORT
+int oskar_evaluate_array_pattern_fft(const oskar_Station* station,
+        double wavenumber, const oskar_Mem* weights, int num_points,
+        const oskar_Mem* x, const oskar_Mem* y, oskar_Mem* pattern,
+        int* status);
+
+/**
+ * @brief
+ * Finds the FFT interpolation kernel width for a lattice station.
+ *
+ * @details
+ * Finds the narrowest interpolation kernel that meets the FFT tolerance
+ * for unit weights, and stores it in the station model. If the tolerance
+ * cannot be met, this is recorded instead, so that
+ * oskar_evaluate_array_pattern_fft() returns false straight away.
+ *
+ * This is called by oskar_station_analyse().
+ *
+ * @param[in,out] station   Pointer to station model.
+ * @param[in,out] status    Status return code.
+ */
+OSKAR_EXPORT
+void oskar_evaluate_array_pattern_fft_analyse(oskar_Station* station,
+        int* status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OSKAR_EVALUATE_ARRAY_PATTERN_FFT_H_ */
@@ -71,6 +71,38 @@ void oskar_evaluate_element_weights(oskar_Mem* weights,
         const oskar_Station* station, double x_beam, double y_beam,
         double z_beam, int time_index, int* status);
 
+/**
+ * @brief
+ * Evaluates element beamforming weights for the station, using
+ * pre-computed element errors.
+ *
+ * @details
+ * This function is the same as oskar_evaluate_element_weights(), except
+ * that the time-variable element errors can be supplied by the caller
+ * (for example, from the cache filled by
+ * oskar_station_work_evaluate_element_errors()).
+ * If \p element_errors is NULL, the errors are generated in
+ * \p weights_error as usual.
+ *
+ * @param[in,out] weights       Output array of beamforming weights.
+ * @param[in,out] weights_error Work array, for calculating the weights error.
+ * @param[in] wavenumber        Wavenumber (2 pi / wavelength).
+ * @param[in] station           Pointer to station model.
+ * @param[in] x_beam            Beam direction cosine, horizontal x-component.
+ * @param[in] y_beam            Beam direction cosine, horizontal y-component.
+ * @param[in] z_beam            Beam direction cosine, horizontal z-component.
+ * @param[in] time_index        Time index of simulation.
+ * @param[in] element_errors    Pre-computed element errors for the station
+ *                              at this time, or NULL to generate them.
+ * @param[in,out] status        Status return code.
+ */
+OSKAR_EXPORT
+void oskar_evaluate_element_weights_with_errors(oskar_Mem* weights,
+        oskar_Mem* weights_error, double wavenumber,
+        const oskar_Station* station, double x_beam, double y_beam,
+        double z_beam, int time_index, const oskar_Mem* element_errors,
+        int* status);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OSKAR_EVALUATE_ELEMENT_WEIGHTS_ERRORS_BLOCK_H_
+#define OSKAR_EVALUATE_ELEMENT_WEIGHTS_ERRORS_BLOCK_H_
+
+/**
+ * @file oskar_evaluate_element_weights_errors_block.h
+ */
+
+#include <oskar_global.h>
+#include <telescope/station/oskar_station.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief
+ * Evaluates element weights errors for a set of stations and times.
+ *
+ * @details
+ * Evaluates the element weights errors for all elements of all the given
+ * stations, for a block of consecutive time indices, in a single
+ * parallel pass.
+ *
+ * The random numbers are generated using the same counters as
+ * oskar_evaluate_element_weights_errors(), so the errors for each station
+ * and time are identical to those obtained by calling that function
+ * separately for each one.
+ *
+ * Errors for station \p k at time index (\p time_index_start + \p t)
+ * are written to the output array starting at element
+ * (\p t * \p offsets[\p num_stations] + \p offsets[\p k]).
+ * The output array is resized if necessary.
+ *
+ * Only arrays in CPU memory are currently supported.
+ *
+ * @param[in] num_stations     Number of stations.
+ * @param[in] stations         Array of pointers to the stations.
+ * @param[in] offsets          Start of each station within a time slice
+ *                             (length \p num_stations + 1).
+ * @param[in] time_index_start First simulation time index of the block.
+ * @param[in] num_times        Number of time indices in the block.
+ * @param[out] errors          Complex element errors for the block.
+ * @param[in,out] status       Status return code.
+ */
+OSKAR_EXPORT
+void oskar_evaluate_element_weights_errors_block(int num_stations,
+        const oskar_Station* const* stations, const int* offsets,
+        int time_index_start, int num_times, oskar_Mem* errors, int* status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OSKAR_EVALUATE_ELEMENT_WEIGHTS_ERRORS_BLOCK_H_ */
@@ -140,6 +140,11 @@ double oskar_station_gaussian_beam_reference_freq_hz(const oskar_Station* model)
 OSKAR_EXPORT
 int oskar_station_identical_children(const oskar_Station* model);
 
+/* Returns NULL if child stations have not been analysed. */
+OSKAR_EXPORT
+const int* oskar_station_equivalent_children_cpu_const(
+        const oskar_Station* model);
+
 OSKAR_EXPORT
 int oskar_station_num_elements(const oskar_Station* model);
 
@@ -158,6 +163,15 @@ int oskar_station_common_element_orientation(const oskar_Station* model);
 OSKAR_EXPORT
 int oskar_station_array_is_3d(const oskar_Station* model);
 
+OSKAR_EXPORT
+int oskar_station_array_is_lattice(const oskar_Station* model);
+
+OSKAR_EXPORT
+int oskar_station_enable_array_fft(const oskar_Station* model);
+
+OSKAR_EXPORT
+double oskar_station_array_fft_tolerance(const oskar_Station* model);
+
 OSKAR_EXPORT
 int oskar_station_apply_element_errors(const oskar_Station* model);
 
@@ -167,6 +181,23 @@ int oskar_station_apply_element_weight(const oskar_Station* model);
 OSKAR_EXPORT
 unsigned int oskar_station_seed_time_variable_errors(const oskar_Station* model);
 
+/**
+ * @brief
+ * Returns the generation number of the station model.
+ *
+ * @details
+ * Returns a value that is unique to this station model, and which changes
+ * whenever the station is created or its element gains, phases or errors
+ * are modified. Element errors cached for the station can be checked
+ * against it.
+ *
+ * @param[in] model   Pointer to station model.
+ *
+ * @return The generation number (never zero).
+ */
+OSKAR_EXPORT
+unsigned int oskar_station_generation(const oskar_Station* model);
+
 OSKAR_EXPORT
 double oskar_station_element_x_alpha_rad(const oskar_Station* model,
         int index);
@@ -450,6 +481,39 @@ void oskar_station_set_normalise_array_pattern(oskar_Station* model, int value);
 OSKAR_EXPORT
 void oskar_station_set_enable_array_pattern(oskar_Station* model, int value);
 
+/**
+ * @brief
+ * Sets the flag to specify whether an FFT may be used for the array pattern.
+ *
+ * @details
+ * Sets the flag to specify whether the array pattern of a station with
+ * elements on a regular lattice may be evaluated using an FFT instead of
+ * a direct DFT (default false). The FFT is used only if it is expected to
+ * be faster, and if it meets the tolerance set using
+ * oskar_station_set_array_fft_tolerance().
+ *
+ * @param[in] model  Pointer to station model.
+ * @param[in] value  True or false.
+ */
+OSKAR_EXPORT
+void oskar_station_set_enable_array_fft(oskar_Station* model, int value);
+
+/**
+ * @brief
+ * Sets the tolerance used when evaluating the array pattern using an FFT.
+ *
+ * @details
+ * Sets the maximum error of the array pattern evaluated using an FFT,
+ * relative to the sum of the magnitudes of the beamforming weights,
+ * which is the largest possible value of the array pattern (default 1e-6).
+ *
+ * @param[in] model  Pointer to station model.
+ * @param[in] value  Relative tolerance.
+ */
+OSKAR_EXPORT
+void oskar_station_set_array_fft_tolerance(oskar_Station* model,
+        double value);
+
 /**
  * @brief
  * Sets the seed used to generate time-variable errors.
@@ -461,6 +525,20 @@ OSKAR_EXPORT
 void oskar_station_set_seed_time_variable_errors(oskar_Station* model,
         unsigned int value);
 
+/**
+ * @brief
+ * Gives the station model a new generation number.
+ *
+ * @details
+ * Gives the station model a new generation number, so that any element
+ * errors cached against the old one are recomputed. This is called by
+ * the functions that modify the element gains, phases and errors.
+ *
+ * @param[in] model   Pointer to station model.
+ */
+OSKAR_EXPORT
+void oskar_station_update_generation(oskar_Station* model);
+
 #ifdef __cplusplus
 }
 #endif
@@ -46,6 +46,18 @@ struct oskar_StationWork;
 typedef struct oskar_StationWork oskar_StationWork;
 #endif /* OSKAR_STATION_WORK_TYPEDEF_ */
 
+struct oskar_Station;
+#ifndef OSKAR_STATION_TYPEDEF_
+#define OSKAR_STATION_TYPEDEF_
+typedef struct oskar_Station oskar_Station;
+#endif /* OSKAR_STATION_TYPEDEF_ */
+
+struct oskar_Telescope;
+#ifndef OSKAR_TELESCOPE_TYPEDEF_
+#define OSKAR_TELESCOPE_TYPEDEF_
+typedef struct oskar_Telescope oskar_Telescope;
+#endif /* OSKAR_TELESCOPE_TYPEDEF_ */
+
 /**
  * @brief Creates a station work buffer structure.
  *
@@ -96,10 +108,124 @@ OSKAR_EXPORT
 oskar_Mem* oskar_station_work_normalised_beam(oskar_StationWork* work,
         const oskar_Mem* output_beam, int* status);
 
+OSKAR_EXPORT
+oskar_Mem* oskar_station_work_visible_beam(oskar_StationWork* work,
+        const oskar_Mem* output_beam, size_t length, int* status);
+
 OSKAR_EXPORT
 oskar_Mem* oskar_station_work_beam(oskar_StationWork* work,
         const oskar_Mem* output_beam, size_t length, int depth, int* status);
 
+/**
+ * @brief Returns a pool of work buffer structures, one for each thread.
+ *
+ * @details
+ * Station beams can only be evaluated concurrently if each thread has its
+ * own work buffers. This function returns an array of \p num_threads
+ * work buffer structures, which are owned by \p work and freed with it.
+ * The first element of the array is \p work itself.
+ *
+ * The pool is enlarged if required, so this function must not itself be
+ * called from more than one thread at once.
+ *
+ * @param[in,out] work        Work buffer structure that owns the pool.
+ * @param[in]     num_threads Number of threads that will use the pool.
+ * @param[in,out] status      Status return code.
+ */
+OSKAR_EXPORT
+oskar_StationWork** oskar_station_work_thread_pool(oskar_StationWork* work,
+        int num_threads, int* status);
+
+/**
+ * @brief Sets the memory limit for hierarchical station beam evaluation.
+ *
+ * @details
+ * Aperture array station beams are evaluated in chunks of directions, using
+ * work buffers whose size is proportional to the number of directions
+ * in a chunk and to the number of elements at each level of the station.
+ * If this limit is set, the chunk size is chosen so that these buffers
+ * use no more than approximately \p max_bytes. If zero (the default),
+ * a fixed chunk size is used for hierarchical stations.
+ *
+ * The limit also applies to each work structure in the thread pool.
+ * While the buffers use more than the limit, each one is shrunk to the
+ * size needed when it is next requested.
+ *
+ * @param[in,out] work      Work buffer structure.
+ * @param[in]     max_bytes Memory limit in bytes, or 0 for no limit.
+ */
+OSKAR_EXPORT
+void oskar_station_work_set_max_memory(oskar_StationWork* work,
+        size_t max_bytes);
+
+/**
+ * @brief Returns the memory limit for hierarchical station beam evaluation.
+ *
+ * @param[in] work Work buffer structure.
+ */
+OSKAR_EXPORT
+size_t oskar_station_work_max_memory(const oskar_StationWork* work);
+
+/**
+ * @brief Returns the peak memory used by the work buffers, in bytes.
+ *
+ * @details
+ * This includes the work buffers of all threads in the thread pool.
+ *
+ * @param[in] work Work buffer structure.
+ */
+OSKAR_EXPORT
+size_t oskar_station_work_memory_peak(const oskar_StationWork* work);
+
+/**
+ * @brief Evaluates and caches element errors for a block of times.
+ *
+ * @details
+ * Evaluates the time-variable element gain and phase errors for all
+ * stations (including child stations) in the telescope model that apply
+ * them, for \p num_times time indices starting at \p time_index_start.
+ * The errors are generated in a single parallel pass, and are cached so
+ * that beams for all channels in the block can reuse them.
+ * The cache is not regenerated if it already holds all the requested
+ * times for the same generation of the telescope model
+ * (see oskar_telescope_generation()), and none of its stations has been
+ * modified since (see oskar_station_generation()).
+ *
+ * The cache is shared by all work structures in the thread pool, so
+ * this function must be called before beams are evaluated concurrently.
+ * It has no effect unless the work buffers are in CPU memory: otherwise
+ * the errors are generated separately for each station as required.
+ *
+ * @param[in,out] work             Work buffer structure.
+ * @param[in]     tel              Telescope model.
+ * @param[in]     time_index_start First simulation time index of the block.
+ * @param[in]     num_times        Number of time indices in the block.
+ * @param[in,out] status           Status return code.
+ */
+OSKAR_EXPORT
+void oskar_station_work_evaluate_element_errors(oskar_StationWork* work,
+        const oskar_Telescope* tel, int time_index_start, int num_times,
+        int* status);
+
+/**
+ * @brief Returns cached element errors for a station, if available.
+ *
+ * @details
+ * Returns the complex element errors for the station at the given time
+ * index, if they are held in the cache filled by
+ * oskar_station_work_evaluate_element_errors(), or NULL otherwise.
+ * The returned array is valid until the next call to this function
+ * using the same work structure.
+ *
+ * @param[in,out] work       Work buffer structure.
+ * @param[in]     station    Station model.
+ * @param[in]     time_index Simulation time index.
+ * @param[in,out] status     Status return code.
+ */
+OSKAR_EXPORT
+const oskar_Mem* oskar_station_work_element_errors(oskar_StationWork* work,
+        const oskar_Station* station, int time_index, int* status);
+
 #ifdef __cplusplus
 }
 #endif
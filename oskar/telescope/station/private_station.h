@@ -75,7 +75,15 @@ struct oskar_Station
     int array_is_3d;              /* True if array is 3-dimensional (auto determined; default false). */
     int apply_element_errors;     /* True if element gain and phase errors should be applied (auto determined; default false). */
     int apply_element_weight;     /* True if weights should be modified by user-supplied complex beamforming weights (auto determined; default false). */
+    int array_is_lattice;         /* True if elements lie on a regular 2D lattice (auto determined; default false). */
+    int lattice_size[2];          /* Number of lattice points along each basis vector (auto determined). */
+    double lattice_origin[2];     /* Horizon coordinates of lattice point (0, 0), in metres (auto determined). */
+    double lattice_basis[4];      /* Lattice basis vectors (a_x, a_y, b_x, b_y), in metres (auto determined). */
+    int enable_array_fft;         /* True if an FFT may be used to evaluate the array pattern of a lattice station (default false). */
+    double array_fft_tolerance;   /* Maximum error of the array pattern if evaluated using an FFT, relative to the sum of weight magnitudes. */
+    int array_fft_spread;         /* FFT kernel half-width that met the tolerance (auto determined; 0 if unknown, -1 if not possible). */
     unsigned int seed_time_variable_errors;   /* Seed for time variable errors. */
+    unsigned int generation;      /* Unique value, changed whenever the element errors are modified. */
     oskar_Mem* element_true_x_enu_metres;     /* True horizon element x-coordinates, in metres, towards East. */
     oskar_Mem* element_true_y_enu_metres;     /* True horizon element y-coordinates, in metres, towards North. */
     oskar_Mem* element_true_z_enu_metres;     /* True horizon element z-coordinates, in metres, towards the zenith. */
@@ -97,6 +105,7 @@ struct oskar_Station
     oskar_Mem* element_y_beta_cpu;  /* Y element Euler angle orientation, guaranteed to be in CPU memory. */
     oskar_Mem* element_y_gamma_cpu; /* Y element Euler angle orientation, guaranteed to be in CPU memory. */
     oskar_Station** child;        /* Array of child station handles (pointer is NULL if none). */
+    oskar_Mem* equivalent_child_cpu; /* Index of the first equivalent child station, per child station (auto determined). */
     oskar_Element** element;      /* Array of element models per element type (pointer is NULL if there are child stations). */
 
     /* Data used only for aperture array stations with fixed beams. */
@@ -35,13 +35,20 @@ struct oskar_StationWork
 {
     oskar_Mem* horizon_mask;     /* Integer. */
     oskar_Mem* source_indices;   /* Integer. */
+    oskar_Mem* child_rows;       /* Integer. Signal row for each child. */
 
     oskar_Mem* enu_direction_x;  /* Real scalar. ENU direction cosine. */
     oskar_Mem* enu_direction_y;  /* Real scalar. ENU direction cosine. */
     oskar_Mem* enu_direction_z;  /* Real scalar. ENU direction cosine. */
 
+    oskar_Mem* visible_x;        /* Real scalar. Directions above horizon. */
+    oskar_Mem* visible_y;        /* Real scalar. Directions above horizon. */
+    oskar_Mem* visible_z;        /* Real scalar. Directions above horizon. */
+    oskar_Mem* visible_beam;     /* Beam for directions above horizon. */
+
     oskar_Mem* theta_modified;   /* Real scalar. */
     oskar_Mem* phi_modified;     /* Real scalar. */
+    oskar_Mem* element_interp;   /* Real scalar. Element frequency interp. */
     oskar_Mem* weights;          /* Complex scalar. */
     oskar_Mem* weights_error;    /* Complex scalar. */
     oskar_Mem* array_pattern;    /* Complex scalar. */
@@ -49,6 +56,23 @@ struct oskar_StationWork
 
     int num_depths;
     oskar_Mem** beam;            /* For hierarchical stations. */
+    size_t max_bytes;            /* Limit on beam work memory (0 if none). */
+    size_t peak_bytes;           /* Peak memory used by work buffers. */
+
+    /* Element errors for a block of times, shared with the thread pool. */
+    oskar_Mem* element_errors;   /* Complex scalar. */
+    oskar_Mem* element_errors_station; /* Alias into cache for one station. */
+    unsigned int element_errors_generation; /* Telescope generation in the cache. */
+    unsigned int element_errors_station_generation; /* Latest station generation in the cache. */
+    const void** element_errors_ptr; /* Station for each unique ID. */
+    int* element_errors_offset;  /* Offset for each unique ID. */
+    int element_errors_num_ids, element_errors_num_per_time;
+    int element_errors_time_start, element_errors_num_times;
+    struct oskar_StationWork* parent; /* Owner of the pool, or NULL. */
+
+    int type, location;
+    int num_threads;
+    struct oskar_StationWork** thread_work; /* Per-thread (0 is this one). */
 };
 
 #ifndef OSKAR_STATION_WORK_TYPEDEF_
@@ -0,0 +1,428 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "telescope/station/private_station.h"
+#include "telescope/station/oskar_evaluate_array_pattern_fft.h"
+
+#include "math/oskar_cmath.h"
+#include "math/oskar_fftpack_cfft.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Maximum half-width of the interpolation kernel, in grid cells. */
+#define MAX_SPREAD 16
+
+/* Number of directions used to check the result against a direct DFT. */
+#define NUM_CHECK 32
+
+/* Grid oversampling factor. */
+#define OVERSAMPLE 2
+
+struct Grid
+{
+    int size[2];       /* Grid dimensions. */
+    int spread;        /* Half-width of the interpolation kernel. */
+    double scale[2];   /* Exponent scale of the kernel, per grid cell. */
+    double tau[2];     /* Gaussian kernel parameter. */
+    double* data;      /* Transformed grid. */
+};
+typedef struct Grid Grid;
+
+/* Returns the projection of a direction onto the lattice basis vectors,
+ * and the phase at the grid origin. */
+static void lattice_coords(const oskar_Station* s, double wavenumber,
+        double l, double m, double* u, double* v, double* phase)
+{
+    const int n0 = s->lattice_size[0] / 2, n1 = s->lattice_size[1] / 2;
+    *u = wavenumber * (s->lattice_basis[0] * l + s->lattice_basis[1] * m);
+    *v = wavenumber * (s->lattice_basis[2] * l + s->lattice_basis[3] * m);
+    *phase = wavenumber * (s->lattice_origin[0] * l +
+            s->lattice_origin[1] * m) + n0 * (*u) + n1 * (*v);
+}
+
+/* Evaluates one kernel dimension. Returns the first grid index. */
+static int kernel(const Grid* g, int dim, double u, double* k)
+{
+    int j, start;
+    double t;
+    const int n = g->size[dim];
+
+    /* Get the position in grid cells, in the range [0, n). */
+    t = fmod(u * n / (2.0 * M_PI), (double) n);
+    if (t < 0.0) t += n;
+    start = (int) floor(t) - g->spread + 1;
+    for (j = 0; j < 2 * g->spread; ++j)
+    {
+        const double d = t - (start + j);
+        k[j] = exp(-g->scale[dim] * d * d);
+    }
+    return start;
+}
+
+/* Interpolates the transformed grid to one direction. */
+static void interpolate(const oskar_Station* s, const Grid* g,
+        double wavenumber, double l, double m, double* re, double* im)
+{
+    int i, j, start[2];
+    double u, v, phase, sum_re = 0.0, sum_im = 0.0;
+    double k0[2 * MAX_SPREAD], k1[2 * MAX_SPREAD];
+
+    /* Directions that are not finite (e.g. outside an image) are zero. */
+    *re = *im = 0.0;
+    lattice_coords(s, wavenumber, l, m, &u, &v, &phase);
+    if (!(fabs(u) < 1e15 && fabs(v) < 1e15)) return;
+    start[0] = kernel(g, 0, u, k0);
+    start[1] = kernel(g, 1, v, k1);
+    for (j = 0; j < 2 * g->spread; ++j)
+    {
+        double row_re = 0.0, row_im = 0.0;
+        int q = (start[1] + j) % g->size[1];
+        if (q < 0) q += g->size[1];
+        for (i = 0; i < 2 * g->spread; ++i)
+        {
+            int p = (start[0] + i) % g->size[0];
+            if (p < 0) p += g->size[0];
+            p = 2 * (q * g->size[0] + p);
+            row_re += k0[i] * g->data[p];
+            row_im += k0[i] * g->data[p + 1];
+        }
+        sum_re += k1[j] * row_re;
+        sum_im += k1[j] * row_im;
+    }
+
+    /* Apply the phase at the grid origin. */
+    *re = sum_re * cos(phase) - sum_im * sin(phase);
+    *im = sum_re * sin(phase) + sum_im * cos(phase);
+}
+
+/* Fills the grid with deconvolved weights, and transforms it. */
+static void grid_weights(const oskar_Station* s, Grid* g,
+        const double* x, const double* y, const double* w, int* status)
+{
+    int i, d, num_cells, len;
+    double det, *wsave, *work;
+    const double* b = s->lattice_basis;
+    const int n[2] = {s->lattice_size[0] / 2, s->lattice_size[1] / 2};
+
+    /* Set the Gaussian kernel parameters for each dimension. */
+    for (d = 0; d < 2; ++d)
+    {
+        const double n = (double) s->lattice_size[d];
+        const double r = g->size[d] / n;
+        g->tau[d] = M_PI * g->spread / (n * n * r * (r - 0.5));
+        g->scale[d] = M_PI * (r - 0.5) / (r * g->spread);
+    }
+
+    /* Add each deconvolved weight to the grid. */
+    num_cells = g->size[0] * g->size[1];
+    for (i = 0; i < 2 * num_cells; ++i) g->data[i] = 0.0;
+    det = b[0] * b[3] - b[1] * b[2];
+    for (i = 0; i < s->num_elements; ++i)
+    {
+        int idx[2];
+        double f;
+        const double dx = x[i] - s->lattice_origin[0];
+        const double dy = y[i] - s->lattice_origin[1];
+        idx[0] = (int) floor((dx * b[3] - dy * b[2]) / det + 0.5) - n[0];
+        idx[1] = (int) floor((b[0] * dy - b[1] * dx) / det + 0.5) - n[1];
+        f = 1.0;
+        for (d = 0; d < 2; ++d)
+        {
+            f *= sqrt(M_PI / g->tau[d]) / g->size[d] *
+                    exp(idx[d] * idx[d] * g->tau[d]);
+            if (idx[d] < 0) idx[d] += g->size[d];
+        }
+        idx[0] = 2 * (idx[1] * g->size[0] + idx[0]);
+        g->data[idx[0]]     += f * w[2 * i];
+        g->data[idx[0] + 1] += f * w[2 * i + 1];
+    }
+
+    /* Transform the grid. */
+    len = 2 * (g->size[0] + g->size[1]) + 8 +
+            (int)(log((double) g->size[0]) / log(2.0)) +
+            (int)(log((double) g->size[1]) / log(2.0));
+    wsave = (double*) malloc(len * sizeof(double));
+    work = (double*) malloc(2 * num_cells * sizeof(double));
+    if (!wsave || !work)
+        *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+    else
+    {
+        oskar_fftpack_cfft2i(g->size[0], g->size[1], wsave);
+        oskar_fftpack_cfft2b(g->size[0], g->size[0], g->size[1], g->data,
+                wsave, work);
+    }
+    free(wsave);
+    free(work);
+}
+
+/* Sets the initial kernel width from the tolerance, and the grid size.
+ * Returns false if the tolerance cannot be met. */
+static int init_grid(const oskar_Station* s, Grid* g)
+{
+    int d;
+
+    /* The error is approximately exp(-3 pi spread / 4). */
+    g->spread = (int) ceil(-log(s->array_fft_tolerance) / (0.75 * M_PI));
+    if (g->spread < 2) g->spread = 2;
+    if (g->spread > MAX_SPREAD) return 0;
+    for (d = 0; d < 2; ++d)
+    {
+        g->size[d] = OVERSAMPLE * s->lattice_size[d];
+        if (g->size[d] < 2 * MAX_SPREAD) g->size[d] = 2 * MAX_SPREAD;
+    }
+    return 1;
+}
+
+/* Widens the kernel until the result at the check directions matches a
+ * direct DFT to within the tolerance, relative to the sum of the weight
+ * magnitudes (the largest possible value of the array pattern).
+ * Returns true if the tolerance was met. */
+static int fit_kernel(const oskar_Station* s, Grid* g, double wavenumber,
+        const double* x, const double* y, const double* w,
+        int num_check, int stride, const double* l, const double* m,
+        int* status)
+{
+    int i;
+    double norm = 0.0;
+    for (i = 0; i < s->num_elements; ++i)
+        norm += sqrt(w[2*i] * w[2*i] + w[2*i + 1] * w[2*i + 1]);
+    while (!*status && g->spread <= MAX_SPREAD)
+    {
+        double max_err = 0.0;
+        grid_weights(s, g, x, y, w, status);
+        if (*status) break;
+        for (i = 0; i < num_check; ++i)
+        {
+            int e;
+            double re, im, dft_re = 0.0, dft_im = 0.0, err;
+            const double l0 = l[i * stride], m0 = m[i * stride];
+            interpolate(s, g, wavenumber, l0, m0, &re, &im);
+            if (re == 0.0 && im == 0.0) continue;
+            for (e = 0; e < s->num_elements; ++e)
+            {
+                const double p = wavenumber * (x[e] * l0 + y[e] * m0);
+                const double c = cos(p), sn = sin(p);
+                dft_re += w[2*e] * c - w[2*e + 1] * sn;
+                dft_im += w[2*e] * sn + w[2*e + 1] * c;
+            }
+            err = sqrt((re - dft_re) * (re - dft_re) +
+                    (im - dft_im) * (im - dft_im));
+            if (err > max_err) max_err = err;
+        }
+        if (max_err <= s->array_fft_tolerance * norm) return 1;
+        g->spread += 2;
+    }
+    return 0;
+}
+
+void oskar_evaluate_array_pattern_fft_analyse(oskar_Station* station,
+        int* status)
+{
+    int i, num_elements;
+    double det, *l, *m, *w;
+    const double* b = station->lattice_basis;
+    oskar_Mem *x_el, *y_el;
+    Grid g;
+
+    /* Check if safe to proceed. */
+    station->array_fft_spread = 0;
+    if (*status || !station->enable_array_fft ||
+            !station->array_is_lattice || station->array_is_3d ||
+            station->array_fft_tolerance <= 0.0)
+        return;
+    if (!init_grid(station, &g))
+    {
+        station->array_fft_spread = -1;
+        return;
+    }
+
+    /* Use unit weights, and directions spread over one period of the
+     * array pattern along each lattice basis vector (for unit wavenumber).
+     * The interpolation error does not depend on the wavenumber. */
+    num_elements = station->num_elements;
+    det = b[0] * b[3] - b[1] * b[2];
+    l = (double*) malloc(NUM_CHECK * sizeof(double));
+    m = (double*) malloc(NUM_CHECK * sizeof(double));
+    w = (double*) calloc(2 * num_elements, sizeof(double));
+    g.data = (double*) malloc(2 * sizeof(double) * g.size[0] * g.size[1]);
+    x_el = oskar_mem_convert_precision(station->element_true_x_enu_metres,
+            OSKAR_DOUBLE, status);
+    y_el = oskar_mem_convert_precision(station->element_true_y_enu_metres,
+            OSKAR_DOUBLE, status);
+    if (!l || !m || !w || !g.data)
+        *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+    if (!*status)
+    {
+        for (i = 0; i < num_elements; ++i) w[2 * i] = 1.0;
+        for (i = 0; i < NUM_CHECK; ++i)
+        {
+            double t;
+            const double u = 2.0 * M_PI * (i + 0.5) / NUM_CHECK;
+            const double v = 2.0 * M_PI * modf(i * 0.6180339887, &t);
+            l[i] = (b[3] * u - b[1] * v) / det;
+            m[i] = (b[0] * v - b[2] * u) / det;
+        }
+
+        /* Record the kernel width, or that the tolerance cannot be met. */
+        if (fit_kernel(station, &g, 1.0, oskar_mem_double_const(x_el, status),
+                oskar_mem_double_const(y_el, status), w, NUM_CHECK, 1, l, m,
+                status))
+            station->array_fft_spread = g.spread;
+        else if (!*status)
+            station->array_fft_spread = -1;
+    }
+
+    /* Free scratch memory. */
+    free(l);
+    free(m);
+    free(w);
+    free(g.data);
+    oskar_mem_free(x_el, status);
+    oskar_mem_free(y_el, status);
+}
+
+int oskar_evaluate_array_pattern_fft(const oskar_Station* station,
+        double wavenumber, const oskar_Mem* weights, int num_points,
+        const oskar_Mem* x, const oskar_Mem* y, oskar_Mem* pattern,
+        int* status)
+{
+    int i, num_elements, num_check, used = 0;
+    double cost_fft;
+    oskar_Mem *x_el, *y_el, *w;
+    const double *x_el_, *y_el_, *w_, *l_, *m_;
+    oskar_Mem *l = 0, *m = 0;
+    Grid g;
+
+    /* Check if safe to proceed. */
+    if (*status) return 0;
+
+    /* Check that the FFT can be used for this station. Stations for which
+     * the tolerance could not be met when analysed use the DFT directly. */
+    num_elements = station->num_elements;
+    if (!station->enable_array_fft || !station->array_is_lattice ||
+            station->array_is_3d || station->array_fft_tolerance <= 0.0 ||
+            station->array_fft_spread < 0 || num_points < 1 ||
+            oskar_mem_location(weights) != OSKAR_CPU ||
+            oskar_mem_location(x) != OSKAR_CPU ||
+            oskar_mem_location(y) != OSKAR_CPU ||
+            oskar_mem_location(pattern) != OSKAR_CPU ||
+            oskar_mem_location(station->element_true_x_enu_metres) !=
+                    OSKAR_CPU)
+        return 0;
+
+    /* Start from the kernel width found when the station was analysed. */
+    if (!init_grid(station, &g)) return 0;
+    if (g.spread < station->array_fft_spread)
+        g.spread = station->array_fft_spread;
+
+    /* Check that the FFT is likely to be faster than a direct DFT, which
+     * needs a sine and cosine for every element and direction. Interpolating
+     * from the grid costs about the same as a DFT over spread^2 elements. */
+    cost_fft = (double) g.size[0] * g.size[1] *
+            log((double) g.size[0] * g.size[1]) / log(2.0) +
+            (double) num_points * g.spread * g.spread;
+    if (cost_fft > (double) num_points * num_elements) return 0;
+
+    /* Get the inputs in double precision. */
+    x_el = oskar_mem_convert_precision(station->element_true_x_enu_metres,
+            OSKAR_DOUBLE, status);
+    y_el = oskar_mem_convert_precision(station->element_true_y_enu_metres,
+            OSKAR_DOUBLE, status);
+    w = oskar_mem_convert_precision(weights, OSKAR_DOUBLE, status);
+    if (oskar_mem_precision(x) == OSKAR_DOUBLE)
+    {
+        l_ = oskar_mem_double_const(x, status);
+        m_ = oskar_mem_double_const(y, status);
+    }
+    else
+    {
+        l = oskar_mem_convert_precision(x, OSKAR_DOUBLE, status);
+        m = oskar_mem_convert_precision(y, OSKAR_DOUBLE, status);
+        l_ = oskar_mem_double_const(l, status);
+        m_ = oskar_mem_double_const(m, status);
+    }
+    x_el_ = oskar_mem_double_const(x_el, status);
+    y_el_ = oskar_mem_double_const(y_el, status);
+    w_ = (const double*) oskar_mem_void_const(w);
+    g.data = (double*) malloc(2 * sizeof(double) * g.size[0] * g.size[1]);
+    if (!g.data) *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+
+    /* Check the result against a direct DFT at a subset of the directions,
+     * widening the kernel if needed. */
+    num_check = num_points < NUM_CHECK ? num_points : NUM_CHECK;
+    if (!*status)
+        used = fit_kernel(station, &g, wavenumber, x_el_, y_el_, w_,
+                num_check, num_points / num_check, l_, m_, status);
+
+    /* Evaluate the array pattern in all directions. */
+    if (used)
+    {
+        if ((int)oskar_mem_length(pattern) < num_points)
+            oskar_mem_realloc(pattern, (size_t) num_points, status);
+        if (oskar_mem_precision(pattern) == OSKAR_DOUBLE)
+        {
+            double2* out = oskar_mem_double2(pattern, status);
+            #pragma omp parallel for private(i)
+            for (i = 0; i < num_points; ++i)
+            {
+                interpolate(station, &g, wavenumber, l_[i], m_[i],
+                        &out[i].x, &out[i].y);
+            }
+        }
+        else
+        {
+            float2* out = oskar_mem_float2(pattern, status);
+            #pragma omp parallel for private(i)
+            for (i = 0; i < num_points; ++i)
+            {
+                double re, im;
+                interpolate(station, &g, wavenumber, l_[i], m_[i], &re, &im);
+                out[i].x = (float) re;
+                out[i].y = (float) im;
+            }
+        }
+    }
+
+    /* Free scratch memory. */
+    free(g.data);
+    oskar_mem_free(x_el, status);
+    oskar_mem_free(y_el, status);
+    oskar_mem_free(w, status);
+    oskar_mem_free(l, status);
+    oskar_mem_free(m, status);
+    return used && !*status;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -38,6 +38,17 @@ void oskar_evaluate_element_weights(oskar_Mem* weights,
         oskar_Mem* weights_error, double wavenumber,
         const oskar_Station* station, double x_beam, double y_beam,
         double z_beam, int time_index, int* status)
+{
+    oskar_evaluate_element_weights_with_errors(weights, weights_error,
+            wavenumber, station, x_beam, y_beam, z_beam, time_index, 0,
+            status);
+}
+
+void oskar_evaluate_element_weights_with_errors(oskar_Mem* weights,
+        oskar_Mem* weights_error, double wavenumber,
+        const oskar_Station* station, double x_beam, double y_beam,
+        double z_beam, int time_index, const oskar_Mem* element_errors,
+        int* status)
 {
     int num_elements;
 
@@ -61,17 +72,22 @@ void oskar_evaluate_element_weights(oskar_Mem* weights,
     /* Apply time-variable errors. */
     if (oskar_station_apply_element_errors(station))
     {
-        /* Generate weights errors. */
-        oskar_evaluate_element_weights_errors(num_elements,
-                oskar_station_element_gain_const(station),
-                oskar_station_element_gain_error_const(station),
-                oskar_station_element_phase_offset_rad_const(station),
-                oskar_station_element_phase_error_rad_const(station),
-                oskar_station_seed_time_variable_errors(station), time_index,
-                oskar_station_unique_id(station), weights_error, status);
+        /* Generate weights errors, unless they were pre-computed. */
+        if (!element_errors)
+        {
+            oskar_evaluate_element_weights_errors(num_elements,
+                    oskar_station_element_gain_const(station),
+                    oskar_station_element_gain_error_const(station),
+                    oskar_station_element_phase_offset_rad_const(station),
+                    oskar_station_element_phase_error_rad_const(station),
+                    oskar_station_seed_time_variable_errors(station),
+                    time_index, oskar_station_unique_id(station),
+                    weights_error, status);
+            element_errors = weights_error;
+        }
 
         /* Modify the weights (complex multiply with error vector). */
-        oskar_mem_multiply(0, weights, weights_error, num_elements, status);
+        oskar_mem_multiply(0, weights, element_errors, num_elements, status);
     }
 
     /* Modify the weights using the provided apodisation values. */
@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "telescope/station/oskar_evaluate_element_weights_errors_block.h"
+#include "telescope/station/oskar_evaluate_element_weights_errors.h"
+#include "math/private_random_helpers.h"
+
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Returns the station containing the given pair of elements. */
+static int find_station(int num_stations, const int* pair_start, int pair)
+{
+    int lo = 0, hi = num_stations - 1;
+    while (lo < hi)
+    {
+        const int mid = (lo + hi + 1) / 2;
+        if (pair_start[mid] <= pair)
+            lo = mid;
+        else
+            hi = mid - 1;
+    }
+    return lo;
+}
+
+/* Single precision. */
+static void oskar_evaluate_element_weights_errors_block_f(int num_stations,
+        const int* offsets, const int* pair_start, const int* num_elements,
+        const unsigned int* seeds, const int* ids, const void** gain,
+        const void** gain_error, const void** phase,
+        const void** phase_error, int time_index_start, int num_times,
+        float2* errors)
+{
+    int i, num_pairs, num_total, num_tasks;
+
+    /* Each task generates four random numbers for two elements,
+     * matching the counters used by oskar_mem_random_gaussian(). */
+    num_pairs = pair_start[num_stations];
+    num_total = offsets[num_stations];
+    num_tasks = num_pairs * num_times;
+#pragma omp parallel for private(i)
+    for (i = 0; i < num_tasks; ++i)
+    {
+        int t, s, j, e, num;
+        float2* out;
+        t = i / num_pairs;
+        s = find_station(num_stations, pair_start, i - t * num_pairs);
+        j = i - t * num_pairs - pair_start[s];
+        e = 2 * j;
+        num = num_elements[s] - e;
+        if (num > 2) num = 2;
+        out = errors + (size_t)t * num_total + offsets[s] + e;
+        {
+            float r[4];
+            OSKAR_R123_GENERATE_4(seeds[s], j, time_index_start + t, ids[s],
+                    0x12345678)
+
+            /* Convert to normalised Gaussian distribution. */
+            oskar_box_muller_f(u.i[0], u.i[1], &r[0], &r[1]);
+            oskar_box_muller_f(u.i[2], u.i[3], &r[2], &r[3]);
+            out[0].x = r[0];
+            out[0].y = r[1];
+            if (num > 1)
+            {
+                out[1].x = r[2];
+                out[1].y = r[3];
+            }
+        }
+        oskar_evaluate_element_weights_errors_f(num,
+                (const float*)gain[s] + e, (const float*)gain_error[s] + e,
+                (const float*)phase[s] + e, (const float*)phase_error[s] + e,
+                out);
+    }
+}
+
+/* Double precision. */
+static void oskar_evaluate_element_weights_errors_block_d(int num_stations,
+        const int* offsets, const int* pair_start, const int* num_elements,
+        const unsigned int* seeds, const int* ids, const void** gain,
+        const void** gain_error, const void** phase,
+        const void** phase_error, int time_index_start, int num_times,
+        double2* errors)
+{
+    int i, num_pairs, num_total, num_tasks;
+
+    /* Each task generates four random numbers for two elements,
+     * matching the counters used by oskar_mem_random_gaussian(). */
+    num_pairs = pair_start[num_stations];
+    num_total = offsets[num_stations];
+    num_tasks = num_pairs * num_times;
+#pragma omp parallel for private(i)
+    for (i = 0; i < num_tasks; ++i)
+    {
+        int t, s, j, e, num;
+        double2* out;
+        t = i / num_pairs;
+        s = find_station(num_stations, pair_start, i - t * num_pairs);
+        j = i - t * num_pairs - pair_start[s];
+        e = 2 * j;
+        num = num_elements[s] - e;
+        if (num > 2) num = 2;
+        out = errors + (size_t)t * num_total + offsets[s] + e;
+        {
+            double r[4];
+            OSKAR_R123_GENERATE_4(seeds[s], j, time_index_start + t, ids[s],
+                    0x12345678)
+
+            /* Convert to normalised Gaussian distribution. */
+            oskar_box_muller_d(u.i[0], u.i[1], &r[0], &r[1]);
+            oskar_box_muller_d(u.i[2], u.i[3], &r[2], &r[3]);
+            out[0].x = r[0];
+            out[0].y = r[1];
+            if (num > 1)
+            {
+                out[1].x = r[2];
+                out[1].y = r[3];
+            }
+        }
+        oskar_evaluate_element_weights_errors_d(num,
+                (const double*)gain[s] + e, (const double*)gain_error[s] + e,
+                (const double*)phase[s] + e, (const double*)phase_error[s] + e,
+                out);
+    }
+}
+
+/* Wrapper. */
+void oskar_evaluate_element_weights_errors_block(int num_stations,
+        const oskar_Station* const* stations, const int* offsets,
+        int time_index_start, int num_times, oskar_Mem* errors, int* status)
+{
+    int k, type, *pair_start, *num_elements, *ids;
+    unsigned int* seeds;
+    const void **gain, **gain_error, **phase, **phase_error;
+
+    /* Check if safe to proceed. */
+    if (*status || num_stations <= 0 || num_times <= 0) return;
+
+    /* Check type and location. */
+    type = oskar_mem_precision(errors);
+    if (!oskar_mem_is_complex(errors) || oskar_mem_is_matrix(errors))
+    {
+        *status = OSKAR_ERR_BAD_DATA_TYPE;
+        return;
+    }
+    if (oskar_mem_location(errors) != OSKAR_CPU)
+    {
+        *status = OSKAR_ERR_BAD_LOCATION;
+        return;
+    }
+    for (k = 0; k < num_stations; ++k)
+    {
+        if (oskar_station_precision(stations[k]) != type)
+        {
+            *status = OSKAR_ERR_TYPE_MISMATCH;
+            return;
+        }
+        if (oskar_station_mem_location(stations[k]) != OSKAR_CPU)
+        {
+            *status = OSKAR_ERR_LOCATION_MISMATCH;
+            return;
+        }
+        if (offsets[k + 1] - offsets[k] <
+                oskar_station_num_elements(stations[k]))
+        {
+            *status = OSKAR_ERR_DIMENSION_MISMATCH;
+            return;
+        }
+    }
+
+    /* Resize the output array if required. */
+    if (oskar_mem_length(errors) < (size_t)num_times * offsets[num_stations])
+        oskar_mem_realloc(errors, (size_t)num_times * offsets[num_stations],
+                status);
+    if (*status) return;
+
+    /* Get the element data for each station. */
+    pair_start   = (int*) malloc((num_stations + 1) * sizeof(int));
+    num_elements = (int*) malloc(num_stations * sizeof(int));
+    ids          = (int*) malloc(num_stations * sizeof(int));
+    seeds        = (unsigned int*) malloc(num_stations * sizeof(unsigned int));
+    gain         = (const void**) malloc(num_stations * sizeof(void*));
+    gain_error   = (const void**) malloc(num_stations * sizeof(void*));
+    phase        = (const void**) malloc(num_stations * sizeof(void*));
+    phase_error  = (const void**) malloc(num_stations * sizeof(void*));
+    if (!pair_start || !num_elements || !ids || !seeds || !gain ||
+            !gain_error || !phase || !phase_error)
+        *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+    if (!*status)
+    {
+        pair_start[0] = 0;
+        for (k = 0; k < num_stations; ++k)
+        {
+            const oskar_Station* s = stations[k];
+            num_elements[k] = oskar_station_num_elements(s);
+            pair_start[k + 1] = pair_start[k] + (num_elements[k] + 1) / 2;
+            ids[k] = oskar_station_unique_id(s);
+            seeds[k] = oskar_station_seed_time_variable_errors(s);
+            gain[k] = oskar_mem_void_const(oskar_station_element_gain_const(s));
+            gain_error[k] = oskar_mem_void_const(
+                    oskar_station_element_gain_error_const(s));
+            phase[k] = oskar_mem_void_const(
+                    oskar_station_element_phase_offset_rad_const(s));
+            phase_error[k] = oskar_mem_void_const(
+                    oskar_station_element_phase_error_rad_const(s));
+        }
+    }
+
+    /* Generate the errors for all stations and times. */
+    if (!*status && pair_start[num_stations] > 0)
+    {
+        if (type == OSKAR_DOUBLE)
+            oskar_evaluate_element_weights_errors_block_d(num_stations,
+                    offsets, pair_start, num_elements, seeds, ids,
+                    gain, gain_error, phase, phase_error, time_index_start,
+                    num_times, oskar_mem_double2(errors, status));
+        else if (type == OSKAR_SINGLE)
+            oskar_evaluate_element_weights_errors_block_f(num_stations,
+                    offsets, pair_start, num_elements, seeds, ids,
+                    gain, gain_error, phase, phase_error, time_index_start,
+                    num_times, oskar_mem_float2(errors, status));
+        else
+            *status = OSKAR_ERR_BAD_DATA_TYPE;
+    }
+
+    /* Clean up. */
+    free(pair_start);
+    free(num_elements);
+    free(ids);
+    free(seeds);
+    free(gain);
+    free(gain_error);
+    free(phase);
+    free(phase_error);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -30,15 +30,30 @@
 #include "telescope/station/oskar_evaluate_station_beam_aperture_array.h"
 #include "telescope/station/oskar_evaluate_station_beam_gaussian.h"
 #include "telescope/station/oskar_evaluate_vla_beam_pbcor.h"
+#include "telescope/station/private_station_work.h"
 #include "convert/oskar_convert_relative_directions_to_enu_directions.h"
 #include "convert/oskar_convert_enu_directions_to_relative_directions.h"
 
 #include <math.h>
+#include <string.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+static void evaluate_station_beam_directions(oskar_Mem* beam_pattern,
+        int np, int coord_type, const oskar_Mem* x, const oskar_Mem* y,
+        const oskar_Mem* z, const oskar_Station* station,
+        oskar_StationWork* work, int time_index, double frequency_hz,
+        double GAST, int* status);
+static int find_visible_directions(int np, int coord_type,
+        const oskar_Mem* x, const oskar_Mem* y, const oskar_Mem* z,
+        const oskar_Station* station, oskar_StationWork* work, double GAST,
+        int* status);
+static void gather(oskar_Mem* out, const oskar_Mem* in, int num,
+        const int* indices, int* status);
+static void scatter(oskar_Mem* out, const oskar_Mem* in, int num_out,
+        int num_in, const int* indices, int* status);
 static void evaluate_station_beam_relative_directions(oskar_Mem* beam_pattern,
         int np, const oskar_Mem* l, const oskar_Mem* m, const oskar_Mem* n,
         const oskar_Station* station, oskar_StationWork* work,
@@ -62,7 +77,7 @@ void oskar_evaluate_station_beam(oskar_Mem* beam_pattern, int num_points,
         oskar_StationWork* work, int time_index, double frequency_hz,
         double GAST, int* status)
 {
-    int normalise_final_beam;
+    int normalise_final_beam, num_visible;
     oskar_Mem* out;
 
     /* Check if safe to proceed. */
@@ -119,20 +134,33 @@ void oskar_evaluate_station_beam(oskar_Mem* beam_pattern, int num_points,
         oskar_mem_set_element_real(z, num_points-1, c_z, status);
     }
 
-    /* Evaluate the station beam for the given directions. */
-    if (coord_type == OSKAR_ENU_DIRECTIONS)
+    /* Evaluate the station beam for the given directions.
+     * If some are below the horizon, evaluate it only for those above it,
+     * and set the others to zero. */
+    num_visible = find_visible_directions(num_points, coord_type, x, y, z,
+            station, work, GAST, status);
+    if (num_visible < num_points)
     {
-        evaluate_station_beam_enu_directions(out, num_points, x, y, z,
-                station, work, time_index, frequency_hz, GAST, status);
-    }
-    else if (coord_type == OSKAR_RELATIVE_DIRECTIONS)
-    {
-        evaluate_station_beam_relative_directions(out, num_points, x, y, z,
-                station, work, time_index, frequency_hz, GAST, status);
+        oskar_Mem* visible_beam;
+        const int* indices;
+        indices = oskar_mem_int_const(work->source_indices, status);
+        gather(work->visible_x, x, num_visible, indices, status);
+        gather(work->visible_y, y, num_visible, indices, status);
+        gather(work->visible_z, z, num_visible, indices, status);
+        visible_beam = oskar_station_work_visible_beam(work, out,
+                num_visible, status);
+        if (num_visible > 0)
+            evaluate_station_beam_directions(visible_beam, num_visible,
+                    coord_type, work->visible_x, work->visible_y,
+                    work->visible_z, station, work, time_index,
+                    frequency_hz, GAST, status);
+        scatter(out, visible_beam, num_points, num_visible, indices, status);
     }
     else
     {
-        *status = OSKAR_ERR_INVALID_ARGUMENT;
+        evaluate_station_beam_directions(out, num_points, coord_type,
+                x, y, z, station, work, time_index, frequency_hz, GAST,
+                status);
     }
 
     /* Scale beam pattern by value of the last source if required. */
@@ -185,6 +213,115 @@ void oskar_evaluate_station_beam(oskar_Mem* beam_pattern, int num_points,
     }
 }
 
+static void evaluate_station_beam_directions(oskar_Mem* beam_pattern,
+        int np, int coord_type, const oskar_Mem* x, const oskar_Mem* y,
+        const oskar_Mem* z, const oskar_Station* station,
+        oskar_StationWork* work, int time_index, double frequency_hz,
+        double GAST, int* status)
+{
+    if (coord_type == OSKAR_ENU_DIRECTIONS)
+    {
+        evaluate_station_beam_enu_directions(beam_pattern, np, x, y, z,
+                station, work, time_index, frequency_hz, GAST, status);
+    }
+    else if (coord_type == OSKAR_RELATIVE_DIRECTIONS)
+    {
+        evaluate_station_beam_relative_directions(beam_pattern, np, x, y, z,
+                station, work, time_index, frequency_hz, GAST, status);
+    }
+    else
+    {
+        *status = OSKAR_ERR_INVALID_ARGUMENT;
+    }
+}
+
+static int find_visible_directions(int np, int coord_type,
+        const oskar_Mem* x, const oskar_Mem* y, const oskar_Mem* z,
+        const oskar_Station* station, oskar_StationWork* work, double GAST,
+        int* status)
+{
+    int i, num_visible = 0, *indices;
+    const oskar_Mem* enu_z;
+
+    /* Only compact directions in CPU memory, and not for isotropic
+     * stations, which are never blanked below the horizon. */
+    if (*status || np == 0 || oskar_mem_location(z) != OSKAR_CPU ||
+            oskar_station_type(station) == OSKAR_STATION_TYPE_ISOTROPIC ||
+            (coord_type != OSKAR_ENU_DIRECTIONS &&
+                    coord_type != OSKAR_RELATIVE_DIRECTIONS))
+        return np;
+
+    /* Get the ENU z-component of each direction. */
+    enu_z = z;
+    if (coord_type == OSKAR_RELATIVE_DIRECTIONS)
+    {
+        compute_enu_directions(work->enu_direction_x, work->enu_direction_y,
+                work->enu_direction_z, np, x, y, z, station, GAST, status);
+        enu_z = work->enu_direction_z;
+    }
+
+    /* Store the indices of directions that are not below the horizon.
+     * (Directions that are not finite are kept, so they propagate.) */
+    if ((int)oskar_mem_length(work->source_indices) < np)
+        oskar_mem_realloc(work->source_indices, np, status);
+    if (*status) return np;
+    indices = oskar_mem_int(work->source_indices, status);
+    if (oskar_mem_precision(enu_z) == OSKAR_DOUBLE)
+    {
+        const double* z_ = oskar_mem_double_const(enu_z, status);
+        for (i = 0; i < np; ++i)
+            if (!(z_[i] < 0.0)) indices[num_visible++] = i;
+    }
+    else
+    {
+        const float* z_ = oskar_mem_float_const(enu_z, status);
+        for (i = 0; i < np; ++i)
+            if (!(z_[i] < 0.0f)) indices[num_visible++] = i;
+    }
+    return num_visible;
+}
+
+static void gather(oskar_Mem* out, const oskar_Mem* in, int num,
+        const int* indices, int* status)
+{
+    int i;
+    size_t size;
+    char* dst;
+    const char* src;
+    if (*status) return;
+    if ((int)oskar_mem_length(out) < num)
+        oskar_mem_realloc(out, num, status);
+    if (*status) return;
+    size = oskar_mem_element_size(oskar_mem_type(in));
+    dst = (char*) oskar_mem_void(out);
+    src = (const char*) oskar_mem_void_const(in);
+    for (i = 0; i < num; ++i)
+        memcpy(dst + i * size, src + indices[i] * size, size);
+}
+
+static void scatter(oskar_Mem* out, const oskar_Mem* in, int num_out,
+        int num_in, const int* indices, int* status)
+{
+    int i, j;
+    size_t size;
+    char* dst;
+    const char* src;
+    if (*status) return;
+    if ((int)oskar_mem_length(out) < num_out)
+        oskar_mem_realloc(out, num_out, status);
+    if (*status) return;
+    size = oskar_mem_element_size(oskar_mem_type(in));
+    dst = (char*) oskar_mem_void(out);
+    src = (const char*) oskar_mem_void_const(in);
+    for (i = 0, j = 0; i < num_out; ++i)
+    {
+        if (j < num_in && indices[j] == i)
+            memcpy(dst + i * size, src + (j++) * size, size);
+        else
+            memset(dst + i * size, 0, size);
+    }
+}
+
 static void evaluate_station_beam_relative_directions(oskar_Mem* beam_pattern,
         int np, const oskar_Mem* l, const oskar_Mem* m, const oskar_Mem* n,
         const oskar_Station* station, oskar_StationWork* work,
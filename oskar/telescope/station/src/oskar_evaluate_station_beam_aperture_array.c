@@ -28,6 +28,7 @@
 
 #include "telescope/station/oskar_evaluate_station_beam_aperture_array.h"
 
+#include "telescope/station/oskar_evaluate_array_pattern_fft.h"
 #include "telescope/station/oskar_evaluate_beam_horizon_direction.h"
 #include "telescope/station/oskar_evaluate_element_weights.h"
 #include "telescope/station/element/oskar_element_evaluate.h"
@@ -36,12 +37,17 @@
 
 #include "math/oskar_cmath.h"
 #include "math/oskar_dftw.h"
+#include "math/oskar_dftw_indexed_input.h"
+
+#include <limits.h>
+#include <stdlib.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 #define MAX_CHUNK_SIZE 49152
+#define MIN_CHUNK_SIZE 256
 
 /* Private function, used for recursive calls. */
 static void oskar_evaluate_station_beam_aperture_array_private(oskar_Mem* beam,
@@ -50,6 +56,15 @@ static void oskar_evaluate_station_beam_aperture_array_private(oskar_Mem* beam,
         double frequency_hz, oskar_StationWork* work, int time_index,
         int depth, int* status);
 
+static int chunk_size_for_memory(const oskar_Station* station,
+        const oskar_Mem* beam, size_t max_bytes, int* status);
+static int station_depth(const oskar_Station* s);
+static int num_distinct_children(const int* equivalent, int num_children);
+static void set_child_rows(oskar_Mem* rows, const int* equivalent,
+        int num_children, int* status);
+static void find_work_sizes(const oskar_Station* s, int location,
+        int depth, size_t* sizes);
+
 
 void oskar_evaluate_station_beam_aperture_array(oskar_Mem* beam,
         const oskar_Station* station, int num_points, const oskar_Mem* x,
@@ -57,18 +72,25 @@ void oskar_evaluate_station_beam_aperture_array(oskar_Mem* beam,
         double frequency_hz, oskar_StationWork* work, int time_index,
         int* status)
 {
-    int start;
+    int start, depth, max_chunk_size = MAX_CHUNK_SIZE;
 
     /* Check if safe to proceed. */
     if (*status) return;
 
+    /* Get the chunk size from the memory limit, if set.
+     * Depth 0 is element level, so start at depth 1 if there are children. */
+    depth = oskar_station_has_child(station) ? 1 : 0;
+    if (work->max_bytes > 0)
+        max_chunk_size = chunk_size_for_memory(station, beam,
+                work->max_bytes, status);
+
     /* Evaluate beam immediately, without chunking, if there are no
-     * child stations. */
-    if (!oskar_station_has_child(station))
+     * child stations (and no memory limit), or if it fits in one chunk. */
+    if ((depth == 0 && work->max_bytes == 0) || num_points <= max_chunk_size)
     {
         oskar_evaluate_station_beam_aperture_array_private(beam, station,
                 num_points, x, y, z, gast, frequency_hz, work,
-                time_index, 0, status);
+                time_index, depth, status);
     }
     else
     {
@@ -79,13 +101,13 @@ void oskar_evaluate_station_beam_aperture_array(oskar_Mem* beam,
         c_z = oskar_mem_create_alias(0, 0, 0, status);
 
         /* Split up list of input points into manageable chunks. */
-        for (start = 0; start < num_points; start += MAX_CHUNK_SIZE)
+        for (start = 0; start < num_points; start += max_chunk_size)
         {
             int chunk_size;
 
             /* Get size of current chunk. */
             chunk_size = num_points - start;
-            if (chunk_size > MAX_CHUNK_SIZE) chunk_size = MAX_CHUNK_SIZE;
+            if (chunk_size > max_chunk_size) chunk_size = max_chunk_size;
 
             /* Get pointers to start of chunk input data. */
             oskar_mem_set_alias(c_beam, beam, start, chunk_size, status);
@@ -93,10 +115,10 @@ void oskar_evaluate_station_beam_aperture_array(oskar_Mem* beam,
             oskar_mem_set_alias(c_y, y, start, chunk_size, status);
             oskar_mem_set_alias(c_z, z, start, chunk_size, status);
 
-            /* Start recursive call at depth 1 (depth 0 is element level). */
+            /* Start recursive call. */
             oskar_evaluate_station_beam_aperture_array_private(c_beam, station,
                     chunk_size, c_x, c_y, c_z, gast, frequency_hz, work,
-                    time_index, 1, status);
+                    time_index, depth, status);
         }
 
         /* Release handles for chunk memory. */
@@ -146,24 +168,30 @@ static void oskar_evaluate_station_beam_aperture_array_private(oskar_Mem* beam,
                         == OSKAR_ELEMENT_TYPE_ISOTROPIC) )
         {
             /* (Always) evaluate element pattern into the output beam array. */
-            oskar_element_evaluate(oskar_station_element_const(s, 0), beam,
+            oskar_element_evaluate_with_work(
+                    oskar_station_element_const(s, 0), beam,
                     oskar_station_element_x_alpha_rad(s, 0) + M_PI/2.0, /* FIXME Will change: This matches the old convention. */
                     oskar_station_element_y_alpha_rad(s, 0),
-                    num_points, x, y, z, frequency_hz, theta, phi, status);
+                    num_points, x, y, z, frequency_hz, theta, phi,
+                    work->element_interp, status);
 
             /* Check if array pattern is enabled. */
             if (oskar_station_enable_array_pattern(s))
             {
-                /* Generate beamforming weights and evaluate array pattern. */
-                oskar_evaluate_element_weights(weights, weights_error,
-                        wavenumber, s, beam_x, beam_y, beam_z,
-                        time_index, status);
-                oskar_dftw(num_elements, wavenumber,
-                        oskar_station_element_true_x_enu_metres_const(s),
-                        oskar_station_element_true_y_enu_metres_const(s),
-                        oskar_station_element_true_z_enu_metres_const(s),
-                        weights, num_points, x, y, (is_3d ? z : 0), 0, array,
-                        status);
+                /* Generate beamforming weights and evaluate array pattern.
+                 * Use an FFT for lattice stations if possible. */
+                oskar_evaluate_element_weights_with_errors(weights,
+                        weights_error, wavenumber, s, beam_x, beam_y, beam_z,
+                        time_index, oskar_station_work_element_errors(work,
+                                s, time_index, status), status);
+                if (!oskar_evaluate_array_pattern_fft(s, wavenumber, weights,
+                        num_points, x, y, array, status))
+                    oskar_dftw(num_elements, wavenumber,
+                            oskar_station_element_true_x_enu_metres_const(s),
+                            oskar_station_element_true_y_enu_metres_const(s),
+                            oskar_station_element_true_z_enu_metres_const(s),
+                            weights, num_points, x, y, (is_3d ? z : 0), 0,
+                            array, status);
 
                 /* Normalise array response if required. */
                 if (oskar_station_normalise_array_pattern(s))
@@ -174,11 +202,16 @@ static void oskar_evaluate_station_beam_aperture_array_private(oskar_Mem* beam,
             }
         }
 
-#if 0
         /* Second optimisation: Common orientation for all elements within the
          * station, but more than one element type. */
-        else if (oskar_station_common_element_orientation(s))
+        /* (Indexed input DFT is currently only available on the CPU.) */
+        else if (oskar_station_common_element_orientation(s) &&
+                oskar_mem_location(beam) == OSKAR_CPU)
         {
+            int i, num_element_types;
+            oskar_Mem *element_block = 0, *element = 0;
+            const int* element_type_array = 0;
+
             /* Must evaluate array pattern, so check that this is enabled. */
             if (!oskar_station_enable_array_pattern(s))
             {
@@ -186,11 +219,59 @@ static void oskar_evaluate_station_beam_aperture_array_private(oskar_Mem* beam,
                 return;
             }
 
+            /* Check element type indices are in range. */
+            element_type_array = oskar_station_element_types_cpu_const(s);
+            num_element_types = oskar_station_num_element_types(s);
+            for (i = 0; i < num_elements; ++i)
+            {
+                if (element_type_array[i] >= num_element_types)
+                {
+                    *status = OSKAR_ERR_OUT_OF_RANGE;
+                    return;
+                }
+            }
+
+            /* Get sized element pattern block (at depth 0). */
+            element_block = oskar_station_work_beam(work, beam,
+                    num_element_types * num_points, 0, status);
+
+            /* Create alias into element block. */
+            element = oskar_mem_create_alias(element_block, 0, 0, status);
+
+            /* Loop over element types and evaluate response for each. */
+            for (i = 0; i < num_element_types; ++i)
+            {
+                oskar_mem_set_alias(element, element_block, i * num_points,
+                        num_points, status);
+                oskar_element_evaluate_with_work(
+                        oskar_station_element_const(s, i), element,
+                        oskar_station_element_x_alpha_rad(s, 0) + M_PI/2.0, /* FIXME Will change: This matches the old convention. */
+                        oskar_station_element_y_alpha_rad(s, 0),
+                        num_points, x, y, z, frequency_hz, theta, phi,
+                        work->element_interp, status);
+            }
+
+            /* Generate beamforming weights. */
+            oskar_evaluate_element_weights_with_errors(weights,
+                    weights_error, wavenumber, s, beam_x, beam_y, beam_z,
+                    time_index, oskar_station_work_element_errors(work, s,
+                            time_index, status), status);
+
             /* Call a DFT using indexed input. */
-            /* TODO Not yet implemented. */
-            *status = OSKAR_ERR_FUNCTION_NOT_AVAILABLE;
+            oskar_dftw_indexed_input(num_elements, wavenumber,
+                    oskar_station_element_true_x_enu_metres_const(s),
+                    oskar_station_element_true_y_enu_metres_const(s),
+                    oskar_station_element_true_z_enu_metres_const(s),
+                    weights, oskar_station_element_types_const(s),
+                    num_points, x, y, z, element_block, beam, status);
+
+            /* Free element alias. */
+            oskar_mem_free(element, status);
+
+            /* Normalise array response if required. */
+            if (oskar_station_normalise_array_pattern(s))
+                oskar_mem_scale_real(beam, 1.0 / num_elements, status);
         }
-#endif
 
         /* No optimisation: No common element orientation. */
         /* Can't separate array and element evaluation. */
@@ -228,18 +309,20 @@ static void oskar_evaluate_station_beam_aperture_array_private(oskar_Mem* beam,
                 }
                 oskar_mem_set_alias(element, element_block, i * num_points,
                         num_points, status);
-                oskar_element_evaluate(
+                oskar_element_evaluate_with_work(
                         oskar_station_element_const(s, element_type_idx),
                         element,
                         oskar_station_element_x_alpha_rad(s, i) + M_PI/2.0, /* FIXME Will change: This matches the old convention. */
                         oskar_station_element_y_alpha_rad(s, i),
-                        num_points, x, y, z, frequency_hz, theta, phi, status);
+                        num_points, x, y, z, frequency_hz, theta, phi,
+                        work->element_interp, status);
             }
 
             /* Generate beamforming weights. */
-            oskar_evaluate_element_weights(weights, weights_error,
-                    wavenumber, s, beam_x, beam_y, beam_z,
-                    time_index, status);
+            oskar_evaluate_element_weights_with_errors(weights,
+                    weights_error, wavenumber, s, beam_x, beam_y, beam_z,
+                    time_index, oskar_station_work_element_errors(work, s,
+                            time_index, status), status);
 
             /* Use DFT to evaluate array response. */
             oskar_dftw(num_elements, wavenumber,
@@ -264,8 +347,9 @@ static void oskar_evaluate_station_beam_aperture_array_private(oskar_Mem* beam,
     /* If there are child stations, must first evaluate the beam for each. */
     else
     {
-        int i;
-        oskar_Mem* signal;
+        int i, row, num_rows, use_index;
+        oskar_Mem *signal, *output;
+        const int* equivalent;
 
         /* Must evaluate array pattern, so check that this is enabled. */
         if (!oskar_station_enable_array_pattern(s))
@@ -274,59 +358,76 @@ static void oskar_evaluate_station_beam_aperture_array_private(oskar_Mem* beam,
             return;
         }
 
+        /* Get the index of the first equivalent station for each child.
+         * (This is NULL if the station has not been analysed.) */
+        equivalent = oskar_station_equivalent_children_cpu_const(s);
+
+        /* On the CPU, the signal block holds one row for each distinct
+         * child, and the DFT indexes the rows for equivalent children.
+         * (Indexed input DFT is currently only available on the CPU.) */
+        use_index = equivalent && oskar_mem_location(beam) == OSKAR_CPU;
+        num_rows = use_index ?
+                num_distinct_children(equivalent, num_elements) :
+                num_elements;
+
         /* Get sized work array for this depth, with the correct type. */
-        signal = oskar_station_work_beam(work, beam, num_elements * num_points,
+        signal = oskar_station_work_beam(work, beam, num_rows * num_points,
                 depth, status);
 
-        /* Check if child stations are identical. */
-        if (oskar_station_identical_children(s))
+        /* Create alias into signal block. */
+        output = oskar_mem_create_alias(signal, 0, 0, status);
+
+        /* Loop over child stations. */
+        for (i = 0, row = 0; i < num_elements; ++i)
         {
-            /* Set up the output buffer for the first station. */
-            oskar_Mem* output0;
-            output0 = oskar_mem_create_alias(signal, 0, num_points, status);
+            if (equivalent && equivalent[i] != i)
+            {
+                /* Copy beam if it has already been evaluated for an
+                 * equivalent child station and the rows are not indexed. */
+                if (!use_index)
+                    oskar_mem_copy_contents(signal, signal, i * num_points,
+                            equivalent[i] * num_points, num_points, status);
+                continue;
+            }
 
             /* Recursive call. */
-            oskar_evaluate_station_beam_aperture_array_private(output0,
-                    oskar_station_child_const(s, 0), num_points,
+            oskar_mem_set_alias(output, signal, row * num_points,
+                    num_points, status);
+            oskar_evaluate_station_beam_aperture_array_private(output,
+                    oskar_station_child_const(s, i), num_points,
                     x, y, z, gast, frequency_hz, work, time_index,
                     depth + 1, status);
-
-            /* Copy beam for child station 0 into memory for other stations. */
-            for (i = 1; i < num_elements; ++i)
-            {
-                oskar_mem_copy_contents(signal, output0, i * num_points, 0,
-                        oskar_mem_length(output0), status);
-            }
-            oskar_mem_free(output0, status);
+            ++row;
         }
-        else
-        {
-            /* Loop over child stations. */
-            for (i = 0; i < num_elements; ++i)
-            {
-                /* Set up the output buffer for this station. */
-                oskar_Mem* output;
-                output = oskar_mem_create_alias(signal, i * num_points,
-                        num_points, status);
 
-                /* Recursive call. */
-                oskar_evaluate_station_beam_aperture_array_private(output,
-                        oskar_station_child_const(s, i), num_points,
-                        x, y, z, gast, frequency_hz, work, time_index,
-                        depth + 1, status);
-                oskar_mem_free(output, status);
-            }
-        }
+        /* Free signal alias. */
+        oskar_mem_free(output, status);
 
         /* Generate beamforming weights and form beam from child stations. */
-        oskar_evaluate_element_weights(weights, weights_error, wavenumber,
-                s, beam_x, beam_y, beam_z, time_index, status);
-        oskar_dftw(num_elements, wavenumber,
-                oskar_station_element_true_x_enu_metres_const(s),
-                oskar_station_element_true_y_enu_metres_const(s),
-                oskar_station_element_true_z_enu_metres_const(s),
-                weights, num_points, x, y, (is_3d ? z : 0), signal, beam,
-                status);
+        oskar_evaluate_element_weights_with_errors(weights, weights_error,
+                wavenumber, s, beam_x, beam_y, beam_z, time_index,
+                oskar_station_work_element_errors(work, s, time_index,
+                        status), status);
+        if (use_index)
+        {
+            /* Set the row for each child after the recursive calls,
+             * as the same index array is used at every depth. */
+            set_child_rows(work->child_rows, equivalent, num_elements,
+                    status);
+            oskar_dftw_indexed_input(num_elements, wavenumber,
+                    oskar_station_element_true_x_enu_metres_const(s),
+                    oskar_station_element_true_y_enu_metres_const(s),
+                    oskar_station_element_true_z_enu_metres_const(s),
+                    weights, work->child_rows, num_points, x, y, z,
+                    signal, beam, status);
+        }
+        else
+            oskar_dftw(num_elements, wavenumber,
+                    oskar_station_element_true_x_enu_metres_const(s),
+                    oskar_station_element_true_y_enu_metres_const(s),
+                    oskar_station_element_true_z_enu_metres_const(s),
+                    weights, num_points, x, y, (is_3d ? z : 0), signal,
+                    beam, status);
 
         /* Normalise array response if required. */
         if (oskar_station_normalise_array_pattern(s))
@@ -334,6 +435,110 @@ static void oskar_evaluate_station_beam_aperture_array_private(oskar_Mem* beam,
     }
 }
 
+static int num_distinct_children(const int* equivalent, int num_children)
+{
+    int i, num = 0;
+    for (i = 0; i < num_children; ++i)
+        if (equivalent[i] == i) ++num;
+    return num;
+}
+
+static void set_child_rows(oskar_Mem* rows, const int* equivalent,
+        int num_children, int* status)
+{
+    int i, row = 0, *r;
+    if ((int)oskar_mem_length(rows) < num_children)
+        oskar_mem_realloc(rows, num_children, status);
+    r = oskar_mem_int(rows, status);
+    if (*status) return;
+    for (i = 0; i < num_children; ++i)
+        r[i] = (equivalent[i] == i) ? row++ : r[equivalent[i]];
+}
+
+static int chunk_size_for_memory(const oskar_Station* station,
+        const oskar_Mem* beam, size_t max_bytes, int* status)
+{
+    int i, num_depths;
+    size_t *sizes, bytes_per_point, chunk_size;
+    if (*status) return MAX_CHUNK_SIZE;
+
+    /* Find the largest work buffer needed at each depth, per direction. */
+    num_depths = station_depth(station) + 1;
+    sizes = (size_t*) calloc(num_depths, sizeof(size_t));
+    if (!sizes)
+    {
+        *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+        return MAX_CHUNK_SIZE;
+    }
+    find_work_sizes(station, oskar_mem_location(beam),
+            oskar_station_has_child(station) ? 1 : 0, sizes);
+
+    /* Sum the beam work buffers, and add the per-direction element pattern
+     * work arrays (theta, phi and the complex array pattern). */
+    bytes_per_point = 4 * oskar_mem_element_size(oskar_mem_precision(beam));
+    for (i = 0; i < num_depths; ++i)
+        bytes_per_point += sizes[i] *
+                oskar_mem_element_size(oskar_mem_type(beam));
+    free(sizes);
+
+    /* Get the number of directions that fit in the limit. */
+    chunk_size = max_bytes / bytes_per_point;
+    if (chunk_size < MIN_CHUNK_SIZE) chunk_size = MIN_CHUNK_SIZE;
+    if (chunk_size > INT_MAX) chunk_size = INT_MAX;
+    return (int) chunk_size;
+}
+
+static int station_depth(const oskar_Station* s)
+{
+    int i, depth = 0, num_elements;
+    if (!oskar_station_has_child(s)) return 0;
+    num_elements = oskar_station_num_elements(s);
+    for (i = 0; i < num_elements; ++i)
+    {
+        int child_depth = station_depth(oskar_station_child_const(s, i));
+        if (child_depth > depth) depth = child_depth;
+    }
+    return depth + 1;
+}
+
+static void find_work_sizes(const oskar_Station* s, int location,
+        int depth, size_t* sizes)
+{
+    int i, num_elements;
+    size_t size = 0;
+    num_elements = oskar_station_num_elements(s);
+    if (oskar_station_has_child(s))
+    {
+        /* Signal block for the child stations at this depth.
+         * On the CPU, this needs one row for each distinct child. */
+        const int* equivalent = oskar_station_equivalent_children_cpu_const(s);
+        size = (equivalent && location == OSKAR_CPU) ?
+                num_distinct_children(equivalent, num_elements) :
+                num_elements;
+        for (i = 0; i < num_elements; ++i)
+            if (!equivalent || equivalent[i] == i)
+                find_work_sizes(oskar_station_child_const(s, i), location,
+                        depth + 1, sizes);
+        if (size > sizes[depth]) sizes[depth] = size;
+    }
+    else
+    {
+        /* Element pattern block at depth 0, if the array pattern and element
+         * pattern are not separable. */
+        if (oskar_station_num_element_types(s) == 1 &&
+                (oskar_station_common_element_orientation(s) ||
+                        oskar_element_type(oskar_station_element_const(s, 0))
+                        == OSKAR_ELEMENT_TYPE_ISOTROPIC) )
+            size = 0;
+        else if (oskar_station_common_element_orientation(s) &&
+                location == OSKAR_CPU)
+            size = oskar_station_num_element_types(s);
+        else
+            size = num_elements;
+        if (size > sizes[0]) sizes[0] = size;
+    }
+}
+
 #ifdef __cplusplus
 }
 #endif
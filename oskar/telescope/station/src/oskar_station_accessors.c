@@ -34,6 +34,9 @@ extern "C" {
 #endif
 
 
+/* Last generation number given to a station model. */
+static unsigned int generation_counter = 0;
+
 /* Data common to all station types. */
 
 int oskar_station_unique_id(const oskar_Station* model)
@@ -140,6 +143,16 @@ int oskar_station_identical_children(const oskar_Station* model)
     return model->identical_children;
 }
 
+const int* oskar_station_equivalent_children_cpu_const(
+        const oskar_Station* model)
+{
+    if (!model->child ||
+            (int)oskar_mem_length(model->equivalent_child_cpu) <
+            model->num_elements)
+        return 0;
+    return (const int*) oskar_mem_void_const(model->equivalent_child_cpu);
+}
+
 int oskar_station_num_elements(const oskar_Station* model)
 {
     return model->num_elements;
@@ -170,6 +183,21 @@ int oskar_station_array_is_3d(const oskar_Station* model)
     return model->array_is_3d;
 }
 
+int oskar_station_array_is_lattice(const oskar_Station* model)
+{
+    return model->array_is_lattice;
+}
+
+int oskar_station_enable_array_fft(const oskar_Station* model)
+{
+    return model->enable_array_fft;
+}
+
+double oskar_station_array_fft_tolerance(const oskar_Station* model)
+{
+    return model->array_fft_tolerance;
+}
+
 int oskar_station_apply_element_errors(const oskar_Station* model)
 {
     return model->apply_element_errors;
@@ -185,6 +213,11 @@ unsigned int oskar_station_seed_time_variable_errors(const oskar_Station* model)
     return model->seed_time_variable_errors;
 }
 
+unsigned int oskar_station_generation(const oskar_Station* model)
+{
+    return model->generation;
+}
+
 double oskar_station_element_x_alpha_rad(const oskar_Station* model,
         int index)
 {
@@ -491,10 +524,33 @@ void oskar_station_set_enable_array_pattern(oskar_Station* model, int value)
     model->enable_array_pattern = value;
 }
 
+void oskar_station_set_enable_array_fft(oskar_Station* model, int value)
+{
+    model->enable_array_fft = value;
+    model->array_fft_spread = 0;
+}
+
+void oskar_station_set_array_fft_tolerance(oskar_Station* model,
+        double value)
+{
+    model->array_fft_tolerance = value;
+    model->array_fft_spread = 0;
+}
+
 void oskar_station_set_seed_time_variable_errors(oskar_Station* model,
         unsigned int value)
 {
     model->seed_time_variable_errors = value;
+    oskar_station_update_generation(model);
+}
+
+void oskar_station_update_generation(oskar_Station* model)
+{
+#pragma omp critical (oskar_station_generation)
+    {
+        if (++generation_counter == 0) ++generation_counter;
+        model->generation = generation_counter;
+    }
 }
 
 #ifdef __cplusplus
@@ -28,13 +28,17 @@
 
 #include "telescope/station/private_station.h"
 #include "telescope/station/oskar_station.h"
+#include "telescope/station/oskar_evaluate_array_pattern_fft.h"
 
+#include <math.h>
 #include <stdlib.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+static void analyse_lattice(oskar_Station* station, int* status);
+
 void oskar_station_analyse(oskar_Station* station,
         int* finished_identical_station_check, int* status)
 {
@@ -60,6 +64,7 @@ void oskar_station_analyse(oskar_Station* station,
     station->apply_element_errors = 0;
     station->apply_element_weight = 0;
     station->common_element_orientation = 1;
+    station->array_is_lattice = 0;
 
     /* Analyse orientations separately (always double precision). */
     mount_type = oskar_mem_char(station->element_mount_types_cpu);
@@ -151,9 +156,16 @@ void oskar_station_analyse(oskar_Station* station,
         }
     }
 
+    /* Check if the elements of a planar array lie on a regular lattice. */
+    if (!station->array_is_3d)
+        analyse_lattice(station, status);
+    oskar_evaluate_array_pattern_fft_analyse(station, status);
+
     /* Check if station has child stations. */
     if (oskar_station_has_child(station))
     {
+        int* equivalent;
+
         /* Recursively analyse all child stations. */
         for (i = 0; i < station->num_elements; ++i)
         {
@@ -161,28 +173,135 @@ void oskar_station_analyse(oskar_Station* station,
                     finished_identical_station_check, status);
         }
 
-        /* Check if we need to examine every station. */
-        if (*finished_identical_station_check)
-        {
-            station->identical_children = 0;
-        }
-        else
+        /* Find the first equivalent child station for each child. */
+        oskar_mem_realloc(station->equivalent_child_cpu,
+                station->num_elements, status);
+        if (*status) return;
+        equivalent = oskar_mem_int(station->equivalent_child_cpu, status);
+        station->identical_children = 1;
+        for (i = 0; i < station->num_elements; ++i)
         {
-            /* Check if child stations are identical. */
-            station->identical_children = 1;
-            for (i = 1; i < station->num_elements; ++i)
+            int j;
+            equivalent[i] = i;
+
+            /* Check if we need to examine every station. */
+            if (!*finished_identical_station_check)
             {
-                if (oskar_station_different(
-                        oskar_station_child_const(station, 0),
-                        oskar_station_child_const(station, i), status))
+                /* Compare only with the first child of each group. */
+                for (j = 0; j < i; ++j)
                 {
-                    station->identical_children = 0;
+                    if (equivalent[j] == j && !oskar_station_different(
+                            oskar_station_child_const(station, j),
+                            oskar_station_child_const(station, i), status))
+                    {
+                        equivalent[i] = j;
+                        break;
+                    }
                 }
             }
+            if (equivalent[i] != 0)
+                station->identical_children = 0;
         }
     }
 }
 
+static int find_lattice(oskar_Station* station, const double* x,
+        const double* y)
+{
+    int i, min_idx[2], max_idx[2];
+    double a[2] = {0.0, 0.0}, b[2] = {0.0, 0.0};
+    double len_a = 0.0, len_b = 0.0, det;
+    const double tol = 1e-4;
+    const int n = station->num_elements;
+
+    /* Find the shortest vector from the first element to any other. */
+    for (i = 1; i < n; ++i)
+    {
+        const double dx = x[i] - x[0], dy = y[i] - y[0];
+        const double d2 = dx * dx + dy * dy;
+        if (d2 > 0.0 && (len_a == 0.0 || d2 < len_a))
+        {
+            a[0] = dx;
+            a[1] = dy;
+            len_a = d2;
+        }
+    }
+    if (len_a == 0.0) return 0;
+
+    /* Find the shortest vector that is not parallel to the first.
+     * If there is none, the elements form a linear array. */
+    for (i = 1; i < n; ++i)
+    {
+        const double dx = x[i] - x[0], dy = y[i] - y[0];
+        const double d2 = dx * dx + dy * dy;
+        if (fabs(a[0] * dy - a[1] * dx) > tol * sqrt(len_a * d2) &&
+                (len_b == 0.0 || d2 < len_b))
+        {
+            b[0] = dx;
+            b[1] = dy;
+            len_b = d2;
+        }
+    }
+    if (len_b == 0.0)
+    {
+        b[0] = -a[1];
+        b[1] = a[0];
+    }
+
+    /* Check that all elements are at integer multiples of the basis. */
+    det = a[0] * b[1] - a[1] * b[0];
+    min_idx[0] = min_idx[1] = max_idx[0] = max_idx[1] = 0;
+    for (i = 0; i < n; ++i)
+    {
+        int j, idx[2];
+        double c[2];
+        const double dx = x[i] - x[0], dy = y[i] - y[0];
+        c[0] = (dx * b[1] - dy * b[0]) / det;
+        c[1] = (a[0] * dy - a[1] * dx) / det;
+        for (j = 0; j < 2; ++j)
+        {
+            idx[j] = (int) floor(c[j] + 0.5);
+            if (fabs(c[j] - idx[j]) > tol) return 0;
+            if (idx[j] < min_idx[j]) min_idx[j] = idx[j];
+            if (idx[j] > max_idx[j]) max_idx[j] = idx[j];
+        }
+    }
+
+    /* Don't use very sparsely-populated lattices. */
+    if ((double)(max_idx[0] - min_idx[0] + 1) *
+            (double)(max_idx[1] - min_idx[1] + 1) > 16.0 * n)
+        return 0;
+
+    /* Store the lattice, with the origin at the lowest index. */
+    station->lattice_size[0] = max_idx[0] - min_idx[0] + 1;
+    station->lattice_size[1] = max_idx[1] - min_idx[1] + 1;
+    station->lattice_origin[0] = x[0] + min_idx[0] * a[0] + min_idx[1] * b[0];
+    station->lattice_origin[1] = y[0] + min_idx[0] * a[1] + min_idx[1] * b[1];
+    station->lattice_basis[0] = a[0];
+    station->lattice_basis[1] = a[1];
+    station->lattice_basis[2] = b[0];
+    station->lattice_basis[3] = b[1];
+    return 1;
+}
+
+static void analyse_lattice(oskar_Station* station, int* status)
+{
+    oskar_Mem *x, *y;
+    if (*status || station->num_elements < 4) return;
+
+    /* Get element coordinates in double precision. */
+    x = oskar_mem_convert_precision(station->element_true_x_enu_metres,
+            OSKAR_DOUBLE, status);
+    y = oskar_mem_convert_precision(station->element_true_y_enu_metres,
+            OSKAR_DOUBLE, status);
+    if (!*status)
+        station->array_is_lattice = find_lattice(station,
+                oskar_mem_double_const(x, status),
+                oskar_mem_double_const(y, status));
+    oskar_mem_free(x, status);
+    oskar_mem_free(y, status);
+}
+
 #ifdef __cplusplus
 }
 #endif
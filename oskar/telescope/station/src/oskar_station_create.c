@@ -101,6 +101,8 @@ oskar_Station* oskar_station_create(int type, int location, int num_elements,
             oskar_mem_create(OSKAR_INT, OSKAR_CPU, num_elements, status);
     model->element_mount_types_cpu =
             oskar_mem_create(OSKAR_CHAR, OSKAR_CPU, num_elements, status);
+    model->equivalent_child_cpu =
+            oskar_mem_create(OSKAR_INT, OSKAR_CPU, 0, status);
     model->permitted_beam_az_rad =
             oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, 0, status);
     model->permitted_beam_el_rad =
@@ -134,7 +136,16 @@ oskar_Station* oskar_station_create(int type, int location, int num_elements,
     model->array_is_3d = OSKAR_FALSE;
     model->apply_element_errors = OSKAR_FALSE;
     model->apply_element_weight = OSKAR_FALSE;
+    model->array_is_lattice = OSKAR_FALSE;
+    model->lattice_size[0] = model->lattice_size[1] = 0;
+    model->lattice_origin[0] = model->lattice_origin[1] = 0.0;
+    model->lattice_basis[0] = model->lattice_basis[1] = 0.0;
+    model->lattice_basis[2] = model->lattice_basis[3] = 0.0;
+    model->enable_array_fft = OSKAR_FALSE;
+    model->array_fft_tolerance = 1e-6;
+    model->array_fft_spread = 0;
     model->seed_time_variable_errors = 1;
+    oskar_station_update_generation(model);
     model->child = 0;
     model->element = 0;
     model->num_permitted_beams = 0;
@@ -80,6 +80,17 @@ oskar_Station* oskar_station_create_copy(const oskar_Station* src,
     model->array_is_3d = src->array_is_3d;
     model->apply_element_errors = src->apply_element_errors;
     model->apply_element_weight = src->apply_element_weight;
+    model->array_is_lattice = src->array_is_lattice;
+    for (i = 0; i < 2; ++i)
+    {
+        model->lattice_size[i] = src->lattice_size[i];
+        model->lattice_origin[i] = src->lattice_origin[i];
+    }
+    for (i = 0; i < 4; ++i)
+        model->lattice_basis[i] = src->lattice_basis[i];
+    model->enable_array_fft = src->enable_array_fft;
+    model->array_fft_tolerance = src->array_fft_tolerance;
+    model->array_fft_spread = src->array_fft_spread;
     model->seed_time_variable_errors = src->seed_time_variable_errors;
     model->num_permitted_beams = src->num_permitted_beams;
 
@@ -122,6 +133,7 @@ oskar_Station* oskar_station_create_copy(const oskar_Station* src,
     oskar_mem_copy(model->element_types, src->element_types, status);
     oskar_mem_copy(model->element_types_cpu, src->element_types_cpu, status);
     oskar_mem_copy(model->element_mount_types_cpu, src->element_mount_types_cpu, status);
+    oskar_mem_copy(model->equivalent_child_cpu, src->equivalent_child_cpu, status);
     oskar_mem_copy(model->permitted_beam_az_rad, src->permitted_beam_az_rad, status);
     oskar_mem_copy(model->permitted_beam_el_rad, src->permitted_beam_el_rad, status);
 
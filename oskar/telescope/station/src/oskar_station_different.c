@@ -63,6 +63,8 @@ int oskar_station_different(const oskar_Station* a, const oskar_Station* b,
             a->array_is_3d != b->array_is_3d ||
             a->apply_element_errors != b->apply_element_errors ||
             a->apply_element_weight != b->apply_element_weight ||
+            a->enable_array_fft != b->enable_array_fft ||
+            a->array_fft_tolerance != b->array_fft_tolerance ||
             a->gaussian_beam_fwhm_rad != b->gaussian_beam_fwhm_rad ||
             a->gaussian_beam_reference_freq_hz != b->gaussian_beam_reference_freq_hz ||
             a->num_permitted_beams != b->num_permitted_beams)
@@ -87,6 +87,7 @@ void oskar_station_override_element_gains(oskar_Station* s, unsigned int seed,
                 gain[i] = gain_mean + gain_std * r[0];
             }
         }
+        oskar_station_update_generation(s);
     }
 }
 
@@ -86,6 +86,7 @@ void oskar_station_override_element_phases(oskar_Station* s, unsigned int seed,
                 phase[i] = phase_std * r[0];
             }
         }
+        oskar_station_update_generation(s);
     }
 }
 
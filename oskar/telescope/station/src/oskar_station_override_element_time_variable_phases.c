@@ -56,6 +56,7 @@ void oskar_station_override_element_time_variable_phases(oskar_Station* s,
         /* Override element data at last level. */
         oskar_mem_set_value_real(s->element_phase_error_rad,
                 phase_std, 0, 0, status);
+        oskar_station_update_generation(s);
     }
 }
 
@@ -84,6 +84,7 @@ void oskar_station_resize(oskar_Station* station, int num_elements,
 
     /* Set the new number of elements. */
     station->num_elements = num_elements;
+    oskar_station_update_generation(station);
 }
 
 #ifdef __cplusplus
@@ -95,6 +95,7 @@ void oskar_station_set_element_errors(oskar_Station* dst,
         oskar_mem_set_element_real(
                 dst->element_phase_error_rad, index, phase_error, status);
     }
+    oskar_station_update_generation(dst);
 }
 
 #ifdef __cplusplus
@@ -28,13 +28,18 @@
 
 #include "telescope/station/oskar_station_work.h"
 #include "telescope/station/private_station_work.h"
+#include "telescope/station/oskar_evaluate_element_weights_errors_block.h"
+#include "telescope/oskar_telescope.h"
+
+#include <stdlib.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-static void get_mem_from_template(oskar_Mem** b, const oskar_Mem* a,
-        size_t length, int* status);
+static void get_mem_from_template(oskar_StationWork* work, oskar_Mem** b,
+        const oskar_Mem* a, size_t length, int* status);
+static size_t work_memory(const oskar_StationWork* work);
 
 oskar_StationWork* oskar_station_work_create(int type,
         int location, int* status)
@@ -51,11 +56,17 @@ oskar_StationWork* oskar_station_work_create(int type,
     /* Initialise arrays. */
     work->horizon_mask = oskar_mem_create(OSKAR_INT, location, 0, status);
     work->source_indices = oskar_mem_create(OSKAR_INT, location, 0, status);
+    work->child_rows = oskar_mem_create(OSKAR_INT, location, 0, status);
     work->theta_modified = oskar_mem_create(type, location, 0, status);
     work->phi_modified = oskar_mem_create(type, location, 0, status);
+    work->element_interp = oskar_mem_create(type, location, 0, status);
     work->enu_direction_x = oskar_mem_create(type, location, 0, status);
     work->enu_direction_y = oskar_mem_create(type, location, 0, status);
     work->enu_direction_z = oskar_mem_create(type, location, 0, status);
+    work->visible_x = oskar_mem_create(type, location, 0, status);
+    work->visible_y = oskar_mem_create(type, location, 0, status);
+    work->visible_z = oskar_mem_create(type, location, 0, status);
+    work->visible_beam = 0;
     work->weights = oskar_mem_create((type | OSKAR_COMPLEX),
             location, 0, status);
     work->weights_error = oskar_mem_create((type | OSKAR_COMPLEX),
@@ -65,6 +76,23 @@ oskar_StationWork* oskar_station_work_create(int type,
     work->normalised_beam = 0;
     work->num_depths = 0;
     work->beam = 0;
+    work->max_bytes = 0;
+    work->peak_bytes = 0;
+    work->element_errors = 0;
+    work->element_errors_station = 0;
+    work->element_errors_generation = 0;
+    work->element_errors_station_generation = 0;
+    work->element_errors_ptr = 0;
+    work->element_errors_offset = 0;
+    work->element_errors_num_ids = 0;
+    work->element_errors_num_per_time = 0;
+    work->element_errors_time_start = 0;
+    work->element_errors_num_times = 0;
+    work->parent = 0;
+    work->type = type;
+    work->location = location;
+    work->num_threads = 0;
+    work->thread_work = 0;
 
     return work;
 }
@@ -76,21 +104,38 @@ void oskar_station_work_free(oskar_StationWork* work, int* status)
 
     oskar_mem_free(work->horizon_mask, status);
     oskar_mem_free(work->source_indices, status);
+    oskar_mem_free(work->child_rows, status);
     oskar_mem_free(work->theta_modified, status);
     oskar_mem_free(work->phi_modified, status);
+    oskar_mem_free(work->element_interp, status);
     oskar_mem_free(work->enu_direction_x, status);
     oskar_mem_free(work->enu_direction_y, status);
     oskar_mem_free(work->enu_direction_z, status);
+    oskar_mem_free(work->visible_x, status);
+    oskar_mem_free(work->visible_y, status);
+    oskar_mem_free(work->visible_z, status);
+    oskar_mem_free(work->visible_beam, status);
     oskar_mem_free(work->weights, status);
     oskar_mem_free(work->weights_error, status);
     oskar_mem_free(work->array_pattern, status);
     oskar_mem_free(work->normalised_beam, status);
+    oskar_mem_free(work->element_errors, status);
+    oskar_mem_free(work->element_errors_station, status);
+    free(work->element_errors_ptr);
+    free(work->element_errors_offset);
 
     for (i = 0; i < work->num_depths; ++i)
     {
         oskar_mem_free(work->beam[i], status);
     }
 
+    /* Free the per-thread work buffers (the first one is this one). */
+    for (i = 1; i < work->num_threads; ++i)
+    {
+        oskar_station_work_free(work->thread_work[i], status);
+    }
+    free(work->thread_work);
+
     /* Free the structure. */
     free(work);
 }
@@ -123,11 +168,19 @@ oskar_Mem* oskar_station_work_enu_direction_z(oskar_StationWork* work)
 oskar_Mem* oskar_station_work_normalised_beam(oskar_StationWork* work,
         const oskar_Mem* output_beam, int* status)
 {
-    get_mem_from_template(&work->normalised_beam, output_beam,
+    get_mem_from_template(work, &work->normalised_beam, output_beam,
             1 + oskar_mem_length(output_beam), status);
     return work->normalised_beam;
 }
 
+oskar_Mem* oskar_station_work_visible_beam(oskar_StationWork* work,
+        const oskar_Mem* output_beam, size_t length, int* status)
+{
+    get_mem_from_template(work, &work->visible_beam, output_beam, length,
+            status);
+    return work->visible_beam;
+}
+
 oskar_Mem* oskar_station_work_beam(oskar_StationWork* work,
         const oskar_Mem* output_beam, size_t length, int depth, int* status)
 {
@@ -143,14 +196,236 @@ oskar_Mem* oskar_station_work_beam(oskar_StationWork* work,
         }
     }
 
-    get_mem_from_template(&work->beam[depth], output_beam, length, status);
+    get_mem_from_template(work, &work->beam[depth], output_beam, length,
+            status);
     return work->beam[depth];
 }
 
-static void get_mem_from_template(oskar_Mem** b, const oskar_Mem* a,
-        size_t length, int* status)
+oskar_StationWork** oskar_station_work_thread_pool(oskar_StationWork* work,
+        int num_threads, int* status)
+{
+    if (*status) return 0;
+    if (num_threads > work->num_threads)
+    {
+        int i;
+        oskar_StationWork** t;
+        t = (oskar_StationWork**) realloc(work->thread_work,
+                num_threads * sizeof(oskar_StationWork*));
+        if (!t)
+        {
+            *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+            return 0;
+        }
+        work->thread_work = t;
+        work->thread_work[0] = work;
+        for (i = (work->num_threads > 1 ? work->num_threads : 1);
+                i < num_threads; ++i)
+        {
+            work->thread_work[i] = oskar_station_work_create(work->type,
+                    work->location, status);
+            work->thread_work[i]->max_bytes = work->max_bytes;
+            work->thread_work[i]->parent = work;
+        }
+        work->num_threads = num_threads;
+    }
+    return work->thread_work;
+}
+
+void oskar_station_work_set_max_memory(oskar_StationWork* work,
+        size_t max_bytes)
+{
+    int i;
+    work->max_bytes = max_bytes;
+    for (i = 1; i < work->num_threads; ++i)
+        work->thread_work[i]->max_bytes = max_bytes;
+}
+
+size_t oskar_station_work_max_memory(const oskar_StationWork* work)
+{
+    return work->max_bytes;
+}
+
+size_t oskar_station_work_memory_peak(const oskar_StationWork* work)
+{
+    int i;
+    size_t peak, current;
+    current = work_memory(work);
+    peak = work->peak_bytes > current ? work->peak_bytes : current;
+    for (i = 1; i < work->num_threads; ++i)
+        peak += oskar_station_work_memory_peak(work->thread_work[i]);
+    return peak;
+}
+
+/* Returns the latest generation of the station and its children. */
+static unsigned int station_generation(const oskar_Station* s)
+{
+    int i;
+    unsigned int g, generation = oskar_station_generation(s);
+    if (oskar_station_has_child(s))
+    {
+        for (i = 0; i < oskar_station_num_elements(s); ++i)
+        {
+            g = station_generation(oskar_station_child_const(s, i));
+            if (g > generation) generation = g;
+        }
+    }
+    return generation;
+}
+
+/* Appends the station and its children that apply element errors. */
+static void collect_stations(const oskar_Station* s, int* num_stations,
+        const oskar_Station*** stations, int* max_id, int* status)
+{
+    int i;
+    if (*status) return;
+    if (oskar_station_apply_element_errors(s) &&
+            oskar_station_num_elements(s) > 0)
+    {
+        const oskar_Station** t = (const oskar_Station**) realloc(
+                (void*)*stations,
+                (*num_stations + 1) * sizeof(oskar_Station*));
+        if (!t)
+        {
+            *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+            return;
+        }
+        *stations = t;
+        (*stations)[(*num_stations)++] = s;
+        if (oskar_station_unique_id(s) > *max_id)
+            *max_id = oskar_station_unique_id(s);
+    }
+    if (oskar_station_has_child(s))
+    {
+        for (i = 0; i < oskar_station_num_elements(s); ++i)
+            collect_stations(oskar_station_child_const(s, i), num_stations,
+                    stations, max_id, status);
+    }
+}
+
+void oskar_station_work_evaluate_element_errors(oskar_StationWork* work,
+        const oskar_Telescope* tel, int time_index_start, int num_times,
+        int* status)
+{
+    int i, num_stations = 0, max_id = -1, *offsets = 0;
+    const oskar_Station** stations = 0;
+    unsigned int generation, station_gen = 0, g;
+    if (*status) return;
+
+    /* Check if the cache already holds these times for this telescope,
+     * and that no station has been modified since it was filled. */
+    generation = oskar_telescope_generation(tel);
+    for (i = 0; i < oskar_telescope_num_stations(tel); ++i)
+    {
+        g = station_generation(oskar_telescope_station_const(tel, i));
+        if (g > station_gen) station_gen = g;
+    }
+    if (work->element_errors_generation == generation &&
+            work->element_errors_station_generation == station_gen &&
+            time_index_start >= work->element_errors_time_start &&
+            time_index_start + num_times <= work->element_errors_time_start +
+            work->element_errors_num_times)
+        return;
+    work->element_errors_generation = 0;
+    if (work->location != OSKAR_CPU ||
+            oskar_telescope_mem_location(tel) != OSKAR_CPU || num_times <= 0)
+        return;
+
+    /* Get the stations that apply element errors. */
+    for (i = 0; i < oskar_telescope_num_stations(tel); ++i)
+        collect_stations(oskar_telescope_station_const(tel, i),
+                &num_stations, &stations, &max_id, status);
+
+    /* Set the offset of each station in the cache, indexed by unique ID. */
+    if (!*status && max_id >= 0)
+    {
+        const void** t = (const void**) realloc(
+                (void*)work->element_errors_ptr,
+                (max_id + 1) * sizeof(void*));
+        int* o = 0;
+        if (t)
+        {
+            work->element_errors_ptr = t;
+            o = (int*) realloc(work->element_errors_offset,
+                    (max_id + 1) * sizeof(int));
+            if (o) work->element_errors_offset = o;
+        }
+        if (!o) *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+    }
+    if (!*status)
+    {
+        offsets = (int*) malloc((num_stations + 1) * sizeof(int));
+        if (!offsets) *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+    }
+    if (*status)
+    {
+        free((void*)stations);
+        return;
+    }
+    work->element_errors_num_ids = max_id + 1;
+    for (i = 0; i <= max_id; ++i)
+    {
+        work->element_errors_ptr[i] = 0;
+        work->element_errors_offset[i] = -1;
+    }
+    offsets[0] = 0;
+    for (i = 0; i < num_stations; ++i)
+    {
+        const int id = oskar_station_unique_id(stations[i]);
+        work->element_errors_ptr[id] = stations[i];
+        work->element_errors_offset[id] = offsets[i];
+        offsets[i + 1] = offsets[i] + oskar_station_num_elements(stations[i]);
+    }
+    work->element_errors_num_per_time = offsets[num_stations];
+
+    /* Generate the errors for all stations and times in one pass. */
+    if (num_stations > 0)
+    {
+        if (!work->element_errors)
+            work->element_errors = oskar_mem_create(
+                    work->type | OSKAR_COMPLEX, OSKAR_CPU, 0, status);
+        oskar_evaluate_element_weights_errors_block(num_stations, stations,
+                offsets, time_index_start, num_times, work->element_errors,
+                status);
+    }
+    free(offsets);
+    free((void*)stations);
+    if (*status) return;
+    work->element_errors_generation = generation;
+    work->element_errors_station_generation = station_gen;
+    work->element_errors_time_start = time_index_start;
+    work->element_errors_num_times = num_times;
+}
+
+const oskar_Mem* oskar_station_work_element_errors(oskar_StationWork* work,
+        const oskar_Station* station, int time_index, int* status)
+{
+    int id, t;
+    const oskar_StationWork* cache;
+    if (*status) return 0;
+
+    /* The cache is held by the owner of the thread pool. */
+    cache = work->parent ? work->parent : work;
+    id = oskar_station_unique_id(station);
+    t = time_index - cache->element_errors_time_start;
+    if (!cache->element_errors_generation || t < 0 ||
+            t >= cache->element_errors_num_times || id < 0 ||
+            id >= cache->element_errors_num_ids ||
+            cache->element_errors_ptr[id] != (const void*)station)
+        return 0;
+    if (!work->element_errors_station)
+        work->element_errors_station = oskar_mem_create_alias(0, 0, 0, status);
+    oskar_mem_set_alias(work->element_errors_station, cache->element_errors,
+            (size_t)t * cache->element_errors_num_per_time +
+            cache->element_errors_offset[id],
+            oskar_station_num_elements(station), status);
+    return work->element_errors_station;
+}
+
+static void get_mem_from_template(oskar_StationWork* work, oskar_Mem** b,
+        const oskar_Mem* a, size_t length, int* status)
 {
     int type, loc;
+    size_t current;
     type = oskar_mem_type(a);
     loc = oskar_mem_location(a);
 
@@ -161,11 +436,51 @@ static void get_mem_from_template(oskar_Mem** b, const oskar_Mem* a,
         *b = 0;
     }
 
-    /* Create or resize the array. */
+    /* Create or resize the array.
+     * If over the memory limit, shrink it if it is larger than needed. */
     if (!*b)
         *b = oskar_mem_create(type, loc, length, status);
-    else if (oskar_mem_length(*b) < length)
+    else if (oskar_mem_length(*b) < length || (work->max_bytes > 0 &&
+            oskar_mem_length(*b) > length &&
+            work_memory(work) > work->max_bytes))
         oskar_mem_realloc(*b, length, status);
+
+    /* Record the peak memory usage. */
+    current = work_memory(work);
+    if (current > work->peak_bytes) work->peak_bytes = current;
+}
+
+static size_t mem_bytes(const oskar_Mem* mem)
+{
+    if (!mem) return 0;
+    return oskar_mem_length(mem) * oskar_mem_element_size(oskar_mem_type(mem));
+}
+
+static size_t work_memory(const oskar_StationWork* work)
+{
+    int i;
+    size_t bytes = 0;
+    bytes += mem_bytes(work->horizon_mask);
+    bytes += mem_bytes(work->source_indices);
+    bytes += mem_bytes(work->child_rows);
+    bytes += mem_bytes(work->enu_direction_x);
+    bytes += mem_bytes(work->enu_direction_y);
+    bytes += mem_bytes(work->enu_direction_z);
+    bytes += mem_bytes(work->visible_x);
+    bytes += mem_bytes(work->visible_y);
+    bytes += mem_bytes(work->visible_z);
+    bytes += mem_bytes(work->visible_beam);
+    bytes += mem_bytes(work->theta_modified);
+    bytes += mem_bytes(work->phi_modified);
+    bytes += mem_bytes(work->element_interp);
+    bytes += mem_bytes(work->weights);
+    bytes += mem_bytes(work->weights_error);
+    bytes += mem_bytes(work->array_pattern);
+    bytes += mem_bytes(work->normalised_beam);
+    bytes += mem_bytes(work->element_errors);
+    for (i = 0; i < work->num_depths; ++i)
+        bytes += mem_bytes(work->beam[i]);
+    return bytes;
 }
 
 #ifdef __cplusplus
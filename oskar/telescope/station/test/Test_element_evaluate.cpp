@@ -0,0 +1,326 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "telescope/station/element/private_element.h"
+#include "telescope/station/element/oskar_element.h"
+#include "utility/oskar_get_error_string.h"
+
+#include "math/oskar_cmath.h"
+#include <cstdlib>
+#include <vector>
+
+static void fit_surface(oskar_Splines* spline, double a, double b, double c,
+        int* status, double d = 1.0)
+{
+    // Fit a smooth function of direction on the sphere.
+    std::vector<double> theta, phi, data, weight;
+    for (int j = 0; j <= 36; ++j)
+    {
+        for (int i = 0; i < 72; ++i)
+        {
+            double t = j * M_PI / 36.0, p = i * 2.0 * M_PI / 72.0;
+            double x = sin(t) * cos(p), y = sin(t) * sin(p), z = cos(t);
+            theta.push_back(t);
+            phi.push_back(p);
+            data.push_back(d + a * x + b * y * z + c * z * z);
+            weight.push_back(1.0);
+        }
+    }
+    double avg_frac_err = 1e-4;
+    oskar_splines_fit(spline, (int)theta.size(), &theta[0], &phi[0],
+            &data[0], &weight[0], OSKAR_SPLINES_SPHERICAL, 1,
+            &avg_frac_err, 1.5, 1.0, 1e-14, status);
+}
+
+static double max_diff(const oskar_Mem* a, const oskar_Mem* b, int* status)
+{
+    double d = 0.0;
+    const double* a_ = oskar_mem_double_const(a, status);
+    const double* b_ = oskar_mem_double_const(b, status);
+    for (size_t i = 0; i < 8 * oskar_mem_length(a); ++i)
+        if (fabs(a_[i] - b_[i]) > d) d = fabs(a_[i] - b_[i]);
+    return d;
+}
+
+TEST(element, tabulate)
+{
+    int status = 0, num_points = 5000;
+    double freq_hz = 100e6, err_linear = 0.0, err_cubic = 0.0;
+    int type = OSKAR_DOUBLE, loc = OSKAR_CPU;
+
+    // Create an element with fitted surfaces for both dipoles.
+    oskar_Element* e = oskar_element_create(type, loc, &status);
+    oskar_element_resize_freq_data(e, 1, &status);
+    e->freqs_hz[0] = freq_hz;
+    fit_surface(oskar_element_x_h_re(e, 0), 0.5, -0.3, 0.2, &status);
+    fit_surface(oskar_element_x_h_im(e, 0), -0.2, 0.1, 0.4, &status);
+    fit_surface(oskar_element_x_v_re(e, 0), 0.1, 0.6, -0.3, &status);
+    fit_surface(oskar_element_x_v_im(e, 0), 0.3, 0.2, 0.1, &status);
+    fit_surface(oskar_element_y_h_re(e, 0), -0.4, 0.3, 0.2, &status);
+    fit_surface(oskar_element_y_h_im(e, 0), 0.2, -0.1, 0.3, &status);
+    fit_surface(oskar_element_y_v_re(e, 0), 0.6, 0.1, -0.2, &status);
+    fit_surface(oskar_element_y_v_im(e, 0), -0.1, 0.4, 0.5, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Generate random directions above the horizon.
+    oskar_Mem *x, *y, *z, *theta, *phi, *ref, *out;
+    x = oskar_mem_create(type, loc, num_points, &status);
+    y = oskar_mem_create(type, loc, num_points, &status);
+    z = oskar_mem_create(type, loc, num_points, &status);
+    theta = oskar_mem_create(type, loc, num_points, &status);
+    phi = oskar_mem_create(type, loc, num_points, &status);
+    srand(2);
+    oskar_mem_random_range(x, -0.7, 0.7, &status);
+    oskar_mem_random_range(y, -0.7, 0.7, &status);
+    double* x_ = oskar_mem_double(x, &status);
+    double* y_ = oskar_mem_double(y, &status);
+    double* z_ = oskar_mem_double(z, &status);
+    for (int i = 0; i < num_points; ++i)
+        z_[i] = sqrt(1.0 - x_[i] * x_[i] - y_[i] * y_[i]);
+
+    // Evaluate the splines directly.
+    ref = oskar_mem_create(type | OSKAR_COMPLEX | OSKAR_MATRIX, loc,
+            num_points, &status);
+    out = oskar_mem_create(type | OSKAR_COMPLEX | OSKAR_MATRIX, loc,
+            num_points, &status);
+    oskar_element_evaluate(e, ref, 0.0, M_PI / 2.0, num_points, x, y, z,
+            freq_hz, theta, phi, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Check the interpolated tables against the splines.
+    oskar_element_tabulate(e, 181, 360, OSKAR_ELEMENT_TABLE_BILINEAR,
+            &err_linear, &status);
+    oskar_element_evaluate(e, out, 0.0, M_PI / 2.0, num_points, x, y, z,
+            freq_hz, theta, phi, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    EXPECT_GT(err_linear, 0.0);
+    EXPECT_LT(err_linear, 1e-3);
+    EXPECT_LT(max_diff(ref, out, &status), 4.0 * err_linear);
+
+    oskar_element_tabulate(e, 181, 360, OSKAR_ELEMENT_TABLE_BICUBIC,
+            &err_cubic, &status);
+    oskar_element_evaluate(e, out, 0.0, M_PI / 2.0, num_points, x, y, z,
+            freq_hz, theta, phi, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    EXPECT_LT(err_cubic, err_linear);
+    EXPECT_LT(max_diff(ref, out, &status), 4.0 * err_cubic);
+
+    // Check that copies use the same tables.
+    oskar_Element* e2 = oskar_element_create(type, loc, &status);
+    oskar_Mem* out2 = oskar_mem_create(type | OSKAR_COMPLEX | OSKAR_MATRIX,
+            loc, num_points, &status);
+    oskar_element_copy(e2, e, &status);
+    oskar_element_evaluate(e2, out2, 0.0, M_PI / 2.0, num_points, x, y, z,
+            freq_hz, theta, phi, &status);
+    EXPECT_EQ(0.0, max_diff(out, out2, &status));
+
+    // Check that removing the tables restores the spline evaluation.
+    oskar_element_tabulate(e, 0, 0, 0, 0, &status);
+    oskar_element_evaluate(e, out, 0.0, M_PI / 2.0, num_points, x, y, z,
+            freq_hz, theta, phi, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    EXPECT_EQ(0.0, max_diff(ref, out, &status));
+
+    oskar_mem_free(x, &status);
+    oskar_mem_free(y, &status);
+    oskar_mem_free(z, &status);
+    oskar_mem_free(theta, &status);
+    oskar_mem_free(phi, &status);
+    oskar_mem_free(ref, &status);
+    oskar_mem_free(out, &status);
+    oskar_mem_free(out2, &status);
+    oskar_element_free(e, &status);
+    oskar_element_free(e2, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+}
+
+TEST(element, interpolate_freq)
+{
+    int status = 0, num_points = 1000;
+    int type = OSKAR_DOUBLE, loc = OSKAR_CPU;
+    int mat = type | OSKAR_COMPLEX | OSKAR_MATRIX;
+
+    // Create an element with different surfaces at two frequencies.
+    oskar_Element* e = oskar_element_create(type, loc, &status);
+    oskar_element_resize_freq_data(e, 2, &status);
+    e->freqs_hz[0] = 200e6;
+    e->freqs_hz[1] = 100e6;
+    for (int f = 0; f < 2; ++f)
+    {
+        double s = f ? 1.0 : -0.5;
+        fit_surface(oskar_element_x_h_re(e, f), 0.5 * s, -0.3, 0.2, &status);
+        fit_surface(oskar_element_x_h_im(e, f), -0.2, 0.1 * s, 0.4, &status);
+        fit_surface(oskar_element_x_v_re(e, f), 0.1, 0.6, -0.3 * s, &status);
+        fit_surface(oskar_element_x_v_im(e, f), 0.3 * s, 0.2, 0.1, &status);
+        fit_surface(oskar_element_y_h_re(e, f), -0.4, 0.3 * s, 0.2, &status);
+        fit_surface(oskar_element_y_h_im(e, f), 0.2, -0.1, 0.3 * s, &status);
+        fit_surface(oskar_element_y_v_re(e, f), 0.6 * s, 0.1, -0.2, &status);
+        fit_surface(oskar_element_y_v_im(e, f), -0.1, 0.4 * s, 0.5, &status);
+    }
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Generate random directions above the horizon.
+    oskar_Mem *x, *y, *z, *theta, *phi, *e1, *e2, *out;
+    x = oskar_mem_create(type, loc, num_points, &status);
+    y = oskar_mem_create(type, loc, num_points, &status);
+    z = oskar_mem_create(type, loc, num_points, &status);
+    theta = oskar_mem_create(type, loc, num_points, &status);
+    phi = oskar_mem_create(type, loc, num_points, &status);
+    srand(3);
+    oskar_mem_random_range(x, -0.7, 0.7, &status);
+    oskar_mem_random_range(y, -0.7, 0.7, &status);
+    double* x_ = oskar_mem_double(x, &status);
+    double* y_ = oskar_mem_double(y, &status);
+    double* z_ = oskar_mem_double(z, &status);
+    for (int i = 0; i < num_points; ++i)
+        z_[i] = sqrt(1.0 - x_[i] * x_[i] - y_[i] * y_[i]);
+
+    // Evaluate the responses at both fitted frequencies.
+    e1 = oskar_mem_create(mat, loc, num_points, &status);
+    e2 = oskar_mem_create(mat, loc, num_points, &status);
+    out = oskar_mem_create(mat, loc, num_points, &status);
+    oskar_element_evaluate(e, e1, 0.0, M_PI / 2.0, num_points, x, y, z,
+            100e6, theta, phi, &status);
+    oskar_element_evaluate(e, e2, 0.0, M_PI / 2.0, num_points, x, y, z,
+            200e6, theta, phi, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    ASSERT_GT(max_diff(e1, e2, &status), 0.1);
+
+    // Without interpolation, the closest frequency should be used.
+    oskar_element_evaluate(e, out, 0.0, M_PI / 2.0, num_points, x, y, z,
+            130e6, theta, phi, &status);
+    EXPECT_EQ(0.0, max_diff(e1, out, &status));
+
+    // With interpolation, check the result differs from both.
+    oskar_element_set_interpolate_freq(e, 1);
+    oskar_element_evaluate(e, out, 0.0, M_PI / 2.0, num_points, x, y, z,
+            130e6, theta, phi, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    EXPECT_GT(max_diff(e1, out, &status), 0.01);
+    EXPECT_GT(max_diff(e2, out, &status), 0.01);
+
+    // Check that fitted frequencies and values outside the range are exact.
+    oskar_element_evaluate(e, out, 0.0, M_PI / 2.0, num_points, x, y, z,
+            200e6, theta, phi, &status);
+    EXPECT_EQ(0.0, max_diff(e2, out, &status));
+    oskar_element_evaluate(e, out, 0.0, M_PI / 2.0, num_points, x, y, z,
+            50e6, theta, phi, &status);
+    EXPECT_EQ(0.0, max_diff(e1, out, &status));
+
+    oskar_mem_free(x, &status);
+    oskar_mem_free(y, &status);
+    oskar_mem_free(z, &status);
+    oskar_mem_free(theta, &status);
+    oskar_mem_free(phi, &status);
+    oskar_mem_free(e1, &status);
+    oskar_mem_free(e2, &status);
+    oskar_mem_free(out, &status);
+    oskar_element_free(e, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+}
+
+TEST(element, interpolate_freq_phase_wrap)
+{
+    int status = 0, num_points = 1000;
+    int type = OSKAR_DOUBLE, loc = OSKAR_CPU, cplx = type | OSKAR_COMPLEX;
+
+    // Create a scalar element with a response close to -1 at both
+    // frequencies, with a phase either side of the wrap at 180 degrees.
+    oskar_Element* e = oskar_element_create(type, loc, &status);
+    oskar_element_resize_freq_data(e, 2, &status);
+    e->freqs_hz[0] = 100e6;
+    e->freqs_hz[1] = 200e6;
+    fit_surface(oskar_element_scalar_re(e, 0), 0.1, -0.1, 0.1, &status, -1.0);
+    fit_surface(oskar_element_scalar_im(e, 0), 0.1, 0.05, 0.0, &status, 0.3);
+    fit_surface(oskar_element_scalar_re(e, 1), -0.1, 0.1, 0.1, &status, -1.2);
+    fit_surface(oskar_element_scalar_im(e, 1), 0.05, 0.1, 0.0, &status, -0.3);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Generate random directions above the horizon.
+    oskar_Mem *x, *y, *z, *theta, *phi, *work, *e1, *e2, *out;
+    x = oskar_mem_create(type, loc, num_points, &status);
+    y = oskar_mem_create(type, loc, num_points, &status);
+    z = oskar_mem_create(type, loc, num_points, &status);
+    theta = oskar_mem_create(type, loc, num_points, &status);
+    phi = oskar_mem_create(type, loc, num_points, &status);
+    work = oskar_mem_create(type, loc, 0, &status);
+    srand(4);
+    oskar_mem_random_range(x, -0.7, 0.7, &status);
+    oskar_mem_random_range(y, -0.7, 0.7, &status);
+    double* x_ = oskar_mem_double(x, &status);
+    double* y_ = oskar_mem_double(y, &status);
+    double* z_ = oskar_mem_double(z, &status);
+    for (int i = 0; i < num_points; ++i)
+        z_[i] = sqrt(1.0 - x_[i] * x_[i] - y_[i] * y_[i]);
+
+    // Evaluate at both fitted frequencies, and between them.
+    e1 = oskar_mem_create(cplx, loc, num_points, &status);
+    e2 = oskar_mem_create(cplx, loc, num_points, &status);
+    out = oskar_mem_create(cplx, loc, num_points, &status);
+    oskar_element_set_interpolate_freq(e, 1);
+    oskar_element_evaluate_with_work(e, e1, 0.0, M_PI / 2.0, num_points,
+            x, y, z, 100e6, theta, phi, work, &status);
+    oskar_element_evaluate_with_work(e, e2, 0.0, M_PI / 2.0, num_points,
+            x, y, z, 200e6, theta, phi, work, &status);
+    oskar_element_evaluate_with_work(e, out, 0.0, M_PI / 2.0, num_points,
+            x, y, z, 125e6, theta, phi, work, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Check amplitude and phase are interpolated across the wrap.
+    const double2* e1_ = oskar_mem_double2_const(e1, &status);
+    const double2* e2_ = oskar_mem_double2_const(e2, &status);
+    const double2* out_ = oskar_mem_double2_const(out, &status);
+    for (int i = 0; i < num_points; ++i)
+    {
+        double amp1 = sqrt(e1_[i].x * e1_[i].x + e1_[i].y * e1_[i].y);
+        double amp2 = sqrt(e2_[i].x * e2_[i].x + e2_[i].y * e2_[i].y);
+        double ph1 = atan2(e1_[i].y, e1_[i].x);
+        double ph2 = atan2(e2_[i].y, e2_[i].x);
+        if (ph2 - ph1 > M_PI) ph2 -= 2.0 * M_PI;
+        if (ph2 - ph1 < -M_PI) ph2 += 2.0 * M_PI;
+        double amp = 0.75 * amp1 + 0.25 * amp2;
+        double ph = 0.75 * ph1 + 0.25 * ph2;
+        EXPECT_NEAR(amp * cos(ph), out_[i].x, 1e-12);
+        EXPECT_NEAR(amp * sin(ph), out_[i].y, 1e-12);
+        EXPECT_LT(out_[i].x, -0.9);
+    }
+
+    oskar_mem_free(x, &status);
+    oskar_mem_free(y, &status);
+    oskar_mem_free(z, &status);
+    oskar_mem_free(theta, &status);
+    oskar_mem_free(phi, &status);
+    oskar_mem_free(work, &status);
+    oskar_mem_free(e1, &status);
+    oskar_mem_free(e2, &status);
+    oskar_mem_free(out, &status);
+    oskar_element_free(e, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+}
@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "telescope/station/oskar_station.h"
+#include "telescope/station/oskar_evaluate_array_pattern_fft.h"
+#include "math/oskar_cmath.h"
+#include "math/oskar_dftw.h"
+#include "utility/oskar_get_error_string.h"
+
+#include <cmath>
+#include <cstdlib>
+
+static oskar_Station* create_lattice_station(int side, double spacing,
+        double angle_deg, double offset, int* status)
+{
+    int num_elements = 0;
+    double rot = angle_deg * M_PI / 180.0, r = (side - 1) / 2.0;
+    oskar_Station* station = oskar_station_create(OSKAR_DOUBLE, OSKAR_CPU,
+            side * side, status);
+
+    /* Place elements within a circle on a lattice, where the second basis
+     * vector is rotated from the first by the given angle. */
+    for (int j = 0; j < side; ++j)
+    {
+        for (int i = 0; i < side; ++i)
+        {
+            double x, y, enu[3];
+            if (pow(i - r, 2.0) + pow(j - r, 2.0) > r * r) continue;
+            x = spacing * (i + j * cos(rot));
+            y = spacing * j * sin(rot);
+            enu[0] = x + offset;
+            enu[1] = y - offset;
+            enu[2] = 0.0;
+            oskar_station_set_element_coords(station, num_elements++,
+                    enu, enu, status);
+        }
+    }
+    oskar_station_resize(station, num_elements, status);
+    return station;
+}
+
+static double max_fft_error(oskar_Station* station, double tolerance,
+        int* used, int* status)
+{
+    int num_points = 4000, finished = 0;
+    int num_elements = oskar_station_num_elements(station);
+    double max_err = 0.0, norm = 0.0;
+    double wavenumber = 2.0 * M_PI * 100e6 / 299792458.0;
+    oskar_station_set_enable_array_fft(station, 1);
+    oskar_station_set_array_fft_tolerance(station, tolerance);
+    oskar_station_analyse(station, &finished, status);
+
+    /* Generate random weights and directions. */
+    oskar_Mem *w = oskar_mem_create(OSKAR_DOUBLE_COMPLEX, OSKAR_CPU,
+            num_elements, status);
+    oskar_Mem *l = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU,
+            num_points, status);
+    oskar_Mem *m = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU,
+            num_points, status);
+    oskar_Mem *fft = oskar_mem_create(OSKAR_DOUBLE_COMPLEX, OSKAR_CPU,
+            0, status);
+    oskar_Mem *dft = oskar_mem_create(OSKAR_DOUBLE_COMPLEX, OSKAR_CPU,
+            num_points, status);
+    oskar_mem_random_range(w, -1.0, 1.0, status);
+    oskar_mem_random_range(l, -0.7, 0.7, status);
+    oskar_mem_random_range(m, -0.7, 0.7, status);
+
+    /* Compare the FFT with a direct DFT. */
+    *used = oskar_evaluate_array_pattern_fft(station, wavenumber, w,
+            num_points, l, m, fft, status);
+    oskar_dftw(num_elements, wavenumber,
+            oskar_station_element_true_x_enu_metres_const(station),
+            oskar_station_element_true_y_enu_metres_const(station),
+            0, w, num_points, l, m, 0, 0, dft, status);
+    if (*used && !*status)
+    {
+        const double2* w_ = oskar_mem_double2_const(w, status);
+        const double2* a = oskar_mem_double2_const(fft, status);
+        const double2* b = oskar_mem_double2_const(dft, status);
+        for (int i = 0; i < num_elements; ++i)
+            norm += sqrt(w_[i].x * w_[i].x + w_[i].y * w_[i].y);
+        for (int i = 0; i < num_points; ++i)
+        {
+            double err = sqrt(pow(a[i].x - b[i].x, 2.0) +
+                    pow(a[i].y - b[i].y, 2.0));
+            if (err > max_err) max_err = err;
+        }
+    }
+    oskar_mem_free(w, status);
+    oskar_mem_free(l, status);
+    oskar_mem_free(m, status);
+    oskar_mem_free(fft, status);
+    oskar_mem_free(dft, status);
+    return norm > 0.0 ? max_err / norm : 0.0;
+}
+
+TEST(evaluate_array_pattern_fft, lattice_detection)
+{
+    int status = 0, finished = 0;
+
+    /* Square lattice, partly filled. */
+    oskar_Station* station = create_lattice_station(16, 1.5, 90.0, 3.2,
+            &status);
+    oskar_station_analyse(station, &finished, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    EXPECT_EQ(1, oskar_station_array_is_lattice(station));
+
+    /* Move one element off the lattice. */
+    double enu[3] = {0.7, 0.1, 0.0};
+    oskar_station_set_element_coords(station, 5, enu, enu, &status);
+    oskar_station_analyse(station, &finished, &status);
+    EXPECT_EQ(0, oskar_station_array_is_lattice(station));
+    oskar_station_free(station, &status);
+
+    /* Triangular lattice. */
+    station = create_lattice_station(12, 2.0, 60.0, 0.0, &status);
+    oskar_station_analyse(station, &finished, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    EXPECT_EQ(1, oskar_station_array_is_lattice(station));
+    oskar_station_free(station, &status);
+}
+
+TEST(evaluate_array_pattern_fft, accuracy)
+{
+    int status = 0, used = 0;
+    const double tol[] = {1e-4, 1e-6, 1e-9};
+    oskar_Station* square = create_lattice_station(24, 1.5, 90.0, 3.2,
+            &status);
+    oskar_Station* skewed = create_lattice_station(20, 1.9, 60.0, -1.0,
+            &status);
+    for (int i = 0; i < 3; ++i)
+    {
+        double err = max_fft_error(square, tol[i], &used, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+        EXPECT_EQ(1, used);
+        EXPECT_LE(err, tol[i]);
+        err = max_fft_error(skewed, tol[i], &used, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+        EXPECT_EQ(1, used);
+        EXPECT_LE(err, tol[i]);
+    }
+
+    /* Check that the FFT is not used if the tolerance cannot be met. */
+    max_fft_error(skewed, 1e-16, &used, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    EXPECT_EQ(0, used);
+
+    /* Check that the FFT is not used if the station is not a lattice. */
+    double enu[3] = {0.7, 0.1, 0.0};
+    oskar_station_set_element_coords(square, 5, enu, enu, &status);
+    max_fft_error(square, 1e-6, &used, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    EXPECT_EQ(0, used);
+    oskar_station_free(square, &status);
+    oskar_station_free(skewed, &status);
+}
@@ -41,6 +41,10 @@
 #include <cstdlib>
 #include <vector>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #define D2R (M_PI / 180.0)
 
 #ifdef OSKAR_HAVE_CUDA
@@ -168,3 +172,88 @@ TEST(evaluate_jones_E, evaluate_e)
     ASSERT_EQ(0, error) << oskar_get_error_string(error);
 }
 
+
+#ifdef _OPENMP
+TEST(evaluate_jones_E, parallel_stations)
+{
+    int error = 0, num_stations = 3, num_antennas = 50, num_pts = 3000;
+    double frequency = 100e6, gast = 0.0;
+
+    // Construct a telescope model with different stations.
+    oskar_Telescope* tel = oskar_telescope_create(OSKAR_DOUBLE,
+            OSKAR_CPU, num_stations, &error);
+    srand(1);
+    for (int i = 0; i < num_stations; ++i)
+    {
+        oskar_Station* s = oskar_telescope_station(tel, i);
+        oskar_station_resize(s, num_antennas, &error);
+        oskar_station_resize_element_types(s, 1, &error);
+        oskar_station_set_position(s, 0.0, 0.1 * i - M_PI / 4.0, 0.0);
+        oskar_station_set_normalise_final_beam(s, 1);
+        oskar_element_set_element_type(oskar_station_element(s, 0),
+                "Isotropic", &error);
+        oskar_mem_random_range(
+                oskar_station_element_measured_x_enu_metres(s),
+                -20.0, 20.0, &error);
+        oskar_mem_random_range(
+                oskar_station_element_measured_y_enu_metres(s),
+                -20.0, 20.0, &error);
+        ASSERT_EQ(0, error) << oskar_get_error_string(error);
+    }
+    oskar_telescope_set_station_ids(tel);
+    oskar_telescope_set_phase_centre(tel,
+            OSKAR_SPHERICAL_TYPE_EQUATORIAL, 0.0, -M_PI / 4.0);
+    oskar_telescope_analyse(tel, &error);
+    ASSERT_EQ(0, error) << oskar_get_error_string(error);
+
+    // Create source positions, with space for the normalisation direction.
+    oskar_Mem *l = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_pts + 1,
+            &error);
+    oskar_Mem *m = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_pts + 1,
+            &error);
+    oskar_Mem *n = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_pts + 1,
+            &error);
+    oskar_mem_random_range(l, -0.5, 0.5, &error);
+    oskar_mem_random_range(m, -0.5, 0.5, &error);
+    double *l_ = oskar_mem_double(l, &error);
+    double *m_ = oskar_mem_double(m, &error);
+    double *n_ = oskar_mem_double(n, &error);
+    for (int i = 0; i < num_pts; ++i)
+        n_[i] = sqrt(1.0 - l_[i] * l_[i] - m_[i] * m_[i]);
+
+    // Evaluate the station beams using one thread, then several.
+    oskar_Jones* E1 = oskar_jones_create(OSKAR_DOUBLE_COMPLEX, OSKAR_CPU,
+            num_stations, num_pts, &error);
+    oskar_Jones* E2 = oskar_jones_create(OSKAR_DOUBLE_COMPLEX, OSKAR_CPU,
+            num_stations, num_pts, &error);
+    oskar_StationWork* work = oskar_station_work_create(OSKAR_DOUBLE,
+            OSKAR_CPU, &error);
+    int num_threads = omp_get_max_threads();
+    omp_set_num_threads(1);
+    oskar_evaluate_jones_E(E1, num_pts, OSKAR_RELATIVE_DIRECTIONS,
+            l, m, n, tel, gast, frequency, work, 0, &error);
+    omp_set_num_threads(4);
+    oskar_evaluate_jones_E(E2, num_pts, OSKAR_RELATIVE_DIRECTIONS,
+            l, m, n, tel, gast, frequency, work, 0, &error);
+    omp_set_num_threads(num_threads);
+    ASSERT_EQ(0, error) << oskar_get_error_string(error);
+
+    // Check the results are the same.
+    const double2* e1 = oskar_mem_double2_const(oskar_jones_mem(E1), &error);
+    const double2* e2 = oskar_mem_double2_const(oskar_jones_mem(E2), &error);
+    for (int i = 0; i < num_stations * num_pts; ++i)
+    {
+        ASSERT_DOUBLE_EQ(e1[i].x, e2[i].x) << "index " << i;
+        ASSERT_DOUBLE_EQ(e1[i].y, e2[i].y) << "index " << i;
+    }
+
+    oskar_jones_free(E1, &error);
+    oskar_jones_free(E2, &error);
+    oskar_mem_free(l, &error);
+    oskar_mem_free(m, &error);
+    oskar_mem_free(n, &error);
+    oskar_telescope_free(tel, &error);
+    oskar_station_work_free(work, &error);
+    ASSERT_EQ(0, error) << oskar_get_error_string(error);
+}
+#endif
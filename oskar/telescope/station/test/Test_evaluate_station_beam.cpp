@@ -29,9 +29,13 @@
 #include <gtest/gtest.h>
 
 #include "telescope/station/oskar_station.h"
+#include "telescope/station/oskar_evaluate_station_beam.h"
 #include "telescope/station/oskar_evaluate_station_beam_aperture_array.h"
 #include "telescope/station/oskar_evaluate_station_beam_gaussian.h"
 #include "telescope/station/oskar_evaluate_beam_horizon_direction.h"
+#include "telescope/station/oskar_evaluate_element_weights_errors.h"
+#include "telescope/station/oskar_evaluate_element_weights_errors_block.h"
+#include "telescope/oskar_telescope.h"
 #include "utility/oskar_get_error_string.h"
 #include "math/oskar_linspace.h"
 #include "math/oskar_meshgrid.h"
@@ -42,6 +46,7 @@
 #include "math/oskar_cmath.h"
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 
 using namespace std;
 
@@ -315,3 +320,508 @@ TEST(evaluate_station_beam, gaussian)
         oskar_mem_free(beam, &error);
     }
 }
+
+
+TEST(evaluate_station_beam, below_horizon)
+{
+    int error = 0, num_points = 100, num_visible = 0;
+    double freq_hz = 100e6;
+
+    // Create a Gaussian beam station pointing at the zenith.
+    oskar_Station* station = oskar_station_create(OSKAR_DOUBLE,
+            OSKAR_CPU, 0, &error);
+    oskar_station_set_station_type(station, OSKAR_STATION_TYPE_GAUSSIAN_BEAM);
+    oskar_station_set_gaussian_beam_values(station, 60.0 * M_PI / 180.0,
+            freq_hz);
+    oskar_station_set_normalise_final_beam(station, 0);
+    oskar_station_set_position(station, 0.0, M_PI / 4.0, 0.0);
+    oskar_station_set_phase_centre(station,
+            OSKAR_SPHERICAL_TYPE_EQUATORIAL, 0.0, M_PI / 4.0);
+    oskar_StationWork* work = oskar_station_work_create(OSKAR_DOUBLE,
+            OSKAR_CPU, &error);
+
+    // Generate ENU directions, with every third one below the horizon.
+    oskar_Mem *x, *y, *z, *vx, *vy, *vz, *beam, *visible_beam;
+    x = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &error);
+    y = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &error);
+    z = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &error);
+    vx = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &error);
+    vy = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &error);
+    vz = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &error);
+    double *x_ = oskar_mem_double(x, &error);
+    double *y_ = oskar_mem_double(y, &error);
+    double *z_ = oskar_mem_double(z, &error);
+    for (int i = 0; i < num_points; ++i)
+    {
+        double el = (i % 3 == 0 ? -1.0 : 1.0) * M_PI * (i + 1) / 210.0;
+        double az = 2.0 * M_PI * i / num_points;
+        x_[i] = cos(el) * sin(az);
+        y_[i] = cos(el) * cos(az);
+        z_[i] = sin(el);
+        if (z_[i] >= 0.0)
+        {
+            oskar_mem_double(vx, &error)[num_visible] = x_[i];
+            oskar_mem_double(vy, &error)[num_visible] = y_[i];
+            oskar_mem_double(vz, &error)[num_visible] = z_[i];
+            num_visible++;
+        }
+    }
+    ASSERT_LT(num_visible, num_points);
+
+    // Evaluate the beam for all directions, and for visible ones only.
+    beam = oskar_mem_create(OSKAR_DOUBLE_COMPLEX, OSKAR_CPU,
+            num_points, &error);
+    visible_beam = oskar_mem_create(OSKAR_DOUBLE_COMPLEX, OSKAR_CPU,
+            num_visible, &error);
+    oskar_evaluate_station_beam(beam, num_points, OSKAR_ENU_DIRECTIONS,
+            x, y, z, 0.0, M_PI / 4.0, station, work, 0, freq_hz, 0.0, &error);
+    oskar_evaluate_station_beam(visible_beam, num_visible,
+            OSKAR_ENU_DIRECTIONS, vx, vy, vz, 0.0, M_PI / 4.0, station,
+            work, 0, freq_hz, 0.0, &error);
+    ASSERT_EQ(0, error) << oskar_get_error_string(error);
+
+    // Check directions below the horizon are zero, and others match.
+    const double* b = oskar_mem_double_const(beam, &error);
+    const double* v = oskar_mem_double_const(visible_beam, &error);
+    for (int i = 0, j = 0; i < num_points; ++i)
+    {
+        if (z_[i] < 0.0)
+        {
+            EXPECT_EQ(0.0, b[2*i]);
+            EXPECT_EQ(0.0, b[2*i + 1]);
+        }
+        else
+        {
+            EXPECT_DOUBLE_EQ(v[2*j], b[2*i]);
+            EXPECT_DOUBLE_EQ(v[2*j + 1], b[2*i + 1]);
+            EXPECT_GT(b[2*i], 0.0);
+            j++;
+        }
+    }
+
+    oskar_mem_free(x, &error);
+    oskar_mem_free(y, &error);
+    oskar_mem_free(z, &error);
+    oskar_mem_free(vx, &error);
+    oskar_mem_free(vy, &error);
+    oskar_mem_free(vz, &error);
+    oskar_mem_free(beam, &error);
+    oskar_mem_free(visible_beam, &error);
+    oskar_station_work_free(work, &error);
+    oskar_station_free(station, &error);
+    ASSERT_EQ(0, error) << oskar_get_error_string(error);
+}
+
+
+static void set_up_station(oskar_Station* s, double lat_rad,
+        double dec_rad, int* status)
+{
+    oskar_station_set_position(s, 0.0, lat_rad, 0.0);
+    oskar_station_set_phase_centre(s,
+            OSKAR_SPHERICAL_TYPE_EQUATORIAL, 0.0, dec_rad);
+    oskar_station_set_normalise_final_beam(s, 0);
+    if (!oskar_station_has_child(s))
+    {
+        oskar_station_resize_element_types(s, 1, status);
+        oskar_element_set_element_type(oskar_station_element(s, 0),
+                "Isotropic", status);
+    }
+}
+
+TEST(evaluate_station_beam, equivalent_children)
+{
+    int error = 0, finished = 0, num_children = 6, num_points = 200;
+    double freq_hz = 100e6, lat = M_PI / 4.0, dec = M_PI / 3.0;
+
+    // Create a station with two alternating types of child station.
+    oskar_Station* station = oskar_station_create(OSKAR_DOUBLE,
+            OSKAR_CPU, 0, &error);
+    oskar_station_resize(station, num_children, &error);
+    oskar_station_create_child_stations(station, &error);
+    set_up_station(station, lat, dec, &error);
+    for (int i = 0; i < num_children; ++i)
+    {
+        double xyz[] = {10.0 * i, 2.0 * i, 0.0};
+        oskar_Station* child = oskar_station_child(station, i);
+        oskar_station_set_element_coords(station, i, xyz, xyz, &error);
+        if (i % 2 == 0)
+        {
+            oskar_station_resize(child, 4, &error);
+            for (int j = 0; j < 4; ++j)
+            {
+                double c[] = {(j % 2) * 1.5 - 0.75, (j / 2) * 1.5 - 0.75, 0.};
+                oskar_station_set_element_coords(child, j, c, c, &error);
+            }
+        }
+        else
+        {
+            oskar_station_resize(child, 3, &error);
+            for (int j = 0; j < 3; ++j)
+            {
+                double c[] = {j - 1.0, 0.0, 0.0};
+                oskar_station_set_element_coords(child, j, c, c, &error);
+            }
+        }
+        set_up_station(child, lat, dec, &error);
+    }
+    ASSERT_EQ(0, error) << oskar_get_error_string(error);
+    EXPECT_TRUE(oskar_station_equivalent_children_cpu_const(station) == 0);
+
+    // Generate ENU directions above the horizon.
+    oskar_Mem *x, *y, *z, *beam_all, *beam;
+    x = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &error);
+    y = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &error);
+    z = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &error);
+    for (int i = 0; i < num_points; ++i)
+    {
+        double el = M_PI / 2.0 * (i + 1) / (num_points + 1);
+        double az = 17.0 * M_PI * i / num_points;
+        oskar_mem_double(x, &error)[i] = cos(el) * sin(az);
+        oskar_mem_double(y, &error)[i] = cos(el) * cos(az);
+        oskar_mem_double(z, &error)[i] = sin(el);
+    }
+
+    // Evaluate the beam by evaluating every child station.
+    oskar_StationWork* work = oskar_station_work_create(OSKAR_DOUBLE,
+            OSKAR_CPU, &error);
+    beam_all = oskar_mem_create(OSKAR_DOUBLE_COMPLEX, OSKAR_CPU,
+            num_points, &error);
+    oskar_evaluate_station_beam_aperture_array(beam_all, station, num_points,
+            x, y, z, 0.0, freq_hz, work, 0, &error);
+    ASSERT_EQ(0, error) << oskar_get_error_string(error);
+
+    // Analyse the station to find equivalent child stations.
+    oskar_station_analyse(station, &finished, &error);
+    ASSERT_EQ(0, error) << oskar_get_error_string(error);
+    const int* equivalent = oskar_station_equivalent_children_cpu_const(
+            station);
+    ASSERT_TRUE(equivalent != 0);
+    EXPECT_EQ(0, oskar_station_identical_children(station));
+    for (int i = 0; i < num_children; ++i)
+        EXPECT_EQ(i % 2, equivalent[i]);
+
+    // Evaluate the beam again, and check it is the same.
+    // Only the distinct child beams should be held in the work buffers.
+    oskar_StationWork* work2 = oskar_station_work_create(OSKAR_DOUBLE,
+            OSKAR_CPU, &error);
+    beam = oskar_mem_create(OSKAR_DOUBLE_COMPLEX, OSKAR_CPU,
+            num_points, &error);
+    oskar_evaluate_station_beam_aperture_array(beam, station, num_points,
+            x, y, z, 0.0, freq_hz, work2, 0, &error);
+    ASSERT_EQ(0, error) << oskar_get_error_string(error);
+    const double* b0 = oskar_mem_double_const(beam_all, &error);
+    const double* b1 = oskar_mem_double_const(beam, &error);
+    for (int i = 0; i < 2 * num_points; ++i)
+        EXPECT_NEAR(b0[i], b1[i], 1e-12);
+    EXPECT_LT(oskar_station_work_memory_peak(work2),
+            oskar_station_work_memory_peak(work));
+
+    oskar_mem_free(x, &error);
+    oskar_mem_free(y, &error);
+    oskar_mem_free(z, &error);
+    oskar_mem_free(beam_all, &error);
+    oskar_mem_free(beam, &error);
+    oskar_station_work_free(work, &error);
+    oskar_station_work_free(work2, &error);
+    oskar_station_free(station, &error);
+    ASSERT_EQ(0, error) << oskar_get_error_string(error);
+}
+
+
+TEST(evaluate_station_beam, multiple_element_types)
+{
+    int error = 0, finished = 0, num_elements = 16, num_points = 300;
+    double freq_hz = 100e6, lat = M_PI / 4.0, dec = M_PI / 3.0;
+
+    // Create a station with two types of dipole and a common orientation.
+    oskar_Station* station = oskar_station_create(OSKAR_DOUBLE,
+            OSKAR_CPU, 0, &error);
+    oskar_station_resize(station, num_elements, &error);
+    oskar_station_set_position(station, 0.0, lat, 0.0);
+    oskar_station_set_phase_centre(station,
+            OSKAR_SPHERICAL_TYPE_EQUATORIAL, 0.0, dec);
+    oskar_station_set_normalise_final_beam(station, 0);
+    oskar_station_resize_element_types(station, 2, &error);
+    for (int i = 0; i < 2; ++i)
+    {
+        oskar_Element* element = oskar_station_element(station, i);
+        oskar_element_set_element_type(element, "Dipole", &error);
+        oskar_element_set_dipole_length(element, 0.5 * (i + 1),
+                "Wavelengths", &error);
+    }
+    for (int i = 0; i < num_elements; ++i)
+    {
+        double xyz[] = {3.0 * (i % 4) + 0.1 * i, 2.5 * (i / 4), 0.0};
+        oskar_station_set_element_coords(station, i, xyz, xyz, &error);
+        oskar_station_set_element_type(station, i, (i * i) % 3 == 1, &error);
+    }
+    oskar_station_analyse(station, &finished, &error);
+    ASSERT_EQ(0, error) << oskar_get_error_string(error);
+    ASSERT_EQ(1, oskar_station_common_element_orientation(station));
+
+    // Generate ENU directions above the horizon.
+    oskar_Mem *x, *y, *z, *beam_indexed, *beam;
+    x = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &error);
+    y = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &error);
+    z = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &error);
+    for (int i = 0; i < num_points; ++i)
+    {
+        double el = M_PI / 2.0 * (i + 1) / (num_points + 1);
+        double az = 13.0 * M_PI * i / num_points;
+        oskar_mem_double(x, &error)[i] = cos(el) * sin(az);
+        oskar_mem_double(y, &error)[i] = cos(el) * cos(az);
+        oskar_mem_double(z, &error)[i] = sin(el);
+    }
+
+    // Evaluate the beam using element patterns for each element type.
+    oskar_StationWork* work = oskar_station_work_create(OSKAR_DOUBLE,
+            OSKAR_CPU, &error);
+    beam_indexed = oskar_mem_create(OSKAR_DOUBLE_COMPLEX_MATRIX, OSKAR_CPU,
+            num_points, &error);
+    oskar_evaluate_station_beam_aperture_array(beam_indexed, station,
+            num_points, x, y, z, 0.0, freq_hz, work, 0, &error);
+    ASSERT_EQ(0, error) << oskar_get_error_string(error);
+
+    // Rotate one element by a full turn, so that the element orientation
+    // is no longer common, and evaluate the beam for each element.
+    oskar_station_set_element_feed_angle(station, 1, num_elements - 1,
+            360.0, 0.0, 0.0, &error);
+    oskar_station_analyse(station, &finished, &error);
+    ASSERT_EQ(0, oskar_station_common_element_orientation(station));
+    beam = oskar_mem_create(OSKAR_DOUBLE_COMPLEX_MATRIX, OSKAR_CPU,
+            num_points, &error);
+    oskar_evaluate_station_beam_aperture_array(beam, station, num_points,
+            x, y, z, 0.0, freq_hz, work, 0, &error);
+    ASSERT_EQ(0, error) << oskar_get_error_string(error);
+
+    // Check the beams are the same.
+    const double* b0 = oskar_mem_double_const(beam, &error);
+    const double* b1 = oskar_mem_double_const(beam_indexed, &error);
+    for (int i = 0; i < 8 * num_points; ++i)
+        EXPECT_NEAR(b0[i], b1[i], 1e-12);
+
+    oskar_mem_free(x, &error);
+    oskar_mem_free(y, &error);
+    oskar_mem_free(z, &error);
+    oskar_mem_free(beam_indexed, &error);
+    oskar_mem_free(beam, &error);
+    oskar_station_work_free(work, &error);
+    oskar_station_free(station, &error);
+    ASSERT_EQ(0, error) << oskar_get_error_string(error);
+}
+
+
+TEST(evaluate_station_beam, work_memory_limit)
+{
+    int error = 0, finished = 0, num_children = 8, num_points = 5000;
+    size_t max_bytes = 64 * 1024;
+    double freq_hz = 100e6, lat = M_PI / 4.0, dec = M_PI / 3.0;
+
+    // Create a station with different child stations.
+    oskar_Station* station = oskar_station_create(OSKAR_DOUBLE,
+            OSKAR_CPU, 0, &error);
+    oskar_station_resize(station, num_children, &error);
+    oskar_station_create_child_stations(station, &error);
+    set_up_station(station, lat, dec, &error);
+    for (int i = 0; i < num_children; ++i)
+    {
+        double xyz[] = {10.0 * i, 3.0 * (i % 3), 0.0};
+        oskar_Station* child = oskar_station_child(station, i);
+        oskar_station_set_element_coords(station, i, xyz, xyz, &error);
+        oskar_station_resize(child, 16, &error);
+        for (int j = 0; j < 16; ++j)
+        {
+            double c[] = {(j % 4) * (1.0 + 0.1 * i), (j / 4) * 1.2, 0.0};
+            oskar_station_set_element_coords(child, j, c, c, &error);
+        }
+        set_up_station(child, lat, dec, &error);
+    }
+    oskar_station_analyse(station, &finished, &error);
+    ASSERT_EQ(0, error) << oskar_get_error_string(error);
+
+    // Generate ENU directions above the horizon.
+    oskar_Mem *x, *y, *z, *beam_limited, *beam;
+    x = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &error);
+    y = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &error);
+    z = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &error);
+    for (int i = 0; i < num_points; ++i)
+    {
+        double el = M_PI / 2.0 * (i + 1) / (num_points + 1);
+        double az = 29.0 * M_PI * i / num_points;
+        oskar_mem_double(x, &error)[i] = cos(el) * sin(az);
+        oskar_mem_double(y, &error)[i] = cos(el) * cos(az);
+        oskar_mem_double(z, &error)[i] = sin(el);
+    }
+
+    // Evaluate the beam without and with a memory limit.
+    oskar_StationWork* work = oskar_station_work_create(OSKAR_DOUBLE,
+            OSKAR_CPU, &error);
+    oskar_StationWork* work_limited = oskar_station_work_create(OSKAR_DOUBLE,
+            OSKAR_CPU, &error);
+    oskar_station_work_set_max_memory(work_limited, max_bytes);
+    EXPECT_EQ(max_bytes, oskar_station_work_max_memory(work_limited));
+    beam = oskar_mem_create(OSKAR_DOUBLE_COMPLEX, OSKAR_CPU,
+            num_points, &error);
+    beam_limited = oskar_mem_create(OSKAR_DOUBLE_COMPLEX, OSKAR_CPU,
+            num_points, &error);
+    oskar_evaluate_station_beam_aperture_array(beam, station, num_points,
+            x, y, z, 0.0, freq_hz, work, 0, &error);
+    oskar_evaluate_station_beam_aperture_array(beam_limited, station,
+            num_points, x, y, z, 0.0, freq_hz, work_limited, 0, &error);
+    ASSERT_EQ(0, error) << oskar_get_error_string(error);
+
+    // Check the beams are the same, and the memory limit was respected
+    // (allowing for the beamforming weights, which are not chunked).
+    const double* b0 = oskar_mem_double_const(beam, &error);
+    const double* b1 = oskar_mem_double_const(beam_limited, &error);
+    for (int i = 0; i < 2 * num_points; ++i)
+        EXPECT_DOUBLE_EQ(b0[i], b1[i]);
+    EXPECT_LE(oskar_station_work_memory_peak(work_limited),
+            max_bytes + max_bytes / 20);
+    EXPECT_GT(oskar_station_work_memory_peak(work),
+            oskar_station_work_memory_peak(work_limited));
+
+    oskar_mem_free(x, &error);
+    oskar_mem_free(y, &error);
+    oskar_mem_free(z, &error);
+    oskar_mem_free(beam, &error);
+    oskar_mem_free(beam_limited, &error);
+    oskar_station_work_free(work, &error);
+    oskar_station_work_free(work_limited, &error);
+    oskar_station_free(station, &error);
+    ASSERT_EQ(0, error) << oskar_get_error_string(error);
+}
+
+
+TEST(evaluate_station_beam, element_errors_block)
+{
+    int error = 0, counter = 0, time_start = 3, num_times = 4;
+    const int num_stations = 3, num_elements[] = {5, 8, 1};
+    int precisions[] = {OSKAR_SINGLE, OSKAR_DOUBLE};
+
+    for (int p = 0; p < 2; ++p)
+    {
+        // Create stations with time-variable element errors.
+        int offsets[num_stations + 1];
+        oskar_Station* owned[num_stations];
+        const oskar_Station* stations[num_stations];
+        offsets[0] = 0;
+        for (int k = 0; k < num_stations; ++k)
+        {
+            oskar_Station* s = oskar_station_create(precisions[p],
+                    OSKAR_CPU, 0, &error);
+            oskar_station_resize(s, num_elements[k], &error);
+            oskar_station_set_unique_ids(s, &counter);
+            oskar_station_set_seed_time_variable_errors(s, 10 + k);
+            for (int i = 0; i < num_elements[k]; ++i)
+                oskar_station_set_element_errors(s, i, 1.0 + 0.1 * i,
+                        0.05 * (k + 1), 0.01 * i, 0.02 * (i + 1), &error);
+            owned[k] = s;
+            stations[k] = s;
+            offsets[k + 1] = offsets[k] + num_elements[k];
+        }
+
+        // Generate errors for all stations and times together.
+        oskar_Mem* block = oskar_mem_create(precisions[p] | OSKAR_COMPLEX,
+                OSKAR_CPU, 0, &error);
+        oskar_evaluate_element_weights_errors_block(num_stations, stations,
+                offsets, time_start, num_times, block, &error);
+        ASSERT_EQ(0, error) << oskar_get_error_string(error);
+
+        // Check they are bitwise identical to those for each station.
+        oskar_Mem* errors = oskar_mem_create(precisions[p] | OSKAR_COMPLEX,
+                OSKAR_CPU, 0, &error);
+        size_t element_size = oskar_mem_element_size(oskar_mem_type(block));
+        for (int t = 0; t < num_times; ++t)
+        {
+            for (int k = 0; k < num_stations; ++k)
+            {
+                const oskar_Station* s = stations[k];
+                oskar_mem_realloc(errors, num_elements[k] + 3, &error);
+                oskar_evaluate_element_weights_errors(num_elements[k],
+                        oskar_station_element_gain_const(s),
+                        oskar_station_element_gain_error_const(s),
+                        oskar_station_element_phase_offset_rad_const(s),
+                        oskar_station_element_phase_error_rad_const(s),
+                        oskar_station_seed_time_variable_errors(s),
+                        time_start + t, oskar_station_unique_id(s),
+                        errors, &error);
+                ASSERT_EQ(0, error) << oskar_get_error_string(error);
+                const char* b = (const char*) oskar_mem_void_const(block) +
+                        (t * offsets[num_stations] + offsets[k]) *
+                        element_size;
+                EXPECT_EQ(0, memcmp(b, oskar_mem_void_const(errors),
+                        num_elements[k] * element_size));
+            }
+        }
+
+        oskar_mem_free(block, &error);
+        oskar_mem_free(errors, &error);
+        for (int k = 0; k < num_stations; ++k)
+            oskar_station_free(owned[k], &error);
+        ASSERT_EQ(0, error) << oskar_get_error_string(error);
+    }
+}
+
+
+TEST(evaluate_station_beam, element_errors_cache_station_modified)
+{
+    int error = 0;
+    const int num_stations = 2, num_elements = 6, num_times = 3;
+
+    // Create a telescope whose stations have time-variable element errors.
+    oskar_Telescope* tel = oskar_telescope_create(OSKAR_DOUBLE, OSKAR_CPU,
+            num_stations, &error);
+    for (int k = 0; k < num_stations; ++k)
+    {
+        oskar_Station* s = oskar_telescope_station(tel, k);
+        oskar_station_resize(s, num_elements, &error);
+        for (int i = 0; i < num_elements; ++i)
+            oskar_station_set_element_errors(s, i, 1.0, 0.1, 0.0, 1.0,
+                    &error);
+    }
+    oskar_telescope_set_station_ids(tel);
+    oskar_telescope_analyse(tel, &error);
+    ASSERT_EQ(0, error) << oskar_get_error_string(error);
+
+    // Fill the cache.
+    oskar_StationWork* work = oskar_station_work_create(OSKAR_DOUBLE,
+            OSKAR_CPU, &error);
+    oskar_station_work_evaluate_element_errors(work, tel, 0, num_times,
+            &error);
+    ASSERT_EQ(0, error) << oskar_get_error_string(error);
+
+    // Modify the errors of one station, and refill the cache.
+    oskar_Station* s = oskar_telescope_station(tel, 1);
+    for (int i = 0; i < num_elements; ++i)
+        oskar_station_set_element_errors(s, i, 2.0, 0.5, 10.0, 5.0, &error);
+    oskar_station_work_evaluate_element_errors(work, tel, 0, num_times,
+            &error);
+    ASSERT_EQ(0, error) << oskar_get_error_string(error);
+
+    // Check the cache holds the errors for the modified station.
+    oskar_Mem* errors = oskar_mem_create(OSKAR_DOUBLE_COMPLEX, OSKAR_CPU,
+            num_elements, &error);
+    for (int t = 0; t < num_times; ++t)
+    {
+        const oskar_Mem* cached = oskar_station_work_element_errors(work, s,
+                t, &error);
+        ASSERT_TRUE(cached != NULL);
+        oskar_evaluate_element_weights_errors(num_elements,
+                oskar_station_element_gain_const(s),
+                oskar_station_element_gain_error_const(s),
+                oskar_station_element_phase_offset_rad_const(s),
+                oskar_station_element_phase_error_rad_const(s),
+                oskar_station_seed_time_variable_errors(s), t,
+                oskar_station_unique_id(s), errors, &error);
+        ASSERT_EQ(0, error) << oskar_get_error_string(error);
+        EXPECT_EQ(0, memcmp(oskar_mem_void_const(cached),
+                oskar_mem_void_const(errors),
+                num_elements * sizeof(double2)));
+    }
+
+    oskar_mem_free(errors, &error);
+    oskar_station_work_free(work, &error);
+    oskar_telescope_free(tel, &error);
+    ASSERT_EQ(0, error) << oskar_get_error_string(error);
+}
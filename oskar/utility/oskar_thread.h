@@ -40,9 +40,11 @@ extern "C" {
 #endif
 
 struct oskar_Mutex;
+struct oskar_ConditionVar;
 struct oskar_Thread;
 struct oskar_Barrier;
 typedef struct oskar_Mutex oskar_Mutex;
+typedef struct oskar_ConditionVar oskar_ConditionVar;
 typedef struct oskar_Thread oskar_Thread;
 typedef struct oskar_Barrier oskar_Barrier;
 
@@ -90,6 +92,90 @@ void oskar_mutex_lock(oskar_Mutex* mutex);
 OSKAR_EXPORT
 void oskar_mutex_unlock(oskar_Mutex* mutex);
 
+/**
+ * @brief Creates a condition variable.
+ *
+ * @details
+ * Creates a condition variable, together with the mutex that
+ * protects it.
+ */
+OSKAR_EXPORT
+oskar_ConditionVar* oskar_condition_create(void);
+
+/**
+ * @brief Destroys the condition variable.
+ *
+ * @details
+ * Destroys the condition variable.
+ *
+ * @param[in,out] var Pointer to condition variable.
+ */
+OSKAR_EXPORT
+void oskar_condition_free(oskar_ConditionVar* var);
+
+/**
+ * @brief Locks the mutex associated with the condition variable.
+ *
+ * @details
+ * Locks the mutex associated with the condition variable.
+ *
+ * @param[in,out] var Pointer to condition variable.
+ */
+OSKAR_EXPORT
+void oskar_condition_lock(oskar_ConditionVar* var);
+
+/**
+ * @brief Unlocks the mutex associated with the condition variable.
+ *
+ * @details
+ * Unlocks the mutex associated with the condition variable.
+ *
+ * @param[in,out] var Pointer to condition variable.
+ */
+OSKAR_EXPORT
+void oskar_condition_unlock(oskar_ConditionVar* var);
+
+/**
+ * @brief Wakes all threads waiting on the condition variable.
+ *
+ * @details
+ * Wakes all threads waiting on the condition variable.
+ *
+ * @param[in,out] var Pointer to condition variable.
+ */
+OSKAR_EXPORT
+void oskar_condition_notify_all(oskar_ConditionVar* var);
+
+/**
+ * @brief Blocks the caller until the condition variable is notified.
+ *
+ * @details
+ * Blocks the caller until the condition variable is notified.
+ *
+ * The mutex must be locked by the caller, and it is locked again on
+ * return. Spurious wake-ups are possible, so the caller must check its
+ * condition in a loop.
+ *
+ * @param[in,out] var Pointer to condition variable.
+ */
+OSKAR_EXPORT
+void oskar_condition_wait(oskar_ConditionVar* var);
+
+/**
+ * @brief Atomically adds to an integer.
+ *
+ * @details
+ * Atomically adds \p increment to the integer pointed to by \p value,
+ * and returns the value it held before the addition.
+ *
+ * @param[in,out] value Pointer to integer to update.
+ * @param[in] increment Value to add.
+ *
+ * @return The original value.
+ */
+OSKAR_EXPORT
+int oskar_atomic_fetch_add_int(volatile int* value, int increment);
+
 /**
  * @brief Creates and starts a thread.
  *
@@ -120,7 +120,6 @@ struct oskar_ConditionVar
     pthread_cond_t var;
 #endif
 };
-typedef struct oskar_ConditionVar oskar_ConditionVar;
 
 static void oskar_condition_init(oskar_ConditionVar* var)
 {
@@ -142,17 +141,32 @@ static void oskar_condition_uninit(oskar_ConditionVar* var)
 #endif
 }
 
-static void oskar_condition_lock(oskar_ConditionVar* var)
+oskar_ConditionVar* oskar_condition_create(void)
+{
+    oskar_ConditionVar* var;
+    var = (oskar_ConditionVar*) calloc(1, sizeof(oskar_ConditionVar));
+    oskar_condition_init(var);
+    return var;
+}
+
+void oskar_condition_free(oskar_ConditionVar* var)
+{
+    if (!var) return;
+    oskar_condition_uninit(var);
+    free(var);
+}
+
+void oskar_condition_lock(oskar_ConditionVar* var)
 {
     oskar_mutex_lock(&var->lock);
 }
 
-static void oskar_condition_unlock(oskar_ConditionVar* var)
+void oskar_condition_unlock(oskar_ConditionVar* var)
 {
     oskar_mutex_unlock(&var->lock);
 }
 
-static void oskar_condition_notify_all(oskar_ConditionVar* var)
+void oskar_condition_notify_all(oskar_ConditionVar* var)
 {
 #if defined(OSKAR_OS_WIN)
     WakeAllConditionVariable(&var->var);
@@ -161,7 +175,7 @@ static void oskar_condition_notify_all(oskar_ConditionVar* var)
 #endif
 }
 
-static void oskar_condition_wait(oskar_ConditionVar* var)
+void oskar_condition_wait(oskar_ConditionVar* var)
 {
 #if defined(OSKAR_OS_WIN)
     SleepConditionVariableCS(&var->var, &(var->lock.lock), INFINITE);
@@ -171,6 +185,32 @@ static void oskar_condition_wait(oskar_ConditionVar* var)
 }
 
 
+/* =========================================================================
+ *  ATOMIC
+ * =========================================================================*/
+
+#if !defined(OSKAR_OS_WIN) && !defined(__GNUC__)
+static pthread_mutex_t oskar_atomic_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+int oskar_atomic_fetch_add_int(volatile int* value, int increment)
+{
+#if defined(OSKAR_OS_WIN)
+    return (int) InterlockedExchangeAdd((volatile LONG*) value,
+            (LONG) increment);
+#elif defined(__GNUC__)
+    return __sync_fetch_and_add(value, increment);
+#else
+    int old;
+    pthread_mutex_lock(&oskar_atomic_lock);
+    old = *value;
+    *value += increment;
+    pthread_mutex_unlock(&oskar_atomic_lock);
+    return old;
+#endif
+}
+
+
 /* =========================================================================
  *  THREAD
  * =========================================================================*/
@@ -368,6 +368,9 @@ class Imager(object):
     def rotate_vis(self, uu_in, vv_in, ww_in, vis):
         """Phase-rotates visibility amplitudes to the new phase centre (if set).
 
+        Deprecated: the imager applies the phase rotation itself when
+        visibilities are passed to update() or run().
+
         Prior to calling this method, the new phase centre must be set first
         using set_direction(), and then the original phase centre
         must be set using set_vis_phase_centre().
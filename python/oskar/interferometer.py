@@ -285,6 +285,24 @@ class Interferometer(object):
         self.capsule_ensure()
         _interferometer_lib.set_max_sources_per_chunk(self._capsule, value)
 
+    def set_max_station_beam_cache_mb(self, value):
+        """Sets the memory limit for the station beam cache on each device.
+
+        Args:
+            value (int): Memory limit in MB.
+        """
+        self.capsule_ensure()
+        _interferometer_lib.set_max_station_beam_cache_mb(self._capsule, value)
+
+    def set_max_station_work_mb(self, value):
+        """Sets the memory limit for station beam work buffers on each device.
+
+        Args:
+            value (int): Memory limit in MB, or 0 to use a fixed chunk size.
+        """
+        self.capsule_ensure()
+        _interferometer_lib.set_max_station_work_mb(self._capsule, value)
+
     def set_max_times_per_block(self, value):
         """Sets the maximum number of times in a visibility block.
 
@@ -309,6 +327,20 @@ class Interferometer(object):
         self.capsule_ensure()
         _interferometer_lib.set_num_devices(self._capsule, value)
 
+    def set_num_threads_per_device(self, value):
+        """Sets the number of OpenMP threads used by each CPU device.
+
+        Using fewer CPU devices, each with more threads, reduces the
+        memory needed for the simulation.
+        If the number of devices is chosen automatically, it is
+        recalculated using this value.
+
+        Args:
+            value (int): Number of threads per CPU device.
+        """
+        self.capsule_ensure()
+        _interferometer_lib.set_num_threads_per_device(self._capsule, value)
+
     def set_observation_frequency(self, start_frequency_hz,
                                   inc_hz=0.0, num_channels=1):
         """Sets observation start frequency, increment, and number of channels.
@@ -374,6 +406,19 @@ class Interferometer(object):
         self._sky_model_set = True
         _interferometer_lib.set_sky_model(self._capsule, sky_model.capsule)
 
+    def set_station_beam_cache_tolerance(self, value):
+        """Sets the tolerance used to reuse station beams between time steps.
+
+        Station beams are re-evaluated only when the beam hour angle moves
+        into a new interval of this size. A value of 0 disables the cache.
+
+        Args:
+            value (float): Cache tolerance, in degrees.
+        """
+        self.capsule_ensure()
+        _interferometer_lib.set_station_beam_cache_tolerance(
+            self._capsule, value)
+
     def set_telescope_model(self, telescope_model):
         """Sets the telescope model used for the simulation.
 
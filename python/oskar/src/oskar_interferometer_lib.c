@@ -399,6 +399,31 @@ static PyObject* set_max_sources_per_chunk(PyObject* self, PyObject* args)
 }
 
 
+static PyObject* set_max_station_beam_cache_mb(PyObject* self,
+        PyObject* args)
+{
+    oskar_Interferometer* h = 0;
+    PyObject* capsule = 0;
+    int value = 0;
+    if (!PyArg_ParseTuple(args, "Oi", &capsule, &value)) return 0;
+    if (!(h = (oskar_Interferometer*) get_handle(capsule, name))) return 0;
+    oskar_interferometer_set_max_station_beam_cache_mb(h, value);
+    return Py_BuildValue("");
+}
+
+
+static PyObject* set_max_station_work_mb(PyObject* self, PyObject* args)
+{
+    oskar_Interferometer* h = 0;
+    PyObject* capsule = 0;
+    int value = 0;
+    if (!PyArg_ParseTuple(args, "Oi", &capsule, &value)) return 0;
+    if (!(h = (oskar_Interferometer*) get_handle(capsule, name))) return 0;
+    oskar_interferometer_set_max_station_work_mb(h, value);
+    return Py_BuildValue("");
+}
+
+
 static PyObject* set_max_times_per_block(PyObject* self, PyObject* args)
 {
     oskar_Interferometer* h = 0;
@@ -423,6 +448,18 @@ static PyObject* set_num_devices(PyObject* self, PyObject* args)
 }
 
 
+static PyObject* set_num_threads_per_device(PyObject* self, PyObject* args)
+{
+    oskar_Interferometer* h = 0;
+    PyObject* capsule = 0;
+    int value = 0;
+    if (!PyArg_ParseTuple(args, "Oi", &capsule, &value)) return 0;
+    if (!(h = (oskar_Interferometer*) get_handle(capsule, name))) return 0;
+    oskar_interferometer_set_num_threads_per_device(h, value);
+    return Py_BuildValue("");
+}
+
+
 static PyObject* set_observation_frequency(PyObject* self, PyObject* args)
 {
     oskar_Interferometer* h = 0;
@@ -513,6 +550,19 @@ static PyObject* set_sky_model(PyObject* self, PyObject* args)
 }
 
 
+static PyObject* set_station_beam_cache_tolerance(PyObject* self,
+        PyObject* args)
+{
+    oskar_Interferometer* h = 0;
+    PyObject* capsule = 0;
+    double value = 0.0;
+    if (!PyArg_ParseTuple(args, "Od", &capsule, &value)) return 0;
+    if (!(h = (oskar_Interferometer*) get_handle(capsule, name))) return 0;
+    oskar_interferometer_set_station_beam_cache_tolerance(h, value);
+    return Py_BuildValue("");
+}
+
+
 static PyObject* set_telescope_model(PyObject* self, PyObject* args)
 {
     oskar_Interferometer* h = 0;
@@ -633,10 +683,18 @@ static PyMethodDef methods[] =
                 METH_VARARGS, "set_horizon_clip(value)"},
         {"set_max_sources_per_chunk", (PyCFunction)set_max_sources_per_chunk,
                 METH_VARARGS, "set_max_sources_per_chunk(value)"},
+        {"set_max_station_beam_cache_mb",
+                (PyCFunction)set_max_station_beam_cache_mb,
+                METH_VARARGS, "set_max_station_beam_cache_mb(value)"},
+        {"set_max_station_work_mb", (PyCFunction)set_max_station_work_mb,
+                METH_VARARGS, "set_max_station_work_mb(value)"},
         {"set_max_times_per_block", (PyCFunction)set_max_times_per_block,
                 METH_VARARGS, "set_max_times_per_block(value)"},
         {"set_num_devices", (PyCFunction)set_num_devices,
                 METH_VARARGS, "set_num_devices(value)"},
+        {"set_num_threads_per_device",
+                (PyCFunction)set_num_threads_per_device,
+                METH_VARARGS, "set_num_threads_per_device(value)"},
         {"set_observation_frequency", (PyCFunction)set_observation_frequency,
                 METH_VARARGS,
                 "set_observation_frequency(start_freq_hz, inc_hz, "
@@ -653,6 +711,9 @@ static PyMethodDef methods[] =
                 METH_VARARGS, "set_settings_path(filename)"},
         {"set_sky_model", (PyCFunction)set_sky_model,
                 METH_VARARGS, "set_sky_model(sky)"},
+        {"set_station_beam_cache_tolerance",
+                (PyCFunction)set_station_beam_cache_tolerance,
+                METH_VARARGS, "set_station_beam_cache_tolerance(value)"},
         {"set_telescope_model", (PyCFunction)set_telescope_model,
                 METH_VARARGS, "set_telescope_model(telescope)"},
         {"set_zero_failed_gaussians", (PyCFunction)set_zero_failed_gaussians,